@@ -5,6 +5,7 @@ int  CloseSaveData();
 int  GenerateMatlab( char * prefix );
 void GetMass( double CL[], double Mass[] );
 void INTEGRATE( double TIN, double TOUT );
+void Update_DEP();
 
 int main()
 {
@@ -50,6 +51,7 @@ int i;
     SaveData();
 
     INTEGRATE( TIME , TIME+DT );
+    Update_DEP();
     TIME += DT;
   }
 
@@ -36,6 +36,7 @@ kron: DO WHILE (T < TEND)
         CALL INTEGRATE( TIN = T, TOUT = T+DT, RSTATUS_U = RSTATE, &
         ICNTRL_U = (/ 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 /) )
         T = RSTATE(1)
+        CALL Update_DEP()
 
       END DO kron
 !~~~> End Time loop
@@ -0,0 +1,245 @@
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Grid of independent boxes integrated on OpenMP threads
+
+    Usage:  KPP_ROOT.exe [Ncell]
+
+    Needs #THREADSAFE on: every thread keeps its own C, RCONST, TEMP,
+    SUN, TIME and STEPMIN.  Cell i has its own concentrations
+    Cgrid[i][NSPEC], temperature Tgrid[i] and local time offset Toff[i];
+    its photolysis follows the local time (Update_SUN at TIME+Toff[i]).
+    The last step size of a cell is kept in Hgrid[i] and starts its
+    next integration.  With #REDUCE the totals of the conservation laws
+    are those of the cell (Update_TOT), and the dependent and QSSA
+    species are updated after its integration (Update_DEP).
+
+    The cost of a cell depends on its stiffness (day/night, polluted or
+    clean) and changes slowly from one call to the next.  Cells are
+    therefore handed out one at a time to idle threads (OpenMP dynamic
+    schedule), the most expensive first according to the wall time
+    they took in the previous call.  The busy time of every thread and
+    the load imbalance (max/mean busy time) are reported.
+
+    Compile with OpenMP (e.g. COPT = -O -fopenmp) to run in parallel.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#include <time.h>
+#endif
+
+void Initialize();
+void INTEGRATE( double TIN, double TOUT );
+void Update_TOT();
+void Update_DEP();
+
+static double *GridCost;         /* Sort key of GridCostCompare */
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+double GridClock()
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+#ifdef _OPENMP
+  return omp_get_wtime();
+#else
+  return (double)clock()/CLOCKS_PER_SEC;
+#endif
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+int GridCostCompare( const void *a, const void *b )
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+/*  Decreasing cost; equal costs keep the cell order                 */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+  int i = *(const int*)a, j = *(const int*)b;
+
+  if ( GridCost[i] > GridCost[j] ) return -1;
+  if ( GridCost[i] < GridCost[j] ) return  1;
+  return i - j;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+double GridIntegrate( int Ncell, double Cgrid[], double Tgrid[],
+                      double Toff[], double Hgrid[], double Cost[],
+                      double TIN, double TOUT, double Busy[] )
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+/*  Integrates all cells from TIN to TOUT. On input Cost[i] is the    */
+/*  cost of cell i in the previous call (any values the first time),  */
+/*  on output its wall time in this call. Busy[k] receives the time   */
+/*  thread k spent integrating. Returns the load imbalance.           */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+  int *Order;
+  int i, k, icell, Nthr = 1;
+  double t0, Bmax, Bsum;
+
+  /* Most expensive cells first */
+  Order = (int*)malloc( Ncell*sizeof(int) );
+  for ( k = 0; k < Ncell; k++ )
+    Order[k] = k;
+  GridCost = Cost;
+  qsort( Order, Ncell, sizeof(int), GridCostCompare );
+
+#ifdef _OPENMP
+  Nthr = omp_get_max_threads();
+#endif
+  for ( k = 0; k < Nthr; k++ )
+    Busy[k] = 0.0;
+
+#pragma omp parallel private(i, k, icell, t0) copyin(RCONST, TEMP, SUN, TIME, STEPMIN)
+  {
+    int ithr = 0;
+#ifdef _OPENMP
+    ithr = omp_get_thread_num();
+#endif
+    KppThreadInit();
+
+#pragma omp for schedule(dynamic,1)
+    for ( k = 0; k < Ncell; k++ ) {
+      icell = Order[k];
+      t0 = GridClock();
+      for ( i = 0; i < NSPEC; i++ )
+        C[i] = Cgrid[icell*NSPEC+i];
+      TEMP    = Tgrid[icell];
+      STEPMIN = Hgrid[icell];
+      Update_TOT();
+      INTEGRATE( TIN+Toff[icell], TOUT+Toff[icell] );
+      Update_DEP();
+      Hgrid[icell] = STEPMIN;
+      for ( i = 0; i < NSPEC; i++ )
+        Cgrid[icell*NSPEC+i] = C[i];
+      Cost[icell] = GridClock() - t0;
+      Busy[ithr] += Cost[icell];
+    }
+  }
+
+  free( Order );
+
+  Bmax = 0.0;
+  Bsum = 0.0;
+  for ( k = 0; k < Nthr; k++ ) {
+    Bsum += Busy[k];
+    if ( Busy[k] > Bmax ) Bmax = Busy[k];
+  }
+  return (Bsum > 0.0) ? Bmax*Nthr/Bsum : 1.0;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+int main( int argc, char *argv[] )
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+/*~~~> Grid of cells */
+  int Ncell = 100;
+  double *Cgrid, *Tgrid, *Toff, *Hgrid, *Cost;
+/*~~~> Busy time per thread: last call and total */
+  double *Busy, *BusyTot, Bmax, Bsum, Imb;
+  int Nthr = 1;
+/*~~~> Local variables */
+  double C0[NSPEC], x, y;
+  int i, k, icell;
+
+  if ( argc > 1 ) Ncell = atoi( argv[1] );
+  if ( Ncell < 1 ) Ncell = 1;
+
+  RTOLS = 1e-3;
+  TSTART = 3600*12;
+  TEND = TSTART + 3600*24;
+  DT = 3600.;
+  TEMP = 236.21;
+
+  Initialize();
+
+  for( i = 0; i < NVAR; i++ ) {
+    RTOL[i] = RTOLS;
+    ATOL[i] = 1.0;
+  }
+  STEPMIN = 0.01;
+  STEPMAX = 900;
+
+#ifdef _OPENMP
+  Nthr = omp_get_max_threads();
+#endif
+  Cgrid   = (double*)malloc( Ncell*NSPEC*sizeof(double) );
+  Tgrid   = (double*)malloc( Ncell*sizeof(double) );
+  Toff    = (double*)malloc( Ncell*sizeof(double) );
+  Hgrid   = (double*)malloc( Ncell*sizeof(double) );
+  Cost    = (double*)malloc( Ncell*sizeof(double) );
+  Busy    = (double*)malloc( Nthr*sizeof(double) );
+  BusyTot = (double*)calloc( Nthr, sizeof(double) );
+  if ( !Cgrid || !Tgrid || !Toff || !Hgrid || !Cost || !Busy || !BusyTot ) {
+    printf("\n Cannot allocate a grid of %d cells\n", Ncell);
+    exit(1);
+  }
+
+  /* Synthetic grid: the cells are spread over the local time of day */
+  /* (longitude), temperature and initial concentrations.  With       */
+  /* #REDUCE the totals are those of the scaled cell, from which      */
+  /* Update_DEP gives its dependent and QSSA species                  */
+  for( i = 0; i < NSPEC; i++ )
+    C0[i] = C[i];
+  for( icell = 0; icell < Ncell; icell++ ) {
+    x = fmod( 0.6180339887*icell, 1.0 );
+    y = fmod( 0.4142135624*icell, 1.0 );
+    for( i = 0; i < NSPEC; i++ )
+      C[i] = C0[i]*pow( 10.0, 2.0*y-1.0 );
+    Update_TOT();
+    for( i = NVAR; i < NSPEC; i++ )
+      C[i] = C0[i];
+    Update_DEP();
+    for( i = 0; i < NSPEC; i++ )
+      Cgrid[icell*NSPEC+i] = C[i];
+    Toff[icell]  = 3600*24*x;
+    Tgrid[icell] = TEMP + 30.0*(y-0.5);
+    Hgrid[icell] = STEPMIN;
+    Cost[icell]  = 0.0;
+  }
+  for( i = 0; i < NSPEC; i++ )
+    C[i] = C0[i];
+  Update_TOT();
+
+/* ********** TIME LOOP **************************** */
+
+  printf("\n%d cells, %d thread(s)", Ncell, Nthr);
+  printf("\n%7s %7s %9s   ", "done[%]", "Time[h]", "imbalance");
+  for( i = 0; i < NMONITOR; i++ )
+    printf( "%8s  ", SPC_NAMES[MONITOR[i]] );
+
+  TIME = TSTART;
+  while (TIME < TEND) {
+    Imb = GridIntegrate( Ncell, Cgrid, Tgrid, Toff, Hgrid, Cost,
+                         TIME, TIME+DT, Busy );
+    TIME += DT;
+    for( k = 0; k < Nthr; k++ )
+      BusyTot[k] += Busy[k];
+
+    printf("\n%6.1f%% %7.2f %9.3f   ", (TIME-TSTART)/(TEND-TSTART)*100,
+           TIME/3600, Imb );
+    for( i = 0; i < NMONITOR; i++ )
+      printf( "%9.3e  ", Cgrid[MONITOR[i]]/CFACTOR );
+  }
+
+/* *********** END TIME LOOP *********************** */
+
+  Bmax = 0.0;
+  Bsum = 0.0;
+  printf("\n\n%7s %12s", "thread", "busy[s]");
+  for( k = 0; k < Nthr; k++ ) {
+    printf("\n%7d %12.4f", k, BusyTot[k]);
+    Bsum += BusyTot[k];
+    if ( BusyTot[k] > Bmax ) Bmax = BusyTot[k];
+  }
+  printf("\nTotal busy time %.4f s, load imbalance (max/mean) %.3f\n",
+         Bsum, (Bsum > 0.0) ? Bmax*Nthr/Bsum : 1.0 );
+
+  free( Cgrid );
+  free( Tgrid );
+  free( Toff );
+  free( Hgrid );
+  free( Cost );
+  free( Busy );
+  free( BusyTot );
+
+  return 0;
+
+}
+/*~~~> End of MAIN function ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
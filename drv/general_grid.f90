@@ -0,0 +1,247 @@
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!  Grid of independent boxes integrated on OpenMP threads
+!
+!  Usage:  KPP_ROOT.exe [Ncell]
+!
+!  Needs #THREADSAFE ON: every thread keeps its own C, RCONST, TEMP,
+!  SUN, TIME and STEPMIN.  Cell i has its own concentrations Cgrid(:,i),
+!  temperature Tgrid(i) and local time offset Toff(i); its photolysis
+!  follows the local time (Update_SUN at TIME+Toff(i)).  The last step
+!  size of a cell is kept in Hgrid(i) and starts its next integration.
+!  With #REDUCE the totals of the conservation laws are those of the
+!  cell (Update_TOT), and the dependent and QSSA species are updated
+!  after its integration (Update_DEP).
+!
+!  The cost of a cell depends on its stiffness (day/night, polluted or
+!  clean) and changes slowly from one call to the next.  Cells are
+!  therefore handed out one at a time to idle threads (OpenMP dynamic
+!  schedule), the most expensive first according to the number of steps
+!  (ISTATUS(3)) they took in the previous call.  The busy time of every
+!  thread and the load imbalance (max/mean busy time) are reported.
+!
+!  Compile with OpenMP (e.g. FC_GFORTRAN = gfortran -fopenmp).
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+PROGRAM KPP_ROOT_Driver
+
+  USE KPP_ROOT_Model
+  USE KPP_ROOT_Initialize, ONLY: Initialize
+!$ USE omp_lib
+
+      INTEGER :: Ncell = 100
+      KPP_REAL, ALLOCATABLE :: Cgrid(:,:), Tgrid(:), Toff(:), Hgrid(:)
+      INTEGER, ALLOCATABLE :: Nsteps(:)
+      KPP_REAL, ALLOCATABLE :: Busy(:), BusyTot(:)
+      KPP_REAL :: C0(NSPEC), T, Imb, x, y
+      INTEGER :: i, icell, Nthr
+      CHARACTER(LEN=32) :: arg
+
+!~~~> Initialization
+
+      IF (COMMAND_ARGUMENT_COUNT() > 0) THEN
+        CALL GET_COMMAND_ARGUMENT(1, arg)
+        READ(arg,*) Ncell
+      END IF
+      Ncell = MAX(Ncell, 1)
+
+      STEPMIN = 0.0d0
+      STEPMAX = 0.0d0
+
+      DO i=1,NVAR
+        RTOL(i) = 1.0d-4
+        ATOL(i) = 1.0d-3
+      END DO
+
+      CALL Initialize()
+
+      Nthr = 1
+!$    Nthr = omp_get_max_threads()
+      ALLOCATE( Cgrid(NSPEC,Ncell), Tgrid(Ncell), Toff(Ncell), Hgrid(Ncell), &
+                Nsteps(Ncell), Busy(0:Nthr-1), BusyTot(0:Nthr-1) )
+      BusyTot(:) = 0.0d0
+
+!~~~> Synthetic grid: the cells are spread over the local time of day
+!     (longitude), temperature and initial concentrations.  With #REDUCE
+!     the totals are those of the scaled cell, from which Update_DEP
+!     gives its dependent and QSSA species
+      C0(:) = C(:)
+      DO icell = 1, Ncell
+        x = MOD( 0.6180339887d0*(icell-1), 1.0d0 )
+        y = MOD( 0.4142135624d0*(icell-1), 1.0d0 )
+        C(1:NSPEC) = C0(1:NSPEC)*10.0d0**(2.0d0*y-1.0d0)
+        CALL Update_TOT()
+        C(NVAR+1:NSPEC) = C0(NVAR+1:NSPEC)
+        CALL Update_DEP()
+        Cgrid(:,icell) = C(:)
+        Toff(icell)  = 3600*24*x
+        Tgrid(icell) = TEMP + 30.0d0*(y-0.5d0)
+        Hgrid(icell) = 0.0d0
+        Nsteps(icell) = 0
+      END DO
+      C(:) = C0(:)
+      CALL Update_TOT()
+
+      WRITE(6,'(I8," cells, ",I4," thread(s)")') Ncell, Nthr
+
+!~~~> Time loop
+      T = TSTART
+kron: DO WHILE (T < TEND)
+
+        CALL GridIntegrate( T, T+DT, Imb )
+        T = T + DT
+        BusyTot(:) = BusyTot(:) + Busy(:)
+
+        WRITE(6,991) (T-TSTART)/(TEND-TSTART)*100, T, Imb,     &
+                   ( TRIM(SPC_NAMES(MONITOR(i))),              &
+                     Cgrid(MONITOR(i),1)/CFACTOR, i=1,NMONITOR )
+
+      END DO kron
+!~~~> End Time loop
+
+      WRITE(6,'(/,A7,A13)') 'thread', 'busy[s]'
+      DO i = 0, Nthr-1
+        WRITE(6,'(I7,F13.4)') i, BusyTot(i)
+      END DO
+      WRITE(6,'(A,F10.4,A,F7.3)') 'Total busy time ', SUM(BusyTot), &
+           ' s, load imbalance (max/mean) ', LoadImbalance(BusyTot)
+
+      DEALLOCATE( Cgrid, Tgrid, Toff, Hgrid, Nsteps, Busy, BusyTot )
+
+991   FORMAT(F6.1,'%. T=',E9.3,' imb=',F6.3,2X,200(A,'=',E11.4,'; '))
+
+CONTAINS
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  SUBROUTINE GridIntegrate( TIN, TOUT, Imb )
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!  Integrates all cells from TIN to TOUT. Nsteps(i) holds the number
+!  of steps of cell i in the previous call and is updated; Busy(k)
+!  receives the time thread k spent integrating; Imb the load imbalance
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+      KPP_REAL, INTENT(IN)  :: TIN, TOUT
+      KPP_REAL, INTENT(OUT) :: Imb
+
+      INTEGER :: Order(Ncell), k, ic, ithr
+      INTEGER :: ISTATUS(20)
+      KPP_REAL :: RCNTRL(20), RSTATUS(20), t0
+
+      ! Most expensive cells first
+      CALL GridOrder( Ncell, Nsteps, Order )
+      Busy(:) = 0.0d0
+
+!$OMP PARALLEL PRIVATE(k, ic, ithr, t0, ISTATUS, RCNTRL, RSTATUS) &
+!$OMP          COPYIN(RCONST, TEMP, SUN, TIME, STEPMIN)
+      ithr = 0
+!$    ithr = omp_get_thread_num()
+      CALL KppThreadInit()
+
+!$OMP DO SCHEDULE(DYNAMIC,1)
+      DO k = 1, Ncell
+        ic = Order(k)
+        t0 = GridClock()
+        C(:) = Cgrid(:,ic)
+        TEMP = Tgrid(ic)
+        TIME = TIN + Toff(ic)
+        CALL Update_SUN()
+        CALL Update_RCONST()
+
+        RCNTRL(:) = 0.0d0
+        RCNTRL(3) = Hgrid(ic)       ! warm start from the last step
+        CALL Update_TOT()
+        CALL INTEGRATE( TIN = TIN+Toff(ic), TOUT = TOUT+Toff(ic),  &
+             RCNTRL_U = RCNTRL, ISTATUS_U = ISTATUS, RSTATUS_U = RSTATUS, &
+             ICNTRL_U = (/ 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 /) )
+        CALL Update_DEP()
+
+        Cgrid(:,ic) = C(:)
+        Hgrid(ic)  = RSTATUS(2)
+        Nsteps(ic) = ISTATUS(3)
+        Busy(ithr) = Busy(ithr) + GridClock() - t0
+      END DO
+!$OMP END DO
+!$OMP END PARALLEL
+
+      Imb = LoadImbalance(Busy)
+
+  END SUBROUTINE GridIntegrate
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  SUBROUTINE GridOrder( N, Key, Order )
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!  Order(1:N) = cells by decreasing Key (heapsort on a min-heap)
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+      INTEGER, INTENT(IN)  :: N, Key(N)
+      INTEGER, INTENT(OUT) :: Order(N)
+      INTEGER :: i, last, tmp
+
+      DO i = 1, N
+        Order(i) = i
+      END DO
+      DO i = N/2, 1, -1
+        CALL GridSiftDown( N, Key, Order, i, N )
+      END DO
+      DO last = N, 2, -1
+        tmp = Order(1)
+        Order(1) = Order(last)
+        Order(last) = tmp
+        CALL GridSiftDown( N, Key, Order, 1, last-1 )
+      END DO
+
+  END SUBROUTINE GridOrder
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  SUBROUTINE GridSiftDown( N, Key, Order, first, last )
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!  Restores the min-heap property of Order(first:last) w.r.t. Key
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+      INTEGER, INTENT(IN)    :: N, Key(N), first, last
+      INTEGER, INTENT(INOUT) :: Order(N)
+      INTEGER :: i, j, tmp
+
+      i = first
+      DO WHILE (2*i <= last)
+        j = 2*i
+        IF (j < last) THEN
+          IF (Key(Order(j+1)) < Key(Order(j))) j = j+1
+        END IF
+        IF (Key(Order(i)) <= Key(Order(j))) EXIT
+        tmp = Order(i)
+        Order(i) = Order(j)
+        Order(j) = tmp
+        i = j
+      END DO
+
+  END SUBROUTINE GridSiftDown
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  KPP_REAL FUNCTION GridClock()
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!  Wall clock time [s]
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+      INTEGER(kind=8) :: cnt, rate
+
+      CALL SYSTEM_CLOCK( cnt, rate )
+      GridClock = REAL(cnt,dp)/REAL(rate,dp)
+
+  END FUNCTION GridClock
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  KPP_REAL FUNCTION LoadImbalance( B )
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!  Max/mean of the busy times B of the threads (1 = perfect balance)
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+      KPP_REAL, INTENT(IN) :: B(:)
+
+      IF (SUM(B) > 0.0d0) THEN
+        LoadImbalance = MAXVAL(B)*SIZE(B)/SUM(B)
+      ELSE
+        LoadImbalance = 1.0d0
+      END IF
+
+  END FUNCTION LoadImbalance
+
+END PROGRAM KPP_ROOT_Driver
@@ -4,8 +4,11 @@ int CloseSaveData();
 int GenerateMatlab( char * prefix );
 void GetMass( double CL[], double Mass[] );
 void INTEGRATE( double TIN, double TOUT );
-void Gillespie(int Nssa, double Volume, double* T, int NmlcV[], int NmlcF[]);
+int StochasticIntegrate(double Tout, double SCT[], double* T,
+               int NmlcV[], int NmlcF[], KPP_RNG* rng);
+void StochasticRates( double RCT[], double Volume, double SCT[] );
 void Update_RCONST();
+void KppRandInit( KPP_RNG *rng, unsigned long seed, unsigned long stream );
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 int main()
@@ -15,8 +18,11 @@ int main()
   FILE* fpDat;
 /*~~~> No of molecules */
   int NmlcV[NVAR], NmlcF[NFIX];
-/*~~~> No of reaction events per output step */
-  int Nevents;
+/*~~~> Stochastic rate constants */
+  double SCT[NREACT];
+/*~~~> Random number stream: generator seed and stream (trajectory) id */
+  KPP_RNG rng;
+  unsigned long Seed = 1, Stream = 0;
 /*~~~> Local variables */
   int i;
   double T;
@@ -27,7 +33,7 @@ int main()
 
   /* Translate initial values from conc. to molecules */
   /* Volume = 100.0; */
-  Nevents = 20;
+  KppRandInit( &rng, Seed, Stream );
   for( i = 0; i < NVAR; i++ ) 
     NmlcV[i] = (int)(Volume*VAR[i]);
   for( i = 0; i < NFIX; i++ ) 
@@ -35,7 +41,7 @@ int main()
   
 /*~~~> Begin Time Loop ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
   T = TSTART;
-  while (T <= TEND) {
+  while (T < TEND) {
     printf("\n%6.1f%% %10.4f   ", (T-TSTART)/(TEND-TSTART)*100, T );
     for( i = 0; i < NVAR; i++ ) 
       printf( "%s=%d  ", SPC_NAMES[i], NmlcV[i] );
@@ -44,9 +50,13 @@ int main()
     for( i = 0; i < NVAR; i++ ) 
         fprintf(fpDat,"%d  ", NmlcV[i]);
    
-    Gillespie( Nevents, Volume, &T , NmlcV, NmlcF );
+    /* Rates are refreshed at the beginning of each output step */
+    TIME = T;
+    Update_RCONST();
+    StochasticRates( RCONST, Volume, SCT );
+    StochasticIntegrate( (T+DT < TEND) ? T+DT : TEND, SCT, &T, NmlcV, NmlcF, &rng );
     
-  }  /* while (T <= TEND) */  
+  }  /* while (T < TEND) */  
 /*~~~> End Time Loop ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
   fprintf(fpDat,"\n%g ", T );
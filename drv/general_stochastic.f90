@@ -11,8 +11,9 @@ PROGRAM KPP_ROOT_Driver
       INTEGER :: Nsteps
 !~~~> No. of Molecules      
       INTEGER :: NmlcV(NVAR), NmlcF(NFIX)
-!~~~> Random numbers     
-      REAL :: r1, r2
+!~~~> Random number stream: generator seed and stream (trajectory) id
+      TYPE(KPP_RNG) :: Rng
+      INTEGER :: Seed = 1, Stream = 0
 !~~~> Local variables     
       INTEGER :: i
       KPP_REAL :: T, Tau, SCT(NREACT)
@@ -23,6 +24,7 @@ PROGRAM KPP_ROOT_Driver
       Nevents = 5000
       Nsteps = 10
       Tau = (TEND-TSTART)/100.0
+      CALL KppRandInit(Rng, Seed, Stream)
 !~~~~~~~~~~~~~~~~     
       
 !~~~> Translate initial values from conc. to NmlcVules
@@ -33,6 +35,7 @@ PROGRAM KPP_ROOT_Driver
       CALL StochasticRates( RCONST, Volume, SCT )   
 
 !~~~> Save initial data
+      T = TSTART
       OPEN(10, file='KPP_ROOT_stochastic.dat')
       WRITE(10,992) T, (NmlcV(i),i=1,NVAR)
             
@@ -43,8 +46,8 @@ kron: DO WHILE (T < TEND)
         WRITE(6,991) T,(SPC_NAMES(i),NmlcV(i), i=1,NVAR)
 
 !~~~> Choose here one of the following time-stepping routines
-        CALL Gillespie(Nevents, T, SCT, NmlcV, NmlcF)
-!        CALL TauLeap(Nsteps, Tau, T, SCT, NmlcV, NmlcF)
+        CALL Gillespie(Nevents, T, SCT, NmlcV, NmlcF, Rng)
+!        CALL TauLeap(Nsteps, Tau, T, SCT, NmlcV, NmlcF, Rng)
         
         WRITE(10,992) T, (NmlcV(i),i=1,NVAR)
         
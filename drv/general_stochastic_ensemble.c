@@ -0,0 +1,266 @@
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Ensemble of stochastic trajectories
+
+    Usage:  KPP_ROOT_stochastic.exe [Ntraj [Seed]]
+
+    Trajectory k is driven by random stream (Seed, k), so the result does
+    not depend on the number of threads.  Trajectories are handed out
+    one at a time to idle threads (OpenMP dynamic schedule) since their
+    cost varies widely.  Each thread keeps its own molecule counts and
+    accumulates, at every output time and for every variable species,
+    the running mean and variance (Welford) and a histogram; the thread
+    results are merged at the end.  No trajectory is stored.
+
+    #REDUCE is ignored with #STOCHASTIC, so every species is simulated
+    and, unlike general.c, there are no dependent species to update.
+
+    Compile with OpenMP (e.g. COPT = -O -fopenmp) to run in parallel.
+
+    The summary is written to KPP_ROOT_ensemble.bin (native byte order):
+       char   magic[8]               "KPPENS1"
+       int    NVAR, NOUT, NBIN, Ntraj
+       char   names[NVAR][NAMELEN]
+       double tout[NOUT]
+       double binw[NVAR]             bin k of species i is [k,k+1)*binw[i];
+                                     the last bin also collects overflow
+       double mean[NOUT][NVAR]
+       double var[NOUT][NVAR]
+       int    hist[NOUT][NVAR][NBIN]
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+void StochasticRates( double RCT[], double Volume, double SCT[] );
+void Update_RCONST();
+int StochasticIntegrate(double Tout, double SCT[], double* T,
+               int NmlcV[], int NmlcF[], KPP_RNG* rng);
+void KppRandInit( KPP_RNG *rng, unsigned long seed, unsigned long stream );
+
+#define NOUT     101             /* No. of output times (incl. TSTART)  */
+#define NBIN     64              /* No. of histogram bins               */
+#define NAMELEN  32              /* Length of species names in output   */
+
+/* Online statistics of a set of trajectories */
+typedef struct {
+  double  N;                     /* No. of trajectories */
+  double *Mean;                  /* [NOUT][NVAR] */
+  double *M2;                    /* [NOUT][NVAR] sum of squared deviations */
+  int    *Hist;                  /* [NOUT][NVAR][NBIN] */
+  double  Nev;                   /* No. of reaction events */
+} ENSEMBLE_STAT;
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+void EnsembleStatInit( ENSEMBLE_STAT* S )
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+  S->N    = 0.0;
+  S->Nev  = 0.0;
+  S->Mean = (double*)calloc( NOUT*NVAR, sizeof(double) );
+  S->M2   = (double*)calloc( NOUT*NVAR, sizeof(double) );
+  S->Hist = (int*)calloc( NOUT*NVAR*NBIN, sizeof(int) );
+  if ( !S->Mean || !S->M2 || !S->Hist ) {
+    printf("\n Cannot allocate ensemble statistics\n");
+    exit(1);
+  }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+void EnsembleStatFree( ENSEMBLE_STAT* S )
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+  free( S->Mean );
+  free( S->M2 );
+  free( S->Hist );
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+void EnsembleStatAdd( ENSEMBLE_STAT* S, double Traj[], double BinW[] )
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+/*  Adds trajectory Traj[NOUT][NVAR] to the statistics (Welford)     */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+  int k, ib;
+  double d;
+
+  S->N += 1.0;
+  for ( k = 0; k < NOUT*NVAR; k++ ) {
+    d = Traj[k] - S->Mean[k];
+    S->Mean[k] += d/S->N;
+    S->M2[k]   += d*(Traj[k] - S->Mean[k]);
+    ib = (int)( Traj[k]/BinW[k%NVAR] );
+    if ( ib >= NBIN ) ib = NBIN-1;
+    if ( ib < 0 ) ib = 0;
+    S->Hist[k*NBIN+ib]++;
+  }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+void EnsembleStatMerge( ENSEMBLE_STAT* S, ENSEMBLE_STAT* P )
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+/*  S <- S + P  (Chan et al. pairwise update of mean and variance)   */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+  int k;
+  double d, N;
+
+  if ( P->N == 0.0 ) return;
+  N = S->N + P->N;
+  for ( k = 0; k < NOUT*NVAR; k++ ) {
+    d = P->Mean[k] - S->Mean[k];
+    S->Mean[k] += d*P->N/N;
+    S->M2[k]   += P->M2[k] + d*d*S->N*P->N/N;
+  }
+  for ( k = 0; k < NOUT*NVAR*NBIN; k++ )
+    S->Hist[k] += P->Hist[k];
+  S->N    = N;
+  S->Nev += P->Nev;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+double RunTrajectory( int NmlcV0[], int NmlcF[], double SCT[],
+                      double Tout[], KPP_RNG* rng, double Traj[] )
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+/*  One trajectory from NmlcV0; Traj[NOUT][NVAR] receives the counts */
+/*  at the output times. Returns the number of reaction events.       */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+  int NmlcV[NVAR];
+  int i, k;
+  double T, Nev = 0.0;
+
+  for ( i = 0; i < NVAR; i++ )
+    NmlcV[i] = NmlcV0[i];
+  T = Tout[0];
+  for ( k = 0; k < NOUT; k++ ) {
+    if ( k > 0 )
+      Nev += StochasticIntegrate( Tout[k], SCT, &T, NmlcV, NmlcF, rng );
+    for ( i = 0; i < NVAR; i++ )
+      Traj[k*NVAR+i] = (double)NmlcV[i];
+  }
+  return Nev;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+int main( int argc, char *argv[] )
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+/*~~~> Output results file */
+  FILE* fpBin;
+/*~~~> Initial no of molecules */
+  int NmlcV0[NVAR], NmlcF[NFIX];
+/*~~~> Ensemble size and random generator seed */
+  int Ntraj = 1000;
+  unsigned long Seed = 1;
+/*~~~> Output times, histogram bin widths, statistics */
+  double Tout[NOUT], BinW[NVAR], SCT[NREACT], *Var;
+  ENSEMBLE_STAT Stat;
+  int Nthreads = 1;
+/*~~~> Local variables */
+  char Name[NAMELEN];
+  double *Traj, Nmax;
+  int i, k, itraj;
+  KPP_RNG rng;
+
+  if ( argc > 1 ) Ntraj = atoi( argv[1] );
+  if ( argc > 2 ) Seed  = strtoul( argv[2], NULL, 10 );
+
+  Initialize();
+
+  /* Translate initial values from conc. to molecules */
+  for( i = 0; i < NVAR; i++ )
+    NmlcV0[i] = (int)(Volume*VAR[i]);
+  for( i = 0; i < NFIX; i++ )
+    NmlcF[i] = (int)(Volume*FIX[i]);
+
+  /* Stochastic rate constants, evaluated once at TSTART */
+  TIME = TSTART;
+  Update_RCONST();
+  StochasticRates( RCONST, Volume, SCT );
+
+  for( k = 0; k < NOUT; k++ )
+    Tout[k] = TSTART + (TEND-TSTART)*k/(NOUT-1);
+
+  /* Histogram bin widths from a pilot trajectory (stream Ntraj) */
+  Traj = (double*)malloc( NOUT*NVAR*sizeof(double) );
+  KppRandInit( &rng, Seed, (unsigned long)Ntraj );
+  RunTrajectory( NmlcV0, NmlcF, SCT, Tout, &rng, Traj );
+  for( i = 0; i < NVAR; i++ ) {
+    Nmax = 0.0;
+    for( k = 0; k < NOUT; k++ )
+      if ( Traj[k*NVAR+i] > Nmax ) Nmax = Traj[k*NVAR+i];
+    BinW[i] = ceil( 2.0*(Nmax+1.0)/NBIN );
+  }
+  free( Traj );
+
+  EnsembleStatInit( &Stat );
+
+/*~~~> Begin Ensemble Loop ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma omp parallel private(i, itraj, rng, Traj)
+  {
+    ENSEMBLE_STAT Local;
+
+    EnsembleStatInit( &Local );
+    Traj = (double*)malloc( NOUT*NVAR*sizeof(double) );
+
+#pragma omp for schedule(dynamic,1)
+    for ( itraj = 0; itraj < Ntraj; itraj++ ) {
+      KppRandInit( &rng, Seed, (unsigned long)itraj );
+      Local.Nev += RunTrajectory( NmlcV0, NmlcF, SCT, Tout, &rng, Traj );
+      EnsembleStatAdd( &Local, Traj, BinW );
+    }
+
+#pragma omp critical
+    EnsembleStatMerge( &Stat, &Local );
+
+#ifdef _OPENMP
+#pragma omp master
+    Nthreads = omp_get_num_threads();
+#endif
+
+    free( Traj );
+    EnsembleStatFree( &Local );
+  }
+/*~~~> End Ensemble Loop ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+  Var = (double*)malloc( NOUT*NVAR*sizeof(double) );
+  for( k = 0; k < NOUT*NVAR; k++ )
+    Var[k] = (Stat.N > 1.0) ? Stat.M2[k]/(Stat.N-1.0) : 0.0;
+
+  printf("\n%d trajectories, %d thread(s), %.0f reaction events",
+         Ntraj, Nthreads, Stat.Nev );
+  printf("\nAt T = %g :", TEND );
+  for( i = 0; i < NVAR; i++ )
+    printf("\n  %-12s mean = %12.4f   std = %12.4f", SPC_NAMES[i],
+           Stat.Mean[(NOUT-1)*NVAR+i], sqrt( Var[(NOUT-1)*NVAR+i] ) );
+  printf("\n");
+
+  fpBin = fopen("KPP_ROOT_ensemble.bin", "wb");
+  if ( fpBin == NULL ) {
+    printf("\n Cannot open KPP_ROOT_ensemble.bin\n");
+    exit(1);
+  }
+  k = NVAR;   fwrite( "KPPENS1", 1, 8, fpBin );
+  fwrite( &k, sizeof(int), 1, fpBin );
+  k = NOUT;   fwrite( &k, sizeof(int), 1, fpBin );
+  k = NBIN;   fwrite( &k, sizeof(int), 1, fpBin );
+  fwrite( &Ntraj, sizeof(int), 1, fpBin );
+  for( i = 0; i < NVAR; i++ ) {
+    memset( Name, 0, NAMELEN );
+    strncpy( Name, SPC_NAMES[i], NAMELEN-1 );
+    fwrite( Name, 1, NAMELEN, fpBin );
+  }
+  fwrite( Tout, sizeof(double), NOUT, fpBin );
+  fwrite( BinW, sizeof(double), NVAR, fpBin );
+  fwrite( Stat.Mean, sizeof(double), NOUT*NVAR, fpBin );
+  fwrite( Var, sizeof(double), NOUT*NVAR, fpBin );
+  fwrite( Stat.Hist, sizeof(int), NOUT*NVAR*NBIN, fpBin );
+  fclose( fpBin );
+
+  free( Var );
+  EnsembleStatFree( &Stat );
+
+  return 0;
+
+}
+/*~~~> End of MAIN function ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
@@ -0,0 +1,158 @@
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   Driver for the tangent linear model (TLM)
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+int  InitSaveData();
+void Initialize();
+int  SaveData();
+int  CloseSaveData();
+int  GenerateMatlab( char * prefix );
+void GetMass( KPP_REAL CL[], KPP_REAL Mass[] );
+void Update_SUN();
+void Update_RCONST();
+void Update_DEP();
+void INTEGRATE_TLM( int NTLM, KPP_REAL Y[], KPP_REAL Y_tlm[][NVAR],
+		    KPP_REAL TIN, KPP_REAL TOUT, KPP_REAL ATOL_tlm[][NVAR],
+		    KPP_REAL RTOL_tlm[][NVAR], int ICNTRL_U[],
+		    KPP_REAL RCNTRL_U[], int ISTATUS_U[],
+		    KPP_REAL RSTATUS_U[] );
+
+int main() {
+
+  KPP_REAL T, DVAL[NSPEC];
+  int i, j, ind_1 = 0, ind_2 = 1;
+
+  /*~~>  NTLM = Number of sensitivity coefficients to compute
+     Note: the setting below is for sensitivities w.r.t. all initial values;
+     the setting may have to be changed for other applications */
+  int NTLM = NVAR;
+  KPP_REAL Y_tlm[NTLM][NVAR], ATOL_tlm[NTLM][NVAR], RTOL_tlm[NTLM][NVAR];
+
+/*~~>  Control (in) and status (out) arguments for the integration */
+  KPP_REAL RCNTRL[20], RSTATUS[20];
+  int ICNTRL[20], ISTATUS[20];
+
+  STEPMIN = (double)0.0;
+  STEPMAX = (double)0.0;
+
+/*~~~> Tolerances for calculating concentrations */
+  for( i=0; i<NVAR; i++) {
+    RTOL[i] = 1.0e-4;
+    ATOL[i] = 1.0e-3;
+  }
+
+/*~~~> Tolerances for calculating sensitivities
+       are used for controlling sensitivity truncation error
+       Note: Sensitivities typically span many orders of magnitude
+       and a careful tuning of ATOL_tlm may be necessary */
+  for(i=0; i<NTLM; i++) {
+    for(j=0; j<NVAR; j++) {
+      RTOL_tlm[i][j] = 1.0e-4;
+      ATOL_tlm[i][j] = 1.0e-3;
+    }
+  }
+
+  Initialize();
+
+/*~~~> Note: the initial values below are for sensitivities
+       w.r.t. initial values;
+       they may have to be changed for other applications */
+  for(i=0; i<NTLM; i++) {
+    for(j=0; j<NVAR; j++)
+      Y_tlm[i][j] = (double)0.0;
+  }
+  for(j=0; j<NTLM; j++)
+    Y_tlm[j][j] = (double)1.0;
+
+/*~~~> Default control options */
+  for(i=0; i<20; i++) {
+    ICNTRL[i] = 0;
+    RCNTRL[i] = (double)0.0;
+    ISTATUS[i] = 0;
+    RSTATUS[i] = (double)0.0;
+  }
+
+/*~~~> Begin time loop */
+
+  InitSaveData();
+
+  T = TSTART;
+
+  while (T < TEND) {
+
+    TIME = T;
+    GetMass( C, DVAL );
+    printf("\n%6.1f%% %7.2f   ", (T-TSTART)/(TEND-TSTART)*100, T/3600 );
+    for( i = 0; i < NMONITOR; i++ )
+      printf( "%9.3e  ", C[ MONITOR[i] ]/CFACTOR );
+    for( i = 0; i < NMASS; i++ )
+      printf( "%9.3e  ", DVAL[i]/CFACTOR );
+
+    SaveData();
+    Update_SUN();
+    Update_RCONST();
+
+    INTEGRATE_TLM( NTLM, VAR, Y_tlm, T, T+DT, ATOL_tlm, RTOL_tlm, ICNTRL,
+		   RCNTRL, ISTATUS, RSTATUS );
+    Update_DEP();
+
+    T = T+DT;
+  }
+
+  TIME = T;
+  GetMass( C, DVAL );
+  printf("\n%6.1f%% %7.2f   ", (T-TSTART)/(TEND-TSTART)*100, T/3600 );
+  for( i = 0; i < NMONITOR; i++ )
+    printf( "%9.3e  ", C[ MONITOR[i] ]/CFACTOR );
+  for( i = 0; i < NMASS; i++ )
+    printf( "%9.3e   ", DVAL[i]/CFACTOR );
+
+  SaveData();
+
+/*~~~> End time loop ~~~~~~~~~~*/
+
+  printf( "\n\n****************************************************\n" );
+  printf( " Concentrations and Sensitivities at final time\n" );
+  printf( " were written in the file KPP_ROOT_TLM_results.m\n");
+  printf( "****************************************************\n");
+
+  FILE *out;
+  out = fopen("KPP_ROOT_TLM_results.m", "w");
+  if(out == NULL) {
+    printf("Unable to open file KPP_ROOT_TLM_results.m\n");
+    exit(1);
+  }
+
+  for(j=0; j<NTLM; j++) {
+    for(i=0; i<NVAR; i++)
+      fprintf( out, "%24.16e  ", Y_tlm[j][i] );
+    fprintf( out, "\n" );
+  }
+
+  fclose(out);
+
+  CloseSaveData();
+
+  printf( "\nTLM: d[%s](tf)/d[%s](t0) = %7.6e\n", SPC_NAMES[ind_1],
+	  SPC_NAMES[ind_1], Y_tlm[0][ind_1] );
+  printf( "TLM: d[%s](tf)/d[%s](t0) = %7.6e\n", SPC_NAMES[ind_2],
+	  SPC_NAMES[ind_2], Y_tlm[1][ind_2] );
+  printf( "TLM: d[%s](tf)/d[%s](t0) = %7.6e\n", SPC_NAMES[ind_1],
+	  SPC_NAMES[ind_2], Y_tlm[0][ind_2] );
+  printf( "TLM: d[%s](tf)/d[%s](t0) = %7.6e\n\n", SPC_NAMES[ind_2],
+	  SPC_NAMES[ind_1], Y_tlm[1][ind_1] );
+
+/*~~~> The entire matrix of sensitivities */
+  printf("          ");
+  for(i=0; i<NVAR; i++)
+    printf( "   d %-8s", SPC_NAMES[i] );
+  printf("\n");
+  for(j=0; j<NTLM; j++) {
+    printf("d/d%-6s = ", SPC_NAMES[j]);
+    for(i=0; i<NVAR; i++)
+      printf( "%12.5e  ",  Y_tlm[j][i] );
+    printf("\n");
+  }
+
+  return 0;
+}
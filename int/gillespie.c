@@ -3,28 +3,37 @@ void Propensity ( int V[], int F[], double SCT[], double A[] );
 void MoleculeChange ( int j, int NmlcV[] );
 double CellMass(double T); 
 void Update_RCONST();
+void KppRandUniformVec( KPP_RNG *rng, int n, KPP_REAL u[] );
+void KppRandExponentialVec( KPP_RNG *rng, int n, KPP_REAL e[] );
+KPP_REAL KppRandUniform( KPP_RNG *rng );
+KPP_REAL KppRandExponential( KPP_RNG *rng );
+
+/* No. of random numbers drawn at once from the stream */
+#define NBATCH 64
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
-void Gillespie(int Nevents, double Volume, double* T, int NmlcV[], int NmlcF[]) 
+void Gillespie(int Nevents, double Volume, double* T, int NmlcV[], int NmlcF[],
+               KPP_RNG* rng) 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 {
     
-      int i, m=0, event;
-      double r1, r2;
+      int i, m=0, event, ib, nb;
+      KPP_REAL r1[NBATCH], r2[NBATCH];
       double A[NREACT], SCT[NREACT], x;
 
      /* Compute the stochastic reaction rates */
       Update_RCONST();
       StochasticRates( RCONST, Volume, SCT );   
    
-      for (event = 1; event <= Nevents; event++) {
-
-          /* Uniformly distributed ranfor (m numbers */
-          r1 = (double)rand()/(double)RAND_MAX;
-          r2 = (double)rand()/(double)RAND_MAX;
+      for (event = 0; event < Nevents; event++) {
 
-	  /* Avoid log of zero */
-	  r2 = (r2-1.0e-14) ? r2 : 1.0e-14;
+          /* Uniformly and exponentially distributed random numbers */
+          ib = event % NBATCH;
+          if (ib == 0) {
+            nb = (Nevents-event < NBATCH) ? Nevents-event : NBATCH;
+            KppRandUniformVec( rng, nb, r1 );
+            KppRandExponentialVec( rng, nb, r2 );
+          }
 	  
           /* Propensity vector */
 	  TIME = *T;
@@ -33,9 +42,15 @@ void Gillespie(int Nevents, double Volume, double* T, int NmlcV[], int NmlcF[])
           /* Cumulative sum of propensities */
 	  for (i=1; i<NREACT; i++)
             A[i] = A[i-1]+A[i];
+
+          /* No reaction can fire any more */
+          if (A[NREACT-1] <= 0.0) {
+            *T = HUGE_VAL;
+            break;
+          }
           
 	  /* Index of next reaction */
-	  x = r1*A[NREACT-1];
+	  x = r1[ib]*A[NREACT-1];
 	  for ( i = 0; i<NREACT; i++)
 	    if (A[i] >= x) {
               m = i+1;
@@ -43,7 +58,7 @@ void Gillespie(int Nevents, double Volume, double* T, int NmlcV[], int NmlcF[])
 	    }
 	  
           /* Update T with time to next reaction */
-          *T = *T - log(r2)/A[NREACT-1];
+          *T = *T + r2[ib]/A[NREACT-1];
 
           /* Update state vector after reaction m */
 	  MoleculeChange( m, NmlcV );
@@ -51,3 +66,50 @@ void Gillespie(int Nevents, double Volume, double* T, int NmlcV[], int NmlcF[])
      } /* for event */
     
 } /* Gillespie */
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+int StochasticIntegrate(double Tout, double SCT[], double* T, 
+               int NmlcV[], int NmlcF[], KPP_RNG* rng) 
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+/*  Exact SSA from *T to Tout with the stochastic rate constants SCT. */
+/*  On return *T = Tout and NmlcV holds the state at Tout.            */
+/*  No global data is used: different trajectories can be advanced   */
+/*  concurrently, each with its own NmlcV and rng.                   */
+/*  Returns the number of reaction events.                           */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+    
+      int i, m, Nev = 0;
+      double A[NREACT], tau, x;
+
+      while (1) {
+
+          /* Cumulative sum of propensities */
+	  Propensity ( NmlcV, NmlcF, SCT, A );
+	  for (i=1; i<NREACT; i++)
+            A[i] = A[i-1]+A[i];
+          if (A[NREACT-1] <= 0.0) break;
+
+          /* Time to next reaction; the process is memoryless so the */
+          /* event beyond Tout is simply discarded                   */
+          tau = KppRandExponential( rng )/A[NREACT-1];
+          if (*T + tau > Tout) break;
+          *T = *T + tau;
+
+	  /* Index of next reaction */
+	  x = KppRandUniform( rng )*A[NREACT-1];
+          m = NREACT;
+	  for ( i = 0; i<NREACT; i++)
+	    if (A[i] >= x) {
+              m = i+1;
+	      break;
+	    }
+	  MoleculeChange( m, NmlcV );
+          Nev++;
+
+      } /* while */
+      
+      *T = Tout;
+      return Nev;
+    
+} /* StochasticIntegrate */
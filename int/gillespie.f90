@@ -10,7 +10,7 @@ MODULE KPP_ROOT_Integrator
 CONTAINS
 
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-  SUBROUTINE Gillespie(Nevents, T, SCT, NmlcV, NmlcF)
+  SUBROUTINE Gillespie(Nevents, T, SCT, NmlcV, NmlcF, Rng)
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 !
 !   Gillespie stochastic integration
@@ -19,9 +19,11 @@ CONTAINS
 !       SCT     = stochastic rate constants
 !       T       = time
 !       NmlcV, NmlcF = no. of molecules for variable and fixed species
+!       Rng     = random number stream (see KppRandInit)
 !   OUTPUT:
 !       T       = updated time (after Nevents reactions)
 !       NmlcV   = updated no. of molecules for variable species
+!       Rng     = advanced random number stream
 !      
 !
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -29,17 +31,16 @@ CONTAINS
       KPP_REAL:: T
       INTEGER :: Nevents     
       INTEGER :: NmlcV(NVAR), NmlcF(NFIX)
+      TYPE(KPP_RNG) :: Rng
       INTEGER :: i, m, issa
-      REAL   :: r1, r2
+      KPP_REAL :: r1, r2
       KPP_REAL :: A(NREACT), SCT(NREACT), x
    
       DO issa = 1, Nevents
 
-          ! Uniformly distributed random numbers
-          CALL RANDOM_NUMBER(r1)
-          CALL RANDOM_NUMBER(r2)
-          ! Avoid log of zero
-          r2 = MAX(r2,1.e-14)
+          ! Uniformly and exponentially distributed random numbers
+          r1 = KppRandUniform(Rng)
+          r2 = KppRandExponential(Rng)
           
           ! Propensity vector
           CALL  Propensity ( NmlcV, NmlcF, SCT, A )
@@ -47,6 +48,12 @@ CONTAINS
           DO i = 2, NREACT
             A(i) = A(i-1)+A(i);
           END DO
+
+          ! No reaction can fire any more
+          IF (A(NREACT) <= 0) THEN
+            T = HUGE(T)
+            EXIT
+          END IF
           
           ! Index of next reaction
           x = r1*A(NREACT)
@@ -58,7 +65,7 @@ CONTAINS
           END DO
           
           ! Update time with time to next reaction
-          T = T - LOG(r2)/A(NREACT);
+          T = T + r2/A(NREACT);
 
           ! Update state vector
           CALL MoleculeChange( m, NmlcV )
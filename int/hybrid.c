@@ -0,0 +1,185 @@
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+/*  Hybrid stochastic-deterministic simulation                        */
+/*                                                                    */
+/*  The reactions are partitioned dynamically (at every step) into    */
+/*    - fast reactions: expected to fire at least LAMBDA times in the */
+/*      current step and changing only species with at least NMIN    */
+/*      molecules; they are integrated as ODEs with the L-stable      */
+/*      two stage Rosenbrock method ROS2 (Verwer et al., 1999)        */
+/*    - slow reactions: all others, simulated stochastically by the   */
+/*      next reaction time of their (frozen) total propensity.        */
+/*  The fast subsystem is integrated in molecule numbers with the     */
+/*  generated Fun_Stoch and Jac_Stoch_SP, masked to the fast          */
+/*  reactions; their rates are the propensities of the reactions, so  */
+/*  both parts follow the same kinetics (see StochasticRates).        */
+/*  Slow reaction events are applied through the sparse               */
+/*  stoichiometric matrix; #STOICMAT must be on.                      */
+/*                                                                    */
+/*  E. L. Haseltine and J. B. Rawlings, J. Chem. Phys. 117 (2002)     */
+/*  H. Salis and Y. Kaznessis, J. Chem. Phys. 122 (2005)              */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void StochasticRates( double RCT[], double Volume, double SCT[] );
+void Propensity ( int V[], int F[], double SCT[], double A[] );
+void Fun_Stoch( double X[], int F[], double SCT[], double Mask[], double Xdot[] );
+void Jac_Stoch_SP( double X[], int F[], double SCT[], double Mask[], double JVS[] );
+int  KppDecomp( KPP_REAL JVS[] );
+void KppSolve( KPP_REAL JVS[], KPP_REAL X[] );
+KPP_REAL KppRandUniform( KPP_RNG *rng );
+KPP_REAL KppRandExponential( KPP_RNG *rng );
+
+#define LAMBDA      10.0     /* Min. no. of firings per step of a fast reaction */
+#define NMIN        100.0    /* Min. population of species changed by it        */
+#define RTOLH       1.0e-3   /* Relative and absolute (molecules) tolerances    */
+#define ATOLH       1.0      /*   of the fast subsystem                         */
+#define ROS2_GAMMA  1.7071067811865475   /* 1 + 1/sqrt(2) */
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+static int HybridRos2( double h, double X[], int NmlcF[], double SCT[],
+                       double Mask[], double Xnew[], double* Err )
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+/*  One ROS2 step of size h for the reactions selected by Mask, in    */
+/*  molecule numbers. Returns 0 on success, 1 if the matrix is        */
+/*  singular. Err is the scaled norm of the difference to the         */
+/*  embedded Euler solution.                                          */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+      double JVS[LU_NONZERO], K1[NVAR], K2[NVAR], Y[NVAR];
+      double ghinv, sc, e;
+      int i;
+
+      Jac_Stoch_SP( X, NmlcF, SCT, Mask, JVS );
+      ghinv = 1.0/(ROS2_GAMMA*h);
+      for (i = 0; i < LU_NONZERO; i++)
+        JVS[i] = -JVS[i];
+      for (i = 0; i < NVAR; i++)
+        JVS[LU_DIAG[i]] += ghinv;
+      if ( KppDecomp( JVS ) != 0 ) return 1;
+
+      /* (I - gamma h J) K1 = f(X) */
+      Fun_Stoch( X, NmlcF, SCT, Mask, K1 );
+      KppSolve( JVS, K1 );
+      for (i = 0; i < NVAR; i++) {
+        K1[i] *= ghinv;
+        Y[i] = X[i] + h*K1[i];
+      }
+
+      /* (I - gamma h J) K2 = f(X + h K1) - 2 K1 */
+      Fun_Stoch( Y, NmlcF, SCT, Mask, K2 );
+      for (i = 0; i < NVAR; i++)
+        K2[i] = K2[i] - 2.0*K1[i];
+      KppSolve( JVS, K2 );
+      for (i = 0; i < NVAR; i++)
+        K2[i] *= ghinv;
+
+      *Err = 0.0;
+      for (i = 0; i < NVAR; i++) {
+        Xnew[i] = X[i] + h*(1.5*K1[i] + 0.5*K2[i]);
+        sc = ATOLH + RTOLH*( (fabs(X[i]) > fabs(Xnew[i])) ? fabs(X[i]) : fabs(Xnew[i]) );
+        e  = 0.5*h*(K1[i] + K2[i])/sc;
+        *Err += e*e;
+      }
+      *Err = sqrt( *Err/NVAR );
+      return 0;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+int StochasticIntegrate(double Tout, double SCT[], double* T,
+               int NmlcV[], int NmlcF[], KPP_RNG* rng)
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+/*  Hybrid simulation from *T to Tout with the stochastic rate        */
+/*  constants SCT. No global data is written: different trajectories  */
+/*  can be advanced concurrently, each with its own NmlcV and rng.    */
+/*  On return *T = Tout and NmlcV holds the state at Tout; the        */
+/*  continuous populations are rounded stochastically (unbiased).     */
+/*  Returns the number of slow reaction events.                       */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+      double X[NVAR], Xnew[NVAR];
+      double A[NREACT], Mask[NREACT];
+      double h, hs, hstep, as, clock, err, fac, x;
+      int N[NVAR], Fast[NREACT];
+      int i, j, k = 0, nfast, Nev = 0;
+
+      for (i = 0; i < NVAR; i++)
+        X[i] = (double)NmlcV[i];
+      clock = KppRandExponential( rng );
+      h = 0.1*(Tout - *T);
+
+      while (*T < Tout) {
+
+          /* Propensities at the (rounded) current state */
+          for (i = 0; i < NVAR; i++)
+            N[i] = (int)( X[i] + 0.5 );
+          Propensity ( N, NmlcF, SCT, A );
+
+          /* Partition into fast and slow reactions */
+          hstep = (h < Tout - *T) ? h : Tout - *T;
+          as = 0.0;
+          nfast = 0;
+          for (j = 0; j < NREACT; j++) {
+            Fast[j] = ( A[j]*hstep >= LAMBDA );
+            for (k = CCOL_STOICM[j]; Fast[j] && (k < CCOL_STOICM[j+1]); k++)
+              if ( X[IROW_STOICM[k]] < NMIN ) Fast[j] = 0;
+            Mask[j] = Fast[j] ? 1.0 : 0.0;
+            if ( Fast[j] ) nfast++; else as += A[j];
+          }
+          if ( (nfast == 0) && (as <= 0.0) ) break;
+
+          /* Step ends at the next slow reaction, if it comes first */
+          hs = (as > 0.0) ? clock/as : HUGE_VAL;
+          if ( hs < hstep ) hstep = hs;
+
+          /* Fast subsystem */
+          if ( nfast > 0 ) {
+            if ( HybridRos2( hstep, X, NmlcF, SCT, Mask, Xnew, &err ) ) {
+              h = 0.25*hstep;
+              continue;
+            }
+            fac = (err > 0.0) ? 0.9/sqrt(err) : 6.0;
+            if ( fac < 0.2 ) fac = 0.2;
+            if ( fac > 6.0 ) fac = 6.0;
+            if ( err > 1.0 ) {
+              h = fac*hstep;
+              continue;
+            }
+            /* A step cut short by a slow event or by Tout does not  */
+            /* shrink the step size (it also sets the fast criterion) */
+            if ( (hstep >= h) || (fac*hstep > h) ) h = fac*hstep;
+            for (i = 0; i < NVAR; i++)
+              X[i] = (Xnew[i] > 0.0) ? Xnew[i] : 0.0;
+          } else if ( hstep >= h ) {
+            h = 2.0*hstep;
+          }
+          *T = *T + hstep;
+
+          /* Slow subsystem */
+          clock -= as*hstep;
+          if ( hstep == hs ) {
+            x = KppRandUniform( rng )*as;
+            for (j = 0; j < NREACT; j++)
+              if ( !Fast[j] ) {
+                k = j;
+                x -= A[j];
+                if (x <= 0.0) break;
+              }
+            for (j = CCOL_STOICM[k]; j < CCOL_STOICM[k+1]; j++) {
+              i = IROW_STOICM[j];
+              X[i] = X[i] + STOICM[j];
+              if ( X[i] < 0.0 ) X[i] = 0.0;
+            }
+            Nev++;
+            clock = KppRandExponential( rng );
+          }
+
+      } /* while */
+
+      /* Unbiased stochastic rounding to molecule numbers */
+      for (i = 0; i < NVAR; i++) {
+        NmlcV[i] = (int)floor( X[i] );
+        if ( KppRandUniform( rng ) < X[i] - NmlcV[i] ) NmlcV[i]++;
+      }
+      *T = Tout;
+      return Nev;
+
+} /* StochasticIntegrate */
@@ -40,20 +40,27 @@ MODULE KPP_ROOT_Integrator
     NGRPDS(:), IPNTRDS(:), JPNTRDS(:), IWADS(:), IWKDS(:), IOPTDS(:)
   KPP_REAL, ALLOCATABLE, PRIVATE :: YSCALEDS(:), WKDS(:), FACDS(:)
   KPP_REAL, PRIVATE :: U125, U325
+!_______________________________________________________________________
+! KPP sparse linear algebra (USE_KPP_LU): the iteration matrix
+! P = I - H*RL1*J is kept on the KPP Jacobian pattern (LU_NONZERO
+! entries, fill-in included), factored by KppDecomp and solved by
+! KppSolve. JKPP is the saved Jacobian. No MA28 storage is used.
+  LOGICAL, PRIVATE :: USE_KPP_LU = .FALSE.
+  KPP_REAL, PRIVATE :: JKPP(LU_NONZERO), PKPP(LU_NONZERO)
 !_______________________________________________________________________
   LOGICAL, PARAMETER, PRIVATE :: USE_MA48_FOR_SPARSE=.FALSE.
 !_______________________________________________________________________
 ! *****MA48 build change point. Replace the above statement.
-  LOGICAL, PARAMETER, PRIVATE :: USE_MA48_FOR_SPARSE=.TRUE.
+!  LOGICAL, PARAMETER, PRIVATE :: USE_MA48_FOR_SPARSE=.TRUE.
 !_______________________________________________________________________
 ! *****MA48 build change point. Insert these statements.
 ! MA48 type declarations:
- TYPE(ZD01_TYPE) MATRIX
- TYPE(MA48_CONTROL) CONTROL
- TYPE(MA48_FACTORS) FACTORS
- TYPE(MA48_AINFO) AINFO
- TYPE(MA48_FINFO) FINFO
- TYPE(MA48_SINFO) SINFO
+! TYPE(ZD01_TYPE) MATRIX
+! TYPE(MA48_CONTROL) CONTROL
+! TYPE(MA48_FACTORS) FACTORS
+! TYPE(MA48_AINFO) AINFO
+! TYPE(MA48_FINFO) FINFO
+! TYPE(MA48_SINFO) SINFO
 !_______________________________________________________________________
 ! .. Parameters ..
 !     IPCUTH_MAX - maximum number of times the solver will halve the
@@ -153,7 +160,7 @@ MODULE KPP_ROOT_Integrator
 !_______________________________________________________________________
 ! *****MA48 build change point. Insert these statements.
 !     For communication with subroutine ma48_control_array:
-      KPP_REAL, PUBLIC :: COPY_OF_U_PIVOT
+!      KPP_REAL, PUBLIC :: COPY_OF_U_PIVOT
 !_______________________________________________________________________
       KPP_REAL, PRIVATE :: ACNRM, ALPHA, BIG, BIG1, CCMXJ, CGCE, CONP, CRATE,  &
         DRC, DRES, DXMAX, EPS, ERRMAX, ETA, ETAMAX, FRACINT, FRACSUB, H, HMIN,  &
@@ -173,7 +180,7 @@ MODULE KPP_ROOT_Integrator
         NSLP, NSRCH, NSRCH1, NST, NSUBS, NSUPS, NUM, NUMNZ, NYH, NZ_ALL,        &
         NZ_SWAG, PREVIOUS_MAXORD, WPD, WPS, MA28AD_CALLS, MA28BD_CALLS,         &
         MA28CD_CALLS, MC19AD_CALLS, MAX_MINIRN, MAX_MINICN, MAX_NNZ, BNGRP
-        MA48AD_CALLS, MA48BD_CALLS, MA48CD_CALLS
+!        MA48AD_CALLS, MA48BD_CALLS, MA48CD_CALLS
 ! *****MA48 build change point. Insert the above line.
       LOGICAL, PRIVATE :: ABORT, ABORT1, ABORT2, ABORT3, ABORTA, ABORTB,        &
         ALLOW_DEFAULT_TOLS, BUILD_IAJA, BOUNDS, CHANGED_ACOR, GROW, IAJA_CALLED,&
@@ -216,8 +223,8 @@ MODULE KPP_ROOT_Integrator
   MC24AD        , SET_ICN       , XERRDV        , XSETF         ,  &
   XSETUN        , DEGR          , IDO           , NUMSRT        ,  &
   SEQ           , SETR          , SLO           , SRTDAT        ,  &
-  FDJS
-  DVJACS48      , DVNLSS48      , DVPREPS48     , DVSOLS48
+  FDJS          , DVJACKPP
+!  DVJACS48      , DVNLSS48      , DVPREPS48     , DVSOLS48
 !_______________________________________________________________________
 ! *****MA48 build change point. Insert the above line.
 !_______________________________________________________________________
@@ -260,8 +267,8 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
    INTEGER       :: ICNTRL(20), ISTATUS(20), IERR
 !!$   INTEGER, SAVE :: Ntotal = 0
    TYPE(VODE_OPTS) :: OPTIONS
-   INTEGER :: ISTATE, ITASK
-   KPP_REAL :: MAXH, T1, T2
+   INTEGER :: ISTATE, ITASK, ISTATS(31)
+   KPP_REAL :: MAXH, T1, T2, RSTATS(22)
 
    ICNTRL(:)  = 0
    RCNTRL(:)  = 0.0_dp
@@ -279,19 +286,28 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
    END IF
 
 
+   ! Sparse analytic Jacobian (METHOD_FLAG=26) on the KPP pattern;
+   ! the Newton matrix is factored by KppDecomp instead of MA28
     OPTIONS = SET_OPTS(USER_SUPPLIED_JACOBIAN=.TRUE., SPARSE_J=.TRUE.,             &
               ABSERR_VECTOR=ATOL, RELERR_VECTOR=RTOL, MXSTEP=100000,               &
               NZSWAG=LU_NONZERO,   METHOD_FLAG=26,                                 &
-              MA28_ELBOW_ROOM=10, MC19_SCALING=.TRUE., MA28_MESSAGES=.FALSE.,      &
-              MA28_EPS=1.0D-4, MA28_RPS=.TRUE.,                                    &
               USER_SUPPLIED_SPARSITY=.TRUE.)
-
-   CALL USERSETS_IAJA(LU_IROW,LU_NONZERO,LU_ICOL,LU_NONZERO)
+   USE_KPP_LU = .TRUE.
    ISTATE = 1
    ITASK  = 1
    T1 = TIN
    T2 = TOUT
    CALL DVODE_F90(FUN_CHEM,NVAR,VAR,T1,T2,ITASK,ISTATE,OPTIONS,J_FCN=JAC_CHEM)
+   IERR = ISTATE
+
+   CALL GET_STATS(RSTATS,ISTATS)
+   ISTATUS(ifun) = ISTATS(12) ! function calls
+   ISTATUS(ijac) = ISTATS(13) ! Jacobian calls
+   ISTATUS(istp) = ISTATS(11) ! steps
+   ISTATUS(idec) = ISTATS(19) ! LU decompositions
+   ISTATUS(isol) = ISTATS(20) ! Newton iterations (one solve each)
+   RSTATUS(itexit) = T1       ! final time
+   RSTATUS(ihexit) = RSTATS(11) ! last step
 
    STEPMIN = RSTATUS(ihexit) ! Save last step
    
@@ -320,8 +336,9 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
 
       IMPLICIT NONE
 
-      INTEGER :: N
-      KPP_REAL :: V(NVAR), FCT(NVAR), T
+      INTEGER, INTENT(IN) :: N
+      KPP_REAL, INTENT(IN) :: T, V(N)
+      KPP_REAL, INTENT(OUT) :: FCT(N)
       
 !      TOLD = TIME
 !      TIME = T
@@ -348,16 +365,10 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
 
       IMPLICIT NONE
 
-      KPP_REAL :: V(NVAR), T
-      INTEGER, INTENT(IN)  :: N
-      INTEGER, INTENT(OUT) :: NNZ
-#ifdef FULL_ALGEBRA    
-      INTEGER :: I, J
-      KPP_REAL :: JV(LU_NONZERO), JF(NVAR,NVAR)
-#else
-      KPP_REAL :: JF(LU_NONZERO)
-      INTEGER  :: IA(LU_NONZERO), JA(LU_NONZERO)
-#endif   
+      INTEGER, INTENT(IN) :: N
+      KPP_REAL, INTENT(IN) :: T, V(N)
+      INTEGER, INTENT(INOUT) :: IA(*), JA(*), NNZ
+      KPP_REAL, INTENT(INOUT) :: JF(*)
   
 !      TOLD = TIME
 !      TIME = T
@@ -366,22 +377,9 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
 !      CALL Update_PHOTO()
 !      TIME = TOLD
     
-#ifdef FULL_ALGEBRA    
-      CALL Jac_SP(V, FIX, RCONST, JV)
-      DO j=1,NVAR
-      DO i=1,NVAR
-         JF(i,j) = 0.0d0
-      END DO
-      END DO
-      DO i=1,LU_NONZERO
-         JF(LU_IROW(i),LU_ICOL(i)) = JV(i)
-      END DO
-#else
-      CALL Jac_SP(V, FIX, RCONST, JF) 
+      ! JF on the KPP sparse pattern (used with USE_KPP_LU)
+      CALL Jac_SP(V, FIX, RCONST, JF(1:LU_NONZERO)) 
       NNZ = LU_NONZERO
-      IA = LU_IROW
-      JA = LU_ICOL
-#endif   
       !Njac=Njac+1
    
    END SUBROUTINE JAC_CHEM 
@@ -2283,7 +2281,7 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
         USE KPP_ROOT_Precision
         INTEGER NEQ, NZ
         KPP_REAL T
-        KPP_REAL Y(NEQ), P(NEQ)
+        KPP_REAL Y(NEQ), P(*)
         INTEGER IA(*), JA(*)
         INTENT(IN) :: NEQ, T, Y
         INTENT(INOUT) IA, JA, NZ, P
@@ -10738,6 +10736,11 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
 ! ..
 ! .. FIRST EXECUTABLE STATEMENT DVSOLS28
 ! ..
+        IF (USE_KPP_LU) THEN
+           IERSL = 0
+           CALL KppSolve(PKPP,X)
+           RETURN
+        END IF
         IF (SCALE_MATRIX) THEN
            DO I = 1, N
               X(I) = X(I) * RSCALEX(I)
@@ -10787,6 +10790,10 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
 ! .. FIRST EXECUTABLE STATEMENT DVJACS28
 ! ..
         IERPJ = 0
+        IF (USE_KPP_LU) THEN
+          CALL DVJACKPP(Y,JAC,IERPJ,N)
+          RETURN
+        END IF
 
 !       Structure determination
 
@@ -11190,6 +11197,59 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
         GOTO 10
 
       END SUBROUTINE DVJACS28
+!_______________________________________________________________________
+
+      SUBROUTINE DVJACKPP(Y,JAC,IERPJ,N)
+! ..
+! Compute and process P = I - H*RL1*J with the KPP sparse linear
+! algebra. J is evaluated on the KPP pattern and saved in JKPP;
+! it is reused (only H*RL1 changed) unless DVJACS28 would also
+! evaluate it. P is factored in place by KppDecomp (no pivoting).
+! ..
+     IMPLICIT NONE
+! ..
+! .. Scalar Arguments ..
+        INTEGER, INTENT (INOUT) :: IERPJ
+        INTEGER, INTENT (IN) :: N
+! ..
+! .. Array Arguments ..
+        KPP_REAL, INTENT (INOUT) :: Y(*)
+! ..
+! .. Subroutine Arguments ..
+        EXTERNAL JAC
+! ..
+! .. Local Scalars ..
+        KPP_REAL :: CON
+        INTEGER :: I, IER, NZ
+! ..
+! .. Local Arrays ..
+        INTEGER :: IADUM(1), JADUM(1)
+! ..
+! .. FIRST EXECUTABLE STATEMENT DVJACKPP
+! ..
+        IERPJ = 0
+        JCUR = 0
+        CON = -H*RL1
+        IF (INEWJ==1 .OR. NST>=NSLJ+MSBJ .OR. (ICF==1 .AND. DRC<CCMXJ) &
+            .OR. ICF==2 .OR. JSTART==0 .OR. JSTART==-1) THEN
+          CALL JAC(N,TN,Y,IADUM,JADUM,NZ,JKPP)
+          JCUR = 1
+          NJE = NJE + 1
+          NSLJ = NST
+        END IF
+        JSTART = 1
+        DO I = 1, LU_NONZERO
+          PKPP(I) = CON*JKPP(I)
+        END DO
+        DO I = 1, N
+          PKPP(LU_DIAG(I)) = PKPP(LU_DIAG(I)) + ONE
+        END DO
+        CALL KppDecomp(PKPP,IER)
+        NLU = NLU + 1
+        IF (IER/=0) IERPJ = 1
+        RETURN
+
+      END SUBROUTINE DVJACKPP
 ! End of Jacobian related routines that use MA28
 !_______________________________________________________________________
 
@@ -166,8 +166,14 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
       KPP_REAL :: Y(NVAR), AbsTol(NVAR), RelTol(NVAR), TIN, TOUT
       KPP_REAL :: RCNTRL(20), RSTATUS(20)
       INTEGER       :: ICNTRL(20), ISTATUS(20)
+#ifdef FULL_ALGEBRA
       INTEGER, PARAMETER :: LRW = 25 + 9*NVAR+2*NVAR*NVAR, &
                             LIW = 32 + NVAR
+#else
+      !~~~> Newton matrix on the KPP sparse pattern, no pivots
+      INTEGER, PARAMETER :: LRW = 25 + 9*NVAR+LU_NONZERO, &
+                            LIW = 32
+#endif
       KPP_REAL :: RWORK(LRW), RPAR(1)
       INTEGER :: IWORK(LIW), IPAR(1), ITOL, ITASK,         &
                  IERR, IOPT, MF
@@ -1532,7 +1538,11 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
       IF (ISTATE .EQ. 1) NYH = N 
       LWM = LYH + (MAXORD + 1)*NYH 
       IF (MITER .EQ. 0) LENWM = 0 
+#ifdef FULL_ALGEBRA
       IF (MITER .EQ. 1 .OR. MITER .EQ. 2) LENWM = N*N + 2 
+#else
+      IF (MITER .EQ. 1 .OR. MITER .EQ. 2) LENWM = LU_NONZERO + 2 
+#endif
       IF (MITER .EQ. 3) LENWM = N + 2 
       IF (MITER .GE. 4) LENWM = (2*ML + MU + 1)*N + 2 
       LEWT = LWM + LENWM 
@@ -1542,6 +1552,9 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
       IWORK(17) = LENRW 
       LIWM = 1 
       LENIW = 20 + N 
+#ifndef FULL_ALGEBRA
+      LENIW = 20 
+#endif
       IF (MITER .EQ. 0 .OR. MITER .EQ. 3) LENIW = 20 
       IWORK(18) = LENIW 
       IF (LENRW .GT. LRW) GO TO 617 
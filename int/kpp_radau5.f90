@@ -23,6 +23,8 @@ MODULE KPP_ROOT_Integrator
   KPP_REAL :: Transf(3,3), TransfInv(3,3),      &
                    rkA(3,3), rkB(3), rkC(3), rkE(3), &
                    rkGamma, rkAlpha, rkBeta
+!$OMP THREADPRIVATE(Nfun, Njac, Nstp, Nacc, Nrej, Ndec, Nsol, Nsng)
+!$OMP THREADPRIVATE(Transf, TransfInv, rkA, rkB, rkC, rkE, rkGamma, rkAlpha, rkBeta)
   
   ! description of the error numbers IERR
   CHARACTER(LEN=50), PARAMETER, DIMENSION(-11:1) :: IERR_NAMES = (/ &
@@ -66,6 +68,7 @@ CONTAINS
     KPP_REAL :: RCNTRL(20), RSTATUS(20)
     INTEGER :: ICNTRL(20), ISTATUS(20)
     INTEGER, SAVE :: Ntotal = 0
+!$OMP THREADPRIVATE(H, Ntotal)
 
     H =0.0_dp
 
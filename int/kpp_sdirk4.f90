@@ -26,6 +26,8 @@ MODULE KPP_ROOT_Integrator
   !  SDIRK method coefficients
   KPP_REAL :: rkAlpha(5,4), rkBeta(5,4), rkD(4,5),  &
                    rkGamma, rkA(5,5), rkB(5), rkC(5)
+!$OMP THREADPRIVATE(Nfun, Njac, Nstp, Nacc, Nrej, Ndec, Nsol, Nsng)
+!$OMP THREADPRIVATE(rkAlpha, rkBeta, rkD, rkGamma, rkA, rkB, rkC)
                    
   ! description of the error numbers IERR
   CHARACTER(LEN=50), PARAMETER, DIMENSION(-8:1) :: IERR_NAMES = (/ &
@@ -21,6 +21,8 @@ MODULE KPP_ROOT_Integrator
   
   ! Statistics
   INTEGER :: Nfun,Njac,Nstp,Nacc,Nrej,Ndec,Nsol,Nsng
+!$OMP THREADPRIVATE(NN, NN2, NN3, NN4, TSOL, HSOL)
+!$OMP THREADPRIVATE(Nfun, Njac, Nstp, Nacc, Nrej, Ndec, Nsol, Nsng)
   
   ! Method parameters
   
@@ -62,6 +64,7 @@ CONTAINS
     INTEGER :: IERR
     INTEGER, SAVE :: Ntotal = 0
     KPP_REAL, SAVE :: H
+!$OMP THREADPRIVATE(Ntotal, H)
 
     H = 0.0_dp
 
@@ -240,6 +243,11 @@ CONTAINS
 !    ICNTRL(14)  = NRDENS = NUMBER OF COMPONENTS, FOR WHICH DENSE OUTPUT
 !              IS REQUIRED
 !
+!    ICNTRL(15) = 1: THE LINES OF THE EXTRAPOLATION TABLE OF A STEP ARE
+!              COMPUTED IN PARALLEL ON OPENMP THREADS (NOT WITH DENSE
+!              OUTPUT, IOUT=2; ONLY FOR MODELS GENERATED WITH
+!              #THREADSAFE ON); DEFAULT 0: ONE AFTER ANOTHER
+!
 !    ICNTRL(21),...,ICNTRL(NRDENS+20) INDICATE THE COMPONENTS, FOR WHICH
 !              DENSE OUTPUT IS REQUIRED
 !
@@ -291,7 +299,7 @@ CONTAINS
                  FacMin, FacMax, FAC1, FAC2, FAC3, FAC4, FacSafe1,     &
                  FacSafe2, H, Hstart,WorkFcn,WorkJac, WorkDec, WorkSol,&
                  WorkRow, FacRej, FacSafe, ThetaMin, T
-      LOGICAL :: AUTNMS
+      LOGICAL :: AUTNMS, ParRows
       KPP_REAL :: RCNTRL(20), RSTATUS(20)
       INTEGER ::       ICNTRL(20), ISTATUS(20)
       KPP_REAL, PARAMETER :: ZERO = 0.0d0
@@ -375,6 +383,11 @@ CONTAINS
    END IF
 
 
+!~~~> ParRows: compute the lines of the extrapolation table in parallel.
+!     Fun keeps the reaction rates in module data unless the model is
+!     generated with #THREADSAFE ON, so the lines are serial otherwise
+   ParRows = ( ICNTRL(15) == 1 ) .AND. ( IOUT /= 2 ) .AND. ( KPP_THREADSAFE == 1 )
+
 !~~~>  Unit roundoff (1+Roundoff>1)
       Roundoff = WLAMCH('E')
 
@@ -556,7 +569,7 @@ CONTAINS
       CALL SEULEX_Integrator(N,T,Tfinal,Y,Hmax,H,Ncolumns,RelTol,AbsTol,ITOL,  &
                 IOUT,IERR,Max_no_steps,Roundoff,Nsequence,AUTNMS,  &
                 FAC1,FAC2,FAC3,FAC4,ThetaMin,FacSafe1,FacSafe2,WorkJac,  &
-                WorkDec,WorkRow,Ncolumns2,NRD,LAMBDA,Nstp)
+                WorkDec,WorkRow,Ncolumns2,NRD,LAMBDA,Nstp,ParRows)
         
       ISTATUS(1)=Nfun
       ISTATUS(2)=Njac
@@ -621,7 +634,7 @@ CONTAINS
       SUBROUTINE SEULEX_Integrator(N,T,Tend,Y,Hmax,H,Ncolumns,RelTol,AbsTol,ITOL,&
        IOUT,IERR,Max_no_steps,Roundoff,Nsequence,AUTNMS,             &
        FAC1,FAC2,FAC3,FAC4,ThetaMin,FacSafe1,FacSafe2,WorkJac,       &
-       WorkDec,WorkRow,Ncolumns2,NRD,LAMBDA,Nstp)
+       WorkDec,WorkRow,Ncolumns2,NRD,LAMBDA,Nstp,ParRows)
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 !     CORE INTEGRATOR FOR SEULEX
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -646,10 +659,11 @@ CONTAINS
        INTEGER IP(N),NJ(Ncolumns),IPHES(N),ICOMP(NRD)
        KPP_REAL RelTol(*),AbsTol(*)
        KPP_REAL FSAFE(Ncolumns2,NRD),FACUL(Ncolumns),E(N,N),DENS((Ncolumns+2)*NRD)
-       LOGICAL REJECT,LAST,ATOV,CALJAC,CALHES,AUTNMS
+       LOGICAL REJECT,LAST,ATOV,CALJAC,CALHES,AUTNMS,ParRows
 
        KPP_REAL TOLDD,HHH,NNRD
        COMMON /COSEU/TOLDD,HHH,NNRD,KRIGHT
+!$OMP THREADPRIVATE(/COSEU/)
 
 !~~~> COMPUTE COEFFICIENTS FOR DENSE OUTPUT
        IF (IOUT == 2) THEN
@@ -750,6 +764,12 @@ CONTAINS
       Nstp=Nstp+1
       IF (Nstp >= Max_no_steps) GOTO 120
       KC=K-1
+      IF (ParRows) THEN
+       CALL SEUL_Rows(KC,N,Y,DY,FJAC,H,Ncolumns,HmaxN,Table,SCAL,NJ,&
+                HH,W,A,ERR,FacSafe1,FAC1,FAC2,FacSafe2,Theta,ERROLD,&
+                AUTNMS,REJECT,ATOV)
+       IF (ATOV) GOTO 10
+      ELSE
       DO J=1,KC
        CALL SEUL(J,N,T,Y,DY,FX,FJAC,LFJAC,E,LE,IP,H,Ncolumns,&
                 HmaxN,Table,SCAL,NJ,HH,W,A,YHH,DYH,DEL,WH,ERR,FacSafe1,&
@@ -758,6 +778,7 @@ CONTAINS
                 ATOV,FSAFE,Ncolumns2,NRD,IOUT,IPT,CALHES)
        IF (ATOV) GOTO 10
       END DO
+      END IF
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 !~~~> CONVERGENCE MONITOR
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -1055,6 +1076,33 @@ CONTAINS
        DO i=1,N
           Table(JJ,I)=YH(i)+DEL(i)
        END DO
+       CALL SEUL_Extrap(JJ,N,H,Ncolumns,HmaxN,Table,SCAL,NJ,HH,W,A,ERR,&
+                FacSafe1,FAC1,FAC2,FacSafe2,ERROLD,ATOV)
+       IF (ATOV) GOTO 79
+       RETURN
+   79  ATOV=.TRUE.
+       H=H*0.5D0
+       REJECT=.TRUE.
+       RETURN
+      END SUBROUTINE SEUL
+
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      SUBROUTINE SEUL_Extrap(JJ,N,H,Ncolumns,HmaxN,Table,SCAL,NJ,HH,W,A,&
+               ERR,FacSafe1,FAC1,FAC2,FacSafe2,ERROLD,ATOV)
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!~~~> EXTRAPOLATES THE TABLE WITH ITS NEW JJ-TH LINE AND
+!~~~> PROVIDES AN ESTIMATE OF THE OPTIMAL STEP SIZE;
+!~~~> ATOV=.TRUE. IF THE ERROR DOES NOT DECREASE
+      IMPLICIT KPP_REAL (A-H,O-Z)
+      IMPLICIT INTEGER (I-N)
+      INTEGER :: Ncolumns, N
+      KPP_REAL :: SCAL(NVAR),HH(Ncolumns),W(Ncolumns),A(Ncolumns)
+      KPP_REAL :: Table(Ncolumns,NVAR)
+      INTEGER :: NJ(Ncolumns)
+      LOGICAL ATOV
+
+      ATOV=.FALSE.
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 !~~~> POLYNOMIAL EXTRAPOLATION
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -1082,10 +1130,219 @@ CONTAINS
        W(JJ)=A(JJ)/HH(JJ)
        RETURN
    79  ATOV=.TRUE.
-       H=H*0.5D0
-       REJECT=.TRUE.
        RETURN
-      END SUBROUTINE SEUL
+      END SUBROUTINE SEUL_Extrap
+
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      SUBROUTINE SEUL_Rows(KC,N,Y,DY,FJAC,H,Ncolumns,HmaxN,Table,SCAL,NJ,&
+               HH,W,A,ERR,FacSafe1,FAC1,FAC2,FacSafe2,Theta,ERROLD,     &
+               AUTNMS,REJECT,ATOV)
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!~~~> COMPUTES THE LINES 1..KC OF THE EXTRAPOLATION TABLE
+!~~~> ON OPENMP THREADS (ICNTRL(15)=1). THE LINEARLY IMPLICIT
+!~~~> EULER SEQUENCES ARE INDEPENDENT; LINE J COSTS ONE
+!~~~> DECOMPOSITION AND NJ(J) FUNCTION CALLS AND SOLVES.
+!~~~> THE LINES GO TO THE THREADS MOST EXPENSIVE FIRST, EACH
+!~~~> TO THE LEAST LOADED THREAD, WHICH PAIRS THE CHEAP LINES
+!~~~> WITH THE EXPENSIVE ONES. THE LINES ARE THEN EXTRAPOLATED
+!~~~> IN ORDER AS IN SEUL, WITH THE SAME RESULT.
+      USE KPP_ROOT_Parameters
+      USE KPP_ROOT_Global, ONLY: FIX, RCONST
+!$    USE omp_lib
+      IMPLICIT KPP_REAL (A-H,O-Z)
+      IMPLICIT INTEGER (I-N)
+      INTEGER :: KC, Ncolumns, N
+      KPP_REAL :: Y(NVAR),DY(NVAR),SCAL(NVAR)
+      KPP_REAL :: HH(Ncolumns),W(Ncolumns),A(Ncolumns)
+#ifdef FULL_ALGEBRA    
+      KPP_REAL :: FJAC(NVAR,NVAR)
+#else
+      KPP_REAL :: FJAC(LU_NONZERO)
+#endif      
+      KPP_REAL :: Table(Ncolumns,NVAR)
+      INTEGER :: NJ(Ncolumns)
+      LOGICAL ATOV,REJECT,AUTNMS
+
+      KPP_REAL :: Row(NVAR,Ncolumns), ThetaJ(Ncolumns)
+      KPP_REAL :: FIXs(NFIX), RCTs(NREACT)
+      INTEGER :: Owner(Ncolumns), Load(Ncolumns), IFAIL(Ncolumns)
+      INTEGER :: NfunJ(Ncolumns), NdecJ(Ncolumns), NsolJ(Ncolumns)
+      INTEGER :: J, Nthr, ithr, nteam
+
+!~~~> Threaded code may not see the thread-private FIX and RCONST
+      FIXs(1:NFIX) = FIX(1:NFIX)
+      RCTs(1:NREACT) = RCONST(1:NREACT)
+
+!~~~> One thread per line at most; a single thread inside a parallel region
+      Nthr = 1
+!$    IF (.NOT.omp_in_parallel()) Nthr = MIN(KC, omp_get_max_threads())
+      Load(1:Nthr) = 0
+      DO J=KC,1,-1
+         ithr = MINLOC(Load(1:Nthr),1)
+         Owner(J) = ithr-1
+         Load(ithr) = Load(ithr)+NJ(J)+1
+      END DO
+
+!$OMP PARALLEL NUM_THREADS(Nthr) PRIVATE(J,ithr,nteam)
+      ithr = 0
+      nteam = 1
+!$    ithr = omp_get_thread_num()
+!$    nteam = omp_get_num_threads()
+      DO J=KC,1,-1
+         IF (MOD(Owner(J),nteam) == ithr)                               &
+            CALL SEUL_Row(J,N,Y,DY,FJAC,H,Ncolumns,SCAL,NJ,AUTNMS,      &
+                 FIXs,RCTs,Row(1,J),ThetaJ(J),IFAIL(J),                 &
+                 NfunJ(J),NdecJ(J),NsolJ(J))
+      END DO
+!$OMP END PARALLEL
+
+      Nfun = Nfun+SUM(NfunJ(1:KC))
+      Ndec = Ndec+SUM(NdecJ(1:KC))
+      Nsol = Nsol+SUM(NsolJ(1:KC))
+
+!~~~> Extrapolation, line by line
+      DO J=1,KC
+         IF (ThetaJ(J) >= 0.D0) Theta=ThetaJ(J)
+         IF (IFAIL(J) /= 0) GOTO 79
+         DO i=1,N
+            Table(J,i)=Row(i,J)
+         END DO
+         CALL SEUL_Extrap(J,N,H,Ncolumns,HmaxN,Table,SCAL,NJ,HH,W,A,ERR,&
+                  FacSafe1,FAC1,FAC2,FacSafe2,ERROLD,ATOV)
+         IF (ATOV) GOTO 79
+      END DO
+      RETURN
+   79 ATOV=.TRUE.
+      H=H*0.5D0
+      REJECT=.TRUE.
+      RETURN
+      END SUBROUTINE SEUL_Rows
+
+
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      SUBROUTINE SEUL_Row(JJ,N,Y,DY,FJAC,H,Ncolumns,SCAL,NJ,AUTNMS,   &
+               FIXs,RCTs,YJ,ThetaJ,IFAIL,NfunJ,NdecJ,NsolJ)
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!~~~> LINEARLY IMPLICIT EULER SEQUENCE OF THE JJ-TH LINE, AS
+!~~~> IN SEUL, WITH ITS OWN WORK ARRAYS AND COUNTERS. YJ IS THE
+!~~~> NEW LINE; THETAJ THE RESULT OF THE STABILITY CHECK (-1 IF
+!~~~> NONE); IFAIL=1 FOR A SINGULAR MATRIX OR AN UNSTABLE LINE
+      USE KPP_ROOT_Parameters
+      USE KPP_ROOT_Jacobian
+      USE KPP_ROOT_Function, ONLY: Fun
+      IMPLICIT KPP_REAL (A-H,O-Z)
+      IMPLICIT INTEGER (I-N)
+      INTEGER :: Ncolumns, N, IFAIL, NfunJ, NdecJ, NsolJ
+      KPP_REAL :: Y(NVAR),DY(NVAR),SCAL(NVAR),YJ(NVAR),ThetaJ
+      KPP_REAL :: FIXs(NFIX), RCTs(NREACT)
+#ifdef FULL_ALGEBRA    
+      KPP_REAL :: FJAC(NVAR,NVAR), E(NVAR,NVAR)
+      INTEGER :: IP(NVAR)
+#else
+      KPP_REAL :: FJAC(LU_NONZERO), E(LU_NONZERO)
+#endif      
+      KPP_REAL :: YH(NVAR),DY0(NVAR),DYH(NVAR),DEL(NVAR),WH(NVAR)
+      INTEGER :: NJ(Ncolumns)
+      LOGICAL AUTNMS
+
+      ThetaJ=-1.D0
+      IFAIL=1
+      NfunJ=0
+      NsolJ=0
+      HJ=H/NJ(JJ)
+      HJI=1.D0/HJ
+#ifdef FULL_ALGEBRA    
+      DO j=1,N
+        DO  i=1,N
+           E(i,j)=-FJAC(i,j)
+        END DO
+        E(j,j)=E(j,j)+HJI
+      END DO
+      CALL DGETRF(N,N,E,N,IP,ISING)
+#else
+      DO  i=1,LU_NONZERO
+         E(i)=-FJAC(i)
+      END DO
+      DO j=1,N
+         E(LU_DIAG(j))=E(LU_DIAG(j))+HJI
+      END DO
+      CALL KppDecomp (E,ISING)
+#endif      
+      NdecJ=1
+      IF (ISING.NE.0) RETURN
+!~~~> STARTING PROCEDURE (FUN_CHEM DOES NOT DEPEND ON T)
+       IF (.NOT.AUTNMS) THEN
+          CALL Fun(Y,FIXs,RCTs,DY0)
+          NfunJ=NfunJ+1
+       ELSE
+          DY0(1:N)=DY(1:N)
+       END IF
+       DO i=1,N
+          YH(i)=Y(i)
+          DEL(i)=DY0(i)
+       END DO
+#ifdef FULL_ALGEBRA      
+       CALL DGETRS ('N',N,1,E,N,IP,DEL,N,ISING)
+#else
+       CALL KppSolve (E,DEL)
+#endif       
+       NsolJ=NsolJ+1
+       M=NJ(JJ)
+!~~~> SEMI-IMPLICIT EULER METHOD
+       DO MM=1,M-1
+          DO i=1,N
+             YH(i)=YH(i)+DEL(i)
+          END DO
+          CALL Fun(YH,FIXs,RCTs,DYH)
+          NfunJ=NfunJ+1
+          IF (MM == 1.AND.JJ <= 2) THEN
+!~~~> STABILITY CHECK
+             DEL1=0.D0
+             DO i=1,N
+                DEL1=DEL1+(DEL(i)/SCAL(i))**2
+             END DO
+             DEL1=SQRT(DEL1)
+             IF (.NOT.AUTNMS) THEN
+                CALL Fun(YH,FIXs,RCTs,WH)
+                NfunJ=NfunJ+1
+                DO i=1,N
+                   DEL(i)=WH(i)-DEL(i)*HJI
+                END DO
+             ELSE
+                DO i=1,N
+                   DEL(i)=DYH(i)-DEL(i)*HJI
+                END DO
+             END IF
+#ifdef FULL_ALGEBRA      
+             CALL DGETRS ('N',N,1,E,N,IP,DEL,N,ISING)
+#else
+             CALL KppSolve (E,DEL)
+#endif
+             NsolJ=NsolJ+1
+             DEL2=0.D0
+             DO i=1,N
+                DEL2=DEL2+(DEL(i)/SCAL(i))**2
+             END DO
+             DEL2=SQRT(DEL2)
+             ThetaJ=DEL2/MAX(1.D0,DEL1)
+             IF (ThetaJ > 1.D0) RETURN
+          END IF
+#ifdef FULL_ALGEBRA      
+          CALL DGETRS ('N',N,1,E,N,IP,DYH,N,ISING)
+#else
+          CALL KppSolve (E,DYH)
+#endif             
+          NsolJ=NsolJ+1
+          DO i=1,N
+             DEL(i)=DYH(i)
+          END DO
+       END DO
+       DO i=1,N
+          YJ(i)=YH(i)+DEL(i)
+       END DO
+       IFAIL=0
+      END SUBROUTINE SEUL_Row
 
 
 
@@ -10,9 +10,35 @@
  #define  ONE      (KPP_REAL)1.0
  #define  HALF     (KPP_REAL)0.5
  #define  DeltaMin (KPP_REAL)1.0e-6    
+ #define  KrylovRefresh 10   /* Krylov iterations that trigger a new ILU(0) */
+ #define  ErrHistMin (KPP_REAL)1.0e-2  /* Lower bound of the stored errors */
+ #define  WQmax    (KPP_REAL)1.2    /* Hnew/H in [1,WQmax] keeps H and the LU
+                                       when the Jacobian is reused */
+ #define  MixedMaxRef 2      /* Max. refinement steps of a mixed precision solve */
    
 /*~~~> Collect statistics: global variables */   
- int Nfun,Njac,Nstp,Nacc,Nrej,Ndec,Nsol,Nsng;
+ int Nfun,Njac,Nstp,Nacc,Nrej,Ndec,Nsol,Nsng,Nkry,Nred;
+/*~~~> Steps of the current call with a reused Jacobian / LU decomposition */
+ int Njre,Nlre;
+/*~~~> Linear solver: sparse LU (0), GMRES (1), BiCGStab (2) or LU in
+       single precision with refinement (3) */
+ int ros_LinSolver;
+ KPP_REAL ros_KrylovTol;
+/*~~~> Mixed precision: single precision factors, in use (ros_Mixed)
+       until a refinement fails; LU decompositions that fell back */
+ float ros_LUS[KPP_LU_NONZERO];
+ char ros_Mixed;
+ int Nfbk;
+/*~~~> Step size controller: elementary (0), PI (1) or PID (2) */
+ int ros_Controller;
+/*~~~> W-method mode: Jacobian kept over at most ros_JacMaxAge steps */
+ int ros_JacReuse, ros_JacMaxAge;
+#ifdef _OPENMP
+ #pragma omp threadprivate( Nfun,Njac,Nstp,Nacc,Nrej,Ndec,Nsol,Nsng,Nkry, \
+                            Nred,Njre,Nlre,ros_LinSolver,ros_KrylovTol, \
+                            ros_LUS,ros_Mixed,Nfbk, \
+                            ros_Controller,ros_JacReuse,ros_JacMaxAge )
+#endif
 
 
 /*~~~> Function headers */   
@@ -39,8 +65,10 @@
      KPP_REAL *Texit, KPP_REAL *Hexit ); 
  char ros_PrepareMatrix (
      KPP_REAL* H, 
-     int Direction,  KPP_REAL gam, KPP_REAL Jac0[], 
+     int Direction,  KPP_REAL gam, KPP_REAL Jac0[], KPP_REAL FacMin,
      KPP_REAL Ghimj[], int Pivot[] );
+ KPP_REAL ros_StepFactor ( int Controller, KPP_REAL Err, KPP_REAL ErrOld[],
+     int Nhist, KPP_REAL Hratio, KPP_REAL ros_ELO );
  KPP_REAL ros_ErrorNorm ( 
      KPP_REAL Y[], KPP_REAL Ynew[], KPP_REAL Yerr[], 
      KPP_REAL AbsTol[], KPP_REAL RelTol[], 
@@ -56,7 +84,11 @@
  void FunTemplate( KPP_REAL T, KPP_REAL Y[], KPP_REAL Ydot[] );
  void JacTemplate( KPP_REAL T, KPP_REAL Y[], KPP_REAL Ydot[] );
  void DecompTemplate( KPP_REAL A[], int Pivot[], int* ising );
+ KPP_REAL KppRowShift( KPP_REAL JVS[], int k );
  void SolveTemplate( KPP_REAL A[], int Pivot[], KPP_REAL b[] );
+ void ros_MixedSolve( KPP_REAL A[], int Pivot[], KPP_REAL W[], KPP_REAL b[] );
+ char ros_KrylovSolve( KPP_REAL ghinv, KPP_REAL Jac0[], KPP_REAL Prec[],
+     KPP_REAL W[], char* NewPrec, KPP_REAL b[] );
  void WCOPY(int N, KPP_REAL X[], int incX, KPP_REAL Y[], int incY);
  void WAXPY(int N, KPP_REAL Alpha, KPP_REAL X[], int incX, KPP_REAL Y[], int incY );
  void WSCAL(int N, KPP_REAL Alpha, KPP_REAL X[], int incX);
@@ -81,8 +113,20 @@
              KPP_REAL ros_M[], KPP_REAL ros_E[], 
 	     KPP_REAL ros_Alpha[], KPP_REAL ros_Gamma[], 
 	     char ros_NewF[], KPP_REAL *ros_ELO, char* ros_Name );
+ void Ros34pw2 ( int *ros_S, KPP_REAL ros_A[], KPP_REAL ros_C[], 
+             KPP_REAL ros_M[], KPP_REAL ros_E[], 
+	     KPP_REAL ros_Alpha[], KPP_REAL ros_Gamma[], 
+	     char ros_NewF[], KPP_REAL *ros_ELO, char* ros_Name );
  int  KppDecomp( KPP_REAL A[] );
  void KppSolve ( KPP_REAL A[], KPP_REAL b[] );
+ int  KppDecompLev( KPP_REAL A[] );
+ void KppSolveLev( KPP_REAL A[], KPP_REAL b[] );
+ int  KppILU0( KPP_REAL A[] );
+ int  KppDecompSP( KPP_REAL A[], float LUS[] );
+ int  KppSolveMixed( KPP_REAL A[], float LUS[], KPP_REAL W[],
+     KPP_REAL Tol, int MaxRef, KPP_REAL b[] );
+ int  KppKrylov( int Method, KPP_REAL Shift, KPP_REAL JVS[], KPP_REAL Prec[],
+     KPP_REAL W[], KPP_REAL Tol, KPP_REAL X[], int *Nit );
  void Update_SUN();
  void Update_RCONST();
  
@@ -90,9 +134,12 @@
 void INTEGRATE( KPP_REAL TIN, KPP_REAL TOUT )
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 {
-   static KPP_REAL  RPAR[20];
-   static int  i, IERR, IPAR[20];
-   static int Ns=0, Na=0, Nr=0, Ng=0;
+   KPP_REAL  RPAR[20];
+   int  i, IERR, IPAR[20];
+   static int Ns=0, Na=0, Nr=0, Ng=0, Nd=0;
+#ifdef _OPENMP
+   #pragma omp threadprivate( Ns, Na, Nr, Ng, Nd )
+#endif
 
    for ( i = 0; i < 20; i++ ) {
      IPAR[i] = 0;
@@ -115,8 +162,9 @@ void INTEGRATE( KPP_REAL TIN, KPP_REAL TOUT )
    Na=Na+IPAR[13];
    Nr=Nr+IPAR[14];
    Ng=Ng+IPAR[17];
-   printf("\n Step=%d  Acc=%d  Rej=%d  Singular=%d\n",
-         Ns,Na,Nr,Ng);
+   Nd=Nd+IPAR[19];
+   printf("\n Step=%d  Acc=%d  Rej=%d  Singular=%d  Reduced=%d\n",
+         Ns,Na,Nr,Ng,Nd);
 
 
    if (IERR < 0)
@@ -192,6 +240,9 @@ int Rosenbrock(KPP_REAL Y[], KPP_REAL Tstart, KPP_REAL Tend,
            = -6 : No of steps exceeds maximum bound
            = -7 : Step size too small
            = -8 : Matrix is repeatedly singular
+           = -9 : Selected linear solver not implemented
+           = -10: Selected step size controller not implemented
+           = -11: Jacobian reuse needs a W-method (Ros2 or Ros34PW2)
 ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  
   *~~~>     INPUT PARAMETERS:
@@ -213,6 +264,42 @@ int Rosenbrock(KPP_REAL Y[], KPP_REAL Tstart, KPP_REAL Tend,
         = 3 :  method is  Ros4 
         = 4 :  method is  Rodas3
         = 5:   method is  Rodas4
+        = 6:   method is  Ros34PW2, a W-method of order 3 (Rang and
+               Angermann, 2005): the order holds with any matrix in
+               place of the Jacobian, as for Ros2
+
+    IPAR[4]  -> linear solver for the stage systems
+        = 0 :  sparse LU decomposition (KppDecomp/KppSolve), default
+        = 1 :  GMRES      } preconditioned by an ILU(0) of the matrix,
+        = 2 :  BiCGStab   } kept over steps while the solves converge
+                            in at most KrylovRefresh iterations
+        = 3 :  sparse LU decomposition in single precision; the solves
+               are refined with residuals in double precision, at most
+               MixedMaxRef=2 times, until the residual meets KrylovTol.
+               If the refinement fails, the matrix is decomposed in double
+               precision for the remaining stages of the step
+
+    IPAR[5]  -> step size controller, from the error Err of the step
+                and Err1, Err2 of the two previous accepted steps
+        = 0 :  elementary, Hnew/H = FacSafe*Err^(-1/ELO) (default)
+        = 1 :  PI, the predictive controller of Gustafsson
+                 Hnew/H = FacSafe*(H/Hold)*(Err1/Err^2)^(1/ELO)
+        = 2 :  PID, the PI ratio times (Err1^2/(Err*Err2))^(1/(4*ELO))
+              The PI/PID ratio is taken if smaller than the elementary
+              one; it avoids the alternating rejections where the step
+              size must decrease steadily (e.g. at sunset).  A rejected
+              step is always reduced by the elementary controller
+
+    IPAR[6]  -> Jacobian reuse (W-method mode, only for IPAR[3] = 1, 6)
+        = 0 :  a new Jacobian at every step (default)
+        = 1 :  the Jacobian is kept from step to step; a new one is
+               evaluated after IPAR[7] steps, when the error estimate
+               grows or the controller reduces the step size, and a
+               rejected step done with an older Jacobian is repeated
+               with a new one.  A step size increase by less than
+               WQmax=1.2 is not taken, so that the LU decomposition
+               is kept as well
+    IPAR[7]  -> maximum no. of steps with the same Jacobian (default 10)
 
     RPAR[0]  -> Hmin, lower bound for the integration step size
           It is strongly recommended to keep Hmin = ZERO 
@@ -225,6 +312,10 @@ int Rosenbrock(KPP_REAL Y[], KPP_REAL Tstart, KPP_REAL Tend,
             (default=0.1)
     RPAR[6]  -> FacSafe, by which the new step is slightly smaller 
          than the predicted value  (default=0.9)
+    RPAR[7]  -> KrylovTol, for IPAR[4] > 0: the Krylov solve (or the
+         iterative refinement for IPAR[4] = 3) stops when the residual,
+         times H*gamma and scaled by AbsTol+RelTol*|Y|, has an RMS norm
+         below KrylovTol (default=0.01)
 ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  
   *~~~>     OUTPUT PARAMETERS:
@@ -238,13 +329,21 @@ int Rosenbrock(KPP_REAL Y[], KPP_REAL Tstart, KPP_REAL Tend,
     IPAR[12] = No. of steps
     IPAR[13] = No. of accepted steps
     IPAR[14] = No. of rejected steps (except at the beginning)
-    IPAR[15] = No. of LU decompositions
+    IPAR[15] = No. of LU decompositions (ILU(0) for IPAR[4] > 0)
     IPAR[16] = No. of forward/backward substitutions
     IPAR[17] = No. of singular matrix decompositions
+    IPAR[18] = No. of Krylov iterations
+    IPAR[19] = No. of step size reductions after a singular matrix or a
+               failed Krylov solve (IPAR[12]-IPAR[13] steps were rejected
+               by the error test)
 
     RPAR[10]  -> Texit, the time corresponding to the 
             computed Y upon return
     RPAR[11]  -> Hexit, last accepted step before exit
+    RPAR[12]  -> fraction of the steps of this call with a reused Jacobian
+    RPAR[13]  -> fraction of the steps of this call with a reused LU
+    RPAR[14]  -> for IPAR[4] = 3, fraction of the single precision LU
+            decompositions of this call that fell back to double precision
     For multiple restarts, use Hexit as Hstart in the following run 
 ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 {   
@@ -272,6 +371,8 @@ int Rosenbrock(KPP_REAL Y[], KPP_REAL Tstart, KPP_REAL Tend,
    Ndec = IPAR[15];
    Nsol = IPAR[16];
    Nsng = IPAR[17];
+   Nkry = IPAR[18];
+   Nred = IPAR[19];
    
   /*~~~>  Autonomous or time dependent ODE. Default is time dependent. */
    Autonomous = !(IPAR[0] == 0);
@@ -299,11 +400,42 @@ int Rosenbrock(KPP_REAL Y[], KPP_REAL Tstart, KPP_REAL Tend,
        Method = 3;
    else                
        Method = IPAR[3];
-   if ( (IPAR[3] < 1) || (IPAR[3] > 5) ){  
+   if ( (IPAR[3] < 1) || (IPAR[3] > 6) ){  
       printf("\n User-selected Rosenbrock method: IPAR[3]=%d\n",IPAR[3]);
       return ros_ErrorMsg(-2,Tstart,ZERO);
    } /* end if */
    
+  /*~~~>  The linear solver */
+   ros_LinSolver = IPAR[4];
+   if ( (IPAR[4] < 0) || (IPAR[4] > 3) ){  
+      printf("\n User-selected linear solver: IPAR[4]=%d\n",IPAR[4]);
+      return ros_ErrorMsg(-9,Tstart,ZERO);
+   } /* end if */
+
+  /*~~~>  The step size controller */
+   ros_Controller = IPAR[5];
+   if ( (IPAR[5] < 0) || (IPAR[5] > 2) ){  
+      printf("\n User-selected step size controller: IPAR[5]=%d\n",IPAR[5]);
+      return ros_ErrorMsg(-10,Tstart,ZERO);
+   } /* end if */
+
+  /*~~~>  Jacobian reuse, only for the W-methods */
+   ros_JacReuse = IPAR[6];
+   if ( (IPAR[6] < 0) || (IPAR[6] > 1) 
+       || ( ros_JacReuse && (Method != 1) && (Method != 6) ) ){  
+      printf("\n User-selected Jacobian reuse: IPAR[6]=%d with IPAR[3]=%d\n",
+             IPAR[6],IPAR[3]);
+      return ros_ErrorMsg(-11,Tstart,ZERO);
+   } /* end if */
+   if (IPAR[7] == 0)  
+      ros_JacMaxAge = 10;
+   else                
+      ros_JacMaxAge = IPAR[7];
+   if (IPAR[7] < 0) {	 
+      printf("\n User-selected max Jacobian age: IPAR[7]=%d\n",IPAR[7]);
+      return ros_ErrorMsg(-11,Tstart,ZERO);
+   } /* end if */
+   
   /*~~~>  Unit Roundoff (1+Roundoff>1)   */
    Roundoff = WLAMCH('E');
 
@@ -366,6 +498,15 @@ int Rosenbrock(KPP_REAL Y[], KPP_REAL Tstart, KPP_REAL Tend,
       printf("\n User-selected FacSafe: RPAR[6]=%e\n", RPAR[6]);
       return ros_ErrorMsg(-4,Tstart,ZERO);
    } /* end if */
+  /*~~~>   KrylovTol: Stopping criterion of the Krylov solver */
+   if (RPAR[7] == ZERO) 
+      ros_KrylovTol = (KPP_REAL)0.01;
+   else
+      ros_KrylovTol = RPAR[7];
+   if (RPAR[7] < ZERO) {	 
+      printf("\n User-selected KrylovTol: RPAR[7]=%e\n", RPAR[7]);
+      return ros_ErrorMsg(-5,Tstart,ZERO);
+   } /* end if */
   /*~~~>  Check if tolerances are reasonable */
     for (i = 0; i < UplimTol; i++) {
       if ( (AbsTol[i] <= ZERO)  ||  (RelTol[i] <= 10.0*Roundoff)
@@ -399,12 +540,19 @@ int Rosenbrock(KPP_REAL Y[], KPP_REAL Tstart, KPP_REAL Tend,
        Rodas4(&ros_S, ros_A, ros_C, ros_M, ros_E, 
          ros_Alpha, ros_Gamma, ros_NewF, &ros_ELO, ros_Name);
        break;	 
+     case 6:
+       Ros34pw2(&ros_S, ros_A, ros_C, ros_M, ros_E, 
+         ros_Alpha, ros_Gamma, ros_NewF, &ros_ELO, ros_Name);
+       break;	 
      default:
        printf("\n Unknown Rosenbrock method: IPAR[3]= %d", Method);
        return ros_ErrorMsg(-2,Tstart,ZERO); 
    } /* end switch */
 
   /*~~~>  Rosenbrock method   */
+   Njre = 0;
+   Nlre = 0;
+   Nfbk = 0;
    IERR = RosenbrockIntegrator( Y,Tstart,Tend,
         AbsTol, RelTol,
         ode_Fun,ode_Jac ,
@@ -419,6 +567,14 @@ int Rosenbrock(KPP_REAL Y[], KPP_REAL Tstart, KPP_REAL Tend,
 	&Texit, &Hexit );
 
 
+  /*~~~> Jacobian and LU reuse rates */
+   if (Nstp > IPAR[12]) {
+     RPAR[12] = (KPP_REAL)Njre/(KPP_REAL)(Nstp-IPAR[12]);
+     RPAR[13] = (KPP_REAL)Nlre/(KPP_REAL)(Nstp-IPAR[12]);
+   } /* end if */
+   if (Ndec > IPAR[15]+Nfbk) 
+     RPAR[14] = (KPP_REAL)Nfbk/(KPP_REAL)(Ndec-IPAR[15]-Nfbk);
+
   /*~~~>  Collect run statistics */
    IPAR[10] = Nfun;
    IPAR[11] = Njac;
@@ -428,6 +584,8 @@ int Rosenbrock(KPP_REAL Y[], KPP_REAL Tstart, KPP_REAL Tend,
    IPAR[15] = Ndec;
    IPAR[16] = Nsol;
    IPAR[17] = Nsng;
+   IPAR[18] = Nkry;
+   IPAR[19] = Nred;
   /*~~~> Last T and H */
    RPAR[10] = Texit;
    RPAR[11] = Hexit;    
@@ -474,10 +632,11 @@ int RosenbrockIntegrator(
       dFdT[KPP_NVAR],
       Jac0[KPP_LU_NONZERO], Ghimj[KPP_LU_NONZERO];
    KPP_REAL K[KPP_NVAR*ros_S];   
-   KPP_REAL H, T, Hnew, HC, HG, Fac, Tau; 
-   KPP_REAL Err, Yerr[KPP_NVAR];
-   int Pivot[KPP_NVAR], Direction, ioffset, j, istage;
-   char RejectLastH, RejectMoreH;
+   KPP_REAL H, T, Hnew, Hacc, Hlu, HC, HG, Fac, Tau; 
+   KPP_REAL Err, Yerr[KPP_NVAR], ErrOld[2];
+   KPP_REAL ghinv, Wkry[KPP_NVAR];
+   int Pivot[KPP_NVAR], Direction, ioffset, i, j, istage, Nhist, JacAge;
+   char RejectLastH, RejectMoreH, NewPrec, Failed, NewJac, NewLU, Krylov;
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
    
@@ -495,6 +654,10 @@ int RosenbrockIntegrator(
    } /* end if */		
 
    RejectLastH=0; RejectMoreH=0;
+   NewPrec=1;
+   Nhist=0; Hacc=H;
+   NewJac=1; JacAge=0; Hlu=ZERO;
+   Krylov = (ros_LinSolver == 1) || (ros_LinSolver == 2);
    
   /*~~~> Time loop begins below  */ 
 
@@ -521,18 +684,37 @@ int RosenbrockIntegrator(
    if (!Autonomous) 
       ros_FunTimeDerivative ( T, Roundoff, Y, Fcn0, ode_Fun, dFdT );
   
-  /*~~~>   Compute the Jacobian at current time  */
-   (*ode_Jac)(T,Y,Jac0);
+  /*~~~>   Compute the Jacobian at current time, or keep the previous
+            one in W-method mode  */
+   if (NewJac) {
+      (*ode_Jac)(T,Y,Jac0);
+      JacAge = 0;
+   } else
+      JacAge++;
  
   /*~~~>  Repeat step calculation until current step accepted  */
    while (1) { /* WHILE STEP NOT ACCEPTED */
 
    
-   if( ros_PrepareMatrix( &H, Direction, ros_Gamma[0],
-          Jac0, Ghimj, Pivot) ) { /* More than 5 consecutive failed decompositions */
-       *Texit = T;
-       return ros_ErrorMsg(-8,T,H);
-   }
+  /*~~~>  With a Krylov solver Ghimj holds the ILU(0) preconditioner,
+          which is kept while the solves converge fast enough */
+   if ( Krylov ? NewPrec : ( (JacAge == 0) || (H != Hlu) ) ) {
+     if( ros_PrepareMatrix( &H, Direction, ros_Gamma[0],
+            Jac0, FacMin, Ghimj, Pivot) ) { /* More than 5 consecutive failed decompositions */
+         *Texit = T;
+         return ros_ErrorMsg(-8,T,H);
+     }
+     NewPrec = 0;
+     NewLU = 1;
+     Hlu = H;
+   } else
+     NewLU = 0;
+   ghinv = ONE/(Direction*H*ros_Gamma[0]);
+   if (ros_LinSolver) 
+     for (i=0; i<KPP_NVAR; i++) 
+       Wkry[i] = ABS(ONE/ghinv)/( VectorTol ? AbsTol[i]+RelTol[i]*ABS(Y[i])
+                                          : AbsTol[0]+RelTol[0]*ABS(Y[i]) );
+   Failed = 0;
 
   /*~~~>   Compute the stages  */
    for (istage = 1; istage <= ros_S; istage++) {
@@ -565,10 +747,29 @@ int RosenbrockIntegrator(
 	WAXPY(KPP_NVAR,HG,dFdT,1,&K[ioffset],1);
       } /* end if !Autonomous */
       
-      SolveTemplate(Ghimj, Pivot, &K[ioffset]);
+      if (Krylov) {
+        Failed = ros_KrylovSolve(ghinv, Jac0, Ghimj, Wkry, &NewPrec, &K[ioffset]);
+        if (Failed) break;
+      } else if (ros_LinSolver == 3)
+        ros_MixedSolve(Ghimj, Pivot, Wkry, &K[ioffset]);
+      else 
+        SolveTemplate(Ghimj, Pivot, &K[ioffset]);
 	 
    } /* for istage */	    
 	    
+  /*~~~>  The stage system could not be solved: retry with H/2 */
+   if (Failed) {
+      H = H*HALF;
+      NewPrec = 1;
+      Nred++;
+      /* The retries never reach the step size check of the time loop */
+      if ( (H <= Hmin) || ((T+0.1*H) == T) || (H <= Roundoff) ) {
+         *Texit = T;
+         return ros_ErrorMsg(-7,T,H);
+      }
+      continue;
+   }
+
 
   /*~~~>  Compute the new solution   */
    WCOPY(KPP_NVAR,Y,1,Ynew,1);
@@ -587,20 +788,47 @@ int RosenbrockIntegrator(
 
   /*~~~>  Check the error magnitude and adjust step size  */
    Nstp++;
+   if (JacAge > 0) Njre++;
+   if (!NewLU) Nlre++;
    if ( (Err <= ONE) || (H <= Hmin) ) {    /*~~~> Accept step  */
       Nacc++;
+      /* The PI/PID controllers predict from the previous accepted steps */
+      if ( ros_Controller && (Nhist >= 1) ) {
+         Fac  = MIN(Fac,MIN(FacMax,MAX(FacMin,FacSafe*ros_StepFactor(
+                     ros_Controller,Err,ErrOld,Nhist,H/Hacc,ros_ELO))));
+         Hnew = H*Fac;
+      }
+      Hacc = H;
+      ErrOld[1] = ErrOld[0];
+      ErrOld[0] = MAX(ErrHistMin,Err);
+      Nhist++;
       WCOPY(KPP_NVAR,Ynew,1,Y,1);
       T += Direction*H;
       Hnew = MAX(Hmin,MIN(Hnew,Hmax));
       /* No step size increase after a rejected step  */
       if (RejectLastH) 
          Hnew = MIN(Hnew,H); 
+      /* W-method mode: keep H, and the LU, for a small increase; a new
+         Jacobian when it is too old, the error grows or the step size
+         must decrease */
+      if (ros_JacReuse) {
+         if ( (Hnew >= H) && (Hnew <= WQmax*H) )
+            Hnew = H;
+         NewJac = (JacAge+1 >= ros_JacMaxAge) || (Hnew < H)
+                  || ( (Nhist >= 2) && (Err > ErrOld[1]) );
+      } /* end if */
       RejectLastH = 0; RejectMoreH = 0;
       H = Hnew;
 	 break; /* EXIT THE LOOP: WHILE STEP NOT ACCEPTED */
    } else {             /*~~~> Reject step  */
       if (Nacc >= 1) 
          Nrej++;    
+      /* Retry the same step with the Jacobian at T if it used an older one */
+      if (JacAge > 0) {
+         (*ode_Jac)(T,Y,Jac0);
+         JacAge = 0;
+         continue;
+      } /* end if */
       if (RejectMoreH) 
          Hnew=H*FacRej;   
       RejectMoreH = RejectLastH; RejectLastH = 1;
@@ -678,7 +906,7 @@ char ros_PrepareMatrix (
        /* Inout argument: (step size is decreased when LU fails) */  
            KPP_REAL* H, 
        /* Input arguments: */    
-           int Direction,  KPP_REAL gam, KPP_REAL Jac0[], 
+           int Direction,  KPP_REAL gam, KPP_REAL Jac0[], KPP_REAL FacMin,
        /* Output arguments: */	  
            KPP_REAL Ghimj[], int Pivot[] )
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -686,7 +914,9 @@ char ros_PrepareMatrix (
   1.  Construct Ghimj = 1/(H*ham) - Jac0
       "(Gamma H) Inverse Minus Jacobian"
   2.  Repeat LU decomposition of Ghimj until successful.
-       -half the step size if LU decomposition fails and retry
+       -if LU decomposition fails for a zero pivot in row k, reduce the
+        step size so that row k becomes diagonally dominant (Gershgorin
+        bound of row k of Jac0), by a factor between FacMin and 1/2
        -exit after 5 consecutive fails
 
   Return value:       Singular (true=1=failed_LU or false=0=successful_LU)
@@ -694,7 +924,7 @@ char ros_PrepareMatrix (
 {   
   /*~~~> Local variables */     
    int i, ising, Nconsecutive;
-   KPP_REAL ghinv;
+   KPP_REAL ghinv, Shift, Fac;
    
    Nconsecutive = 0;
    
@@ -713,11 +943,16 @@ char ros_PrepareMatrix (
   /*~~~>    if successful done  */
         return 0;  /* Singular = false */
      } else { /* ising .ne. 0 */
-  /*~~~>    if unsuccessful half the step size; if 5 consecutive fails return */
+  /*~~~>    if unsuccessful reduce the step size; if 5 consecutive fails return */
         Nsng++; Nconsecutive++;
         printf("\nWarning: LU Decomposition returned ising = %d\n",ising);
         if (Nconsecutive <= 5) { /* Less than 5 consecutive failed LUs */
-          *H = (*H)*HALF;
+          Fac = HALF;
+          Shift = KppRowShift( Jac0, ising-1 );
+          if ( (Direction > 0) && (Shift > ZERO) )
+            Fac = MIN(HALF,MAX(FacMin,HALF*ghinv/Shift));
+          *H = (*H)*Fac;
+          Nred++;
         } else {                  /* More than 5 consecutive failed LUs */
           return 1; /* Singular = true */
         } /* end if  Nconsecutive */
@@ -728,6 +963,32 @@ char ros_PrepareMatrix (
 }  /*  ros_PrepareMatrix */
 
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
+KPP_REAL ros_StepFactor ( 
+  /*~~~> Input arguments */  
+     int Controller, KPP_REAL Err, KPP_REAL ErrOld[], int Nhist,
+     KPP_REAL Hratio, KPP_REAL ros_ELO )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   Step size ratio Hnew/H, before the safety factor and the bounds, of
+   the controller acting on the step size ratio Hratio = H/Hold:
+     PI  (Controller=1, predictive controller of Gustafsson):
+         Hratio * (ErrOld[0]/Err^2)^(1/ELO)
+     PID (Controller=2): the PI ratio times the derivative term
+         (ErrOld[0]^2/(Err*ErrOld[1]))^(1/(4*ELO))
+   ErrOld[0:Nhist-1] are the errors of the previous accepted steps;
+   with Nhist = 1 the PID controller reduces to the PI controller.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
+{
+   KPP_REAL Fac;
+
+   Fac = Hratio*pow(Err*Err/ErrOld[0],-ONE/ros_ELO);
+   if ( (Controller == 2) && (Nhist >= 2) )
+      Fac = Fac*pow(ErrOld[0]*ErrOld[0]/(Err*ErrOld[1]),(KPP_REAL)0.25/ros_ELO);
+   return Fac;
+
+}  /*  ros_StepFactor */
+
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
 int ros_ErrorMsg(int Code, KPP_REAL T, KPP_REAL H)
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -754,6 +1015,12 @@ int ros_ErrorMsg(int Code, KPP_REAL T, KPP_REAL H)
       printf("--> Step size too small (T + H/10 = T) or H < Roundoff"); break;
    case -8:   
       printf("--> Matrix is repeatedly singular"); break;
+   case -9:   
+      printf("--> Selected linear solver not implemented"); break;
+   case -10:   
+      printf("--> Selected step size controller not implemented"); break;
+   case -11:   
+      printf("--> Jacobian reuse needs a W-method (Ros2 or Ros34PW2)"); break;
    default:
       printf("Unknown Error code: %d ",Code); 
    } /* end switch */
@@ -1140,6 +1407,83 @@ void Rodas4 ( int *ros_S, KPP_REAL ros_A[], KPP_REAL ros_C[],
 }  /*  Rodas4 */
 
    
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
+void Ros34pw2 ( int *ros_S, KPP_REAL ros_A[], KPP_REAL ros_C[], 
+             KPP_REAL ros_M[], KPP_REAL ros_E[], 
+	     KPP_REAL ros_Alpha[], KPP_REAL ros_Gamma[], 
+	     char ros_NewF[], KPP_REAL *ros_ELO, char* ros_Name )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~   
+     STIFFLY ACCURATE W-METHOD OF ORDER 3 (EMBEDDED 2), WITH 4 STAGES
+     The order is kept with an approximate (e.g. old) Jacobian
+
+      J. RANG AND L. ANGERMANN, NEW ROSENBROCK W-METHODS OF ORDER 3
+      FOR PARTIAL DIFFERENTIAL ALGEBRAIC EQUATIONS OF INDEX 1.
+      BIT NUMERICAL MATHEMATICS 45, 761-787 (2005)
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
+{
+  /*~~~> Name of the method */
+   strcpy(ros_Name, "ROS-34PW2");  
+   
+  /*~~~> Number of stages */
+    *ros_S = 4;
+
+  /*~~~> Y_stage_i ~ Y( T + H*Alpha_i ) */
+    ros_Alpha[0] = (KPP_REAL)0.0;
+    ros_Alpha[1] = (KPP_REAL)0.8717330430169180;
+    ros_Alpha[2] = (KPP_REAL)0.7315799577888524;
+    ros_Alpha[3] = (KPP_REAL)1.0;
+	
+  /*~~~> Gamma_i = \sum_j  gamma_{i,j}  */     
+    ros_Gamma[0] = (KPP_REAL)0.4358665215084590;
+    ros_Gamma[1] = (KPP_REAL)(-0.4358665215084590);
+    ros_Gamma[2] = (KPP_REAL)(-0.4133333762338865);
+    ros_Gamma[3] = (KPP_REAL)0.0;
+
+  /*~~~> The coefficient matrices A and C are strictly lower triangular.
+    The lower triangular (subdiagonal) elements are stored in row-wise order:
+    A(2,1) = ros_A[0], A(3,1)=ros_A[1], A(3,2)=ros_A[2], etc.
+    The general mapping formula is:  A_{i,j} = ros_A[ (i-1)*(i-2)/2 + j -1 ]  */
+    ros_A[0]  = (KPP_REAL)0.2000000000000000e+01;
+    ros_A[1]  = (KPP_REAL)0.1419217317455765e+01;
+    ros_A[2]  = (KPP_REAL)(-0.2592322116729698);
+    ros_A[3]  = (KPP_REAL)0.4184760482319161e+01;
+    ros_A[4]  = (KPP_REAL)(-0.2851920173554960);
+    ros_A[5]  = (KPP_REAL)0.2294280360279042e+01;
+
+  /*~~~>     C_{i,j} = ros_C[ (i-1)*(i-2)/2 + j -1]  */
+    ros_C[0]  = (KPP_REAL)(-0.4588560720558084e+01);
+    ros_C[1]  = (KPP_REAL)(-0.4184760482319161e+01);
+    ros_C[2]  = (KPP_REAL)( 0.2851920173554960);
+    ros_C[3]  = (KPP_REAL)(-0.6368179200128360e+01);
+    ros_C[4]  = (KPP_REAL)(-0.6795620944466837e+01);
+    ros_C[5]  = (KPP_REAL)( 0.2870098604331055e+01);
+
+  /*~~~> M_i  = Coefficients for new step solution */
+    ros_M[0] = ros_A[3];
+    ros_M[1] = ros_A[4];
+    ros_M[2] = ros_A[5];
+    ros_M[3] = (KPP_REAL)1.0;
+
+  /*~~~> E_i  = Coefficients for error estimator */   
+    ros_E[0] = (KPP_REAL)0.2777499476479686;
+    ros_E[1] = (KPP_REAL)(-0.1403239895175999e+01);
+    ros_E[2] = (KPP_REAL)0.1772630127667551e+01;
+    ros_E[3] = (KPP_REAL)0.5;
+
+  /*~~~> does the stage i require a new function evaluation (ros_NewF(i)=TRUE)
+    or does it re-use the function evaluation from stage i-1 (ros_NewF(i)=FALSE) */
+    ros_NewF[0] = 1;
+    ros_NewF[1] = 1;
+    ros_NewF[2] = 1;
+    ros_NewF[3] = 1;
+     
+  /*~~~> ros_ELO  = estimator of local order - the minimum between the
+!    main and the embedded scheme orders plus 1 */
+    *ros_ELO = (KPP_REAL)3.0;
+     
+}  /*  Ros34pw2 */
+
+   
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
 void DecompTemplate( KPP_REAL A[], int Pivot[], int* ising )
@@ -1147,7 +1491,22 @@ void DecompTemplate( KPP_REAL A[], int Pivot[], int* ising )
         Template for the LU decomposition   
 ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
 {   
-   *ising = KppDecomp ( A );
+   switch (ros_LinSolver) {
+     case 1: case 2:
+       *ising = KppILU0 ( A );
+       break;
+     case 3:
+     /* A is kept for the residuals of the refinement */
+       *ising = KppDecompSP ( A, ros_LUS );
+       ros_Mixed = (*ising == 0);
+       if (ros_Mixed) break;
+       Nfbk++;
+       Ndec++;
+       *ising = KppDecompLev ( A );
+       break;
+     default:
+       *ising = KppDecompLev ( A );
+   } /* end switch */
   /*~~~> Note: for a full matrix use Lapack:
       DGETRF( KPP_NVAR, KPP_NVAR, A, KPP_NVAR, Pivot, ising ) */
     
@@ -1161,7 +1520,7 @@ void DecompTemplate( KPP_REAL A[], int Pivot[], int* ising )
      Template for the forward/backward substitution (using pre-computed LU decomposition)   
 ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
 {   
-   KppSolve( A, b );
+   KppSolveLev( A, b );
   /*~~~> Note: for a full matrix use Lapack:
       NRHS = 1
       DGETRS( 'N', KPP_NVAR , NRHS, A, KPP_NVAR, Pivot, b, KPP_NVAR, INFO ) */
@@ -1171,6 +1530,85 @@ void DecompTemplate( KPP_REAL A[], int Pivot[], int* ising )
 }  /*  SolveTemplate */
 
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
+void ros_MixedSolve( KPP_REAL A[], int Pivot[], KPP_REAL W[], KPP_REAL b[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  
+     Solves A*x = b with the single precision factors of A and iterative
+     refinement.  If the refinement fails, A is decomposed in double
+     precision and used for the remaining stages of the step
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
+{   
+   if (ros_Mixed) {
+     if ( KppSolveMixed( A, ros_LUS, W, ros_KrylovTol, MixedMaxRef, b ) == 0 ) {
+       Nsol++;
+       return;
+     }
+     ros_Mixed = 0;
+     Nfbk++;
+     Ndec++;
+     if ( KppDecompLev( A ) ) Nsng++;
+   } /* end if */
+   SolveTemplate( A, Pivot, b );
+
+}  /*  ros_MixedSolve */
+
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
+char ros_KrylovSolve( KPP_REAL ghinv, KPP_REAL Jac0[], KPP_REAL Prec[],
+     KPP_REAL W[], char* NewPrec, KPP_REAL b[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~  
+     Solves (ghinv - Jac0)*x = b with the Krylov method ros_LinSolver,
+     preconditioned by Prec, an ILU(0) computed at this or an earlier step.
+     - more than KrylovRefresh iterations: a new ILU(0) at the next step
+     - no convergence: a new ILU(0) now and a second try, then the
+       sparse LU decomposition (which is kept as the preconditioner)
+
+  Return value:       Failed (true=1=singular matrix or false=0=solved)
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
+{   
+   KPP_REAL b0[KPP_NVAR];
+   int i, it = 0, ising, attempt;
+   
+   Nsol++;
+   WCOPY(KPP_NVAR,b,1,b0,1);
+   if ( KppKrylov(ros_LinSolver, ghinv, Jac0, Prec, W, ros_KrylovTol, b, &it) == 0 ) {
+      Nkry += it;
+      if (it > KrylovRefresh) *NewPrec = 1;
+      return 0;
+   }
+   Nkry += it;
+
+   for (attempt = 1; attempt <= 2; attempt++) {
+     WCOPY(KPP_LU_NONZERO,Jac0,1,Prec,1);
+     WSCAL(KPP_LU_NONZERO,(-ONE),Prec,1);
+     for (i=0; i<KPP_NVAR; i++)
+       Prec[LU_DIAG[i]] = Prec[LU_DIAG[i]]+ghinv;
+     WCOPY(KPP_NVAR,b0,1,b,1);
+     Ndec++;
+     if (attempt == 1) {
+       ising = KppILU0( Prec );
+       if (ising == 0) { 
+         it = 0;
+         ising = KppKrylov(ros_LinSolver, ghinv, Jac0, Prec, W, ros_KrylovTol, b, &it);
+         Nkry += it;
+         if (ising == 0) return 0;
+       }
+     } else {
+       ising = KppDecompLev( Prec );
+       if (ising == 0) {
+         KppSolveLev( Prec, b );
+         return 0;
+       }
+     } /* end if attempt */
+   } /* for attempt */
+
+   Nsng++;
+   *NewPrec = 1;
+   return 1;
+
+}  /*  ros_KrylovSolve */
+
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/   
 void FunTemplate( KPP_REAL T, KPP_REAL Y[], KPP_REAL Ydot[] )
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ 
@@ -25,7 +25,7 @@ MODULE KPP_ROOT_Integrator
   
 !~~~>  Statistics on the work performed by the Rosenbrock method
   INTEGER, PARAMETER :: Nfun=1, Njac=2, Nstp=3, Nacc=4, &
-                        Nrej=5, Ndec=6, Nsol=7, Nsng=8, &
+                        Nrej=5, Ndec=6, Nsol=7, Nsng=8, Nfbk=9, &
                         Ntexit=1, Nhexit=2, Nhnew = 3
 
 CONTAINS
@@ -48,6 +48,7 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
    INTEGER       :: ICNTRL(20), ISTATUS(20), IERR
 
    INTEGER, SAVE :: Ntotal = 0
+!$OMP THREADPRIVATE(Ntotal)
 
    ICNTRL(:)  = 0
    RCNTRL(:)  = 0.0_dp
@@ -159,6 +160,14 @@ SUBROUTINE Rosenbrock(N,Y,Tstart,Tend, &
 !    ICNTRL(4)  -> maximum number of integration steps
 !        For ICNTRL(4)=0) the default value of 100000 is used
 !
+!    ICNTRL(5)  -> linear algebra (sparse only, not with FULL_ALGEBRA)
+!        = 0 :    LU decomposition in double precision (default)
+!        = 1 :    LU decomposition in single precision; the solves are
+!                 refined with residuals in double precision, at most
+!                 twice, until they meet RCNTRL(8).  If the refinement
+!                 fails, the matrix is decomposed in double precision
+!                 for the remaining stages of the step
+!
 !    RCNTRL(1)  -> Hmin, lower bound for the integration step size
 !          It is strongly recommended to keep Hmin = ZERO
 !    RCNTRL(2)  -> Hmax, upper bound for the integration step size
@@ -170,6 +179,9 @@ SUBROUTINE Rosenbrock(N,Y,Tstart,Tend, &
 !                          (default=0.1)
 !    RCNTRL(7)  -> FacSafe, by which the new step is slightly smaller
 !         than the predicted value  (default=0.9)
+!    RCNTRL(8)  -> MixedTol, for ICNTRL(5) = 1: the refinement stops when
+!         the residual, times H*gamma and scaled by AbsTol+RelTol*|Y|,
+!         has an RMS norm below MixedTol (default=0.01)
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 !
 !
@@ -193,6 +205,8 @@ SUBROUTINE Rosenbrock(N,Y,Tstart,Tend, &
 !    ISTATUS(6)  -> No. of LU decompositions
 !    ISTATUS(7)  -> No. of forward/backward substitutions
 !    ISTATUS(8)  -> No. of singular matrix decompositions
+!    ISTATUS(9)  -> No. of single precision LU decompositions that fell
+!                   back to double precision (ICNTRL(5) = 1)
 !
 !    RSTATUS(1)  -> Texit, the time corresponding to the
 !                     computed Y upon return
@@ -230,12 +244,18 @@ SUBROUTINE Rosenbrock(N,Y,Tstart,Tend, &
    KPP_REAL :: Texit
    INTEGER       :: i, UplimTol, Max_no_steps
    LOGICAL       :: Autonomous, VectorTol
+!~~~>  Mixed precision (ICNTRL(5) = 1): the single precision factors LUS,
+!      in use (ros_Mixed) until a refinement fails
+   LOGICAL       :: MixedLU, ros_Mixed
+   REAL(kind=sp) :: LUS(LU_NONZERO)
+   KPP_REAL :: MixedTol
+   INTEGER, PARAMETER :: MixedMaxRef = 2
 !~~~>   Parameters
    KPP_REAL, PARAMETER :: ZERO = 0.0_dp, ONE  = 1.0_dp
    KPP_REAL, PARAMETER :: DeltaMin = 1.0E-5_dp
 
 !~~~>  Initialize statistics
-   ISTATUS(1:8) = 0
+   ISTATUS(1:9) = 0
    RSTATUS(1:3) = ZERO
 
 !~~~>  Autonomous or time dependent ODE. Default is time dependent.
@@ -282,6 +302,23 @@ SUBROUTINE Rosenbrock(N,Y,Tstart,Tend, &
       RETURN
    END IF
 
+!~~~>  Double or mixed precision linear algebra
+   SELECT CASE (ICNTRL(5))
+     CASE (0)
+       MixedLU = .FALSE.
+     CASE (1)
+#ifdef FULL_ALGEBRA    
+       MixedLU = .FALSE.
+#else
+       MixedLU = .TRUE.
+#endif
+     CASE DEFAULT
+       PRINT * , 'User-selected linear algebra: ICNTRL(5)=',ICNTRL(5)
+       CALL ros_ErrorMsg(-9,Tstart,ZERO,IERR)
+       RETURN
+   END SELECT
+   ros_Mixed = .FALSE.
+
 !~~~>  Unit roundoff (1+Roundoff>1)
    Roundoff = WLAMCH('E')
 
@@ -354,6 +391,16 @@ SUBROUTINE Rosenbrock(N,Y,Tstart,Tend, &
       CALL ros_ErrorMsg(-4,Tstart,ZERO,IERR)
       RETURN
    END IF
+!~~~>   MixedTol: Stopping criterion of the iterative refinement
+   IF (RCNTRL(8) == ZERO) THEN
+      MixedTol = 0.01_dp
+   ELSEIF (RCNTRL(8) > ZERO) THEN
+      MixedTol = RCNTRL(8)
+   ELSE
+      PRINT * , 'User-selected MixedTol: RCNTRL(8)=', RCNTRL(8)
+      CALL ros_ErrorMsg(-5,Tstart,ZERO,IERR)
+      RETURN
+   END IF
 !~~~>  Check if tolerances are reasonable
     DO i=1,UplimTol
       IF ( (AbsTol(i) <= ZERO) .OR. (RelTol(i) <= 10.0_dp*Roundoff) &
@@ -412,6 +459,8 @@ CONTAINS !  SUBROUTINES internal to Rosenbrock
             ' or H < Roundoff'
     CASE (-8)    
       PRINT * , '--> Matrix is repeatedly singular'
+    CASE (-9)    
+      PRINT * , '--> Selected linear algebra not implemented'
     CASE DEFAULT
       PRINT *, 'Unknown Error code: ', Code
    END SELECT
@@ -461,7 +510,7 @@ CONTAINS !  SUBROUTINES internal to Rosenbrock
    KPP_REAL :: Jac0(LU_NONZERO), Ghimj(LU_NONZERO)
 #endif
    KPP_REAL :: H, Hnew, HC, HG, Fac, Tau
-   KPP_REAL :: Err, Yerr(N)
+   KPP_REAL :: Err, Yerr(N), Wmix(N)
    INTEGER :: Pivot(N), Direction, ioffset, j, istage
    LOGICAL :: RejectLastH, RejectMoreH, Singular
 !~~~>  Local parameters
@@ -529,6 +578,15 @@ UntilAccepted: DO
        CALL ros_ErrorMsg(-8,T,H,IERR)
        RETURN
    END IF
+   IF (MixedLU) THEN ! Weights of the refinement residual
+     DO j=1,N
+       IF (VectorTol) THEN
+         Wmix(j) = ABS(H*ros_Gamma(1))/(AbsTol(j)+RelTol(j)*ABS(Y(j)))
+       ELSE
+         Wmix(j) = ABS(H*ros_Gamma(1))/(AbsTol(1)+RelTol(1)*ABS(Y(j)))
+       END IF
+     END DO
+   END IF
 
 !~~~>   Compute the stages
 Stage: DO istage = 1, ros_S
@@ -562,7 +620,11 @@ Stage: DO istage = 1, ros_S
          HG = Direction*H*ros_Gamma(istage)
          CALL WAXPY(N,HG,dFdT,1,K(ioffset+1),1)
        END IF
-       CALL ros_Solve(Ghimj, Pivot, K(ioffset+1))
+       IF (MixedLU) THEN
+         CALL ros_MixedSolve(Ghimj, Pivot, Wmix, K(ioffset+1))
+       ELSE
+         CALL ros_Solve(Ghimj, Pivot, K(ioffset+1))
+       END IF
 
    END DO Stage
 
@@ -783,7 +845,18 @@ Stage: DO istage = 1, ros_S
 #ifdef FULL_ALGEBRA    
    CALL  DGETRF( N, N, A, N, Pivot, ISING )
 #else   
-   CALL KppDecomp ( A, ISING )
+   IF (MixedLU) THEN
+!~~~>  A is kept for the residuals of the refinement
+      CALL KppDecompSP ( A, LUS, ISING )
+      ros_Mixed = (ISING == 0)
+      IF (.NOT.ros_Mixed) THEN
+         ISTATUS(Nfbk) = ISTATUS(Nfbk) + 1
+         ISTATUS(Ndec) = ISTATUS(Ndec) + 1
+         CALL KppDecomp ( A, ISING )
+      END IF
+   ELSE
+      CALL KppDecomp ( A, ISING )
+   END IF
    Pivot(1) = 1
 #endif
    ISTATUS(Ndec) = ISTATUS(Ndec) + 1
@@ -822,6 +895,45 @@ Stage: DO istage = 1, ros_S
   END SUBROUTINE ros_Solve
 
 
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  SUBROUTINE ros_MixedSolve( A, Pivot, W, b )
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!  Solves A*x = b with the single precision factors of A and iterative
+!  refinement.  If the refinement fails, A is decomposed in double
+!  precision and used for the remaining stages of the step
+!~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   IMPLICIT NONE
+!~~~> Inout variables
+#ifdef FULL_ALGEBRA    
+   KPP_REAL, INTENT(INOUT) :: A(N,N)
+#else   
+   KPP_REAL, INTENT(INOUT) :: A(LU_NONZERO)
+#endif
+   INTEGER, INTENT(IN) :: Pivot(N)
+   KPP_REAL, INTENT(IN) :: W(N)
+   KPP_REAL, INTENT(INOUT) :: b(N)
+!~~~> Local variables
+   INTEGER :: ISING
+
+#ifndef FULL_ALGEBRA    
+   IF (ros_Mixed) THEN
+      CALL KppSolveMixed( A, LUS, W, MixedTol, MixedMaxRef, b, ISING )
+      IF (ISING == 0) THEN
+         ISTATUS(Nsol) = ISTATUS(Nsol) + 1
+         RETURN
+      END IF
+      ros_Mixed = .FALSE.
+      ISTATUS(Nfbk) = ISTATUS(Nfbk) + 1
+      ISTATUS(Ndec) = ISTATUS(Ndec) + 1
+      CALL KppDecomp ( A, ISING )
+      IF (ISING /= 0) ISTATUS(Nsng) = ISTATUS(Nsng) + 1
+   END IF
+#endif
+   CALL ros_Solve( A, Pivot, b )
+
+  END SUBROUTINE ros_MixedSolve
+
+
 
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   SUBROUTINE Ros2
@@ -88,6 +88,8 @@ int ros_PrepareMatrix ( KPP_REAL H, int Direction, KPP_REAL gam,
 void ros_Decomp( KPP_REAL A[], int Pivot[], int* ising, int ISTATUS[] );
 void ros_Solve( char How, KPP_REAL A[], int Pivot[], KPP_REAL b[], 
 		int ISTATUS[] );
+void ros_HessPos( int HesPos[] );
+void ros_HessMat( KPP_REAL Hes[], int HesPos[], KPP_REAL U[], KPP_REAL HU[] );
 void ros_cadj_Y( KPP_REAL T, KPP_REAL Y[] );
 void ros_Hermite3( KPP_REAL a, KPP_REAL b, KPP_REAL T, KPP_REAL Ya[], 
 		   KPP_REAL Yb[], KPP_REAL Ja[], KPP_REAL Jb[], KPP_REAL Y[] );
@@ -117,6 +119,8 @@ void HessTR_Vec(KPP_REAL Hess[], KPP_REAL U1[], KPP_REAL U2[], KPP_REAL HTU[]);
 void KppSolve( KPP_REAL A[], KPP_REAL b[] );
 int KppDecomp( KPP_REAL A[] );
 void KppSolveTR( KPP_REAL JVS[], KPP_REAL X[], KPP_REAL XX[] );
+void KppSolveTR_Multi( KPP_REAL JVS[], int NRHS, KPP_REAL X[] );
+void JacTR_SP_Mat( KPP_REAL JVS[], int NRHS, KPP_REAL U[], KPP_REAL JTU[] );
 void Hessian( KPP_REAL V[], KPP_REAL F[], KPP_REAL RCT[], KPP_REAL Hess[] );
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
@@ -1187,24 +1191,35 @@ int ros_DadjInt ( int NADJ, KPP_REAL Lambda[][NVAR], KPP_REAL Tstart,
 
 /*~~~~ Local variables */
   KPP_REAL Ystage[NVAR*ros_S], K[NVAR*ros_S];
-  KPP_REAL U[NADJ][NVAR*ros_S], V[NADJ][NVAR*ros_S];
+  KPP_REAL U[NVAR*NADJ*ros_S], V[NVAR*NADJ*ros_S];
+  KPP_REAL Lam[NVAR*NADJ], Tmp[NVAR*NADJ], Tmp2[NVAR*NADJ];
 #ifdef FULL_ALGEBRA
   KPP_REAL Jac[NVAR][NVAR], dJdT[NVAR][NVAR], Ghimj[NVAR][NVAR];
 #else
   KPP_REAL Jac[LU_NONZERO], dJdT[LU_NONZERO], Ghimj[LU_NONZERO];
 #endif
-  KPP_REAL Hes0[NHESS];
-  KPP_REAL Tmp[NVAR], Tmp2[NVAR];
+  KPP_REAL Hes0[NHESS], HesK[LU_NONZERO];
   KPP_REAL H=0.0, HC, HA, Tau;
+  int HesPos[2*NHESS];
   int Pivot[NVAR], Direction;
-  int i, j, m, istage, istart, jstart;
+  int i, j, m, NA, istage, istart, jstart;
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 
   if (Tend  >=  Tstart)
     Direction = 1;
   else
     Direction = -1;
-  
+
+/*~~~> The NADJ adjoint vectors are carried together: Lam[i*NADJ+m]
+       holds Lambda[m][i], so that each row of the LU factors and of the
+       Jacobians is read once per stage for all of them */
+  NA = NVAR*NADJ;
+  for (m = 0; m < NADJ; m++) {
+    for (i = 0; i < NVAR; i++)
+      Lam[i*NADJ+m] = Lambda[m][i];
+  }
+  ros_HessPos( HesPos );
+
   /*~~~> Time loop begins below */
   while ( stack_ptr > 0 ) { /* TimeLoop */
 
@@ -1238,37 +1253,27 @@ int ros_DadjInt ( int NADJ, KPP_REAL Lambda[][NVAR], KPP_REAL Tstart,
     for (istage = ros_S - 1; istage >= 0; istage--) { /* Stage loop */
 
       /*~~~> Current istage first entry */
-      istart = NVAR*istage;
-	 
+      istart = NA*istage;
+
       /*~~~> Compute U */
-      for (m = 0; m<NADJ; m++) {
-	WCOPY(NVAR,&Lambda[m][0],1,&U[m][istart],1);
-	WSCAL(NVAR,ros_M[istage],&U[m][istart],1);
-      } /* m=0:NADJ-1 */
+      WCOPY(NA,Lam,1,&U[istart],1);
+      WSCAL(NA,ros_M[istage],&U[istart],1);
       for (j = istage+1; j < ros_S; j++) {
-	jstart = NVAR*j;
+	jstart = NA*j;
 	HA = ros_A[j*(j-1)/2+istage];
 	HC = ros_C[j*(j-1)/2+istage]/(Direction*H);
-	for ( m = 0; m < NADJ; m++ ) {
-	  WAXPY(NVAR,HA,&V[m][jstart],1,&U[m][istart],1);
-	  WAXPY(NVAR,HC,&U[m][jstart],1,&U[m][istart],1);
-	} /* m=0:NADJ-1 */
+	WAXPY(NA,HA,&V[jstart],1,&U[istart],1);
+	WAXPY(NA,HC,&U[jstart],1,&U[istart],1);
       }
-      for ( m = 0; m < NADJ; m++ )
-	ros_Solve('T', Ghimj, Pivot, &U[m][istart], ISTATUS); /* m=1:NADJ-1 */
+      /* One transposed solve for all the adjoint vectors */
+      KppSolveTR_Multi( Ghimj, NADJ, &U[istart] );
+      ISTATUS[Nsol]++;
 
       /*~~~> Compute V */
       Tau = T + ros_Alpha[istage]*Direction*H;
-      JacTemplate(Tau,&Ystage[istart],Jac);
+      JacTemplate(Tau,&Ystage[NVAR*istage],Jac);
       ISTATUS[Njac]++;
-      for ( m = 0; m < NADJ; m++ ) {
-#ifdef FULL_ALGEBRA
-	for (i=istart; i < istart+NVAR-1; i++ )
-	  V[[m][i] = MATMUL(TRANSPOSE(Jac),U[m][i]];
-#else
-	JacTR_SP_Vec(Jac,&U[m][istart],&V[m][istart]); 
-#endif
-      } /* m=0:NADJ-1 */
+      JacTR_SP_Mat( Jac, NADJ, &U[istart], &V[istart] );
     } /*End of Stage loop */
 
     if (!Autonomous)
@@ -1277,39 +1282,34 @@ int ros_DadjInt ( int NADJ, KPP_REAL Lambda[][NVAR], KPP_REAL Tstart,
       ros_JacTimeDerivative ( T, Roundoff, &Ystage[0], Jac, dJdT, ISTATUS );
 
 /*~~~>  Compute the new solution */
-    /*~~~>  Compute Lambda */ 
+    /*~~~>  Compute Lambda */
     for( istage = 0; istage < ros_S; istage++ ) {
-      istart = NVAR*istage;
-      for (m = 0; m < NADJ; m++) {
-	/* Add V_i */
-	WAXPY(NVAR,ONE,&V[m][istart],1,&Lambda[m][0],1);
-	/* Add (H0xK_i)^T * U_i */
-	HessTR_Vec ( Hes0, &U[m][istart], &K[istart], Tmp );
-	WAXPY(NVAR,ONE,Tmp,1,&Lambda[m][0],1);
-      } /* m=0:NADJ-1 */
+      istart = NA*istage;
+      /* Add V_i */
+      WAXPY(NA,ONE,&V[istart],1,Lam,1);
+      /* Add (H0xK_i)^T * U_i */
+      ros_HessMat( Hes0, HesPos, &K[NVAR*istage], HesK );
+      JacTR_SP_Mat( HesK, NADJ, &U[istart], Tmp );
+      WAXPY(NA,ONE,Tmp,1,Lam,1);
     }
 
     /* Add H * dJac_dT_0^T * \sum(gamma_i U_i) */
     /* Tmp holds sum gamma_i U_i */
     if (!Autonomous) {
-      for( m = 0; m < NADJ; m++ ) {
-	for(i=0; i<NVAR; i++)
-	  Tmp[i] = ZERO;
-	for( istage = 0; istage < ros_S; istage++ ) {
-	  istart = NVAR*istage;
-	  WAXPY(NVAR,ros_Gamma[istage],&U[m][istart],1,Tmp,1);
-	}
-#ifdef FULL_ALGEBRA
-	Tmp2 = MATMUL(TRANSPOSE(dJdT),Tmp);
-#else
-	JacTR_SP_Vec(dJdT,Tmp,Tmp2);
-#endif
-	WAXPY(NVAR,H,Tmp2,1,&Lambda[m][0],1);
-      } /* m=0:NADJ-1 */
+      WSCAL(NA,ZERO,Tmp,1);
+      for( istage = 0; istage < ros_S; istage++ )
+	WAXPY(NA,ros_Gamma[istage],&U[NA*istage],1,Tmp,1);
+      JacTR_SP_Mat( dJdT, NADJ, Tmp, Tmp2 );
+      WAXPY(NA,H,Tmp2,1,Lam,1);
     } /* .NOT.Autonomous */
   } /* End of TimeLoop */
 
   /*~~~> Save last state */
+  for (m = 0; m < NADJ; m++) {
+    for (i = 0; i < NVAR; i++)
+      Lambda[m][i] = Lam[i*NADJ+m];
+  }
+
   /*~~~> Succesful exit */
   return 1;  /*~~~> The integration was successful */
 
@@ -1911,6 +1911,58 @@ void ros_Solve( char How, KPP_REAL A[], int Pivot[], KPP_REAL b[],
 
 } /* End of ros_Solve */
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void ros_HessPos( int HesPos[] ) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+~~~> For the Hessian element m = d^2 f_i / dv_j dv_k, the positions of
+     (i,j) and (i,k) in the sparse Jacobian: HesPos[2*m], HesPos[2*m+1].
+     A Hessian element couples i to j and to k, so both are in the
+     sparsity pattern of the Jacobian, whose rows have sorted columns
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~> Local variables */
+  int m, n, c, lo, hi, mid;
+
+  for(m=0; m<NHESS; m++) {
+    for(n=0; n<2; n++) {
+      c  = (n == 0) ? IHESS_J[m] : IHESS_K[m];
+      lo = LU_CROW[IHESS_I[m]];
+      hi = LU_CROW[IHESS_I[m]+1]-1;
+      while (lo < hi) {
+	mid = (lo+hi)/2;
+	if (LU_ICOL[mid] < c)
+	  lo = mid+1;
+	else
+	  hi = mid;
+      }
+      HesPos[2*m+n] = lo;
+    }
+  }
+
+} /* End of ros_HessPos */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void ros_HessMat( KPP_REAL Hes[], int HesPos[], KPP_REAL U[],
+		  KPP_REAL HU[] ) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+~~~> The Hessian contracted with the vector U, in the sparse Jacobian
+     format: HU(i,j) = sum_k d^2 f_i / dv_j dv_k * U(k).  For any V,
+     Jac_SP_Vec( HU, V ) equals Hess_Vec( Hes, U, V ) and
+     JacTR_SP_Vec( HU, V ) equals HessTR_Vec( Hes, V, U )
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~> Local variables */
+  int m;
+
+  WSCAL(LU_NONZERO,ZERO,HU,1);
+  for(m=0; m<NHESS; m++) {
+    HU[HesPos[2*m]] += Hes[m]*U[IHESS_K[m]];
+    if (IHESS_J[m] != IHESS_K[m])
+      HU[HesPos[2*m+1]] += Hes[m]*U[IHESS_J[m]];
+  }
+
+} /* End of ros_HessMat */
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 void ros_cadj_Y( KPP_REAL T, KPP_REAL Y[] ) {
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
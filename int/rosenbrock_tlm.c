@@ -0,0 +1,1350 @@
+#define MAX(a,b) ( ((a) >= (b)) ? (a):(b)  )
+#define MIN(b,c) ( ((b) < (c))  ? (b):(c)  )
+#define ABS(x)	 ( ((x) >= 0 )  ? (x):(-x) )
+#define SQRT(d)  ( pow((d),0.5) )
+
+/* Numerical Constants */
+#define ZERO	    (KPP_REAL)0.0
+#define ONE	    (KPP_REAL)1.0
+#define HALF        (KPP_REAL)0.5
+#define DeltaMin    (KPP_REAL)1.0e-5
+enum boolean { FALSE=0, TRUE=1 };
+
+/*  Statistics on the work performed by the Rosenbrock method */
+enum statistics { Nfun=1, Njac=2, Nstp=3, Nacc=4, Nrej=5, Ndec=6, Nsol=7,
+		  Nsng=8, Nhes=9, Ntexit=1, Nhexit=2, Nhnew=3 };
+
+/*~~~>  Parameters of the Rosenbrock method, up to 6 stages */
+int ros_S, rosMethod;
+enum ros_Params { RS2=1, RS3=2, RS4=3, RD3=4, RD4=5 };
+KPP_REAL ros_A[15], ros_C[15], ros_M[6], ros_E[6], ros_Alpha[6], ros_Gamma[6],
+       ros_ELO;
+int ros_NewF[6]; /* Holds Boolean values */
+char ros_Name[12]; /* Length 12 */
+
+/* Function Headers */
+void INTEGRATE_TLM( int NTLM, KPP_REAL Y[], KPP_REAL Y_tlm[][NVAR],
+		    KPP_REAL TIN, KPP_REAL TOUT, KPP_REAL ATOL_tlm[][NVAR],
+		    KPP_REAL RTOL_tlm[][NVAR], int ICNTRL_U[],
+		    KPP_REAL RCNTRL_U[], int ISTATUS_U[], KPP_REAL RSTATUS_U[] );
+int RosenbrockTLM( KPP_REAL Y[], int NTLM, KPP_REAL Y_tlm[],
+		   KPP_REAL Tstart, KPP_REAL Tend, KPP_REAL AbsTol[],
+		   KPP_REAL RelTol[], KPP_REAL AbsTol_tlm[],
+		   KPP_REAL RelTol_tlm[], KPP_REAL RCNTRL[],
+		   int ICNTRL[], KPP_REAL RSTATUS[], int ISTATUS[] );
+int ros_ErrorMsg( int Code, KPP_REAL T, KPP_REAL H );
+int ros_TlmInt ( KPP_REAL Y[], int NTLM, KPP_REAL Y_tlm[], KPP_REAL Tstart,
+		 KPP_REAL Tend, KPP_REAL AbsTol[], KPP_REAL RelTol[],
+		 KPP_REAL AbsTol_tlm[], KPP_REAL RelTol_tlm[],
+		 KPP_REAL Hmin, KPP_REAL Hstart, KPP_REAL Hmax,
+		 KPP_REAL Roundoff, int ISTATUS[], int Max_no_steps,
+		 KPP_REAL RSTATUS[], int Autonomous, int VectorTol,
+		 int TLMtruncErr, KPP_REAL FacMax, KPP_REAL FacMin,
+		 KPP_REAL FacSafe, KPP_REAL FacRej );
+KPP_REAL ros_ErrorNorm ( KPP_REAL Y[], KPP_REAL Ynew[], KPP_REAL Yerr[],
+		       KPP_REAL AbsTol[], KPP_REAL RelTol[], int VectorTol );
+KPP_REAL ros_ErrorNorm_tlm ( int NTLM, KPP_REAL Y_tlm[], KPP_REAL Ynew_tlm[],
+		       KPP_REAL K_tlm[], KPP_REAL AbsTol_tlm[],
+		       KPP_REAL RelTol_tlm[], KPP_REAL Fwd_Err, int VectorTol );
+void ros_FunTimeDerivative ( KPP_REAL T, KPP_REAL Roundoff, KPP_REAL Y[],
+			     KPP_REAL Fcn0[], KPP_REAL dFdT[], int ISTATUS[] );
+void ros_JacTimeDerivative ( KPP_REAL T, KPP_REAL Roundoff, KPP_REAL Y[],
+			     KPP_REAL Jac0[], KPP_REAL dJdT[], int ISTATUS[] );
+int ros_PrepareMatrix ( KPP_REAL* H, int Direction, KPP_REAL gam,
+			KPP_REAL Jac0[], KPP_REAL Ghimj[], int ISTATUS[] );
+void ros_HessPos( int HesPos[] );
+void ros_HessMat( KPP_REAL Hes[], int HesPos[], KPP_REAL U[], KPP_REAL HU[] );
+void Ros2();
+void Ros3();
+void Ros4();
+void Rodas3();
+void Rodas4();
+void JacTemplate( KPP_REAL T, KPP_REAL Y[], KPP_REAL Jcb[] );
+void HessTemplate( KPP_REAL T, KPP_REAL Y[], KPP_REAL Hes[] );
+void FunTemplate( KPP_REAL T, KPP_REAL Y[], KPP_REAL Fun [] );
+void WSCAL( int N, KPP_REAL Alpha, KPP_REAL X[], int incX );
+void WAXPY( int N, KPP_REAL Alpha, KPP_REAL X[], int incX, KPP_REAL Y[],
+	    int incY );
+void WCOPY( int N, KPP_REAL X[], int incX, KPP_REAL Y[], int incY );
+KPP_REAL WLAMCH( char C );
+void Update_SUN();
+void Update_RCONST();
+void Fun( KPP_REAL Y[], KPP_REAL FIX[], KPP_REAL RCONST[], KPP_REAL Ydot[] );
+void Jac_SP( KPP_REAL Y[], KPP_REAL FIX[], KPP_REAL RCONST[], KPP_REAL Ydot[]);
+void Jac_SP_Mat( KPP_REAL JVS[], int NRHS, KPP_REAL U[], KPP_REAL JU[] );
+void KppSolve( KPP_REAL A[], KPP_REAL b[] );
+void KppSolve_Multi( KPP_REAL JVS[], int NRHS, KPP_REAL X[] );
+int KppDecomp( KPP_REAL A[] );
+void Hessian( KPP_REAL V[], KPP_REAL F[], KPP_REAL RCT[], KPP_REAL Hess[] );
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void INTEGRATE_TLM( int NTLM, KPP_REAL Y[], KPP_REAL Y_tlm[][NVAR],
+		    KPP_REAL TIN, KPP_REAL TOUT, KPP_REAL ATOL_tlm[][NVAR],
+		    KPP_REAL RTOL_tlm[][NVAR], int ICNTRL_U[],
+		    KPP_REAL RCNTRL_U[], int ISTATUS_U[],
+		    KPP_REAL RSTATUS_U[] ) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Y_tlm[j][0:NVAR-1] holds the sensitivities of Y w.r.t. the j-th
+    parameter, j = 0..NTLM-1.  The integrator works on copies that keep
+    the NTLM directions of each species together (index i*NTLM+j)
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*  Local Variables */
+  KPP_REAL RCNTRL[20], RSTATUS[20];
+  KPP_REAL *Yw, *ATOLw, *RTOLw;
+  int ICNTRL[20], ISTATUS[20], IERR, i, j;
+
+  for( i = 0; i < 20; i++ ) {
+    ICNTRL[i]  = 0;
+    RCNTRL[i]  = ZERO;
+    ISTATUS[i] = 0;
+    RSTATUS[i] = ZERO;
+  }
+
+/*~~~> fine-tune the integrator:
+  ICNTRL[0]  = 0      ! 0 = non-autonomous, 1 = autonomous
+  ICNTRL[1]  = 1      ! 0 = vector, 1 = scalar tolerances
+  ICNTRL[2]  = 5      ! choice of the method
+  ICNTRL[11] = 1      ! 0 = forward truncation error only, 1 = with TLM
+  RCNTRL[2]  = STEPMIN ! starting step */
+  ICNTRL[1]  = 1;
+  ICNTRL[2]  = 5;
+  ICNTRL[11] = 1;
+  RCNTRL[2]  = STEPMIN;
+
+/* if optional parameters are given, and if they are >=0, then they overwrite
+   default settings */
+  if (ICNTRL_U != NULL) {
+    for(i=0; i<20; i++)
+      if (ICNTRL_U[i] >= 0)
+	ICNTRL[i] = ICNTRL_U[i];
+  }
+  if (RCNTRL_U != NULL) {
+    for(i=0; i<20; i++)
+      if (RCNTRL_U[i] >= 0)
+	RCNTRL[i] = RCNTRL_U[i];
+  }
+
+  Yw    = (KPP_REAL*) malloc(NVAR*NTLM*sizeof(KPP_REAL));
+  ATOLw = (KPP_REAL*) malloc(NVAR*NTLM*sizeof(KPP_REAL));
+  RTOLw = (KPP_REAL*) malloc(NVAR*NTLM*sizeof(KPP_REAL));
+  if ( (Yw == NULL) || (ATOLw == NULL) || (RTOLw == NULL) ) {
+    printf( "Allocation of the TLM work arrays failed" );
+    exit(0);
+  }
+  for(j=0; j<NTLM; j++) {
+    for(i=0; i<NVAR; i++) {
+      Yw[i*NTLM+j]    = Y_tlm[j][i];
+      ATOLw[i*NTLM+j] = ATOL_tlm[j][i];
+      RTOLw[i*NTLM+j] = RTOL_tlm[j][i];
+    }
+  }
+
+  IERR = RosenbrockTLM( Y, NTLM, Yw, TIN, TOUT, ATOL, RTOL, ATOLw, RTOLw,
+			RCNTRL, ICNTRL, RSTATUS, ISTATUS );
+
+  if (IERR < 0)
+    printf( "RosenbrockTLM: Unsucessful step at T=%f (IERR=%d)", TIN, IERR );
+
+  for(j=0; j<NTLM; j++) {
+    for(i=0; i<NVAR; i++)
+      Y_tlm[j][i] = Yw[i*NTLM+j];
+  }
+  free(Yw); free(ATOLw); free(RTOLw);
+
+  STEPMIN = RSTATUS[Nhexit];
+
+/* if optional parameters are given for output
+   copy to them to return information */
+  if (ISTATUS_U != NULL) {
+    for(i=0; i<20; i++)
+      ISTATUS_U[i] = ISTATUS[i];
+  }
+  if (RSTATUS_U != NULL) {
+    for(i=0; i<20; i++)
+      RSTATUS_U[i] = RSTATUS[i];
+  }
+
+} /* End of INTEGRATE_TLM */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int RosenbrockTLM( KPP_REAL Y[], int NTLM, KPP_REAL Y_tlm[],
+		   KPP_REAL Tstart, KPP_REAL Tend, KPP_REAL AbsTol[],
+		   KPP_REAL RelTol[], KPP_REAL AbsTol_tlm[],
+		   KPP_REAL RelTol_tlm[], KPP_REAL RCNTRL[],
+		   int ICNTRL[], KPP_REAL RSTATUS[], int ISTATUS[] ) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+    TLM = Tangent Linear Model of a Rosenbrock Method
+
+    Solves the system y'=F(t,y) using a Rosenbrock method defined by:
+
+     G = 1/(H*gamma(1)) - Jac(t0,Y0)
+     T_i = t0 + Alpha(i)*H
+     Y_i = Y0 + \sum_{j=1}^{i-1} A(i,j)*K_j
+     G * K_i = Fun( T_i, Y_i ) + \sum_{j=1}^S C(i,j)/H * K_j +
+         gamma(i)*dF/dT(t0, Y0)
+     Y1 = Y0 + \sum_{j=1}^S M(j)*K_j
+
+    and, with the same LU factorization of G, its tangent linear model
+
+     G * K_tlm_i = Jac(T_i,Y_i)*Y_tlm_i + \sum_{j=1}^S C(i,j)/H * K_tlm_j
+         + Hess(t0,Y0) x (K_i,Y_tlm_0) + gamma(i)*dJ/dT(t0,Y0)*Y_tlm_0
+
+    for the NTLM directions at once.  Each row of the factors of G is
+    read once per stage for all directions (KppSolve_Multi), and the
+    Hessian term is contracted with K_i once, into a matrix with the
+    sparsity of the Jacobian, for all directions.
+
+    For details on Rosenbrock methods and their implementation consult:
+      E. Hairer and G. Wanner
+      "Solving ODEs II. Stiff and differential-algebraic problems".
+      Springer series in computational mathematics, Springer-Verlag, 1996.
+    The codes contained in the book inspired this implementation.
+
+    (C)  Adrian Sandu, August 2004
+    Virginia Polytechnic Institute and State University
+    Contact: sandu@cs.vt.edu
+    Translation of the Fortran90 version, with batched directions
+    This implementation is part of KPP - the Kinetic PreProcessor
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+~~~>   INPUT ARGUMENTS:
+
+-     Y[NVAR]    = vector of initial conditions (at T=Tstart)
+      NTLM       -> dimension of linearized system,
+                   i.e. the number of sensitivity coefficients
+-     Y_tlm[NVAR*NTLM] -> initial sensitivities (at T=Tstart),
+                   Y_tlm[i*NTLM+j] for species i and direction j
+-    [Tstart,Tend]  = time range of integration
+     (if Tstart>Tend the integration is performed backwards in time)
+-    RelTol, AbsTol = user precribed accuracy
+-    RelTol_tlm, AbsTol_tlm = accuracy of the sensitivities, in the
+                   layout of Y_tlm
+-    ICNTRL[0:19]   = integer inputs parameters
+-    RCNTRL[0:19]   = real inputs parameters
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+~~~>     OUTPUT ARGUMENTS:
+
+-    Y[NVAR]    -> vector of final states (at T->Tend)
+-    Y_tlm[NVAR*NTLM] -> final sensitivities (at T=Tend)
+-    ISTATUS[0:19]  -> integer output parameters
+-    RSTATUS[0:19]  -> real output parameters
+-    IERR       -> job status upon return
+       - succes (positive value) or failure (negative value) -
+           =  1 : Success
+           = -1 : Improper value for maximal no of steps
+           = -2 : Selected RosenbrockTLM method not implemented
+           = -3 : Hmin/Hmax/Hstart must be positive
+           = -4 : FacMin/FacMax/FacRej must be positive
+           = -5 : Improper tolerance values
+           = -6 : No of steps exceeds maximum bound
+           = -7 : Step size too small
+           = -8 : Matrix is repeatedly singular
+           = -9 : Allocation of the work arrays failed
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+~~~>     INPUT PARAMETERS:
+
+    Note: For input parameters equal to zero the default values of the
+       corresponding variables are used.
+
+    ICNTRL[0]   = 1: F = F(y)   Independent of T (AUTONOMOUS)
+              = 0: F = F(t,y) Depends on T (NON-AUTONOMOUS)
+
+    ICNTRL[1]   = 0: AbsTol, RelTol are NVAR-dimensional vectors
+              = 1:  AbsTol, RelTol are scalars
+
+    ICNTRL[2]  -> selection of a particular Rosenbrock method
+        = 0 :  default method is Rodas3
+        = 1 :  method is  Ros2
+        = 2 :  method is  Ros3
+        = 3 :  method is  Ros4
+        = 4 :  method is  Rodas3
+        = 5:   method is  Rodas4
+
+    ICNTRL[3]  -> maximum number of integration steps
+        For ICNTRL[3]=0) the default value of 100000 is used
+
+    ICNTRL[11] -> switch for TLM truncation error control
+        ICNTRL[11] = 0: TLM error is not used
+        ICNTRL[11] = 1: TLM error is computed and used
+
+~~~>  Real input parameters:
+
+    RCNTRL[0]  -> Hmin, lower bound for the integration step size
+          It is strongly recommended to keep Hmin = ZERO
+
+    RCNTRL[1]  -> Hmax, upper bound for the integration step size
+
+    RCNTRL[2]  -> Hstart, starting value for the integration step size
+
+    RCNTRL[3]  -> FacMin, lower bound on step decrease factor (default=0.2)
+
+    RCNTRL[4]  -> FacMax, upper bound on step increase factor (default=6)
+
+    RCNTRL[5]  -> FacRej, step decrease factor after multiple rejections
+            (default=0.1)
+
+    RCNTRL[6]  -> FacSafe, by which the new step is slightly smaller
+         than the predicted value  (default=0.9)
+
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+~~~>     OUTPUT PARAMETERS:
+
+    ISTATUS[1] = No. of function calls
+    ISTATUS[2] = No. of jacobian calls
+    ISTATUS[3] = No. of steps
+    ISTATUS[4] = No. of accepted steps
+    ISTATUS[5] = No. of rejected steps (except at the beginning)
+    ISTATUS[6] = No. of LU decompositions
+    ISTATUS[7] = No. of forward/backward substitutions (one for all
+                 the directions of a stage)
+    ISTATUS[8] = No. of singular matrix decompositions
+    ISTATUS[9] = No. of Hessian calls
+
+    RSTATUS[1]  -> Texit, the time corresponding to the
+                   computed Y upon return
+    RSTATUS[2]  -> Hexit, last accepted step before exit
+    For multiple restarts, use Hexit as Hstart in the following run
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~>  Local variables */
+  KPP_REAL Roundoff, FacMin, FacMax, FacRej, FacSafe;
+  KPP_REAL Hmin, Hmax, Hstart;
+  int i, UplimTol, Max_no_steps=0;
+  int Autonomous, VectorTol, TLMtruncErr; /* Holds boolean values */
+
+/*~~~>  Initialize statistics */
+  for(i=0; i<20; i++) {
+    ISTATUS[i] = 0;
+    RSTATUS[i] = ZERO;
+  }
+
+/*~~~>  Autonomous or time dependent ODE. Default is time dependent. */
+  Autonomous = !(ICNTRL[0] == 0);
+
+/*~~~> For Scalar tolerances(ICNTRL[1] != 0) the code uses AbsTol[0] and
+         RelTol[0]
+   For Vector tolerances(ICNTRL[1] == 0) the code uses AbsTol[1:NVAR] and
+     RelTol[1:NVAR] */
+
+  if (ICNTRL[1] == 0) {
+    VectorTol = TRUE;
+    UplimTol  = NVAR;
+  }
+  else {
+    VectorTol = FALSE;
+    UplimTol  = 1;
+  }
+
+/*~~~>   Initialize the particular Rosenbrock method selected */
+  switch( ICNTRL[2] ) {
+    case 0:
+    case 4:
+      Rodas3();
+      break;
+    case 1:
+      Ros2();
+      break;
+    case 2:
+      Ros3();
+      break;
+    case 3:
+      Ros4();
+      break;
+    case 5:
+      Rodas4();
+      break;
+    default:
+      printf( "Unknown Rosenbrock method: ICNTRL[2]=%d", ICNTRL[2] );
+      return ros_ErrorMsg(-2, Tstart, ZERO);
+  } /* End switch */
+
+/*~~~>   The maximum number of steps admitted */
+  if (ICNTRL[3] == 0)
+    Max_no_steps = 100000;
+  else if (ICNTRL[3] > 0)
+    Max_no_steps = ICNTRL[3];
+  else {
+    printf("User-selected max no. of steps: ICNTRL[3]=%d",ICNTRL[3] );
+    return ros_ErrorMsg(-1,Tstart,ZERO);
+  }
+
+/*~~~>  TLM truncation error control */
+  TLMtruncErr = (ICNTRL[11] != 0);
+
+/*~~~>  Unit roundoff (1+Roundoff>1)  */
+  Roundoff = WLAMCH('E');
+
+/*~~~>  Lower bound on the step size: (positive value) */
+  if (RCNTRL[0] == ZERO)
+    Hmin = ZERO;
+  else if (RCNTRL[0] > ZERO)
+    Hmin = RCNTRL[0];
+  else {
+    printf( "User-selected Hmin: RCNTRL[0]=%f", RCNTRL[0] );
+    return ros_ErrorMsg(-3,Tstart,ZERO);
+  }
+
+/*~~~>  Upper bound on the step size: (positive value) */
+  if (RCNTRL[1] == ZERO)
+    Hmax = ABS(Tend-Tstart);
+  else if (RCNTRL[1] > ZERO)
+    Hmax = MIN(ABS(RCNTRL[1]),ABS(Tend-Tstart));
+  else {
+    printf( "User-selected Hmax: RCNTRL[1]=%f", RCNTRL[1] );
+    return ros_ErrorMsg(-3,Tstart,ZERO);
+  }
+
+/*~~~>  Starting step size: (positive value) */
+  if (RCNTRL[2] == ZERO) {
+    Hstart = MAX(Hmin,DeltaMin);
+  }
+  else if (RCNTRL[2] > ZERO)
+    Hstart = MIN(ABS(RCNTRL[2]),ABS(Tend-Tstart));
+  else {
+    printf( "User-selected Hstart: RCNTRL[2]=%f", RCNTRL[2] );
+    return ros_ErrorMsg(-3,Tstart,ZERO);
+  }
+
+/*~~~>  Step size can be changed s.t.  FacMin < Hnew/Hold < FacMax */
+  if (RCNTRL[3] == ZERO)
+    FacMin = (KPP_REAL)0.2;
+  else if (RCNTRL[3] > ZERO)
+    FacMin = RCNTRL[3];
+  else {
+    printf( "User-selected FacMin: RCNTRL[3]=%f", RCNTRL[3] );
+    return ros_ErrorMsg(-4,Tstart,ZERO);
+  }
+  if (RCNTRL[4] == ZERO)
+    FacMax = (KPP_REAL)6.0;
+  else if (RCNTRL[4] > ZERO)
+    FacMax = RCNTRL[4];
+  else {
+    printf( "User-selected FacMax: RCNTRL[4]=%f", RCNTRL[4] );
+    return ros_ErrorMsg(-4,Tstart,ZERO);
+  }
+
+/*~~~>   FacRej: Factor to decrease step after 2 succesive rejections */
+  if (RCNTRL[5] == ZERO)
+    FacRej = (KPP_REAL)0.1;
+  else if (RCNTRL[5] > ZERO)
+    FacRej = RCNTRL[5];
+  else {
+    printf( "User-selected FacRej: RCNTRL[5]=%f", RCNTRL[5] );
+    return ros_ErrorMsg(-4,Tstart,ZERO);
+  }
+
+/*~~~>   FacSafe: Safety Factor in the computation of new step size */
+  if (RCNTRL[6] == ZERO)
+    FacSafe = (KPP_REAL)0.9;
+  else if (RCNTRL[6] > ZERO)
+    FacSafe = RCNTRL[6];
+  else {
+    printf( "User-selected FacSafe: RCNTRL[6]=%f", RCNTRL[6] );
+    return ros_ErrorMsg(-4,Tstart,ZERO);
+  }
+
+/*~~~>  Check if tolerances are reasonable */
+  for(i=0; i < UplimTol; i++) {
+    if ( (AbsTol[i] <= ZERO) || (RelTol[i] <= (KPP_REAL)10.0*Roundoff)
+	 || (RelTol[i] >= (KPP_REAL)1.0) ) {
+      printf( " AbsTol[%d] = %f", i, AbsTol[i] );
+      printf( " RelTol[%d] = %f", i, RelTol[i] );
+      return ros_ErrorMsg(-5,Tstart,ZERO);
+    }
+  }
+
+/*~~~>  CALL Rosenbrock method */
+  return ros_TlmInt( Y, NTLM, Y_tlm, Tstart, Tend, AbsTol, RelTol,
+		     AbsTol_tlm, RelTol_tlm, Hmin, Hstart, Hmax, Roundoff,
+		     ISTATUS, Max_no_steps, RSTATUS, Autonomous, VectorTol,
+		     TLMtruncErr, FacMax, FacMin, FacSafe, FacRej );
+
+} /* End of RosenbrockTLM */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int ros_ErrorMsg( int Code, KPP_REAL T, KPP_REAL H) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Handles all error messages
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+  int IERR = Code;
+  printf( "Forced exit from RosenbrockTLM due to the following error:");
+
+  switch (Code) {
+    case -1:
+      printf( "--> Improper value for maximal no of steps" );
+      break;
+    case -2:
+      printf( "--> Selected RosenbrockTLM method not implemented" );
+      break;
+    case -3:
+      printf( "--> Hmin/Hmax/Hstart must be positive" );
+      break;
+    case -4:
+      printf( "--> FacMin/FacMax/FacRej must be positive" );
+      break;
+    case -5:
+      printf( "--> Improper tolerance values" );
+      break;
+    case -6:
+      printf( "--> No of steps exceeds maximum bound" );
+      break;
+    case -7:
+      printf( "--> Step size too small: T + 10*H = T or H < Roundoff" );
+      break;
+    case -8:
+      printf( "--> Matrix is repeatedly singular" );
+      break;
+    case -9:
+      printf( "--> Allocation of the work arrays failed" );
+      break;
+    default:
+      printf( "Unknown Error code: %d", Code );
+  } /* End of switch */
+  printf( "\n     T=%e and H=%e\n", T, H );
+
+  return IERR;
+} /* End of ros_ErrorMsg */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int ros_TlmInt ( KPP_REAL Y[], int NTLM, KPP_REAL Y_tlm[], KPP_REAL Tstart,
+		 KPP_REAL Tend, KPP_REAL AbsTol[], KPP_REAL RelTol[],
+		 KPP_REAL AbsTol_tlm[], KPP_REAL RelTol_tlm[],
+		 KPP_REAL Hmin, KPP_REAL Hstart, KPP_REAL Hmax,
+		 KPP_REAL Roundoff, int ISTATUS[], int Max_no_steps,
+		 KPP_REAL RSTATUS[], int Autonomous, int VectorTol,
+		 int TLMtruncErr, KPP_REAL FacMax, KPP_REAL FacMin,
+		 KPP_REAL FacSafe, KPP_REAL FacRej ) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+   Template for the implementation of a generic Rosenbrock method
+      defined by ros_S (no of stages)
+      and its coefficients ros_{A,C,M,E,Alpha,Gamma},
+      with its tangent linear model for NTLM directions
+~~~> Y, Y_tlm - Input: the initial condition and sensitivities at Tstart;
+                Output: the solution and sensitivities at T
+~~~> Tstart, Tend - Input: integration interval
+~~~> AbsTol, RelTol, AbsTol_tlm, RelTol_tlm - Input: tolerances
+~~~> IERR - Output: Error indicator
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* ~~~~ Local variables */
+  KPP_REAL Ynew[NVAR], Fcn0[NVAR], Fcn[NVAR];
+  KPP_REAL K[NVAR*ros_S], dFdT[NVAR];
+  KPP_REAL Jac0[LU_NONZERO], Jac[LU_NONZERO], Ghimj[LU_NONZERO];
+  KPP_REAL dJdT[LU_NONZERO], Hes0[NHESS], HesK[LU_NONZERO];
+  KPP_REAL *Ynew_tlm, *Fcn0_tlm, *Fcn_tlm, *K_tlm, *Tmp_tlm;
+  KPP_REAL T, H, Hnew, HC, HG, Fac, Tau;
+  KPP_REAL Err, Yerr[NVAR];
+  int HesPos[2*NHESS];
+  int Direction, ioffset, toffset, j, istage, NT;
+  int RejectLastH, RejectMoreH, Singular; /* Boolean Values */
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~>  The sensitivities, NT = NVAR*NTLM values per vector */
+  NT = NVAR*NTLM;
+  Ynew_tlm = (KPP_REAL*) malloc(NT*sizeof(KPP_REAL));
+  Fcn0_tlm = (KPP_REAL*) malloc(NT*sizeof(KPP_REAL));
+  Fcn_tlm  = (KPP_REAL*) malloc(NT*sizeof(KPP_REAL));
+  Tmp_tlm  = (KPP_REAL*) malloc(NT*sizeof(KPP_REAL));
+  K_tlm    = (KPP_REAL*) malloc(NT*ros_S*sizeof(KPP_REAL));
+  if ( (Ynew_tlm == NULL) || (Fcn0_tlm == NULL) || (Fcn_tlm == NULL) ||
+       (Tmp_tlm == NULL) || (K_tlm == NULL) ) {
+    free(Ynew_tlm); free(Fcn0_tlm); free(Fcn_tlm); free(Tmp_tlm); free(K_tlm);
+    return ros_ErrorMsg(-9,Tstart,ZERO);
+  }
+  ros_HessPos( HesPos );
+
+/*~~~>  Initial preparations */
+  T = Tstart;
+  RSTATUS[Nhexit] = ZERO;
+  H = MIN( MAX(ABS(Hmin),ABS(Hstart)) , ABS(Hmax) );
+  if (ABS(H) <= ((KPP_REAL)10.0)*Roundoff)
+    H = DeltaMin;
+
+  if (Tend >= Tstart)
+    Direction = 1;
+  else
+    Direction = -1;
+
+  H = Direction*H;
+
+  RejectLastH = FALSE;
+  RejectMoreH = FALSE;
+
+/*~~~> Time loop begins below */
+  while ( ((Direction > 0) && ((T-Tend)+Roundoff <= ZERO)) ||
+	  ((Direction < 0) && ((Tend-T)+Roundoff <= ZERO)) ) { /* TimeLoop */
+
+    if ( ISTATUS[Nstp] > Max_no_steps ) { /* Too many steps */
+      free(Ynew_tlm); free(Fcn0_tlm); free(Fcn_tlm); free(Tmp_tlm); free(K_tlm);
+      return ros_ErrorMsg(-6,T,H);
+    }
+    if ( ((T+((KPP_REAL)0.1)*H) == T) || (H <= Roundoff) ) { /* Step size
+							      too small */
+      free(Ynew_tlm); free(Fcn0_tlm); free(Fcn_tlm); free(Tmp_tlm); free(K_tlm);
+      return ros_ErrorMsg(-7,T,H);
+    }
+
+/*~~~>  Limit H if necessary to avoid going beyond Tend */
+    RSTATUS[Nhexit] = H;
+    H = MIN(H,ABS(Tend-T));
+
+/*~~~>   Compute the function at current time */
+    FunTemplate(T,Y,Fcn0);
+    ISTATUS[Nfun]++;
+
+/*~~~>   Compute the Jacobian at current time */
+    JacTemplate(T,Y,Jac0);
+    ISTATUS[Njac]++;
+
+/*~~~>   Compute the Hessian at current time */
+    HessTemplate(T,Y,Hes0);
+    ISTATUS[Nhes]++;
+
+/*~~~>   Compute the TLM function at current time, all directions */
+    Jac_SP_Mat( Jac0, NTLM, Y_tlm, Fcn0_tlm );
+
+/*~~~>  Compute the function and Jacobian derivatives with respect to T */
+    if (!Autonomous) {
+      ros_FunTimeDerivative ( T, Roundoff, Y, Fcn0, dFdT, ISTATUS );
+      ros_JacTimeDerivative ( T, Roundoff, Y, Jac0, dJdT, ISTATUS );
+    }
+
+/*~~~>  Repeat step calculation until current step accepted */
+    do {  /* UntilAccepted */
+
+      Singular = ros_PrepareMatrix ( &H, Direction, ros_Gamma[0], Jac0,
+				     Ghimj, ISTATUS );
+
+      if (Singular) { /* More than 5 consecutive failed decompositions */
+	free(Ynew_tlm); free(Fcn0_tlm); free(Fcn_tlm); free(Tmp_tlm);
+	free(K_tlm);
+	return ros_ErrorMsg(-8,T,H);
+      }
+
+/*~~~>   Compute the stages */
+      for( istage = 0; istage < ros_S; istage++ ) { /* Stage */
+
+	/* Current istage offsets. Current istage vectors are
+	   K[ioffset:ioffset+NVAR-1] and K_tlm[toffset:toffset+NT-1] */
+	ioffset = NVAR*istage;
+	toffset = NT*istage;
+
+	/*For the 1st istage the function has been computed previously*/
+	if ( istage == 0 ) {
+	  WCOPY(NVAR,Fcn0,1,Fcn,1);
+	  WCOPY(NT,Fcn0_tlm,1,Fcn_tlm,1);
+	}
+	/* istage>0 and a new function evaluation is needed at the
+	   current istage */
+	else if ( ros_NewF[istage] ) {
+	  WCOPY(NVAR,Y,1,Ynew,1);
+	  WCOPY(NT,Y_tlm,1,Ynew_tlm,1);
+	  for ( j = 0; j < istage; j++ ) {
+	    WAXPY( NVAR,ros_A[(istage)*(istage-1)/2+j],
+		   &K[NVAR*j],1,Ynew,1 );
+	    WAXPY( NT,ros_A[(istage)*(istage-1)/2+j],
+		   &K_tlm[NT*j],1,Ynew_tlm,1 );
+	  }
+	  Tau = T + ros_Alpha[istage]*Direction*H;
+	  FunTemplate(Tau,Ynew,Fcn);
+	  ISTATUS[Nfun]++;
+	  JacTemplate(Tau,Ynew,Jac);
+	  ISTATUS[Njac]++;
+	  Jac_SP_Mat( Jac, NTLM, Ynew_tlm, Fcn_tlm );
+	} /* if istage == 0 elseif ros_NewF[istage] */
+
+	WCOPY(NVAR,Fcn,1,&K[ioffset],1);
+	WCOPY(NT,Fcn_tlm,1,&K_tlm[toffset],1);
+	for( j = 0; j < istage; j++ ) {
+	  HC = ros_C[(istage)*(istage-1)/2+j]/(Direction*H);
+	  WAXPY(NVAR,HC,&K[NVAR*j],1,&K[ioffset],1);
+	  WAXPY(NT,HC,&K_tlm[NT*j],1,&K_tlm[toffset],1);
+	}
+	if (( !Autonomous) && (ros_Gamma[istage] != ZERO)) {
+	  HG = Direction*H*ros_Gamma[istage];
+	  WAXPY(NVAR,HG,dFdT,1,&K[ioffset],1);
+	  Jac_SP_Mat( dJdT, NTLM, Y_tlm, Tmp_tlm );
+	  WAXPY(NT,HG,Tmp_tlm,1,&K_tlm[toffset],1);
+	}
+	KppSolve( Ghimj, &K[ioffset] );
+	ISTATUS[Nsol]++;
+
+	/* Hess x (K_i, Y_tlm) = (Hess x K_i) * Y_tlm for all directions */
+	ros_HessMat( Hes0, HesPos, &K[ioffset], HesK );
+	Jac_SP_Mat( HesK, NTLM, Y_tlm, Tmp_tlm );
+	WAXPY(NT,ONE,Tmp_tlm,1,&K_tlm[toffset],1);
+	KppSolve_Multi( Ghimj, NTLM, &K_tlm[toffset] );
+	ISTATUS[Nsol]++;
+      } /* End of Stage loop */
+
+/*~~~>  Compute the new solution */
+      WCOPY(NVAR,Y,1,Ynew,1);
+      WCOPY(NT,Y_tlm,1,Ynew_tlm,1);
+      for( j=0; j<ros_S; j++ ) {
+	WAXPY(NVAR,ros_M[j],&K[NVAR*j],1,Ynew,1);
+	WAXPY(NT,ros_M[j],&K_tlm[NT*j],1,Ynew_tlm,1);
+      }
+
+/*~~~>  Compute the error estimation */
+      WSCAL(NVAR,ZERO,Yerr,1);
+      for( j=0; j<ros_S; j++ )
+	WAXPY(NVAR,ros_E[j],&K[NVAR*j],1,Yerr,1);
+      Err = ros_ErrorNorm ( Y, Ynew, Yerr, AbsTol, RelTol, VectorTol );
+      if (TLMtruncErr)
+	Err = ros_ErrorNorm_tlm ( NTLM, Y_tlm, Ynew_tlm, K_tlm, AbsTol_tlm,
+				  RelTol_tlm, Err, VectorTol );
+
+/*~~~> New step size is bounded by FacMin <= Hnew/H <= FacMax */
+      Fac  = MIN(FacMax,MAX(FacMin,FacSafe/pow(Err,(ONE/ros_ELO))));
+      Hnew = H*Fac;
+
+/*~~~>  Check the error magnitude and adjust step size */
+      ISTATUS[Nstp]++;
+      if ( (Err <= ONE) || (H <= Hmin) ) {  /*~~~> Accept step */
+	ISTATUS[Nacc]++;
+	WCOPY(NVAR,Ynew,1,Y,1);
+	WCOPY(NT,Ynew_tlm,1,Y_tlm,1);
+	T = T + Direction*H;
+	Hnew = MAX(Hmin,MIN(Hnew,Hmax));
+	if (RejectLastH) { /* No step size increase after a
+			     rejected step */
+	  Hnew = MIN(Hnew,H);
+	}
+	RSTATUS[Nhexit] = H;
+	RSTATUS[Nhnew]  = Hnew;
+	RSTATUS[Ntexit] = T;
+	RejectLastH = FALSE;
+	RejectMoreH = FALSE;
+	H = Hnew;
+	break; /* UntilAccepted - EXIT THE LOOP: WHILE STEP NOT ACCEPTED */
+      }
+
+      else { /*~~~> Reject step */
+	if (RejectMoreH)
+	  Hnew = H*FacRej;
+        RejectMoreH = RejectLastH;
+        RejectLastH = TRUE;
+        H = Hnew;
+        if (ISTATUS[Nacc] >= 1)
+	  ISTATUS[Nrej]++;
+      } /* End if else - Err <= 1 */
+
+    } while(1); /* End of UntilAccepted do loop */
+  } /* End of TimeLoop */
+
+  free(Ynew_tlm); free(Fcn0_tlm); free(Fcn_tlm); free(Tmp_tlm); free(K_tlm);
+
+/*~~~> Succesful exit */
+  return 1;  /*~~~> The integration was successful */
+} /* End of ros_TlmInt */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+KPP_REAL ros_ErrorNorm ( KPP_REAL Y[], KPP_REAL Ynew[], KPP_REAL Yerr[],
+		       KPP_REAL AbsTol[], KPP_REAL RelTol[], int VectorTol ) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+~~~> Computes the "scaled norm" of the error vector Yerr
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* Local variables */
+  KPP_REAL Err, Scale, Ymax;
+  int i;
+
+  Err = ZERO;
+  for(i=0; i<NVAR; i++) {
+    Ymax = MAX(ABS(Y[i]),ABS(Ynew[i]));
+    if (VectorTol)
+      Scale = AbsTol[i]+RelTol[i]*Ymax;
+    else
+      Scale = AbsTol[0]+RelTol[0]*Ymax;
+
+    Err = Err+pow((Yerr[i]/Scale),2);
+  }
+  Err  = SQRT(Err/NVAR);
+
+  return MAX(Err,(KPP_REAL)1.0e-10);
+} /* End of ros_ErrorNorm */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+KPP_REAL ros_ErrorNorm_tlm ( int NTLM, KPP_REAL Y_tlm[], KPP_REAL Ynew_tlm[],
+		       KPP_REAL K_tlm[], KPP_REAL AbsTol_tlm[],
+		       KPP_REAL RelTol_tlm[], KPP_REAL Fwd_Err, int VectorTol ) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+~~~> The largest of Fwd_Err and the "scaled norms" of the errors
+     sum_j E(j)*K_tlm_j of the sensitivities in each direction
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/* Local variables */
+  KPP_REAL Err, Errd, Scale, Ymax, Yerr;
+  int i, j, d, m;
+
+  Err = Fwd_Err;
+  for(d=0; d<NTLM; d++) {
+    Errd = ZERO;
+    for(i=0; i<NVAR; i++) {
+      m = i*NTLM+d;
+      Yerr = ZERO;
+      for(j=0; j<ros_S; j++)
+	Yerr += ros_E[j]*K_tlm[NVAR*NTLM*j+m];
+      Ymax = MAX(ABS(Y_tlm[m]),ABS(Ynew_tlm[m]));
+      if (VectorTol)
+	Scale = AbsTol_tlm[m]+RelTol_tlm[m]*Ymax;
+      else
+	Scale = AbsTol_tlm[d]+RelTol_tlm[d]*Ymax;
+      Errd = Errd+pow((Yerr/Scale),2);
+    }
+    Err = MAX(Err,SQRT(Errd/NVAR));
+  }
+
+  return MAX(Err,(KPP_REAL)1.0e-10);
+} /* End of ros_ErrorNorm_tlm */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void ros_FunTimeDerivative ( KPP_REAL T, KPP_REAL Roundoff, KPP_REAL Y[],
+			     KPP_REAL Fcn0[], KPP_REAL dFdT[], int ISTATUS[]) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+~~~> The time partial derivative of the function by finite differences
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~> Local variables */
+  KPP_REAL Delta;
+
+  Delta = SQRT(Roundoff)*MAX(DeltaMin,ABS(T));
+  FunTemplate(T+Delta,Y,dFdT);
+  ISTATUS[Nfun]++;
+  WAXPY(NVAR,(-ONE),Fcn0,1,dFdT,1);
+  WSCAL(NVAR,(ONE/Delta),dFdT,1);
+
+} /* End of ros_FunTimeDerivative */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void ros_JacTimeDerivative ( KPP_REAL T, KPP_REAL Roundoff, KPP_REAL Y[],
+			     KPP_REAL Jac0[], KPP_REAL dJdT[], int ISTATUS[]) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+~~~> The time partial derivative of the Jacobian by finite differences
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~> Local variables */
+  KPP_REAL Delta;
+
+  Delta = SQRT(Roundoff)*MAX(DeltaMin,ABS(T));
+  JacTemplate(T+Delta,Y,dJdT);
+  ISTATUS[Njac]++;
+  WAXPY(LU_NONZERO,(-ONE),Jac0,1,dJdT,1);
+  WSCAL(LU_NONZERO,(ONE/Delta),dJdT,1);
+
+} /* End of ros_JacTimeDerivative */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int ros_PrepareMatrix ( KPP_REAL* H, int Direction, KPP_REAL gam,
+			KPP_REAL Jac0[], KPP_REAL Ghimj[], int ISTATUS[] ) {
+/* --- --- --- --- --- --- --- --- --- --- --- --- ---
+  Prepares the LHS matrix for stage calculations
+  1.  Construct Ghimj = 1/(H*gam) - Jac0
+      "(Gamma H) Inverse Minus Jacobian"
+  2.  Repeat LU decomposition of Ghimj until successful.
+       -half the step size if LU decomposition fails and retry
+       -exit after 5 consecutive fails
+ --- --- --- --- --- --- --- --- --- --- --- --- --- */
+
+/*~~~> Local variables */
+  int i, ising, Nconsecutive;
+  KPP_REAL ghinv;
+
+  Nconsecutive = 0;
+
+  while (1) {
+
+/*~~~>    Construct Ghimj = 1/(H*gam) - Jac0 */
+    WCOPY(LU_NONZERO,Jac0,1,Ghimj,1);
+    WSCAL(LU_NONZERO,(-ONE),Ghimj,1);
+    ghinv = ONE/(Direction*(*H)*gam);
+    for(i=0; i<NVAR; i++)
+      Ghimj[LU_DIAG[i]] = Ghimj[LU_DIAG[i]]+ghinv;
+
+/*~~~>    Compute LU decomposition */
+    ising = KppDecomp( Ghimj );
+    ISTATUS[Ndec]++;
+    if (ising == 0)
+/*~~~>    If successful done */
+      return FALSE;
+
+/*~~~>    If unsuccessful half the step size;
+          if 5 consecutive fails then return */
+    ISTATUS[Nsng]++;
+    Nconsecutive++;
+    printf( "Warning: LU Decomposition returned ising = %d\n", ising );
+    if (Nconsecutive > 5) /* More than 5 consecutive failed decompositions */
+      return TRUE;
+    *H = (*H)*HALF;
+  }  /* while Singular */
+
+} /* End of ros_PrepareMatrix */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void ros_HessPos( int HesPos[] ) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+~~~> For the Hessian element m = d^2 f_i / dv_j dv_k, the positions of
+     (i,j) and (i,k) in the sparse Jacobian: HesPos[2*m], HesPos[2*m+1].
+     A Hessian element couples i to j and to k, so both are in the
+     sparsity pattern of the Jacobian, whose rows have sorted columns
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~> Local variables */
+  int m, n, c, lo, hi, mid;
+
+  for(m=0; m<NHESS; m++) {
+    for(n=0; n<2; n++) {
+      c  = (n == 0) ? IHESS_J[m] : IHESS_K[m];
+      lo = LU_CROW[IHESS_I[m]];
+      hi = LU_CROW[IHESS_I[m]+1]-1;
+      while (lo < hi) {
+	mid = (lo+hi)/2;
+	if (LU_ICOL[mid] < c)
+	  lo = mid+1;
+	else
+	  hi = mid;
+      }
+      HesPos[2*m+n] = lo;
+    }
+  }
+
+} /* End of ros_HessPos */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void ros_HessMat( KPP_REAL Hes[], int HesPos[], KPP_REAL U[],
+		  KPP_REAL HU[] ) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+~~~> The Hessian contracted with the vector U, in the sparse Jacobian
+     format: HU(i,j) = sum_k d^2 f_i / dv_j dv_k * U(k).  For any V,
+     Jac_SP_Vec( HU, V ) equals Hess_Vec( Hes, U, V )
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~> Local variables */
+  int m;
+
+  WSCAL(LU_NONZERO,ZERO,HU,1);
+  for(m=0; m<NHESS; m++) {
+    HU[HesPos[2*m]] += Hes[m]*U[IHESS_K[m]];
+    if (IHESS_J[m] != IHESS_K[m])
+      HU[HesPos[2*m+1]] += Hes[m]*U[IHESS_J[m]];
+  }
+
+} /* End of ros_HessMat */
+
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void Ros2() {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ --- AN L-STABLE METHOD, 2 stages, order 2
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+  KPP_REAL g;
+
+  g = (KPP_REAL)1.0 + ((KPP_REAL)1.0)/SQRT((KPP_REAL)2.0);
+
+  rosMethod = RS2;
+/*~~~> Name of the method */
+  strcpy(ros_Name, "ROS-2");
+/*~~~> Number of stages */
+  ros_S = 2;
+
+/*~~~> The coefficient matrices A and C are strictly lower triangular.
+  The lower triangular (subdiagonal) elements are stored in row-wise order:
+  A[0][1] = ros_A[0], A[0][2]=ros_A[1], A[1][2]=ros_A[2], etc.
+  The general mapping formula is:
+      A[i][j] = ros_A[ (i-1)*(i-2)/2 + j ]
+      C[i][j] = ros_C[ (i-1)*(i-2)/2 + j ] */
+
+  ros_A[0] = ((KPP_REAL)1.0)/g;
+  ros_C[0] = ((KPP_REAL)-2.0)/g;
+
+/*~~~> Does the stage i require a new function evaluation (ros_NewF[i]=TRUE)
+       or does it re-use the function evaluation from stage i-1 
+       (ros_NewF[i]=FALSE) */
+  ros_NewF[0] = TRUE;
+  ros_NewF[1] = TRUE;
+
+/*~~~> M_i = Coefficients for new step solution */
+  ros_M[0]= ((KPP_REAL)3.0)/((KPP_REAL)2.0*g);
+  ros_M[1]= ((KPP_REAL)1.0)/((KPP_REAL)2.0*g);
+
+/* E_i = Coefficients for error estimator */
+  ros_E[0] = ((KPP_REAL)1.0)/((KPP_REAL)2.0*g);
+  ros_E[1] = ((KPP_REAL)1.0)/((KPP_REAL)2.0*g);
+
+/*~~~> ros_ELO = estimator of local order - the minimum between the
+       main and the embedded scheme orders plus one */
+  ros_ELO = (KPP_REAL)2.0;
+
+/*~~~> Y_stage_i ~ Y( T + H*Alpha_i ) */
+  ros_Alpha[0] = (KPP_REAL)0.0;
+  ros_Alpha[1] = (KPP_REAL)1.0;
+
+/*~~~> Gamma_i = \sum_j  gamma_{i,j} */
+  ros_Gamma[0] = g;
+  ros_Gamma[1] =-g;
+
+} /* End of Ros2 */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void Ros3() {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ --- AN L-STABLE METHOD, 3 stages, order 3, 2 function evaluations
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+  rosMethod = RS3;
+/*~~~> Name of the method */
+  strcpy(ros_Name, "ROS-3");
+/*~~~> Number of stages */
+  ros_S = 3;
+
+/*~~~> The coefficient matrices A and C are strictly lower triangular.
+   The lower triangular (subdiagonal) elements are stored in row-wise order:
+   A[0][1] = ros_A[0], A[0][2]=ros_A[1], A[1][2]=ros_A[2], etc.
+   The general mapping formula is:
+       A[i][j] = ros_A[ (i-1)*(i-2)/2 + j ]
+       C[i][j] = ros_C[ (i-1)*(i-2)/2 + j ] */
+
+  ros_A[0]= (KPP_REAL)1.0;
+  ros_A[1]= (KPP_REAL)1.0;
+  ros_A[2]= (KPP_REAL)0.0;
+  ros_C[0] = (KPP_REAL)-0.10156171083877702091975600115545e01;
+  ros_C[1] = (KPP_REAL) 0.40759956452537699824805835358067e01;
+  ros_C[2] = (KPP_REAL) 0.92076794298330791242156818474003e01;
+
+/*~~~> Does the stage i require a new function evaluation (ros_NewF[i]=TRUE)
+       or does it re-use the function evaluation from stage i-1 
+       (ros_NewF[i]=FALSE) */
+  ros_NewF[0] = TRUE;
+  ros_NewF[1] = TRUE;
+  ros_NewF[2] = FALSE;
+/*~~~> M_i = Coefficients for new step solution */
+  ros_M[0] = (KPP_REAL) 0.1e01;
+  ros_M[1] = (KPP_REAL) 0.61697947043828245592553615689730e01;
+  ros_M[2] = (KPP_REAL)-0.42772256543218573326238373806514;
+/* E_i = Coefficients for error estimator */
+  ros_E[0] = (KPP_REAL) 0.5;
+  ros_E[1] = (KPP_REAL)-0.29079558716805469821718236208017e01;
+  ros_E[2] = (KPP_REAL) 0.22354069897811569627360909276199;
+
+/*~~~> ros_ELO = estimator of local order - the minimum between the
+       main and the embedded scheme orders plus 1 */
+  ros_ELO = (KPP_REAL)3.0;
+/*~~~> Y_stage_i ~ Y( T + H*Alpha_i ) */
+  ros_Alpha[0]= (KPP_REAL)0.0;
+  ros_Alpha[1]= (KPP_REAL)0.43586652150845899941601945119356;
+  ros_Alpha[2]= (KPP_REAL)0.43586652150845899941601945119356;
+/*~~~> Gamma_i = \sum_j  gamma_{i,j} */
+  ros_Gamma[0]= (KPP_REAL)0.43586652150845899941601945119356;
+  ros_Gamma[1]= (KPP_REAL)0.24291996454816804366592249683314;
+  ros_Gamma[2]= (KPP_REAL)0.21851380027664058511513169485832e01;
+
+} /* End of Ros3 */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void Ros4() {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     L-STABLE ROSENBROCK METHOD OF ORDER 4, WITH 4 STAGES
+     L-STABLE EMBEDDED ROSENBROCK METHOD OF ORDER 3
+
+      E. HAIRER AND G. WANNER, SOLVING ORDINARY DIFFERENTIAL
+      EQUATIONS II. STIFF AND DIFFERENTIAL-ALGEBRAIC PROBLEMS.
+      SPRINGER SERIES IN COMPUTATIONAL MATHEMATICS,
+      SPRINGER-VERLAG (1990)
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+  rosMethod = RS4;
+/*~~~> Name of the method */
+  strcpy(ros_Name, "ROS-4");
+/*~~~> Number of stages */
+  ros_S = 4;
+
+/*~~~> The coefficient matrices A and C are strictly lower triangular.
+   The lower triangular (subdiagonal) elements are stored in row-wise order:
+   A[0][1] = ros_A[0], A[0][2]=ros_A[1], A[1][2]=ros_A[2], etc.
+   The general mapping formula is:
+       A[i][j] = ros_A[ (i-1)*(i-2)/2 + j ]
+       C[i][j] = ros_C[ (i-1)*(i-2)/2 + j ] */
+
+  ros_A[0] = (KPP_REAL)0.2000000000000000e01;
+  ros_A[1] = (KPP_REAL)0.1867943637803922e01;
+  ros_A[2] = (KPP_REAL)0.2344449711399156;
+  ros_A[3] = ros_A[1];
+  ros_A[4] = ros_A[2];
+  ros_A[5] = (KPP_REAL)0.0;
+
+  ros_C[0] = (KPP_REAL)-0.7137615036412310e01;
+  ros_C[1] = (KPP_REAL) 0.2580708087951457e01;
+  ros_C[2] = (KPP_REAL) 0.6515950076447975;
+  ros_C[3] = (KPP_REAL)-0.2137148994382534e01;
+  ros_C[4] = (KPP_REAL)-0.3214669691237626;
+  ros_C[5] = (KPP_REAL)-0.6949742501781779;
+
+/*~~~> Does the stage i require a new function evaluation (ros_NewF[i]=TRUE)
+       or does it re-use the function evaluation from stage i-1 
+       (ros_NewF[i]=FALSE) */
+  ros_NewF[0] = TRUE;
+  ros_NewF[1] = TRUE;
+  ros_NewF[2] = TRUE;
+  ros_NewF[3] = FALSE;
+/*~~~> M_i = Coefficients for new step solution */
+  ros_M[0] = (KPP_REAL)0.2255570073418735e01;
+  ros_M[1] = (KPP_REAL)0.2870493262186792;
+  ros_M[2] = (KPP_REAL)0.4353179431840180;
+  ros_M[3] = (KPP_REAL)0.1093502252409163e01;
+/*~~~> E_i  = Coefficients for error estimator */
+  ros_E[0] = (KPP_REAL)-0.2815431932141155;
+  ros_E[1] = (KPP_REAL)-0.7276199124938920e-01;
+  ros_E[2] = (KPP_REAL)-0.1082196201495311;
+  ros_E[3] = (KPP_REAL)-0.1093502252409163e01;
+
+/*~~~> ros_ELO  = estimator of local order - the minimum between the
+       main and the embedded scheme orders plus 1 */
+  ros_ELO = (KPP_REAL)4.0;
+/*~~~> Y_stage_i ~ Y( T + H*Alpha_i ) */
+  ros_Alpha[0] = (KPP_REAL)0.0;
+  ros_Alpha[1] = (KPP_REAL)0.1145640000000000e01;
+  ros_Alpha[2] = (KPP_REAL)0.6552168638155900;
+  ros_Alpha[3] = ros_Alpha[2];
+/*~~~> Gamma_i = \sum_j  gamma_{i,j} */ 
+  ros_Gamma[0] = (KPP_REAL) 0.5728200000000000;
+  ros_Gamma[1] = (KPP_REAL)-0.1769193891319233e01;
+  ros_Gamma[2] = (KPP_REAL) 0.7592633437920482;
+  ros_Gamma[3] = (KPP_REAL)-0.1049021087100450;
+
+} /* End of Ros4 */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void Rodas3() {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ --- A STIFFLY-STABLE METHOD, 4 stages, order 3
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+  rosMethod = RD3;
+/*~~~> Name of the method */
+  strcpy(ros_Name, "RODAS-3");
+/*~~~> Number of stages */
+  ros_S = 4;
+
+/*~~~> The coefficient matrices A and C are strictly lower triangular.
+   The lower triangular (subdiagonal) elements are stored in row-wise order:
+   A[0][1] = ros_A[0], A[0][2]=ros_A[1], A[1][2]=ros_A[2], etc.
+   The general mapping formula is:
+       A[i][j] = ros_A[ (i-1)*(i-2)/2 + j ]
+       C[i][j] = ros_C[ (i-1)*(i-2)/2 + j ] */
+
+  ros_A[0] = (KPP_REAL)0.0;
+  ros_A[1] = (KPP_REAL)2.0;
+  ros_A[2] = (KPP_REAL)0.0;
+  ros_A[3] = (KPP_REAL)2.0;
+  ros_A[4] = (KPP_REAL)0.0;
+  ros_A[5] = (KPP_REAL)1.0;
+
+  ros_C[0] = (KPP_REAL) 4.0;
+  ros_C[1] = (KPP_REAL) 1.0;
+  ros_C[2] = (KPP_REAL)-1.0;
+  ros_C[3] = (KPP_REAL) 1.0;
+  ros_C[4] = (KPP_REAL)-1.0;
+  ros_C[5] = -(((KPP_REAL)8.0)/((KPP_REAL)3.0));
+
+/*~~~> Does the stage i require a new function evaluation (ros_NewF[i]=TRUE)
+       or does it re-use the function evaluation from stage i-1 
+       (ros_NewF[i]=FALSE) */
+  ros_NewF[0] = TRUE;
+  ros_NewF[1] = FALSE;
+  ros_NewF[2] = TRUE;
+  ros_NewF[3] = TRUE;
+/*~~~> M_i = Coefficients for new step solution */
+  ros_M[0] = (KPP_REAL)2.0;
+  ros_M[1] = (KPP_REAL)0.0;
+  ros_M[2] = (KPP_REAL)1.0;
+  ros_M[3] = (KPP_REAL)1.0;
+/*~~~> E_i  = Coefficients for error estimator */
+  ros_E[0] = (KPP_REAL)0.0;
+  ros_E[1] = (KPP_REAL)0.0;
+  ros_E[2] = (KPP_REAL)0.0;
+  ros_E[3] = (KPP_REAL)1.0;
+
+/*~~~> ros_ELO  = estimator of local order - the minimum between the
+    main and the embedded scheme orders plus 1 */
+  ros_ELO  = (KPP_REAL)3.0;
+/*~~~> Y_stage_i ~ Y( T + H*Alpha_i ) */
+  ros_Alpha[0] = (KPP_REAL)0.0;
+  ros_Alpha[1] = (KPP_REAL)0.0;
+  ros_Alpha[2] = (KPP_REAL)1.0;
+  ros_Alpha[3] = (KPP_REAL)1.0;
+/*~~~> Gamma_i = \sum_j  gamma_{i,j} */
+  ros_Gamma[0] = (KPP_REAL)0.5;
+  ros_Gamma[1] = (KPP_REAL)1.5;
+  ros_Gamma[2] = (KPP_REAL)0.0;
+  ros_Gamma[3] = (KPP_REAL)0.0;
+
+} /* End of Rodas3 */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void Rodas4() {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     STIFFLY-STABLE ROSENBROCK METHOD OF ORDER 4, WITH 6 STAGES
+
+      E. HAIRER AND G. WANNER, SOLVING ORDINARY DIFFERENTIAL
+      EQUATIONS II. STIFF AND DIFFERENTIAL-ALGEBRAIC PROBLEMS.
+      SPRINGER SERIES IN COMPUTATIONAL MATHEMATICS,
+      SPRINGER-VERLAG (1996)
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+  rosMethod = RD4;
+/*~~~> Name of the method */
+  strcpy(ros_Name, "RODAS-4");
+/*~~~> Number of stages */
+  ros_S = 6;
+
+/*~~~> Y_stage_i ~ Y( T + H*Alpha_i ) */
+  ros_Alpha[0] = (KPP_REAL)0.000;
+  ros_Alpha[1] = (KPP_REAL)0.386;
+  ros_Alpha[2] = (KPP_REAL)0.210;
+  ros_Alpha[3] = (KPP_REAL)0.630;
+  ros_Alpha[4] = (KPP_REAL)1.000;
+  ros_Alpha[5] = (KPP_REAL)1.000;
+
+/*~~~> Gamma_i = \sum_j  gamma_{i,j} */
+  ros_Gamma[0] = (KPP_REAL) 0.2500000000000000;
+  ros_Gamma[1] = (KPP_REAL)-0.1043000000000000;
+  ros_Gamma[2] = (KPP_REAL) 0.1035000000000000;
+  ros_Gamma[3] = (KPP_REAL)-0.3620000000000023e-01;
+  ros_Gamma[4] = (KPP_REAL) 0.0;
+  ros_Gamma[5] = (KPP_REAL) 0.0;
+
+/*~~~> The coefficient matrices A and C are strictly lower triangular.
+   The lower triangular (subdiagonal) elements are stored in row-wise order:
+   A[0][1] = ros_A[0], A[0][2]=ros_A[1], A[1][2]=ros_A[2], etc.
+   The general mapping formula is:  A[i][j] = ros_A[ (i-1)*(i-2)/2 + j ]
+                  C[i][j] = ros_C[ (i-1)*(i-2)/2 + j ] */
+
+  ros_A[0] = (KPP_REAL) 0.1544000000000000e01;
+  ros_A[1] = (KPP_REAL) 0.9466785280815826;
+  ros_A[2] = (KPP_REAL) 0.2557011698983284;
+  ros_A[3] = (KPP_REAL) 0.3314825187068521e01;
+  ros_A[4] = (KPP_REAL) 0.2896124015972201e01;
+  ros_A[5] = (KPP_REAL) 0.9986419139977817;
+  ros_A[6] = (KPP_REAL) 0.1221224509226641e01;
+  ros_A[7] = (KPP_REAL) 0.6019134481288629e01;
+  ros_A[8] = (KPP_REAL) 0.1253708332932087e02;
+  ros_A[9] = (KPP_REAL)-0.6878860361058950;
+  ros_A[10] = ros_A[6];
+  ros_A[11] = ros_A[7];
+  ros_A[12] = ros_A[8];
+  ros_A[13] = ros_A[9];
+  ros_A[14] = (KPP_REAL)1.0;
+  
+  ros_C[0]  = (KPP_REAL)-0.5668800000000000e01;
+  ros_C[1]  = (KPP_REAL)-0.2430093356833875e01;
+  ros_C[2]  = (KPP_REAL)-0.2063599157091915;
+  ros_C[3]  = (KPP_REAL)-0.1073529058151375;
+  ros_C[4]  = (KPP_REAL)-0.9594562251023355e01;
+  ros_C[5]  = (KPP_REAL)-0.2047028614809616e02;
+  ros_C[6]  = (KPP_REAL) 0.7496443313967647e01;
+  ros_C[7]  = (KPP_REAL)-0.1024680431464352e02;
+  ros_C[8]  = (KPP_REAL)-0.3399990352819905e02;
+  ros_C[9]  = (KPP_REAL) 0.1170890893206160e02;
+  ros_C[10] = (KPP_REAL) 0.8083246795921522e01;
+  ros_C[11] = (KPP_REAL)-0.7981132988064893e01;
+  ros_C[12] = (KPP_REAL)-0.3152159432874371e02;
+  ros_C[13] = (KPP_REAL) 0.1631930543123136e02;
+  ros_C[14] = (KPP_REAL)-0.6058818238834054e01;
+
+/*~~~> M_i = Coefficients for new step solution */
+  ros_M[0] = ros_A[6];
+  ros_M[1] = ros_A[7];
+  ros_M[2] = ros_A[8];
+  ros_M[3] = ros_A[9];
+  ros_M[4] = (KPP_REAL)1.0;
+  ros_M[5] = (KPP_REAL)1.0;
+
+/*~~~> E_i  = Coefficients for error estimator */
+  ros_E[0] = (KPP_REAL)0.0;
+  ros_E[1] = (KPP_REAL)0.0;
+  ros_E[2] = (KPP_REAL)0.0;
+  ros_E[3] = (KPP_REAL)0.0;
+  ros_E[4] = (KPP_REAL)0.0;
+  ros_E[5] = (KPP_REAL)1.0;
+
+/*~~~> Does the stage i require a new function evaluation (ros_NewF[i]=TRUE)
+       or does it re-use the function evaluation from stage i-1 
+       (ros_NewF[i]=FALSE) */
+  ros_NewF[0] = TRUE;
+  ros_NewF[1] = TRUE;
+  ros_NewF[2] = TRUE;
+  ros_NewF[3] = TRUE;
+  ros_NewF[4] = TRUE;
+  ros_NewF[5] = TRUE;
+
+/*~~~> ros_ELO  = estimator of local order - the minimum between the
+        main and the embedded scheme orders plus 1 */
+  ros_ELO = (KPP_REAL)4.0;
+
+} /* End of Rodas4 */
+
+void FunTemplate( KPP_REAL T, KPP_REAL Y[], KPP_REAL Ydot[] ) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  Template for the ODE function call.
+  Updates the rate coefficients (and possibly the fixed species) at each call
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~> Local variables */
+  KPP_REAL Told;
+
+  Told = TIME;
+  TIME = T;
+  Update_SUN();
+  Update_RCONST();
+  Fun( Y, FIX, RCONST, Ydot );
+  TIME = Told;
+
+} /* End of FunTemplate */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void JacTemplate( KPP_REAL T, KPP_REAL Y[], KPP_REAL Jcb[] ) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  Template for the ODE Jacobian call.
+  Updates the rate coefficients (and possibly the fixed species) at each call
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~> Local variables */
+  KPP_REAL Told;
+
+  Told = TIME;
+  TIME = T;
+  Update_SUN();
+  Update_RCONST();
+  Jac_SP( Y, FIX, RCONST, Jcb );
+  TIME = Told;
+
+} /* End of JacTemplate */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void HessTemplate( KPP_REAL T, KPP_REAL Y[], KPP_REAL Hes[] ) {
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  Template for the ODE Hessian call.
+  Updates the rate coefficients (and possibly the fixed species) at each call
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~> Local variables */
+  KPP_REAL Told;
+
+  Told = TIME;
+  TIME = T;
+  Update_SUN();
+  Update_RCONST();
+  Hessian( Y, FIX, RCONST, Hes );
+  TIME = Told;
+
+} /* End of HessTemplate */
+
+/* End of INTEGRATE_TLM function                                                 */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
@@ -18,6 +18,8 @@
  #define Ndec	5
  #define Nsol	6
  #define Nsng	7
+ #define Nkry	8
+ #define Nred	9
  #define Ntexit	0
  #define Nhacc	1
  #define Nhnew	2
@@ -50,6 +52,18 @@
    	rkAlpha,
    	rkBeta,
 	rkELO;
+/*~~~> Linear solver: sparse LU (0), GMRES (1) or BiCGStab (2); the Krylov
+	solvers apply the Jacobian rkFJAC and scale by the weights rkSCAL */
+ int rkLinSolver;
+ KPP_REAL rkKrylovTol,
+	*rkFJAC,
+	*rkSCAL;
+#ifdef _OPENMP
+ #pragma omp threadprivate( rkMethod, SdirkError, rkT, rkTinv, rkTinvAinv, \
+     rkAinvT, rkA, rkB, rkC, rkD, rkE, rkBgam, rkBhat, rkTheta, rkF, \
+     rkGamma, rkAlpha, rkBeta, rkELO, rkLinSolver, rkKrylovTol, rkFJAC, \
+     rkSCAL )
+#endif
 /*~~~> Function headers */
 // void INTEGRATE(KPP_REAL TIN, KPP_REAL TOUT, int ICNTRL_U[], KPP_REAL RCNTRL_U[],
 //		int ISTATUS_U[], KPP_REAL RSTATUS_U[], int IERR_U); 
@@ -62,7 +76,7 @@
      		   int ISTATUS[], KPP_REAL RSTATUS[], KPP_REAL Hmin,
 		   KPP_REAL Hmax, KPP_REAL Hstart, KPP_REAL Roundoff,
 		   int Max_no_steps, int NewtonMaxit, int StartNewton,
-		   int Gustafsson, KPP_REAL ThetaMin, KPP_REAL NewtonTol,
+		   int Controller, KPP_REAL ThetaMin, KPP_REAL NewtonTol,
 		   KPP_REAL FacSafe, KPP_REAL FacMax, KPP_REAL FacMin,
      		   KPP_REAL FacRej, KPP_REAL Qmin, KPP_REAL Qmax, int* IERR);
  void RK_ErrorMsg(int Code, KPP_REAL T, KPP_REAL H, int* IERR);
@@ -85,6 +99,9 @@
         KPP_REAL FO[], KPP_REAL E1[], int IP1[], KPP_REAL Z1[],
         KPP_REAL Z2[], KPP_REAL Z3[], KPP_REAL SCAL[], KPP_REAL* Err,
         int FirstStep, int Reject, int ISTATUS[]);
+ void RK_SolveReal(KPP_REAL H, KPP_REAL E1[], KPP_REAL R[], int ISTATUS[]);
+ void RK_SolveCmplx(KPP_REAL H, KPP_REAL E2R[], KPP_REAL E2I[], KPP_REAL BR[],
+	KPP_REAL BI[], int ISTATUS[]);
  void Radau2A_Coefficients();
  void Lobatto3C_Coefficients ();
  void Gauss_Coefficients();
@@ -104,6 +121,16 @@
  void Set2Zero(int N, KPP_REAL A[]);
  int KppDecomp( KPP_REAL A[] );
  void KppSolve ( KPP_REAL A[], KPP_REAL b[] );
+ int KppDecompLev( KPP_REAL A[] );
+ void KppSolveLev( KPP_REAL A[], KPP_REAL b[] );
+ int KppILU0( KPP_REAL A[] );
+ KPP_REAL KppRowShift( KPP_REAL JVS[], int k );
+ int KppILU0CmplxR( KPP_REAL JVSR[], KPP_REAL JVSI[] );
+ int KppKrylov( int Method, KPP_REAL Shift, KPP_REAL JVS[], KPP_REAL Prec[],
+	KPP_REAL W[], KPP_REAL Tol, KPP_REAL X[], int *Nit );
+ int KppKrylovCmplxR( int Method, KPP_REAL ShiftR, KPP_REAL ShiftI,
+	KPP_REAL JVS[], KPP_REAL PrecR[], KPP_REAL PrecI[], KPP_REAL W[],
+	KPP_REAL Tol, KPP_REAL XR[], KPP_REAL XI[], int *Nit );
  void Update_SUN();
  void Update_RCONST();
  void Update_PHOTO();
@@ -137,6 +164,9 @@ void INTEGRATE(KPP_REAL TIN, KPP_REAL TOUT )
    int ICNTRL[20],
        ISTATUS[20];
    static int Ntotal = 0; /* for printing the number of steps */
+#ifdef _OPENMP
+   #pragma omp threadprivate( Ntotal )
+#endif
    
    int i;
    for ( i = 0; i < 20; i++ ) {
@@ -148,8 +178,9 @@ void INTEGRATE(KPP_REAL TIN, KPP_REAL TOUT )
    ICNTRL[1]  = 0;    /* 0=vector tolerances, 1=scalar tolerances */
    ICNTRL[4]  = 8;    /* Max no. of Newton iterations */
    ICNTRL[5]  = 0;    /* Starting values for Newton are interpolated(0) or zero(1) */
+   ICNTRL[6]  = 0;    /* Linear solver: sparse LU (0), GMRES (1), BiCGStab (2) */
    ICNTRL[9]  = 1;    /* 0 - classic or 1 - SDIRK error estimation */
-   ICNTRL[10] = 0;    /* Gustaffson(0) or classic(1) controller */ 
+   ICNTRL[10] = 0;    /* Gustaffson(0), classic(1) or PID(2) controller */ 
    
 //   /*~~~> if optional parameters are given, and if they are >0,
 //          then use them to overwrite default settings */	
@@ -270,6 +301,11 @@ void RungeKutta(int N, KPP_REAL T, KPP_REAL Tend, KPP_REAL Y[],
 		     (the default)
    	ICNTRL[5] = 1: starting values are zero
 
+     ICNTRL[6] -> linear solver for the Newton iterations
+	ICNTRL[6] = 0: sparse LU decomposition (the default)
+	ICNTRL[6] = 1: GMRES    } preconditioned by ILU(0) factorizations
+	ICNTRL[6] = 2: BiCGStab } of the real and complex matrices
+
      ICNTRL[9] -> switch for error estimation strategy
 	ICNTRL[9] = 0: one additional stage at c = 0,
 		     see Hairer (default)
@@ -277,8 +313,11 @@ void RungeKutta(int N, KPP_REAL T, KPP_REAL Tend, KPP_REAL Y[],
 		     and SDIRK at c = 1, stiffly accurate
 
      ICNTRL[10] -> switch for step size strategy
-	ICNTRL[10] = 0: mod. predictive controller (Gustafsson, default)
+	ICNTRL[10] = 0: mod. predictive controller (Gustafsson, default),
+		  a PI controller on the step size ratio
 	ICNTRL[10] = 1: classical step size control
+	ICNTRL[10] = 2: PID, the predictive controller times the term
+		  (ErrOld^2/(Err*ErrOld2))^(1/16) of the last three errors
  	the choice 1 seems to produce safer results;
 	for simple problems, the choice 2 produces
 	often slightly faster runs
@@ -315,6 +354,11 @@ void RungeKutta(int N, KPP_REAL T, KPP_REAL Tend, KPP_REAL Y[],
      RCNTRL[10] -> Qmax. If Qmin < Hnew/Hold < Qmax, then the
 		 step size is kept constant and the LU factorization
 		 reused (default Qmin=1, Qmax=1.2)	
+
+     RCNTRL[11] -> KrylovTol, for ICNTRL[6] > 0: the Krylov solve stops
+		 when the residual, times H/gamma and scaled by
+		 AbsTol+RelTol*|Y|, has an RMS norm below KrylovTol
+		 (default=0.01)
 ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
   *~~~>     OUTPUT ARGUMENTS:
@@ -336,6 +380,9 @@ void RungeKutta(int N, KPP_REAL T, KPP_REAL Tend, KPP_REAL Y[],
      ISTATUS[5] -> No. of LU decompositions
      ISTATUS[6] -> No. of forward/backward substitutions
      ISTATUS[7] -> No. of singular matrix decompositions
+     ISTATUS[8] -> No. of Krylov iterations
+     ISTATUS[9] -> No. of step size reductions after a singular
+		 matrix or a failed Newton iteration
 
      RSTATUS[0] -> Texit, the time corresponding to the 
 		 computed Y upon return
@@ -364,6 +411,8 @@ void RungeKutta(int N, KPP_REAL T, KPP_REAL Tend, KPP_REAL Y[],
 	= -11 : Matrix is repeatedly singular
    	= -12 : Non-convergence of Newton iterations
     	= -13 : Requested RK method not implemented
+    	= -14 : Selected linear solver not implemented
+    	= -15 : Selected step size controller not implemented
 ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 {
   /*~~~>  Control arguments */
@@ -386,7 +435,7 @@ void RungeKutta(int N, KPP_REAL T, KPP_REAL Tend, KPP_REAL Y[],
        ITOL,
        i,
        StartNewton,
-       Gustafsson; 
+       Controller; 
 
    *IERR = 0;
    for (i = 0; i < 20; i++) {
@@ -468,13 +517,20 @@ void RungeKutta(int N, KPP_REAL T, KPP_REAL Tend, KPP_REAL Y[],
 	StartNewton = 0;
    } /* end if */
 
- /*~~~> Gustafsson: step size controller */
-   if (ICNTRL[10] == 0) {
-	Gustafsson = 1;
-	/*printf("Gustafsson = %d\n", Gustafsson);*/
-   }
-   else {
-	Gustafsson = 0;
+ /*~~~> Controller: step size controller */
+   Controller = ICNTRL[10];
+   if ((ICNTRL[10] < 0) || (ICNTRL[10] > 2)) {
+	printf("\n ICNTRL[10]=%d\n", ICNTRL[10]);
+	*IERR = -15;
+	RK_ErrorMsg(-15, T, ZERO, IERR);
+   } /* end if */
+
+ /*~~~> rkLinSolver: the linear solver */
+   rkLinSolver = ICNTRL[6];
+   if ((ICNTRL[6] < 0) || (ICNTRL[6] > 2)) {
+	printf("\n ICNTRL[6]=%d\n", ICNTRL[6]);
+	*IERR = -14;
+	RK_ErrorMsg(-14, T, ZERO, IERR);
    } /* end if */
   
  /*~~~> Roundoff: smallest number s.t. 1.0 + Roundoff > 1.0 */
@@ -581,6 +637,11 @@ void RungeKutta(int N, KPP_REAL T, KPP_REAL Tend, KPP_REAL Y[],
 	printf("\n RCNTRL[10]=%f\n", Qmax);
 	RK_ErrorMsg(-7, T, ZERO, IERR);
    } /* end if */
+ /*~~~> KrylovTol: stopping criterion of the Krylov solver */
+   if (RCNTRL[11] == ZERO)
+	rkKrylovTol = (KPP_REAL)0.01;
+   else
+	rkKrylovTol = RCNTRL[11];
  /*~~~> Check if tolerances are reasonable */
    if (ITOL == 0) {
 	if ( AbsTol[0] <= ZERO || RelTol[0] <= ( ((KPP_REAL)10.0)*Roundoff) ) {
@@ -606,7 +667,7 @@ void RungeKutta(int N, KPP_REAL T, KPP_REAL Tend, KPP_REAL Y[],
  /*~~~> Call the core method */	
    RK_Integrator(N, &T, Tend, Y, AbsTol, RelTol, ITOL, ISTATUS, RSTATUS,
 		   Hmin, Hmax, Hstart, Roundoff, Max_no_steps, NewtonMaxit,
-		   StartNewton, Gustafsson, ThetaMin, NewtonTol,
+		   StartNewton, Controller, ThetaMin, NewtonTol,
 		   FacSafe, FacMax, FacMin, FacRej, Qmin, Qmax, IERR);
   /*printf("*IERR = %d\n", *IERR);*/
   /*printf("Ending RungeKutta\n");*/
@@ -620,7 +681,7 @@ void RK_Integrator( int N,
   /*~~~> Input: the initial condition at T; output: the solution at Tend */     
      	int ISTATUS[], KPP_REAL RSTATUS[], KPP_REAL Hmin, KPP_REAL Hmax, 
 	KPP_REAL Hstart, KPP_REAL Roundoff, int Max_no_steps, int NewtonMaxit,
-       	int StartNewton, int Gustafsson, KPP_REAL ThetaMin,
+       	int StartNewton, int Controller, KPP_REAL ThetaMin,
        	KPP_REAL NewtonTol, KPP_REAL FacSafe, KPP_REAL FacMax, KPP_REAL FacMin,
      	KPP_REAL FacRej, KPP_REAL Qmin, KPP_REAL Qmax, int* IERR)
 {  
@@ -649,9 +710,11 @@ void RK_Integrator( int N,
 	  Hold,
 	  Fac,
 	  FacGus, 
+	  Shift,
    	  Theta,
 	  Err,
 	  ErrOld,
+	  ErrOld2,
 	  NewtonRate,
 	  NewtonIncrement,
 	  Hratio,
@@ -695,7 +758,12 @@ void RK_Integrator( int N,
 	H = Tend - *T;
    } /* end if */
    Nconsecutive = 0;
+   Hacc = H;
+   ErrOld = ONE;
+   ErrOld2 = ONE;
    RK_ErrorScale(N, ITOL, AbsTol, RelTol, Y, SCAL);
+   rkFJAC = FJAC;
+   rkSCAL = SCAL;
    /*for(i=0; i<NVAR; i++) {
         printf("AbsTol=%g RelTol=%g Y=%g SCAL=%g \n", AbsTol[i], RelTol[i], Y[i], SCAL[i] );
    }*/
@@ -727,7 +795,15 @@ Tloop:   while ( (Tend-*T)*Tdirection - Roundoff > ZERO ) {
 	   if (Nconsecutive >= 5) {
 		RK_ErrorMsg(-12,*T,H,IERR);
 	   }
-	   H = H * ((KPP_REAL)0.5);
+	   /* Reduce H so that the row with the zero pivot becomes diagonally
+	      dominant (Gershgorin bound), by a factor between FacMin and 1/2 */
+	   Fac = (KPP_REAL)0.5;
+	   Shift = KppRowShift(FJAC, ISING-1);
+	   if ( (Tdirection > ZERO) && (Shift > ZERO) )
+		Fac = MIN((KPP_REAL)0.5, MAX(FacMin,
+			(KPP_REAL)0.5*MIN(rkGamma,rkAlpha)/(H*Shift)));
+	   H = H * Fac;
+	   ISTATUS[Nred]++;
 	   Reject = 1;
 	   SkipJac = 1;
 	   SkipLU = 0;
@@ -844,6 +920,7 @@ Tloop:   while ( (Tend-*T)*Tdirection - Roundoff > ZERO ) {
 	/*printf( "Entering if NewtonDone == 0\n" );*/
 	/*RK_ErrorMsg(-12,*T,H,IERR); */
 	H = Fac*H;
+	ISTATUS[Nred]++;
 	Reject  = 1;
 	SkipJac = 1;
 	SkipLU  = 0;
@@ -888,7 +965,7 @@ Tloop:   while ( (Tend-*T)*Tdirection - Roundoff > ZERO ) {
 	   WAXPY(N,rkGamma/H,G,1,DZ4,1);
 
 	   /*~~~> Solve the linear system */
-	   KppSolve(E1, DZ4);
+	   RK_SolveReal(H, E1, DZ4, ISTATUS);
 	   /*~~~> Note: for a full matrix use Lapack:
 		DGETRS('N', 5, 1, E1, N, IP1, DZ4, 5, ISING) */
 
@@ -940,6 +1017,7 @@ Tloop:   while ( (Tend-*T)*Tdirection - Roundoff > ZERO ) {
       	if ( NewtonDone == 0 ) {
 	   /*printf( "Entering if NewtonDone == 0\n" );*/
 	   H       = Fac*H;
+	   ISTATUS[Nred]++;
 	   Reject  = 1;
 	   SkipJac = 1;
 	   SkipLU  = 0;
@@ -998,15 +1076,19 @@ Tloop:   while ( (Tend-*T)*Tdirection - Roundoff > ZERO ) {
       if (Err < ONE) { /*~~~> STEP IS ACCEPTED */
       	FirstStep = 0;
       	ISTATUS[Nacc]++;
-      	if (Gustafsson == 1) {
+      	if (Controller != 1) {
 	   /*~~~> Predictive controller of Gustafsson */
 	   if (ISTATUS[Nacc] > 1) {
 	      FacGus = FacSafe*(H/Hacc)*pow(Err*Err/ErrOld,(KPP_REAL)(-0.25));
+	      /*~~~> PID: derivative term from the last three errors */
+	      if ((Controller == 2) && (ISTATUS[Nacc] > 2))
+		 FacGus = FacGus*pow(ErrOld*ErrOld/(Err*ErrOld2),(KPP_REAL)0.0625);
 	      FacGus = MIN(FacMax,MAX(FacMin,FacGus));
 	      Fac = MIN(Fac,FacGus);	
 	      Hnew = Fac*H;
 	   } /* end if */
 	   Hacc = H;
+	   ErrOld2 = ErrOld;
 	   ErrOld = MAX((KPP_REAL)1.0e-02,Err);
       	} /* end if */
         Hold = H;
@@ -1111,6 +1193,12 @@ void RK_ErrorMsg(int Code, KPP_REAL T, KPP_REAL H, int* IERR)
    case -13:
       printf("--> Requested RK method not implemented");
       break;
+   case -14:
+      printf("--> Selected linear solver not implemented");
+      break;
+   case -15:
+      printf("--> Selected step size controller not implemented");
+      break;
    default:
       printf("Unknown Error code: %d \n", Code);
    } /* end switch */ 
@@ -1269,7 +1357,10 @@ void RK_Decomp(int N, KPP_REAL H, KPP_REAL FJAC[], KPP_REAL E1[],
 	j = LU_DIAG[i];
 	E1[j] = E1[j] + Gamma;
    }
-   *ISING = KppDecomp(E1);
+   if (rkLinSolver)
+	*ISING = KppILU0(E1);
+   else
+	*ISING = KppDecompLev(E1);
    /*~~~> Note: for a full matrix use Lapack:
    for (j = 0; j < N; j++) {
 	for (i = 0; i < N; i++)
@@ -1295,7 +1386,10 @@ void RK_Decomp(int N, KPP_REAL H, KPP_REAL FJAC[], KPP_REAL E1[],
 	E2R[j] = E2R[j] + Alpha;
 	E2I[j] = E2I[j] + Beta;
    }
-   *ISING = KppDecompCmplxR(E2R, E2I);
+   if (rkLinSolver)
+	*ISING = KppILU0CmplxR(E2R, E2I);
+   else
+	*ISING = KppDecompCmplxR(E2R, E2I);
    /*printf("Matrix is singular, ISING=%d\n", *ISING);*/
    /*~~~> Note: for a full matrix use Lapack:
    for (j = 0; j < N; j++) {
@@ -1327,7 +1421,7 @@ void RK_Solve(int N, KPP_REAL H, KPP_REAL E1[], int IP1[], KPP_REAL E2R[],
 	R2[i] = rkTinvAinv[1][0]*x1 + rkTinvAinv[1][1]*x2 + rkTinvAinv[1][2]*x3;
 	R3[i] = rkTinvAinv[2][0]*x1 + rkTinvAinv[2][1]*x2 + rkTinvAinv[2][2]*x3;
    } 
-   KppSolve(E1,R1);
+   RK_SolveReal(H,E1,R1,ISTATUS);
    /*~~~> Note: for a full matrix use Lapack:
    DGETRS('N',5,1,E1,N,IP1,R1,5,0); */
    for(i = 0; i < N; i++)
@@ -1335,7 +1429,7 @@ void RK_Solve(int N, KPP_REAL H, KPP_REAL E1[], int IP1[], KPP_REAL E2R[],
         BCR[i] = (KPP_REAL)(R2[i]);
         BCI[i] = (KPP_REAL)(R3[i]);
    }
-   KppSolveCmplxR(E2R,E2I,BCR,BCI);
+   RK_SolveCmplx(H,E2R,E2I,BCR,BCI,ISTATUS);
    /*~~~> Note: for a full matrix use Lapack:
    ZGETRS ('N',N,1,E2,N,IP2,BC,N,0); */
    for (i = 0; i < N; i++)
@@ -1357,6 +1451,92 @@ void RK_Solve(int N, KPP_REAL H, KPP_REAL E1[], int IP1[], KPP_REAL E2R[],
    ISTATUS[Nsol]++;
 } /* RK_Solve */
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/*~~~> Solves (rkGamma/H - Jac)*x = R with the matrix E1: its LU
+	decomposition, or with rkLinSolver > 0 its ILU(0) as preconditioner
+	of the Krylov solver. If the Krylov solver does not converge E1 is
+	replaced by the LU decomposition until the next RK_Decomp
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void RK_SolveReal(KPP_REAL H, KPP_REAL E1[], KPP_REAL R[], int ISTATUS[])
+{
+   KPP_REAL Gamma, B[NVAR], W[NVAR];
+   int i;
+
+   if (rkLinSolver == 0) {
+	KppSolveLev(E1, R);
+	return;
+   }
+   Gamma = rkGamma / H;
+   for (i = 0; i < NVAR; i++) {
+	B[i] = R[i];
+	W[i] = rkSCAL[i] / ABS(Gamma);
+   }
+   if (KppKrylov(rkLinSolver, Gamma, rkFJAC, E1, W, rkKrylovTol, R,
+		&ISTATUS[Nkry]) == 0)
+	return;
+
+   /*~~~> No convergence: sparse LU decomposition */
+   for (i = 0; i < LU_NONZERO; i++)
+	E1[i] = -rkFJAC[i];
+   for (i = 0; i < NVAR; i++)
+	E1[LU_DIAG[i]] = E1[LU_DIAG[i]] + Gamma;
+   ISTATUS[Ndec]++;
+   if (KppDecompLev(E1) != 0) {
+	ISTATUS[Nsng]++;
+	return;	/* R is returned: the Newton iterations will not converge */
+   }
+   for (i = 0; i < NVAR; i++)
+	R[i] = B[i];
+   KppSolveLev(E1, R);
+} /* RK_SolveReal */
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/*~~~> Complex version of RK_SolveReal: solves
+	((rkAlpha + i*rkBeta)/H - Jac)*x = BR + i*BI with the matrix E2
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void RK_SolveCmplx(KPP_REAL H, KPP_REAL E2R[], KPP_REAL E2I[], KPP_REAL BR[],
+	KPP_REAL BI[], int ISTATUS[])
+{
+   KPP_REAL Alpha, Beta, Mod, B[2*NVAR], W[NVAR];
+   int i;
+
+   if (rkLinSolver == 0) {
+	KppSolveCmplxR(E2R, E2I, BR, BI);
+	return;
+   }
+   Alpha = rkAlpha / H;
+   Beta  = rkBeta / H;
+   Mod   = SQRT(Alpha*Alpha + Beta*Beta);
+   for (i = 0; i < NVAR; i++) {
+	B[i] = BR[i];
+	B[NVAR+i] = BI[i];
+	W[i] = rkSCAL[i] / Mod;
+   }
+   if (KppKrylovCmplxR(rkLinSolver, Alpha, Beta, rkFJAC, E2R, E2I, W,
+		rkKrylovTol, BR, BI, &ISTATUS[Nkry]) == 0)
+	return;
+
+   /*~~~> No convergence: sparse LU decomposition */
+   for (i = 0; i < LU_NONZERO; i++) {
+	E2R[i] = -rkFJAC[i];
+	E2I[i] = ZERO;
+   }
+   for (i = 0; i < NVAR; i++) {
+	E2R[LU_DIAG[i]] = E2R[LU_DIAG[i]] + Alpha;
+	E2I[LU_DIAG[i]] = E2I[LU_DIAG[i]] + Beta;
+   }
+   ISTATUS[Ndec]++;
+   if (KppDecompCmplxR(E2R, E2I) != 0) {
+	ISTATUS[Nsng]++;
+	return;
+   }
+   for (i = 0; i < NVAR; i++) {
+	BR[i] = B[i];
+	BI[i] = B[NVAR+i];
+   }
+   KppSolveCmplxR(E2R, E2I, BR, BI);
+} /* RK_SolveCmplx */
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 void RK_ErrorEstimate(int N, KPP_REAL H, KPP_REAL T, KPP_REAL Y[], 
 	KPP_REAL FO[], KPP_REAL E1[], int IP1[], KPP_REAL Z1[], 
@@ -1378,11 +1558,11 @@ void RK_ErrorEstimate(int N, KPP_REAL H, KPP_REAL T, KPP_REAL Y[],
 	TMP[i] = rkE[0]*FO[i] + F2[i];
    }
    
-   KppSolve(E1, TMP);
+   RK_SolveReal(H, E1, TMP, ISTATUS);
    if ((rkMethod == R1A) || (rkMethod == GAU) || (rkMethod == L3A))
-	KppSolve(E1,TMP);
+	RK_SolveReal(H, E1, TMP, ISTATUS);
    if (rkMethod == GAU)
-	KppSolve(E1,TMP);
+	RK_SolveReal(H, E1, TMP, ISTATUS);
    /*~~~> Note: for a full matrix use Lapack:
 	DGETRS ('N',N,1,E1,N,IP1,TMP,N,0);
       	if ((rkMethod == R1A) || (rkMethod == GAU) || (rkMethod == L3A))
@@ -1405,7 +1585,7 @@ void RK_ErrorEstimate(int N, KPP_REAL H, KPP_REAL T, KPP_REAL Y[],
 	   TMP[i] = F1[i] + F2[i];
 	} /* end for */
 
-        KppSolve(E1, TMP);
+        RK_SolveReal(H, E1, TMP, ISTATUS);
 	/*~~~> Note: for a full matrix use Lapack:
 	   DGETRS ('N',N,1,E1,N,IP1,TMP,N,0); */
         *Err = RK_ErrorNorm(N,SCAL,TMP);
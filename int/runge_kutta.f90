@@ -55,6 +55,7 @@ CONTAINS
     KPP_REAL :: RCNTRL(20), RSTATUS(20), T1, T2
     INTEGER :: ICNTRL(20), ISTATUS(20)
     INTEGER, SAVE :: Ntotal = 0
+!$OMP THREADPRIVATE(Ntotal)
 
     RCNTRL(1:20) = 0.0_dp
     ICNTRL(1:20) = 0
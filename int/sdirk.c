@@ -10,17 +10,20 @@
 #define  ONE      (KPP_REAL)1.0
 
 /* ~~~>  Statistics on the work performed by the SDIRK method */
-#define  Nfun 1
-#define  Njac 2
-#define  Nstp 3
-#define  Nacc 4
-#define  Nrej 5
-#define  Ndec 6
-#define  Nsol 7
-#define  Nsng 8
-#define  Ntexit 1
-#define  Nhexit 2
-#define  Nhnew 3
+#define  Nfun 0
+#define  Njac 1
+#define  Nstp 2
+#define  Nacc 3
+#define  Nrej 4
+#define  Ndec 5
+#define  Nsol 6
+#define  Nsng 7
+#define  Nkry 8
+#define  Nred 9
+#define  Ntexit 0
+#define  Nhexit 1
+#define  Nhnew 2
+#define  ErrHistMin (KPP_REAL)1.0e-2  /* Lower bound of the stored errors */
 
 /*~~~>  SDIRK method coefficients, up to 5 stages    */
 #define Smax 5
@@ -45,6 +48,20 @@ KPP_REAL rkGamma,
 	rkTheta[Smax][Smax], 
 	rkAlpha[Smax][Smax];
 
+/*~~~> Linear solver: sparse LU (0), GMRES (1) or BiCGStab (2); the Krylov
+	solvers apply the Jacobian sdFJAC and scale by the weights sdSCAL */
+int sdLinSolver;
+KPP_REAL sdKrylovTol,
+	*sdFJAC,
+	*sdSCAL;
+/*~~~> Step size controller: classical (0), PI (1) or PID (2) */
+int sdController;
+#ifdef _OPENMP
+#pragma omp threadprivate( sdMethod, rkS, rkGamma, rkA, rkB, rkELO, rkBhat, \
+	rkC, rkD, rkE, rkTheta, rkAlpha, sdLinSolver, sdKrylovTol, sdFJAC, \
+	sdSCAL, sdController )
+#endif
+
 /*~~~> Function headers     */
 //void INTEGRATE(KPP_REAL TIN, KPP_REAL TOUT, int ICNTRL_U[], KPP_REAL RCNTRL_U[],
 //	int ISTATUS_U[], KPP_REAL RSTATUS_U[], int Ierr);
@@ -62,11 +79,15 @@ void SDIRK_ErrorScale(int N, int ITOL, KPP_REAL AbsTol[], KPP_REAL RelTol[],
 	KPP_REAL Y[], KPP_REAL SCAL[]);
 KPP_REAL SDIRK_ErrorNorm(int N, KPP_REAL Y[], KPP_REAL SCAL[]);
 int SDIRK_ErrorMsg(int code, KPP_REAL T, KPP_REAL H, int Ierr);
-void SDIRK_PrepareMatrix(KPP_REAL H, KPP_REAL T, KPP_REAL Y[], KPP_REAL FJAC[], 
-	int SkipJac, int SkipLU, KPP_REAL E[], int IP[], int Reject, 
-	int ISING, int ISTATUS[]);
+void SDIRK_PrepareMatrix(KPP_REAL* H, KPP_REAL T, KPP_REAL Y[], KPP_REAL FJAC[], 
+	int SkipJac, int SkipLU, KPP_REAL FacMin, KPP_REAL E[], int IP[], 
+	int* Reject, int* ISING, int ISTATUS[]);
+KPP_REAL SDIRK_StepFactor(int Controller, KPP_REAL Err, KPP_REAL ErrOld[],
+	int Nhist, KPP_REAL Hratio);
 void SDIRK_Solve(KPP_REAL H, int N, KPP_REAL E[], int IP[], int ISING, 
 	KPP_REAL RHS[], int ISTATUS[]);
+void SDIRK_KrylovSolve(KPP_REAL HGammaInv, KPP_REAL E[], KPP_REAL RHS[],
+	int ISTATUS[]);
 void Sdirk4a(void);
 void Sdirk4b(void);
 void Sdirk2a(void);
@@ -83,6 +104,12 @@ void WADD(int N, KPP_REAL Y[], KPP_REAL Z[], KPP_REAL TMP[]);
 void Set2Zero(int N, KPP_REAL Y[]);
 void KppSolve(KPP_REAL A[], KPP_REAL b[]);
 int KppDecomp(KPP_REAL A[]);
+int KppDecompLev(KPP_REAL A[]);
+void KppSolveLev(KPP_REAL A[], KPP_REAL b[]);
+int KppILU0(KPP_REAL A[]);
+KPP_REAL KppRowShift(KPP_REAL JVS[], int k);
+int KppKrylov(int Method, KPP_REAL Shift, KPP_REAL JVS[], KPP_REAL Prec[],
+	KPP_REAL W[], KPP_REAL Tol, KPP_REAL X[], int *Nit);
 void Update_SUN();
 void Update_RCONST();
 
@@ -116,6 +143,8 @@ for(i=0; i<20; i++) {
 /*~> fine-tune the integrator: */
 ICNTRL[1] = 0; /* 0 - vector tolerances, 1 - scalar tolerances */
 ICNTRL[5] = 0; /* starting values of N. iter.: interpolated 0), zero (1) */
+ICNTRL[6] = 0; /* linear solver: sparse LU (0), GMRES (1), BiCGStab (2) */
+ICNTRL[10] = 0; /* step size controller: classical (0), PI (1), PID (2) */
 
 ///* If optional parameters are given, and if they are >0, 
 //	then they overwrite default settings. */
@@ -236,6 +265,18 @@ int SDIRK(int N, KPP_REAL Tinitial, KPP_REAL Tfinal, KPP_REAL Y[],
     ICNTRL[5]  -> starting values of Newton iterations:
     ICNTRL[5]=0 : starting values are interpolated (the default)
     ICNTRL[5]=1 : starting values are zero
+    ICNTRL[6]  -> linear solver for the Newton iterations
+    ICNTRL[6]=0 : sparse LU decomposition (the default)
+    ICNTRL[6]=1 : GMRES    } preconditioned by an ILU(0) of the matrix,
+    ICNTRL[6]=2 : BiCGStab } computed together with the Jacobian
+    ICNTRL[10] -> step size controller, from the error Err of the step
+                  and Err1, Err2 of the two previous accepted steps
+    ICNTRL[10]=0 : classical, Hnew/H = FacSafe*Err^(-1/ELO) (the default)
+    ICNTRL[10]=1 : PI, the predictive controller of Gustafsson
+                   Hnew/H = FacSafe*(H/Hold)*(Err1/Err^2)^(1/ELO)
+    ICNTRL[10]=2 : PID, the PI ratio times (Err1^2/(Err*Err2))^(1/(4*ELO))
+                   The PI/PID ratio is taken if smaller than the classical
+                   one; a rejected step is reduced by the classical controller
 
 ~~~>  Real parameters
 
@@ -258,6 +299,9 @@ int SDIRK(int N, KPP_REAL Tinitial, KPP_REAL Tfinal, KPP_REAL Y[],
     RCNTRL[10] -> Qmax. If Qmin < Hnew/Hold < Qmax, then the
                   step size is kept constant and the LU factorization
                   reused (default Qmin=1, Qmax=1.2)
+    RCNTRL[11] -> KrylovTol, for ICNTRL[6] > 0: the Krylov solve stops when
+                  the residual, times H*gamma and scaled by AbsTol+RelTol*|Y|,
+                  has an RMS norm below KrylovTol (default=0.01)
 ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 ~~~>  OUTPUT PARAMETERS:
    Note: each call to Rosenbrock adds the current no. of fcn calls
@@ -271,6 +315,9 @@ int SDIRK(int N, KPP_REAL Tinitial, KPP_REAL Tfinal, KPP_REAL Y[],
   ISTATUS[5] = No. of LU decompositions
   ISTATUS[6] = No. of forward/backward substitutions
   ISTATUS[7] = No. of singular matrix decompositions
+  ISTATUS[8] = No. of Krylov iterations
+  ISTATUS[9] = No. of step size reductions after a singular matrix or a
+               failed Newton iteration
   RSTATUS[0]  -> Texit, the time corresponding to the computed Y upon return
   RSTATUS[1]  -> Hexit,last accepted step before return
   RSTATUS[2]  -> Hnew, last predicted step before return
@@ -369,6 +416,20 @@ else {
 	StartNewton = 0;
 } /* end if */
 
+/*~~~> The linear solver */
+sdLinSolver = ICNTRL[6];
+if ((ICNTRL[6] < 0) || (ICNTRL[6] > 2)) {
+	printf("User-selected linear solver: ICNTRL[6]=%d", ICNTRL[6]);
+	Ierr = SDIRK_ErrorMsg(-9,Tinitial,ZERO,Ierr);
+} /* end if */
+
+/*~~~> The step size controller */
+sdController = ICNTRL[10];
+if ((ICNTRL[10] < 0) || (ICNTRL[10] > 2)) {
+	printf("User-selected step size controller: ICNTRL[10]=%d", ICNTRL[10]);
+	Ierr = SDIRK_ErrorMsg(-10,Tinitial,ZERO,Ierr);
+} /* end if */
+
 /*~~~>  Unit roundoff (1+Roundoff>1) */
 Roundoff = WLAMCH('E');
 
@@ -486,6 +547,18 @@ else {
 	Qmax = RCNTRL [10];
 } /* end if */
 
+/*~~~> KrylovTol: Stopping criterion of the Krylov solver */
+if (RCNTRL[11] == ZERO) {
+	sdKrylovTol = (KPP_REAL)0.01;
+}
+else if (RCNTRL[11] > ZERO) {
+	sdKrylovTol = RCNTRL[11];
+}
+else {
+	printf("User-selected KrylovTol: RCNTRL[11]=%f", RCNTRL[11]);
+	Ierr = SDIRK_ErrorMsg(-5,Tinitial,ZERO,Ierr);
+} /* end if */
+
 /* ~~~>  Check if tolerances are reasonable */
 if (ITOL == 0) {
 	if ((AbsTol[0]<=ZERO || RelTol[0])<=(((KPP_REAL)10.0)*Roundoff)) {
@@ -537,8 +610,10 @@ KPP_REAL Z[Smax][NVAR],
 	NewtonPredictedErr,
 	Qnewton,
 	Err=0,
+	ErrOld[2],
 	Fac,
 	Hnew,
+	Hacc,
 	Tdirection,
 	NewtonIncrement=0,
 	NewtonIncrementOld=0;
@@ -553,6 +628,7 @@ int IER=0,
 	SkipLU,
 	NewtonDone,
 	CycleTloop,
+	Nhist,
 	i,
 	j;
 
@@ -582,8 +658,14 @@ SkipJac = 0;
 Reject = 0;
 FirstStep = 1;
 CycleTloop = 0;
+Nhist = 0;
+Hacc = H;
 
 SDIRK_ErrorScale(N, ITOL, AbsTol, RelTol, Y, SCAL);
+#ifndef FULL_ALGEBRA
+sdFJAC = FJAC;
+sdSCAL = SCAL;
+#endif
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 /*~~~>  Time loop begins                */
@@ -592,11 +674,10 @@ while((Tfinal-T)*Tdirection - Roundoff > ZERO) {  /* Tloop */
 
 /*~~~>  Compute E = 1/(h*gamma)-Jac and its LU decomposition */
 	if(SkipLU == 0) { /* This time around skip the Jac update and LU */
-		SDIRK_PrepareMatrix(H, T, Y, FJAC, SkipJac, SkipLU, E, IP, 
-			Reject, IER, ISTATUS);
+		SDIRK_PrepareMatrix(&H, T, Y, FJAC, SkipJac, SkipLU, FacMin, E,
+			IP, &Reject, &IER, ISTATUS);
 		if(IER != 0) {
-			SDIRK_ErrorMsg(-8, T, H, Ierr);
-		return Ierr;
+			return SDIRK_ErrorMsg(-8, T, H, Ierr);
 		} /* end if */
 	} /* end if */
 
@@ -701,6 +782,7 @@ while((Tfinal-T)*Tdirection - Roundoff > ZERO) {  /* Tloop */
 		if(NewtonDone == 0) {
 		/* CALL RK_ErrorMsg(-12,T,H,Ierr); */
 			H = Fac*H;
+			ISTATUS[Nred]++;
 			Reject = 1; /* true */
 			SkipJac = 1;/* true */
 			SkipLU = 0;/* false */
@@ -743,6 +825,18 @@ while((Tfinal-T)*Tdirection - Roundoff > ZERO) {  /* Tloop */
 		FirstStep = 0; /* false */
 		ISTATUS[Nacc]++;
 
+	/*~~~> The PI/PID controllers predict from the previous accepted steps */
+		if((sdController != 0) && (Nhist >= 1)) {
+			Fac = MIN(Fac, MAX(FacMin, MIN(FacMax, FacSafe*
+				SDIRK_StepFactor(sdController, Err, ErrOld,
+				Nhist, H/Hacc))));
+			Hnew = H*Fac;
+		} /* end if */
+		Hacc = H;
+		ErrOld[1] = ErrOld[0];
+		ErrOld[0] = MAX(ErrHistMin, Err);
+		Nhist++;
+
 	/*~~~> Update time and solution */
 		T = T + H;
 
@@ -889,6 +983,12 @@ case -7:
 case -8:
 	printf("--> Matrix is repeatedly singular");
 	break;
+case -9:
+	printf("--> Selected linear solver not implemented");
+	break;
+case -10:
+	printf("--> Selected step size controller not implemented");
+	break;
 default: /* causing an error */
 	printf("Unknown Error code: %d", code);
 
@@ -902,22 +1002,25 @@ return code;
 } /*  end SDIRK_ErrorMsg   */
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
-void SDIRK_PrepareMatrix(KPP_REAL H, KPP_REAL T, KPP_REAL Y[], KPP_REAL FJAC[],
-			int SkipJac, int SkipLU, KPP_REAL E[], int IP[], 
-			int Reject, int ISING, int ISTATUS[] )
+void SDIRK_PrepareMatrix(KPP_REAL* H, KPP_REAL T, KPP_REAL Y[], KPP_REAL FJAC[],
+			int SkipJac, int SkipLU, KPP_REAL FacMin, KPP_REAL E[],
+			int IP[], int* Reject, int* ISING, int ISTATUS[] )
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
- *  Compute the matrix E = 1/(H*GAMMA)*Jac, and its decomposition
+ *  Compute the matrix E = 1/(H*GAMMA)*Jac, and its decomposition;
+ *  for a zero pivot in row k, H is reduced so that row k becomes
+ *  diagonally dominant (Gershgorin bound of row k of FJAC), by a
+ *  factor between FacMin and 1/2
  *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 {
 
-KPP_REAL HGammaInv;
+KPP_REAL HGammaInv, Fac, Shift;
 int i, j;
 int ConsecutiveSng = 0;
-ISING = 1;
+*ISING = 1;
 
 
-while( ISING != 0) {
-	HGammaInv = ONE/(H*rkGamma);
+while( *ISING != 0) {
+	HGammaInv = ONE/((*H)*rkGamma);
 
 /*~~~>  Compute the Jacobian */
 	if(SkipJac==0) {
@@ -945,13 +1048,18 @@ while( ISING != 0) {
 			E[j]=E[j] + HGammaInv;
 		} /* end for */
 
-		ISING = KppDecomp(E);
+		if(sdLinSolver) {
+			*ISING = KppILU0(E);
+		}
+		else {
+			*ISING = KppDecompLev(E);
+		} /* end if */
 		IP[0] = 1;
 	#endif
 
 	ISTATUS[Ndec]++;
 
-	if(ISING != 0) {
+	if(*ISING != 0) {
 		ISTATUS[Nsng]++;
 		ConsecutiveSng++;
 
@@ -959,15 +1067,47 @@ while( ISING != 0) {
 			return; /* Failure */
 		} /* end internal if */
 
-		H = (KPP_REAL)(0.5) * H;
+		Fac = (KPP_REAL)(0.5);
+	#ifndef FULL_ALGEBRA
+		Shift = KppRowShift(FJAC, *ISING-1);
+		if((HGammaInv > ZERO) && (Shift > ZERO)) {
+			Fac = MIN((KPP_REAL)(0.5), MAX(FacMin,
+				(KPP_REAL)(0.5)*HGammaInv/Shift));
+		} /* end if */
+	#endif
+		*H = Fac * (*H);
+		ISTATUS[Nred]++;
 		SkipJac = 1; /* true */
 		SkipLU = 0; /* false */
-		Reject = 1; /* true */
+		*Reject = 1; /* true */
 	} /* end if */
 } /* end while */
 
 } /* end SDIRK_PrepareMatrix */
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+KPP_REAL SDIRK_StepFactor(int Controller, KPP_REAL Err, KPP_REAL ErrOld[],
+			int Nhist, KPP_REAL Hratio)
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  Step size ratio Hnew/H, before the safety factor and the bounds,
+ *  of the PI (Controller=1) or PID (Controller=2) controller, from
+ *  Hratio = H/Hold and the errors ErrOld[0:Nhist-1] of the previous
+ *  accepted steps; with Nhist = 1 the PID reduces to the PI controller
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+
+KPP_REAL Fac;
+
+Fac = Hratio * pow(Err*Err/ErrOld[0], -ONE/rkELO);
+if((Controller == 2) && (Nhist >= 2)) {
+	Fac = Fac * pow(ErrOld[0]*ErrOld[0]/(Err*ErrOld[1]),
+		(KPP_REAL)0.25/rkELO);
+} /* end if */
+
+return Fac;
+
+} /* end SDIRK_StepFactor */
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 void SDIRK_Solve( KPP_REAL H, int N, KPP_REAL E[], int IP[], int ISING, 
 		KPP_REAL RHS[], int ISTATUS[] )
@@ -984,12 +1124,63 @@ WSCAL(N, HGammaInv, RHS, 1);
 #ifdef FULL_ALGEBRA
 	DGETRS('N', N, 1, E, N, IP, RHS, N, ISING);
 #else
-	KppSolve(E, RHS);
+	if(sdLinSolver) {
+		SDIRK_KrylovSolve(HGammaInv, E, RHS, ISTATUS);
+	}
+	else {
+		KppSolveLev(E, RHS);
+	} /* end if */
 #endif
 	ISTATUS[Nsol]++;
 
 } /* end SDIRK_Solve */
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void SDIRK_KrylovSolve( KPP_REAL HGammaInv, KPP_REAL E[], KPP_REAL RHS[],
+		int ISTATUS[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *  Solves (HGammaInv-Jac)*x = RHS with the Krylov method sdLinSolver,
+ *  preconditioned by the ILU(0) in E. If the iterations do not
+ *  converge, E is replaced by the LU decomposition of the matrix,
+ *  which is then used (also as preconditioner) until the next
+ *  SDIRK_PrepareMatrix
+ *~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+
+KPP_REAL B[NVAR],
+	W[NVAR];
+int i, j;
+
+for(i=0; i<NVAR; i++) {
+	B[i] = RHS[i];
+	W[i] = sdSCAL[i]/HGammaInv;
+} /* end for */
+
+if(KppKrylov(sdLinSolver, HGammaInv, sdFJAC, E, W, sdKrylovTol, RHS,
+		&ISTATUS[Nkry]) == 0) {
+	return;
+} /* end if */
+
+/*~~~> No convergence: sparse LU decomposition */
+for(i=0; i<LU_NONZERO; i++) {
+	E[i] = -sdFJAC[i];
+} /* end for */
+for(i=0; i<NVAR; i++) {
+	j = LU_DIAG[i];
+	E[j] = E[j] + HGammaInv;
+} /* end for */
+ISTATUS[Ndec]++;
+if(KppDecompLev(E) != 0) {
+	ISTATUS[Nsng]++;
+	return; /* RHS is returned: the Newton iterations will not converge */
+} /* end if */
+for(i=0; i<NVAR; i++) {
+	RHS[i] = B[i];
+} /* end for */
+KppSolveLev(E, RHS);
+
+} /* end SDIRK_KrylovSolve */
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 void Sdirk4a()
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
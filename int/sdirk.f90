@@ -50,6 +50,7 @@ SUBROUTINE INTEGRATE( TIN, TOUT, &
    INTEGER,       INTENT(OUT), OPTIONAL :: Ierr_U
 
    INTEGER, SAVE :: Ntotal = 0
+!$OMP THREADPRIVATE(Ntotal)
    KPP_REAL :: RCNTRL(20), RSTATUS(20), T1, T2
    INTEGER       :: ICNTRL(20), ISTATUS(20), Ierr
 
@@ -0,0 +1,183 @@
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+/*  Adaptive explicit tau-leaping                                     */
+/*                                                                    */
+/*  Y. Cao, D. T. Gillespie and L. R. Petzold, "Efficient step size   */
+/*  selection for the tau-leaping simulation method", J. Chem. Phys.  */
+/*  124, 044109 (2006).                                               */
+/*                                                                    */
+/*  - reactions that can exhaust a reactant within NCRIT firings are  */
+/*    "critical"; at most one critical reaction fires per leap        */
+/*  - the leap size keeps the relative change of every propensity     */
+/*    below EPSTAU                                                    */
+/*  - if the leap is not worth it (tau < NSSA/a0) a batch of exact    */
+/*    SSA steps is taken instead                                      */
+/*  The state is updated through the sparse stoichiometric matrix     */
+/*  (STOICM, IROW_STOICM, CCOL_STOICM); #STOICMAT must be on.         */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void StochasticRates( double RCT[], double Volume, double SCT[] );
+void Propensity ( int V[], int F[], double SCT[], double A[] );
+void MoleculeChange ( int j, int NmlcV[] );
+void Update_RCONST();
+KPP_REAL KppRandUniform( KPP_RNG *rng );
+KPP_REAL KppRandExponential( KPP_RNG *rng );
+int KppRandPoisson( KPP_RNG *rng, KPP_REAL mu );
+
+#define NCRIT       10      /* Critical reaction threshold n_c          */
+#define EPSTAU      0.03    /* Bound on the relative propensity change  */
+#define NSSA        10.0    /* SSA is used when tau < NSSA/a0 ...       */
+#define NSSA_STEPS  100     /* ... for this many reaction events        */
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+static double TauLeapG( int i, int x )
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+/*  g_i of Cao et al. from the highest order of reaction (HOR) of     */
+/*  reactant species i and its multiplicity in those reactions        */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+      switch ( HOR_STOICM[i] ) {
+        case 1:
+          return 1.0;
+        case 2:
+          if ( (HORM_STOICM[i] == 1) || (x < 2) ) return 2.0;
+          return 2.0 + 1.0/(x-1);
+        case 3:
+          if ( (HORM_STOICM[i] == 1) || (x < 3) ) return 3.0;
+          if ( HORM_STOICM[i] == 2 ) return 1.5*(2.0 + 1.0/(x-1));
+          return 3.0 + 1.0/(x-1) + 2.0/(x-2);
+        default:
+          return (double)HOR_STOICM[i];
+      }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+int StochasticIntegrate(double Tout, double SCT[], double* T,
+               int NmlcV[], int NmlcF[], KPP_RNG* rng)
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+/*  Tau-leaping from *T to Tout with the stochastic rate constants    */
+/*  SCT. On return *T = Tout and NmlcV holds the state at Tout.       */
+/*  No global data is written: different trajectories can be         */
+/*  advanced concurrently, each with its own NmlcV and rng.           */
+/*  Returns the number of reaction events.                            */
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+{
+      int i, j, k, L, m = 0, ev, Nev = 0, negative;
+      int Crit[NREACT], K[NREACT], Nnew[NVAR];
+      double A[NREACT], Mu[NVAR], Sigma2[NVAR];
+      double a0, ac, tau, tau1, tau2, bnd, x;
+
+      while (*T < Tout) {
+
+          /* Propensities and critical reactions */
+          Propensity ( NmlcV, NmlcF, SCT, A );
+          a0 = 0.0;
+          ac = 0.0;
+          for (j = 0; j < NREACT; j++) {
+            a0 += A[j];
+            L = NCRIT;
+            for (k = CCOL_STOICM[j]; k < CCOL_STOICM[j+1]; k++)
+              if ( STOICM[k] < 0.0 ) {
+                m = (int)( NmlcV[IROW_STOICM[k]]/(-STOICM[k]) );
+                if ( m < L ) L = m;
+              }
+            Crit[j] = (A[j] > 0.0) && (L < NCRIT);
+            if ( Crit[j] ) ac += A[j];
+          }
+          if (a0 <= 0.0) break;
+
+          /* Leap size bound from the non-critical reactions */
+          for (i = 0; i < NVAR; i++) {
+            Mu[i] = 0.0;
+            Sigma2[i] = 0.0;
+          }
+          for (j = 0; j < NREACT; j++) {
+            if ( Crit[j] || (A[j] <= 0.0) ) continue;
+            for (k = CCOL_STOICM[j]; k < CCOL_STOICM[j+1]; k++) {
+              Mu[IROW_STOICM[k]]     += STOICM[k]*A[j];
+              Sigma2[IROW_STOICM[k]] += STOICM[k]*STOICM[k]*A[j];
+            }
+          }
+          tau1 = HUGE_VAL;
+          for (i = 0; i < NVAR; i++) {
+            if ( HOR_STOICM[i] == 0 ) continue;
+            bnd = EPSTAU*NmlcV[i]/TauLeapG( i, NmlcV[i] );
+            if ( bnd < 1.0 ) bnd = 1.0;
+            if ( Mu[i] != 0.0 && bnd/fabs(Mu[i]) < tau1 )
+              tau1 = bnd/fabs(Mu[i]);
+            if ( Sigma2[i] > 0.0 && bnd*bnd/Sigma2[i] < tau1 )
+              tau1 = bnd*bnd/Sigma2[i];
+          }
+
+          /* Leaping is not worth it: a batch of exact SSA steps */
+          if ( tau1 < NSSA/a0 ) {
+            for (ev = 0; ev < NSSA_STEPS; ev++) {
+              if (ev > 0) {
+                Propensity ( NmlcV, NmlcF, SCT, A );
+                a0 = 0.0;
+                for (j = 0; j < NREACT; j++) a0 += A[j];
+                if (a0 <= 0.0) break;
+              }
+              tau = KppRandExponential( rng )/a0;
+              if (*T + tau > Tout) {
+                *T = Tout;
+                break;
+              }
+              *T = *T + tau;
+              x = KppRandUniform( rng )*a0;
+              for (j = 0; j < NREACT-1; j++) {
+                x -= A[j];
+                if (x <= 0.0) break;
+              }
+              MoleculeChange( j+1, NmlcV );
+              Nev++;
+            }
+            continue;
+          }
+
+          /* Time to the next critical reaction */
+          tau2 = (ac > 0.0) ? KppRandExponential( rng )/ac : HUGE_VAL;
+
+          do {
+            /* The leap ends at the earliest of tau1, tau2, Tout */
+            tau = (tau1 < tau2) ? tau1 : tau2;
+            if (tau > Tout - *T) tau = Tout - *T;
+
+            for (j = 0; j < NREACT; j++)
+              K[j] = Crit[j] ? 0 : KppRandPoisson( rng, A[j]*tau );
+            if ( tau == tau2 ) {
+              x = KppRandUniform( rng )*ac;
+              for (j = 0; j < NREACT; j++)
+                if ( Crit[j] ) {
+                  m = j;
+                  x -= A[j];
+                  if (x <= 0.0) break;
+                }
+              K[m] = 1;
+            }
+
+            for (i = 0; i < NVAR; i++)
+              Nnew[i] = NmlcV[i];
+            for (j = 0; j < NREACT; j++)
+              if ( K[j] )
+                for (k = CCOL_STOICM[j]; k < CCOL_STOICM[j+1]; k++)
+                  Nnew[IROW_STOICM[k]] += K[j]*(int)STOICM[k];
+            negative = 0;
+            for (i = 0; i < NVAR; i++)
+              if ( Nnew[i] < 0 ) negative = 1;
+
+            /* Negative population: halve the leap and try again */
+            if ( negative ) tau1 = 0.5*tau;
+          } while ( negative );
+
+          for (i = 0; i < NVAR; i++)
+            NmlcV[i] = Nnew[i];
+          for (j = 0; j < NREACT; j++)
+            Nev += K[j];
+          *T = *T + tau;
+
+      } /* while */
+
+      *T = Tout;
+      return Nev;
+
+} /* StochasticIntegrate */
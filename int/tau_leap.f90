@@ -1607,7 +1607,7 @@ MODULE KPP_ROOT_Integrator
 CONTAINS
 
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-SUBROUTINE TauLeap(Nsteps, Tau, T, SCT, NmlcV, NmlcF)
+SUBROUTINE TauLeap(Nsteps, Tau, T, SCT, NmlcV, NmlcF, Rng)
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 !
 !   Tau-leap stochastic integration
@@ -1617,9 +1617,11 @@ SUBROUTINE TauLeap(Nsteps, Tau, T, SCT, NmlcV, NmlcF)
 !       T       = time
 !       SCT     = stochastic rate constants
 !       NmlcV, NmlcF = no. of molecules for variable and fixed species
+!       Rng     = random number stream (see KppRandInit)
 !   OUTPUT:
 !       T       = updated time (after Nsteps)
 !       NmlcV   = updated no. of molecules for variable species
+!       Rng     = advanced random number stream
 !      
 !
 !~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -1629,10 +1631,9 @@ SUBROUTINE TauLeap(Nsteps, Tau, T, SCT, NmlcV, NmlcF)
       KPP_REAL:: T, Tau
       INTEGER :: Nsteps     
       INTEGER :: NmlcV(NVAR), NmlcF(NFIX)
+      TYPE(KPP_RNG) :: Rng
       INTEGER :: i, j, irct, id, istep, Nfirings(NREACT)
-      REAL   :: mu
       KPP_REAL :: A(NREACT), SCT(NREACT), x
-      LOGICAL, SAVE :: First = .TRUE.
    
       DO istep = 1, Nsteps
 
@@ -1641,9 +1642,7 @@ SUBROUTINE TauLeap(Nsteps, Tau, T, SCT, NmlcV, NmlcF)
           
           ! Index of next reaction
           DO irct = 1, NREACT
-            mu = A(irct)*Tau
-            Nfirings(irct) = random_Poisson(mu, First)
-            First = .TRUE.
+            Nfirings(irct) = KppRandPoisson(Rng, A(irct)*Tau)
           END DO
           
           ! Update time with the leap interval
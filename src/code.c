@@ -247,7 +247,7 @@ void IncludeCode( char* fmt, ... )
 {
 Va_list args;
 char buf[200];
-char cmd[500];
+char cmd[1000];
 static char tmpfile[] = "kppfile.tmp";
 FILE * fp;
 
@@ -282,6 +282,9 @@ FILE * fp;
   sprintf( cmd, "%s -e 's/KPP_NONZERO/%d/g'", cmd, Jac_NZ );  
   sprintf( cmd, "%s -e 's/KPP_LU_NONZERO/%d/g'", cmd, LU_Jac_NZ );  
   sprintf( cmd, "%s -e 's/KPP_NHESS/%d/g'", cmd, Hess_NZ );  
+  sprintf( cmd, "%s -e 's/KPP_THREADSAFE/%d/g'", cmd, useThreadsafe );  
+  sprintf( cmd, "%s -e 's/KPP_HESSIAN/%s/g'", cmd, useHessian ? "ON" : "OFF" );  
+  sprintf( cmd, "%s -e 's/KPP_STOICMAT/%s/g'", cmd, useStoicmat ? "ON" : "OFF" );  
   
   switch( useLang ) { 
     case F77_LANG: 
@@ -44,7 +44,10 @@ char *C_types[] = { "void",     /* VOID */
                     "float",  /* FLOAT */
                     "double", /* DOUBLE */
                     "char *", /* STRING */
-                    "char *"  /* DOUBLESTRING */
+                    "char *", /* DOUBLESTRING */
+                    "const unsigned char",   /* IDX8 */
+                    "const unsigned short",  /* IDX16 */
+                    "const int"              /* IDX32 */
                   }; 
 
 void C_WriteElm( NODE * n )
@@ -312,10 +315,14 @@ int maxCols = MAX_COLS;
       bprintf(" /* %s */\n\n", var->comment );
         
   switch( var->type ) {
-    case VELM: bprintf( "  %s  %s[] = {\n%5s", C_types[var->baseType], var->name, " " );
+    case VELM: bprintf( "  %s  %s[]%s = {\n%5s", C_types[var->baseType], var->name,
+                        (var->baseType >= IDX8) ? " KPP_ALIGN" : "", " " );
                for( i = 0; i < n; i++ ) {
                  switch( var->baseType ) {
-                   case INT: bprintf( "%3d",  ival[i] ); maxCols=12; break;
+                   case INT:
+                   case IDX8:
+                   case IDX16:
+                   case IDX32: bprintf( "%3d",  ival[i] ); maxCols=12; break;
                    case DOUBLE: 
                    case REAL:bprintf( "%5lg", dval[i] ); maxCols=8; break;
                    case STRING:bprintf( "\"%s\"", cval[i] ); maxCols=8; break;
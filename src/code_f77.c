@@ -42,7 +42,10 @@ char *F77_types[] = { "",                 /* VOID */
                     "REAL",             /* FLOAT */
                     "REAL*8",           /* DOUBLE */
                     "CHARACTER*12",     /* STRING */
-                    "CHARACTER*100"     /* DOUBLESTRING */
+                    "CHARACTER*100",    /* DOUBLESTRING */
+                    "INTEGER",          /* IDX8 */
+                    "INTEGER",          /* IDX16 */
+                    "INTEGER"           /* IDX32 */
                   };
 
 /*************************************************************************************************/
@@ -42,7 +42,10 @@ char *F90_types[] = { "",                   /* VOID */
                     "REAL(kind=sp)",      /* FLOAT */
                     "REAL(kind=dp)",      /* DOUBLE */
                     "CHARACTER(LEN=15)",  /* STRING */
-                    "CHARACTER(LEN=100)"  /* DOUBLESTRING */
+                    "CHARACTER(LEN=100)", /* DOUBLESTRING */
+                    "INTEGER",            /* IDX8 */
+                    "INTEGER",            /* IDX16 */
+                    "INTEGER"             /* IDX32 */
                   };
 
 /*************************************************************************************************/
@@ -45,7 +45,10 @@ char *MATLAB_types[] = { "",              /* VOID */
                     /*"REAL(dp)", */            /* DOUBLE */
                     "DOUBLE PRECISION",   /* DOUBLE */
                     "CHARACTER(LEN=12)",  /* STRING */
-                    "CHARACTER(LEN=100)"  /* DOUBLESTRING */
+                    "CHARACTER(LEN=100)", /* DOUBLESTRING */
+                    "INTEGER",            /* IDX8 */
+                    "INTEGER",            /* IDX16 */
+                    "INTEGER"             /* IDX32 */
                   };
 
 /*************************************************************************************************/
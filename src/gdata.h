@@ -50,6 +50,7 @@
 #define MAX_PATH        120
 #define MAX_FILES	 20
 #define MAX_EQNLEN      100
+#define MAX_SAMPLE      500
 
 #define NO_CODE 	-1
 #define max( x, y ) (x) > (y) ? (x) : (y)
@@ -70,6 +71,7 @@ enum inl_code { F77_GLOBAL,    F77_INIT,    F77_DATA,    F77_UTIL,    F77_RATES,
 	      };
 
 enum jacobian_format { JAC_OFF, JAC_FULL, JAC_LU_ROW, JAC_ROW };	      
+enum drg_modes { DRG_OFF, DRG_ON, DRGEP_ON };
 
                	      
 typedef short int CODE;
@@ -91,6 +93,7 @@ typedef struct {
 		 char lookat;
 		 char moni;
 		 char trans;
+		 char target;
                  short int nratoms;
 		 char name[ MAX_SPNAME ];
                  char ival[ MAX_IVAL ];
@@ -111,6 +114,12 @@ typedef struct {
 		 int maxlen;
 	       } ICODE;
 
+typedef struct {
+		 char name[ MAX_SPNAME ];
+		 double val;
+		 short int set;
+	       } SAMPLE_DEF;
+
 
 extern int SpeciesNr;
 extern int EqnNr;
@@ -146,6 +155,14 @@ extern int useDummyindex;
 extern int useEqntags;
 extern int useLang;
 extern int useStochastic;
+extern int useThreadsafe;
+extern int useRatetable;
+extern double rtabTmin, rtabTmax, rtabStep;
+extern int useReduce;
+extern int useDrg;
+extern double drgEps;
+extern int useQssa;
+extern double qssaTau;
 
 /* if useValues=1 KPP replaces parameters like NVAR etc. 
        by their values in vector/matrix declarations */
@@ -173,8 +190,19 @@ extern int **structB;
 extern int **structJ;
 extern int **LUstructJ;
 
+extern int ConsNr;
+extern CODE ConsDep[ MAX_SPECIES ];
+extern double *ConsCoef[ MAX_SPECIES ];
+extern int QssaNr;
+extern CODE QssaSpc[ MAX_SPECIES ];
+extern char *QssaDep[ MAX_SPECIES ];
+
 extern ICODE InlineCode[ INLINE_OPT ];
 
+extern SAMPLE_DEF SampleTable[ MAX_SAMPLE ];
+extern int SampleNr;
+extern int SampleSetNr;
+
 extern char *fileList[ MAX_FILES ];
 extern int fileNr;
 
@@ -190,6 +218,9 @@ void CmdDeclareValues( char *cmd );
 void CmdDouble( char *cmd );
 void CmdReorder( char *cmd );
 void CmdMex( char *cmd );
+void CmdThreadsafe( char *cmd );
+void CmdRatetable( char *cmd );
+void CmdReduce( char *cmd );
 void CmdDummyindex( char *cmd );
 void CmdEqntags( char *cmd );
 void CmdUse( char *cmd );
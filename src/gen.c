@@ -31,6 +31,7 @@
 
 
 #include <string.h>
+#include <ctype.h>
 #include <math.h>
 #include "gdata.h"
 #include "code.h"
@@ -62,10 +63,13 @@ int X, XX, NTMPB;
 int D2A, NTMPD2A, NHESS, HESS, IHESS_I, IHESS_J, IHESS_K;
 int DDMTYPE;
 int STOICM, NSTOICM, IROW_STOICM, ICOL_STOICM, CCOL_STOICM, CNEQN;
+int HOR_STOICM, HORM_STOICM, CROW_STOICM, IPOS_STOICM;
 int IROW, ICOL, CROW, DIAG;
 int LU_IROW, LU_ICOL, LU_CROW, LU_DIAG, CNVAR;   
+int LU_NLEV, LU_NBLEV, LU_LEVROW, LU_LEVPTR, LU_BLEVROW, LU_BLEVPTR;
 int LOOKAT, NLOOKAT, MONITOR, NMONITOR;
 int NMASS, SMASS;
+int NCONS, TOT;
 int SPC_NAMES, EQN_NAMES;
 int EQN_TAGS; 
 int NONZERO, LU_NONZERO;
@@ -74,8 +78,10 @@ int RTOLS, TSTART, TEND, DT;
 int ATOL, RTOL, STEPMIN, STEPMAX, CFACTOR;
 int V_USER, CL;
 int NMLCV, NMLCF, SCT, PROPENSITY, VOLUME, IRCT;
+int NMLCX, NMLCXDOT, MASK;
 
 int Jac_NZ, LU_Jac_NZ, nzr;
+int LU_Nlev, LU_Nblev;
 
 NODE *sum, *prod;
 int real;
@@ -196,6 +202,10 @@ int i,j;
   IROW_STOICM  = DefvElm( "IROW_STOICM", INT, -NSTOICM, "Row indices in STOICM" );
   ICOL_STOICM  = DefvElm( "ICOL_STOICM", INT, -NSTOICM, "Column indices in STOICM" );
   CCOL_STOICM  = DefvElm( "CCOL_STOICM", INT, -CNEQN, "Beginning of columns in STOICM" );
+  HOR_STOICM   = DefvElm( "HOR_STOICM", INT, -NVAR, "Highest order of reactions with the species as reactant" );
+  HORM_STOICM  = DefvElm( "HORM_STOICM", INT, -NVAR, "Max. reactant molecules of the species in those reactions" );
+  CROW_STOICM  = DefvElm( "CROW_STOICM", INT, -CNVAR, "Beginning of rows in STOICM" );
+  IPOS_STOICM  = DefvElm( "IPOS_STOICM", INT, -NSTOICM, "Positions in STOICM of the entries by rows" );
 
   DDMTYPE      = DefElm( "DDMTYPE", INT, "DDM sensitivity w.r.t.: 0=init.val., 1=params" );
 
@@ -221,6 +231,12 @@ int i,j;
   LU_ICOL  = DefvElm( "LU_ICOL", INT, -LU_NONZERO, "Column indexes of the LU Jacobian of variables" );
   LU_CROW  = DefvElm( "LU_CROW", INT, -CNVAR, "Compressed row indexes of the LU Jacobian of variables" );
   LU_DIAG  = DefvElm( "LU_DIAG", INT, -CNVAR, "Diagonal indexes of the LU Jacobian of variables" );
+  LU_NLEV  = DefConst( "LU_NLEV", INT, "Number of levels of the LU factorization" );
+  LU_NBLEV = DefConst( "LU_NBLEV", INT, "Number of levels of the back substitution" );
+  LU_LEVROW  = DefvElm( "LU_LEVROW", INT, -NVAR, "Rows of the LU factorization by level" );
+  LU_LEVPTR  = DefvElm( "LU_LEVPTR", INT, 0, "Start of each level in LU_LEVROW" );
+  LU_BLEVROW = DefvElm( "LU_BLEVROW", INT, -NVAR, "Rows of the back substitution by level" );
+  LU_BLEVPTR = DefvElm( "LU_BLEVPTR", INT, 0, "Start of each level in LU_BLEVROW" );
 
   IV = DefeElm( "IV", 0 );
 
@@ -243,6 +259,9 @@ int i,j;
   NMASS  = DefConst( "NMASS", INT, "Number of atoms to check mass balance" );
   SMASS  = DefvElm( "SMASS", STRING, -NMASS, "Names of atoms for mass balance" );
 
+  NCONS  = DefConst( "NCONS", INT, "Number of conservation laws (#REDUCE)" );
+  TOT    = DefvElm( "TOT", real, -NCONS, "Conserved totals (#REDUCE)" );
+
   EQN_TAGS    = DefvElm( "EQN_TAGS", STRING, -NREACT, "Equation tags" );
   EQN_NAMES  = DefvElm( "EQN_NAMES", DOUBLESTRING, -NREACT, "Equation names" );
   SPC_NAMES  = DefvElm( "SPC_NAMES", STRING, -NSPEC, "Names of chemical species" );
@@ -256,6 +275,9 @@ int i,j;
   PROPENSITY  = DefvElm( "Prop",  real, -NREACT, "Propensity vector" );
   VOLUME = DefElm( "Volume", real, "Volume of the reaction container" );
   IRCT  = DefElm( "IRCT", INT, "Index of chemical reaction" );
+  NMLCX = DefvElm( "NmlcX", real, -NVAR, "No. molecules of variable species (continuous)" );
+  NMLCXDOT = DefvElm( "NmlcXdot", real, -NVAR, "Time derivative of no. molecules" );
+  MASK  = DefvElm( "Mask", real, -NREACT, "Selected reactions (1 = selected, 0 = not)" );
 
   for ( i=0; i<EqnNr; i++ ) 
     for ( j=0; j<SpcNr; j++ ) 
@@ -270,6 +292,7 @@ int i,j;
     varTable[ NREACT ]  -> value  = max(EqnNr,1);
     varTable[ NVARST ]  -> value  = Index(0);
     varTable[ NFIXST ]  -> value  = Index(VarNr);
+    varTable[ NCONS ]   -> value  = max(ConsNr,1);
   }
 }
 
@@ -301,6 +324,28 @@ int i,j;
 }
 
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* Global variables that hold the state of one box (#THREADSAFE);   */
+/* STEPMIN is included since the integrators return the last step in it */
+char * ThreadPrivateList()
+{
+static char buf[256];
+
+  sprintf( buf, "%s, %s, %s, %s, %s, %s, %s, %s", 
+           varTable[C]->name, varTable[VAR]->name, varTable[FIX]->name,
+           varTable[RCONST]->name, varTable[TIME]->name, varTable[SUN]->name,
+           varTable[TEMP]->name, varTable[STEPMIN]->name );
+  if ( useStochastic ) {
+    strcat( buf, ", " );
+    strcat( buf, varTable[VOLUME]->name );
+  }
+  if ( ConsNr > 0 ) {
+    strcat( buf, ", " );
+    strcat( buf, varTable[TOT]->name );
+  }
+  return buf;
+}
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 void GenerateGData()
 {
@@ -326,10 +371,16 @@ int dim;
   NewLines(1);
 
   GlobalDeclare( C );
-  C_Inline("%s * %s = & %s[%d];", C_types[real], 
-            varTable[VAR]->name, varTable[C]->name, 0 );
-  C_Inline("%s * %s = & %s[%d];", C_types[real], 
-            varTable[FIX]->name, varTable[C]->name, VarNr );
+  if ( useThreadsafe ) {
+    /* Thread-local C has no constant address: see KppThreadInit */
+    C_Inline("%s * %s = 0;", C_types[real], varTable[VAR]->name );
+    C_Inline("%s * %s = 0;", C_types[real], varTable[FIX]->name );
+  } else {
+    C_Inline("%s * %s = & %s[%d];", C_types[real], 
+              varTable[VAR]->name, varTable[C]->name, 0 );
+    C_Inline("%s * %s = & %s[%d];", C_types[real], 
+              varTable[FIX]->name, varTable[C]->name, VarNr );
+  }
 	     
 
   GlobalDeclare( RCONST );
@@ -347,6 +398,17 @@ int dim;
   GlobalDeclare( CFACTOR );
   if (useStochastic)
       GlobalDeclare( VOLUME );
+  if ( ConsNr > 0 )
+      GlobalDeclare( TOT );
+
+  if ( useThreadsafe ) {
+    C_Inline("\n#ifdef _OPENMP\n#pragma omp threadprivate( %s )\n#endif", ThreadPrivateList() );
+    C_Inline("\n/* KppThreadInit - point VAR and FIX into the C of the calling thread;");
+    C_Inline("     call it in every thread before using them (Initialize does) */");
+    C_Inline("void KppThreadInit()\n{");
+    C_Inline("  %s = & %s[%d];", varTable[VAR]->name, varTable[C]->name, 0 );
+    C_Inline("  %s = & %s[%d];\n}", varTable[FIX]->name, varTable[C]->name, VarNr );
+  }
 
   MATLAB_Inline("  %s_Parameters;",rootFileName);
   MATLAB_Inline("  %s_Global_defs;",rootFileName);
@@ -500,6 +562,118 @@ int dim;
 }
 
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void IndexTable( int v, int n, int* values )
+{
+int i, vmax = 0;
+
+  /* In C the sparse index tables are read-only data of the narrowest  */
+  /* unsigned type that holds their values, so that more of them stay  */
+  /* in cache during the decomposition and the solves.  Fortran keeps  */
+  /* the default INTEGER kind (the tables are passed to user routines) */
+  if( useLang != C_LANG ) return;
+
+  for( i = 0; i < n; i++ )
+    if( values[i] > vmax ) vmax = values[i];
+  if( vmax <= 255 )
+    varTable[ v ]->baseType = IDX8;
+  else if( vmax <= 65535 )
+    varTable[ v ]->baseType = IDX16;
+  else
+    varTable[ v ]->baseType = IDX32;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int LevelSchedule( int upper, int *row, int *ptr )
+{
+int *lev;
+int i, j, k, n, nlev;
+
+  /* Row i of the LU factorization (and of the forward substitution)   */
+  /* needs the rows j < i of its L part, row i of the back substitution */
+  /* the rows j > i of its U part.  The level of a row is one more than */
+  /* the highest level it needs; the rows of one level are independent. */
+  /* row[] gets the rows sorted by level, ptr[l] the first row of level */
+  /* l (ptr[nlev] = VarNr).  Returns the number of levels nlev          */
+  lev = AllocIntegerVector( VarNr+1, "lev in LevelSchedule" );
+
+  nlev = 0;
+  for( n = 0; n < VarNr; n++ ) {
+    i = upper ? VarNr-1-n : n;
+    lev[i] = 0;
+    for( j = 0; j < VarNr; j++ ) {
+      if( (j == i) || !LUstructJ[i][j] ) continue;
+      if( upper ? (j < i) : (j > i) ) continue;
+      if( lev[j]+1 > lev[i] ) lev[i] = lev[j]+1;
+    }
+    if( lev[i]+1 > nlev ) nlev = lev[i]+1;
+  }
+
+  for( k = 0; k <= nlev; k++ ) ptr[k] = 0;
+  for( i = 0; i < VarNr; i++ ) ptr[ lev[i]+1 ]++;
+  for( k = 0; k < nlev; k++ ) ptr[k+1] += ptr[k];
+  for( i = 0; i < VarNr; i++ ) row[ ptr[ lev[i] ]++ ] = i;
+  for( k = nlev; k > 0; k-- ) ptr[k] = ptr[k-1];
+  ptr[0] = 0;
+
+  free(lev);
+  return nlev;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int LUBlocks( int *nmax, int *n1 )
+{
+int j, p, mincol, nblk, end;
+
+  /* Diagonal blocks of the LU factorization: a block starts at row p  */
+  /* if no row i >= p has L entries left of column p, so that L has no */
+  /* entries outside the blocks.  Returns the number of blocks, *nmax  */
+  /* the size of the largest one and *n1 the number of 1x1 blocks      */
+  nblk = 0; *nmax = 0; *n1 = 0;
+  mincol = VarNr; end = VarNr;
+  for( p = VarNr-1; p >= 0; p-- ) {
+    for( j = 0; j < p; j++ )
+      if( LUstructJ[p][j] ) break;
+    if( j < mincol ) mincol = j;
+    if( mincol < p ) continue;
+    nblk++;
+    if( end-p > *nmax ) *nmax = end-p;
+    if( end-p == 1 ) (*n1)++;
+    end = p;
+  }
+  return nblk;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void GenerateLevelData()
+{
+int *row;
+int *ptr;
+
+  /* Level schedule of the LU factorization and of the substitutions, */
+  /* used by the threaded KppDecompLev and KppSolveLev (C only)        */
+  if( (useLang != C_LANG) || (VarNr < 1) ) return;
+
+  row = AllocIntegerVector( VarNr+1, "row in GenerateLevelData" );
+  ptr = AllocIntegerVector( VarNr+2, "ptr in GenerateLevelData" );
+
+  LU_Nlev = LevelSchedule( 0, row, ptr );
+  varTable[ LU_LEVPTR ]->maxi = LU_Nlev+1;
+  IndexTable( LU_LEVROW, VarNr, row );
+  InitDeclare( LU_LEVROW, VarNr, (void*)row );
+  IndexTable( LU_LEVPTR, LU_Nlev+1, ptr );
+  InitDeclare( LU_LEVPTR, LU_Nlev+1, (void*)ptr );
+
+  LU_Nblev = LevelSchedule( 1, row, ptr );
+  varTable[ LU_BLEVPTR ]->maxi = LU_Nblev+1;
+  IndexTable( LU_BLEVROW, VarNr, row );
+  InitDeclare( LU_BLEVROW, VarNr, (void*)row );
+  IndexTable( LU_BLEVPTR, LU_Nblev+1, ptr );
+  InitDeclare( LU_BLEVPTR, LU_Nblev+1, (void*)ptr );
+
+  free(row); free(ptr);
+}
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 void GenerateJacobianSparseData()
 {
@@ -541,17 +715,26 @@ int dim;
   switch (useJacobian) {
   case JAC_ROW:
     Jac_NZ = NonZero( PLAIN, 0, VarNr, irow, icol, crow, diag );
+    IndexTable( IROW, Jac_NZ, irow );
     InitDeclare( IROW, Jac_NZ, (void*)irow );
+    IndexTable( ICOL, Jac_NZ, icol );
     InitDeclare( ICOL, Jac_NZ, (void*)icol );
+    IndexTable( CROW, VarNr+1, crow );
     InitDeclare( CROW, VarNr+1, (void*)crow );
+    IndexTable( DIAG, VarNr+1, diag );
     InitDeclare( DIAG, VarNr+1, (void*)diag );
     break;
   case JAC_LU_ROW:
     LU_Jac_NZ = NonZero( LU, 0, VarNr, irow, icol, crow, diag );
+    IndexTable( LU_IROW, LU_Jac_NZ, irow );
     InitDeclare( LU_IROW, LU_Jac_NZ, (void*)irow );
+    IndexTable( LU_ICOL, LU_Jac_NZ, icol );
     InitDeclare( LU_ICOL, LU_Jac_NZ, (void*)icol );
+    IndexTable( LU_CROW, VarNr+1, crow );
     InitDeclare( LU_CROW, VarNr+1, (void*)crow );
+    IndexTable( LU_DIAG, VarNr+1, diag );
     InitDeclare( LU_DIAG, VarNr+1, (void*)diag );
+    GenerateLevelData();
   }
   NewLines(1);
   F77_Inline( "%6sEND\n\n", " " );
@@ -585,6 +768,12 @@ void GenerateJacobianSparseHeader()
     ExternDeclare( LU_ICOL );
     ExternDeclare( LU_CROW );
     ExternDeclare( LU_DIAG );
+    if( useLang == C_LANG ) {
+      ExternDeclare( LU_LEVROW );
+      ExternDeclare( LU_LEVPTR );
+      ExternDeclare( LU_BLEVROW );
+      ExternDeclare( LU_BLEVPTR );
+    }
   }
   
   NewLines(1);
@@ -593,6 +782,166 @@ void GenerateJacobianSparseHeader()
 
 
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* #REDUCE CONSERVED: the dependent species d of conservation law l is */
+/* the fixed species F(d) = TOT(l) - sum_j ConsCoef(l,j)*V(j)          */
+void GenerateConsDep( int v, int f )
+{
+int l, j, d;
+
+  if( ConsNr == 0 ) return;
+
+  NewLines(1);
+  WriteComment("Dependent species of the conservation laws");
+  for( l = 0; l < ConsNr; l++ ) {
+    d = ReverseCode[ ConsDep[l] ];
+    sum = Elm( TOT, l );
+    for( j = 0; j < VarNr; j++ )
+      if( ConsCoef[l][ Code[j] ] != 0 )
+        sum = Sub( sum, Mul( Const( ConsCoef[l][ Code[j] ] ), Elm( v, j ) ) );
+    Assign( Elm( f, d - VarNr ), sum );
+  }
+}
+
+/* Jacobian term (i,j) through the dependent species: dF(d)/dV(j) = -ConsCoef(l,j) */
+NODE * ConsJac( NODE * s, int i, int j )
+{
+int l, k, d;
+double c;
+
+  for( l = 0; l < ConsNr; l++ ) {
+    c = ConsCoef[l][ Code[j] ];
+    if( c == 0 ) continue;
+    d = ReverseCode[ ConsDep[l] ];
+    for (k = 0; k < EqnNr; k++)
+      if( Stoich[i][k]*structB[k][d] != 0 )
+        s = Add( s, Mul( Const( -c*Stoich[i][k] ), Elm( BV, structB[k][d]-1 ) ) );
+  }
+  return s;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* #REDUCE QSSA: the QSSA species q, upstream ones first, are the      */
+/* fixed species F(q) = P(q)/L(q), with P(q) their production rate     */
+/* and L(q)*F(q) their loss rate                                        */
+
+/* Rate of reaction k, without one factor of species q (q < 0: none) */
+NODE * QssaProd( int k, int q, int v, int f, int rct )
+{
+int m, n, e;
+NODE *p;
+
+  p = ( kr[k].type == NUMBER ) ? Const( kr[k].val.f ) : Elm( rct, k );
+  for( m = 0; m < SpcNr; m++ ) {
+    e = (int)Stoich_Left[m][k] - ( m == q );
+    for( n = 1; n <= e; n++ )
+      p = Mul( p, ( m < VarNr ) ? Elm( v, m ) : Elm( f, m - VarNr ) );
+  }
+  return p;
+}
+
+void GenerateQssaDep( int v, int f, int rct )
+{
+int l, q, k;
+NODE *p, *d;
+
+  if( QssaNr == 0 ) return;
+
+  NewLines(1);
+  WriteComment("Quasi-steady-state species");
+  for( l = 0; l < QssaNr; l++ ) {
+    q = ReverseCode[ QssaSpc[l] ];
+    p = Const(0);
+    d = Const(0);
+    for( k = 0; k < EqnNr; k++ ) {
+      if( Stoich_Right[q][k] != 0 )
+        p = Add( p, Mul( Const( Stoich_Right[q][k] ), QssaProd( k, -1, v, f, rct ) ) );
+      if( Stoich_Left[q][k] != 0 )
+        d = Add( d, QssaProd( k, q, v, f, rct ) );
+    }
+    Assign( Elm( f, q - VarNr ), Div( p, d ) );
+  }
+}
+
+/* Entries of B after the dA/dC ones: L(q) in qssaL[l] and, for the    */
+/* species j that q depends on, dF(q)/dV(j) in qssaD[l][j]-1           */
+int *qssaL;
+int **qssaD;
+
+int QssaSlots( int nb )
+{
+int l, j;
+
+  if( QssaNr == 0 ) return nb;
+  qssaL = AllocIntegerVector( QssaNr, "qssaL in QssaSlots" );
+  qssaD = (int**)malloc( QssaNr * sizeof(int*) );
+  for( l = 0; l < QssaNr; l++ ) {
+    qssaL[l] = nb++;
+    qssaD[l] = AllocIntegerVector( VarNr, "qssaD in QssaSlots" );
+    for( j = 0; j < VarNr; j++ )
+      qssaD[l][j] = QssaDep[l][ Code[j] ] ? ++nb : 0;
+  }
+  return nb;
+}
+
+/* B(k,q) = dA(k)/dF(q), L(q) and, from the implicit function theorem */
+/* on P(q) - L(q)*F(q) = 0, dF(q)/dV(j) = ( df(q)/dV(j) +              */
+/*   sum_q' df(q)/dF(q')*dF(q')/dV(j) ) / L(q), with q' upstream of q  */
+void GenerateQssaJac()
+{
+int l, l2, q, q2, j, k;
+
+  if( QssaNr == 0 ) return;
+
+  NewLines(1);
+  WriteComment("Derivatives of the quasi-steady-state species");
+  for( l = 0; l < QssaNr; l++ ) {
+    q = ReverseCode[ QssaSpc[l] ];
+    sum = Const(0);
+    for( k = 0; k < EqnNr; k++ ) {
+      if( Stoich_Left[q][k] == 0 ) continue;
+      WriteComment("B(%d) = dA(%d)/dF(%d)",Index(structB[k][q]-1),Index(k),Index(q-VarNr));
+      Assign( Elm( BV, structB[k][q]-1 ), QssaProd( k, q, V, F, RCT ) );
+      sum = Add( sum, Elm( BV, structB[k][q]-1 ) );
+    }
+    WriteComment("B(%d) = L(%d)",Index(qssaL[l]),Index(q-VarNr));
+    Assign( Elm( BV, qssaL[l] ), sum );
+    for( j = 0; j < VarNr; j++ ) {
+      if( qssaD[l][j] == 0 ) continue;
+      sum = Const(0);
+      for( k = 0; k < EqnNr; k++ ) {
+        if( Stoich[q][k] == 0 ) continue;
+        if( structB[k][j] )
+          sum = Add( sum, Mul( Const( Stoich[q][k] ), Elm( BV, structB[k][j]-1 ) ) );
+        for( l2 = 0; l2 < l; l2++ ) {
+          q2 = ReverseCode[ QssaSpc[l2] ];
+          if( ( Stoich_Left[q2][k] == 0 ) || ( qssaD[l2][j] == 0 ) ) continue;
+          sum = Add( sum, Mul( Mul( Const( Stoich[q][k] ), Elm( BV, structB[k][q2]-1 ) ),
+                               Elm( BV, qssaD[l2][j]-1 ) ) );
+        }
+      }
+      WriteComment("B(%d) = dF(%d)/dV(%d)",Index(qssaD[l][j]-1),Index(q-VarNr),Index(j));
+      Assign( Elm( BV, qssaD[l][j]-1 ), Div( sum, Elm( BV, qssaL[l] ) ) );
+    }
+  }
+}
+
+/* Jacobian term (i,j) through the QSSA species: df(i)/dF(q)*dF(q)/dV(j) */
+NODE * QssaJac( NODE * s, int i, int j )
+{
+int l, k, q;
+
+  for( l = 0; l < QssaNr; l++ ) {
+    if( qssaD[l][j] == 0 ) continue;
+    q = ReverseCode[ QssaSpc[l] ];
+    for (k = 0; k < EqnNr; k++)
+      if( Stoich[i][k]*Stoich_Left[q][k] != 0 )
+        s = Add( s, Mul( Mul( Const( Stoich[i][k] ), Elm( BV, structB[k][q]-1 ) ),
+                         Elm( BV, qssaD[l][j]-1 ) ) );
+  }
+  return s;
+}
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 void GenerateFun()
 {
@@ -618,11 +967,13 @@ int F_VAR, FSPLIT_VAR;
      printf("\nWarning: in the function definition move P_VAR to output vars\n");
 
   
-  if ( useLang!=F90_LANG ) { /* A is a module variable in F90 */
+  if ( (useLang!=F90_LANG)||useThreadsafe ) { /* A is a module variable in F90 */
     NewLines(1);
     WriteComment("Local variables");
     Declare( A );
   }  
+  GenerateConsDep( V, F );
+  GenerateQssaDep( V, F, RCT );
   NewLines(1);
   WriteComment("Computation of equation rates");
   
@@ -722,7 +1073,8 @@ int F_VAR, FSPLIT_VAR;
 void GenerateStochastic()
 {
 int i, j, k, l, m, n, jnr;
-int used;
+int used, nElm, nonzeros_B;
+int **rankB;
 int F_VAR;
 
   if( VarNr == 0 ) return;
@@ -837,6 +1189,157 @@ int F_VAR;
   FunctionEnd( F_VAR );
   FreeVariable( F_VAR );  
  
+  if (useLang == MATLAB_LANG) return;
+
+  /* ~~~~~~~> 4. RATE OF CHANGE OF THE NUMBER OF MOLECULES */
+  /* Continuous counterpart of Propensity/MoleculeChange, restricted */
+  /* to the reactions selected by Mask (used by hybrid integrators)  */
+  F_VAR = DefFnc( "Fun_Stoch", 5, "time derivatives of no. molecules - selected reactions");
+  FunctionBegin( F_VAR, NMLCX, NMLCF, SCT, MASK, NMLCXDOT );
+
+  NewLines(1);
+  WriteComment("Local variables");
+  Declare( A );
+  NewLines(1);
+  WriteComment("Propensities of the selected reactions");
+
+  for(j=0; j<EqnNr; j++) {
+    used = 0;
+    for (i = 0; i < VarNr; i++) 
+      if ( Stoich[i][j] != 0 ) { 
+        used = 1;
+        break;
+      }
+    if ( used ) {    
+      prod = Mul( Elm( MASK, j ), Elm( SCT, j ) );
+      for (i = 0; i < VarNr; i++) 
+        for (k = 1; k <= (int)Stoich_Left[i][j]; k++ )
+	  if (k==1)
+             prod = Mul( prod, Elm( NMLCX, i ) );
+	  else
+	     prod = Mul( prod, Add( Elm( NMLCX, i ), Const(-k+1) ) );
+      for ( ; i < SpcNr; i++) 
+        for (k = 1; k <= (int)Stoich_Left[i][j]; k++ )
+	  if (k==1)
+             prod = Mul( prod, Elm( NMLCF, i - VarNr ) );
+	  else
+	     prod = Mul( prod, Add( Elm( NMLCF, i - VarNr ), Const(-k+1) ) );
+      Assign( Elm( A, j ), prod );
+    } /* if used */
+  } /* for j */
+
+  NewLines(1);
+  WriteComment("Aggregate function");
+  for (i = 0; i < VarNr; i++) {
+    sum = Const(0);
+    for (j = 0; j < EqnNr; j++) 
+      sum = Add( sum, Mul( Const( Stoich[i][j] ), Elm( A, j ) ) );
+    Assign( Elm( NMLCXDOT, i ), sum );
+  }    
+
+  FunctionEnd( F_VAR );
+  FreeVariable( F_VAR );  
+
+  /* ~~~~~~~> 5. JACOBIAN OF Fun_Stoch (LU sparse format of Jac_SP) */
+  if ( !useJacSparse ) return;
+
+  F_VAR = DefFnc( "Jac_Stoch_SP", 5, "the Jacobian of Fun_Stoch in sparse matrix representation");
+  FunctionBegin( F_VAR, NMLCX, NMLCF, SCT, MASK, JVS );
+
+  /* Rank of each dA(j)/dX(i) in B, numbered as in Jac_SP */
+  rankB = AllocIntegerMatrix( EqnNr, VarNr, "rankB in GenerateStochastic" );
+  nonzeros_B = 0;
+  for ( j=0; j<EqnNr; j++ ) 
+    for ( i=0; i<SpcNr; i++ ) 
+      if ( Stoich_Left[i][j] != 0 ) {
+        nonzeros_B++;
+        if ( i < VarNr ) rankB[j][i] = nonzeros_B;
+      }
+
+  NewLines(1);
+  WriteComment("Local variables");
+  varTable[ NTMPB ] -> value = nonzeros_B;
+  Declare( BV );
+  NewLines(1);
+
+  /* d/dx of x(x-1)...(x-s+1) = sum over m of the product without factor m */
+  for ( j=0; j<EqnNr; j++ ) {
+    for ( l=0; l<VarNr; l++ ) {
+      if ( rankB[j][l] == 0 ) continue;
+      sum = 0;
+      for ( m = 1; m <= (int)Stoich_Left[l][j]; m++ ) {
+        prod = Const(1);
+        for ( k = 1; k <= (int)Stoich_Left[l][j]; k++ )
+          if ( k != m )
+            prod = Mul( prod, (k==1) ? Elm( NMLCX, l ) 
+                                     : Add( Elm( NMLCX, l ), Const(-k+1) ) );
+        sum = Add( sum, prod );
+      }
+      prod = Mul( Mul( Elm( MASK, j ), Elm( SCT, j ) ), sum );
+      for ( i = 0; i < VarNr; i++ ) {
+        if ( i == l ) continue;
+        for ( k = 1; k <= (int)Stoich_Left[i][j]; k++ ) {
+          if (k==1)
+            prod = Mul( prod, Elm( NMLCX, i ) );
+          else
+            prod = Mul( prod, Add( Elm( NMLCX, i ), Const(-k+1) ) );
+        }
+      }
+      for ( ; i < SpcNr; i++) 
+        for ( k = 1; k <= (int)Stoich_Left[i][j]; k++ )
+	  if (k==1)
+             prod = Mul( prod, Elm( NMLCF, i - VarNr ) );
+	  else
+	     prod = Mul( prod, Add( Elm( NMLCF, i - VarNr ), Const(-k+1) ) );
+      WriteComment("B(%d) = dA(%d)/dX(%d)",Index(rankB[j][l]-1),Index(j),Index(l));
+      Assign( Elm( BV, rankB[j][l]-1 ), prod );
+    }
+  }
+
+  nElm = 0;
+  NewLines(1);
+  WriteComment("Construct the Jacobian terms from B's"); 
+  for (i = 0; i < VarNr; i++) {
+    for (l = 0; l < VarNr; l++) {
+      if( LUstructJ[i][l] ) {
+        sum = Const(0);
+        for (j = 0; j < EqnNr; j++) {
+          if( Stoich[i][j]*rankB[j][l] != 0 ) 
+            sum = Add( sum, Mul( Const( Stoich[i][j] ), Elm( BV, rankB[j][l]-1 ) ) );
+        }
+        Assign( Elm( JVS, nElm ), sum );
+        nElm++;
+      } else {
+        if( i == l ) {
+          Assign( Elm( JVS, nElm ), Const(0) );
+          nElm++;
+        }
+      }
+    }
+  }  
+
+  FreeIntegerMatrix( rankB, EqnNr, VarNr );
+  FunctionEnd( F_VAR );
+  FreeVariable( F_VAR );  
+ 
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void GenerateRandomUtil()
+{
+int RUTIL;
+
+  if ( (useLang != C_LANG)&&(useLang != F90_LANG) ) return;
+
+  UseFile( stochasticFile );
+
+  RUTIL = DefFnc( "RANDOM_UTIL", 0, "Random number streams for the stochastic solvers");
+  CommentFunctionBegin( RUTIL );
+
+  IncludeCode( "%s/util/random", Home );
+
+  CommentFunctionEnd( RUTIL );
+  FreeVariable( RUTIL );
 }
 
 
@@ -888,18 +1391,20 @@ void GenerateJacReactantProd()
 int i, j, k, l, m, JVRP_NZ, newrow;
 int used;
 int F_STOIC;
-int crow_JVRP[MAX_EQN], icol_JVRP[MAX_EQN*MAX_SPECIES];
-int irow_JVRP[MAX_EQN*MAX_SPECIES];
+int *crow_JVRP, *icol_JVRP, *irow_JVRP;
 
   if( VarNr == 0 ) return;
   
-  if (useDeclareValues) {
-    JVRP_NZ = -1;
-    for ( i=0; i<EqnNr; i++ )
-      for ( j=0; j<VarNr; j++ )
-         if ( Stoich_Left[j][i] != 0 ) JVRP_NZ++;
+  JVRP_NZ = -1;
+  for ( i=0; i<EqnNr; i++ )
+    for ( j=0; j<VarNr; j++ )
+       if ( Stoich_Left[j][i] != 0 ) JVRP_NZ++;
+  if (useDeclareValues)
     varTable[ NJVRP ]  -> value  = JVRP_NZ + 1;
-  }
+
+  crow_JVRP = AllocIntegerVector( EqnNr+1, "crow_JVRP in GenerateJacReactantProd" );
+  icol_JVRP = AllocIntegerVector( JVRP_NZ+2, "icol_JVRP in GenerateJacReactantProd" );
+  irow_JVRP = AllocIntegerVector( JVRP_NZ+2, "irow_JVRP in GenerateJacReactantProd" );
 
   UseFile( stoichiomFile ); 
 
@@ -965,8 +1470,11 @@ int irow_JVRP[MAX_EQN*MAX_SPECIES];
 	for (k=0; k<EqnNr+1; k++) 
            crow_JVRP[k]++;
   }  
+  IndexTable( CROW_JVRP, EqnNr+1, crow_JVRP );
   InitDeclare( CROW_JVRP, EqnNr+1, (void*)crow_JVRP );
+  IndexTable( ICOL_JVRP, JVRP_NZ + 1, icol_JVRP );
   InitDeclare( ICOL_JVRP, JVRP_NZ + 1, (void*)icol_JVRP );
+  IndexTable( IROW_JVRP, JVRP_NZ + 1, irow_JVRP );
   InitDeclare( IROW_JVRP, JVRP_NZ + 1, (void*)irow_JVRP );
   NewLines(1);
   F77_Inline( "%6sEND\n\n", " " );
@@ -978,6 +1486,7 @@ int irow_JVRP[MAX_EQN*MAX_SPECIES];
   NewLines(1);
   DeclareConstant( NJVRP,   ascii( JVRP_NZ + 1 ) );
 
+  free(crow_JVRP); free(icol_JVRP); free(irow_JVRP);
 }
 
 
@@ -985,7 +1494,7 @@ int irow_JVRP[MAX_EQN*MAX_SPECIES];
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 void GenerateJac()
 {
-int i,j,k,l,m;
+int i,j,k,l,m,n;
 int nElm, nonzeros_B;
 int Jac_SP, Jac;
   
@@ -1023,6 +1532,7 @@ int Jac_SP, Jac;
 	 nonzeros_B++;
          structB[i][j] = nonzeros_B;
 	 }
+  nonzeros_B = QssaSlots( nonzeros_B );
 	 
   if ( (useLang==C_LANG)||(useLang==F77_LANG)||(useLang==F90_LANG) ) {
     NewLines(1);
@@ -1031,6 +1541,8 @@ int Jac_SP, Jac;
     varTable[ NTMPB ] -> value = nonzeros_B;
     Declare( BV );
   }
+  GenerateConsDep( V, F );
+  GenerateQssaDep( V, F, RCT );
         
   NewLines(1);
 
@@ -1051,7 +1563,23 @@ int Jac_SP, Jac;
         Assign( Elm( BV, structB[i][j]-1 ), prod );
       }
     }
+    for ( l = 0; l < ConsNr; l++ ) {
+      j = ReverseCode[ ConsDep[l] ];
+      if ( Stoich_Left[j][i] == 0 ) continue;
+      for ( m = 0; m < VarNr; m++ )
+        if ( Stoich[m][i] != 0 ) break;
+      if ( m == VarNr ) continue;
+      prod = Mul( RConst( i ), Const( Stoich_Left[j][i] ) );
+      for (m = 0; m < SpcNr; m++) {
+        n = (int)Stoich_Left[m][i] - (m==j);
+        for (k = 1; k <= n; k++ )
+          prod = Mul( prod, (m < VarNr) ? Elm( V, m ) : Elm( F, m - VarNr ) );
+      }
+      WriteComment("B(%d) = dA(%d)/dF(%d)",Index(structB[i][j]-1),Index(i),Index(j-VarNr));
+      Assign( Elm( BV, structB[i][j]-1 ), prod );
+    }
   }
+  GenerateQssaJac();
 
   nElm = 0;
   NewLines(1);
@@ -1066,6 +1594,8 @@ int Jac_SP, Jac;
           if( Stoich[i][k]*structB[k][j] != 0 ) 
             sum = Add( sum, Mul( Const( Stoich[i][k] ), Elm( BV, structB[k][j]-1 ) ) );
         }
+        sum = ConsJac( sum, i, j );
+        sum = QssaJac( sum, i, j );
 	/* Comment the B */
 	 WriteComment("JVS(%d) = Jac_FULL(%d,%d)",
 	          Index(nElm),Index(i),Index(j));
@@ -1088,6 +1618,8 @@ int Jac_SP, Jac;
           if( Stoich[i][k]*structB[k][j] != 0 ) 
             sum = Add( sum, Mul( Const( Stoich[i][k] ), Elm( BV, structB[k][j]-1 ) ) );
         }
+        sum = ConsJac( sum, i, j );
+        sum = QssaJac( sum, i, j );
         Assign( Elm( JV, i, j ), sum );
       } 
     }
@@ -1413,8 +1945,11 @@ int k;
 	}
   }
   
+  IndexTable( IHESS_I, Hess_NZ, iHess_i );
   InitDeclare( IHESS_I, Hess_NZ, (void*)iHess_i );
+  IndexTable( IHESS_J, Hess_NZ, iHess_j );
   InitDeclare( IHESS_J, Hess_NZ, (void*)iHess_j );
+  IndexTable( IHESS_K, Hess_NZ, iHess_k );
   InitDeclare( IHESS_K, Hess_NZ, (void*)iHess_k );
 
   if( (useLang==F77_LANG)||(useLang==F90_LANG) ) {
@@ -1467,6 +2002,8 @@ int *irow_stoicm;
 int *ccol_stoicm;
 int *icol_stoicm;
 double *stoicm;
+int *hor, *horm, order;
+int *crow_stoicm, *ipos_stoicm;
 
 /* Compute the sparsity structure and allocate data structure vectors */
   nnz_stoicm = 0;
@@ -1499,13 +2036,29 @@ double *stoicm;
   }  
   ccol_stoicm[ EqnNr ] =  nnz_stoicm;
 
+  /* The same entries by rows, for the row-wise Fun and Jac kernels */
+  crow_stoicm = AllocIntegerVector( VarNr+1, "GenerateStoicmSparseData: crow_stoicm" );
+  ipos_stoicm = AllocIntegerVector( nnz_stoicm+2, "GenerateStoicmSparseData: ipos_stoicm" );
+  for (k=0; k<nnz_stoicm; k++)
+    crow_stoicm[ irow_stoicm[k]+1 ]++;
+  for (i=0; i<VarNr; i++)
+    crow_stoicm[i+1] += crow_stoicm[i];
+  for (k=0; k<nnz_stoicm; k++)
+    ipos_stoicm[ crow_stoicm[ irow_stoicm[k] ]++ ] = k;
+  for (i=VarNr; i>0; i--)
+    crow_stoicm[i] = crow_stoicm[i-1];
+  crow_stoicm[0] = 0;
+
   if( (useLang==F77_LANG)||(useLang==F90_LANG) ) {
         for (k=0; k<nnz_stoicm; k++) {
-           irow_stoicm[k]++; icol_stoicm[k]++; 
+           irow_stoicm[k]++; icol_stoicm[k]++; ipos_stoicm[k]++;
 	}
         for (k=0; k<=EqnNr; k++) {
            ccol_stoicm[k]++; 
 	}
+        for (k=0; k<=VarNr; k++) {
+           crow_stoicm[k]++; 
+	}
   }
   
 
@@ -1516,11 +2069,47 @@ double *stoicm;
   F77_Inline("%6sINCLUDE '%s_Sparse.h'", " ", rootFileName);  
   F77_Inline("%6sINTEGER i", " ");
   /* F90_Inline("   USE %s_Sparse", rootFileName);  */
+  IndexTable( CCOL_STOICM, EqnNr+1, ccol_stoicm );
   InitDeclare( CCOL_STOICM, EqnNr+1, (void*)ccol_stoicm );
+  IndexTable( IROW_STOICM, nnz_stoicm, irow_stoicm );
   InitDeclare( IROW_STOICM, nnz_stoicm, (void*)irow_stoicm );
+  IndexTable( ICOL_STOICM, nnz_stoicm, icol_stoicm );
   InitDeclare( ICOL_STOICM, nnz_stoicm, (void*)icol_stoicm );
   InitDeclare( STOICM, nnz_stoicm, (void*)stoicm );
+  IndexTable( CROW_STOICM, VarNr+1, crow_stoicm );
+  InitDeclare( CROW_STOICM, VarNr+1, (void*)crow_stoicm );
+  IndexTable( IPOS_STOICM, nnz_stoicm, ipos_stoicm );
+  InitDeclare( IPOS_STOICM, nnz_stoicm, (void*)ipos_stoicm );
   NewLines(1);
+
+  /* Highest order of reaction (HOR) of each reactant species, */
+  /* used by the stochastic tau-leap step size selection       */
+  if ( useStochastic ) {
+    hor  = AllocIntegerVector( VarNr+1, "GenerateStoicmSparseData: hor" );
+    horm = AllocIntegerVector( VarNr+1, "GenerateStoicmSparseData: horm" );
+    for (j=0; j<EqnNr; j++) {
+      order = 0;
+      for (i=0; i<SpcNr; i++)
+        order += (int)Stoich_Left[i][j];
+      for (i=0; i<VarNr; i++) {
+        if ( Stoich_Left[i][j] == 0 ) continue;
+        if ( order > hor[i] ) {
+          hor[i]  = order;
+          horm[i] = 0;
+        }
+        if ( (order == hor[i]) && ((int)Stoich_Left[i][j] > horm[i]) )
+          horm[i] = (int)Stoich_Left[i][j];
+      }
+    }
+    WriteComment(" Highest order of reaction of each reactant species");
+    NewLines(1);
+    IndexTable( HOR_STOICM, VarNr, hor );
+    InitDeclare( HOR_STOICM, VarNr, (void*)hor );
+    IndexTable( HORM_STOICM, VarNr, horm );
+    InitDeclare( HORM_STOICM, VarNr, (void*)horm );
+    NewLines(1);
+    free(hor); free(horm);
+  }
   F77_Inline( "%6sEND\n\n", " " );
 
 
@@ -1531,6 +2120,7 @@ double *stoicm;
    
 /* Free data structure vectors */
   free(irow_stoicm); free(ccol_stoicm); free(icol_stoicm); free(stoicm);
+  free(crow_stoicm); free(ipos_stoicm);
 }
 
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
@@ -1547,6 +2137,12 @@ void GenerateStoicmSparseHeader()
   ExternDeclare( IROW_STOICM );
   ExternDeclare( CCOL_STOICM );  
   ExternDeclare( ICOL_STOICM );
+  ExternDeclare( CROW_STOICM );
+  ExternDeclare( IPOS_STOICM );
+  if ( useStochastic ) {
+    ExternDeclare( HOR_STOICM );
+    ExternDeclare( HORM_STOICM );
+  }
   NewLines(1);
    
   NewLines(1);
@@ -1693,8 +2289,12 @@ int SUTIL;
   SUTIL = DefFnc( "SPARSE_UTIL", 0, "SPARSE utility functions");  
   CommentFunctionBegin( SUTIL );
 
-  IncludeCode( "%s/util/sutil", Home );  
-  
+  IncludeCode( "%s/util/sutil", Home );
+  if ( useLang == C_LANG ) {
+    IncludeCode( "%s/util/krylov", Home );
+    IncludeCode( "%s/util/lulevel", Home );
+  }
+
   CommentFunctionEnd( SUTIL );
   FreeVariable( SUTIL );
 }
@@ -1760,6 +2360,30 @@ void GenerateDJacDRcoeff()
 
 
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void GenerateStoicmKernels()
+{
+  /* Fun and Jac from the stoichiometric matrix; the Jacobian is */
+  /* written in the LU row-compressed format of Jac_SP           */
+  if( (useLang != C_LANG) && (useLang != F90_LANG) ) return;
+  if( useJacobian != JAC_LU_ROW ) return;
+
+  UseFile( stoichiomFile );
+
+  NewLines(1);
+  WriteComment("Begin Stoichiometric Fun and Jacobian");
+  NewLines(1);
+  
+  IncludeCode( "%s/util/stoichiom", Home );  
+
+  NewLines(1);
+  WriteComment("End Stoichiometric Fun and Jacobian");
+  NewLines(1);
+  
+}
+
+
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 void GenerateSolve()
 {
@@ -1969,10 +2593,599 @@ int UPDATE_SUN;
   FreeVariable( UPDATE_SUN );
 }
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* Update_RCONST_Batch: rate constants of a batch of cells. The standard */
+/* rate laws ARR, ARR2, EP2, EP3 and FALL with numerical arguments are   */
+/* expanded inline, using 1/TEMP and log(TEMP/300) computed once per     */
+/* cell, so that pow() becomes exp(C0*log(TEMP/300)) and the cell loops  */
+/* vectorize. Other rate expressions are evaluated cell by cell.         */
+
+#define RCONST_BATCH 64                  /* Cells per block of the batch */
+#define BATCH_LINE   76                  /* Line length of the batch code */
+
+/* Reads  NAME( num, ..., num )  from rate expression s into tok[] and */
+/* a[] (rounded to single precision, as the rate law functions do);    */
+/* NAME = "" reads  ( num ). Returns the number of arguments, or -1 if */
+/* s has another form                                                  */
+int RateLawArgs( char *s, char *name, char tok[][40], double a[], int maxa )
+{
+char num[ 40 ];
+char *end;
+int n, k;
+
+  while( (*s == ' ') || (*s == '\t') ) s++;
+  for( ; *name; name++, s++ )
+    if( toupper( *s ) != *name ) return -1;
+  while( (*s == ' ') || (*s == '\t') ) s++;
+  if( *s++ != '(' ) return -1;
+
+  for( n = 0; ; n++ ) {
+    for( k = 0; *s && (*s != ',') && (*s != ')'); s++ ) 
+      if( (*s != ' ') && (*s != '\t') && (k < 39) ) 
+        num[k++] = *s;
+    num[k] = 0;
+    if( (*s == 0) || (n == maxa) || (k == 0) || (k == 39) ) return -1;
+    strcpy( tok[n], num );
+    if( (end = strchr( num, '_' )) != 0 ) *end = 0;      /* 1.0_dp   */ 
+    if( (end = strpbrk( num, "dD" )) != 0 ) *end = 'e';  /* 1.0d-11  */ 
+    a[n] = (double)(float)strtod( num, &end );
+    if( *end != 0 ) return -1;
+    if( *s++ == ')' ) break;
+  }
+  while( (*s == ' ') || (*s == '\t') ) s++;
+  return (*s == 0) ? n+1 : -1;
+}
+
+/* Literal for argument tok of a rate law, without its sign. In C it  */
+/* is a float constant (single = 1), like the arguments of the rate   */
+/* law functions                                                      */
+char * BatchLit( char *tok, int single )
+{
+static char buf[4][48];
+static int k = 0;
+char *p;
+
+  k = (k+1) % 4;
+  if( (*tok == '-') || (*tok == '+') ) tok++;
+  strcpy( buf[k], tok );
+  if( useLang == C_LANG ) {
+    if( (p = strchr( buf[k], '_' )) != 0 ) *p = 0;
+    if( (p = strpbrk( buf[k], "dD" )) != 0 ) *p = 'e';
+    if( !strpbrk( buf[k], ".eE" ) ) strcat( buf[k], ".0" );
+    if( single ) strcat( buf[k], "f" );
+  }
+  return buf[k];
+}
+
+/* Shortest literal that reads back as x (as (float)x if single = 1) */
+char * BatchNum( double x, int single )
+{
+static char buf[4][48];
+static int k = 0;
+int p;
+
+  k = (k+1) % 4;
+  for( p = 6; p < 17; p++ ) {
+    sprintf( buf[k], "%.*g", p, x );
+    if( single ? ((float)strtod( buf[k], 0 ) == (float)x) 
+               : (strtod( buf[k], 0 ) == x) ) break;
+  }
+  if( !strpbrk( buf[k], ".e" ) ) strcat( buf[k], ".0" );
+  if( useLang == F90_LANG ) strcat( buf[k], "_dp" );
+  return buf[k];
+}
+
+/* buf = A*exp(sb*B/TEMP)*(TEMP/300)**C  for the cells of a block,  */
+/* from the first n = 2 (A, B) or 3 (A, B, C) arguments in tok, a    */
+void BatchArr( char *buf, char tok[][40], double a[], int n, int sb )
+{
+char e[ 200 ];
+char *tinv = (useLang == C_LANG) ? "Tinv[ib]" : "Tinv(1:nb)";
+char *logt = (useLang == C_LANG) ? "LogT[ib]" : "LogT(1:nb)";
+
+  *e = 0;
+  if( a[1] != 0 ) 
+    sprintf( e, "%s%s*%s", (sb*a[1] < 0) ? "-" : "", BatchLit( tok[1], 1 ), tinv );
+  if( (n == 3) && (a[2] != 0) ) 
+    sprintf( e+strlen(e), "%s%s*%s", (a[2] < 0) ? (*e ? " - " : "-") : (*e ? " + " : ""),
+             BatchLit( tok[2], 1 ), logt );
+  if( a[0] == 0 )                       /* also if A underflows */
+    strcpy( buf, (useLang == C_LANG) ? "0.0" : "0.0_dp" );
+  else if( *e == 0 ) 
+    strcpy( buf, BatchLit( tok[0], 1 ) );
+  else 
+    sprintf( buf, (useLang == C_LANG) ? "%s%s*exp( %s )" : "%s%s*EXP( %s )", 
+             (a[0] < 0) ? "-" : "", BatchLit( tok[0], 1 ), e );
+}
+
+/* Writes  ls = rs  with the cell loop of a block; ls is work array */
+/* K<k>, or RCb of reaction -k-1 if k < 0. Long lines break at blanks */
+void BatchAssign( int k, char *rs )
+{
+char buf[ 1000 ];
+char *p, *q;
+int start, width;
+
+  start = 2 + ident*2;
+  if( useLang == C_LANG ) {
+    bprintf( "%*sfor( ib = 0; ib < nb; ib++ )\n", start, "" );
+    start += 2;
+    if( k >= 0 ) sprintf( buf, "%*sK%d[ib] = ", start, "", k );
+            else sprintf( buf, "%*sRCb[%d*Ncell+ic0+ib] = ", start, "", -k-1 );
+  } else {
+    if( k >= 0 ) sprintf( buf, "%*sK%d(1:nb) = ", start, "", k );
+            else sprintf( buf, "%*sRCb(ic0:ic0+nb-1,%d) = ", start, "", -k );
+  }
+  width = BATCH_LINE - strlen( buf );
+  for( p = rs; (int)strlen( p ) > width; p = q+1 ) {
+    for( q = p + width; (q > p) && (*q != ' '); q-- ) ;
+    if( q == p ) break;
+    strncat( buf, p, q-p );
+    strcat( buf, (useLang == C_LANG) ? "\n" : " &\n" );
+    sprintf( buf+strlen(buf), "%*s", start+4, "" );
+    width = BATCH_LINE - start - 4;
+  }
+  strcat( buf, p );
+  bprintf( "%s%s\n", buf, (useLang == C_LANG) ? ";" : "" );
+  FlushBuf();
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void GenerateUpdateRconstBatch()
+{
+int i, nscalar, nconst, ntmp;
+int UPDATE_RCONST_BATCH;
+int NCELL, TEMPB, SUNB, RCB;
+double a[7], lcf;
+char tok[7][40];
+char r0[ 200 ], r1[ 200 ], r2[ 400 ];
+char *s, *inl;
+int *batch;
+
+  if( (useLang != C_LANG) && (useLang != F90_LANG) ) return;
+
+  UseFile( rateFile );
+
+  NCELL = DefElm( "Ncell", INT, "Number of cells");
+  TEMPB = DefvElm( "TEMPb", real, -NCELL, "Temperature of the cells");
+  SUNB  = DefvElm( "SUNb", real, -NCELL, "Sunlight intensity of the cells");
+  if( useLang == C_LANG ) 
+    RCB = DefvElm( "RCb", real, -NCELL, "Rate constants: RCb[j*Ncell+i] for reaction j, cell i");
+  else  
+    RCB = DefmElm( "RCb", real, -NCELL, -NREACT, "Rate constants: RCb(i,j) for cell i, reaction j");
+  UPDATE_RCONST_BATCH = DefFnc( "Update_RCONST_Batch", 4, 
+                     "function to update rate constants of a batch of cells");
+
+  /* batch[i] = 1 if reaction i is expanded inline */
+  batch = (int*)malloc( (EqnNr+1)*sizeof(int) );
+  nscalar = 0;
+  nconst = 0;
+  ntmp = 0;
+  for( i = 0; i < EqnNr; i++ ) {
+    s = kr[i].val.st;
+    batch[i] = ( kr[i].type == NUMBER ) 
+           || ( (kr[i].type == EXPRESION) && (
+                ( RateLawArgs( s, "",     tok, a, 1 ) == 1 ) ||
+                ( RateLawArgs( s, "ARR",  tok, a, 3 ) == 3 ) ||
+                ( RateLawArgs( s, "ARR2", tok, a, 2 ) == 2 ) ||
+                ( RateLawArgs( s, "EP2",  tok, a, 6 ) == 6 ) ||
+                ( RateLawArgs( s, "EP3",  tok, a, 4 ) == 4 ) ||
+                ( ( RateLawArgs( s, "FALL", tok, a, 7 ) == 7 ) && ( a[6] > 0 ) ) ) );
+    if( !batch[i] ) nscalar++;
+    if( ( kr[i].type == NUMBER ) || 
+        ( (kr[i].type == EXPRESION) && ( RateLawArgs( s, "", tok, a, 1 ) == 1 ) ) ) nconst++;
+    if( batch[i] && ( ( RateLawArgs( s, "EP2", tok, a, 6 ) == 6 ) ||
+                      ( RateLawArgs( s, "FALL", tok, a, 7 ) == 7 ) ) ) ntmp++;
+  }
+
+  FunctionBegin( UPDATE_RCONST_BATCH, NCELL, TEMPB, SUNB, RCB );
+
+  NewLines(1);
+  WriteComment("Local variables");
+  if( nscalar < EqnNr ) {
+    C_Inline("  int ic0, ib, nb;");
+    F90_Inline("  INTEGER :: ic0, nb");
+  }
+  if( nscalar + nconst < EqnNr ) {
+    C_Inline("  %s Tinv[%d], LogT[%d];", C_types[real], RCONST_BATCH, RCONST_BATCH );
+    F90_Inline("  %s :: Tinv(%d), LogT(%d)", F90_types[real], RCONST_BATCH, RCONST_BATCH );
+  }
+  if( ntmp > 0 ) {
+    C_Inline("  %s K0[%d], K1[%d], K2[%d];", C_types[real], 
+             RCONST_BATCH, RCONST_BATCH, RCONST_BATCH );
+    F90_Inline("  %s :: K0(%d), K1(%d), K2(%d)", F90_types[real], 
+             RCONST_BATCH, RCONST_BATCH, RCONST_BATCH );
+  }
+  if( nscalar > 0 ) {
+    C_Inline("  %s TEMP0 = TEMP, SUN0 = SUN;", C_types[real] );
+    C_Inline("  int ic;");
+    F90_Inline("  %s :: TEMP0, SUN0", F90_types[real] );
+    F90_Inline("  INTEGER :: ic");
+  }
+
+  if( nscalar < EqnNr ) {
+    NewLines(1);
+    WriteComment("Standard rate laws, in blocks of %d cells", RCONST_BATCH);
+    C_Inline("  for( ic0 = 0; ic0 < Ncell; ic0 += %d ) {", RCONST_BATCH);
+    C_Inline("    nb = ( Ncell-ic0 < %d ) ? Ncell-ic0 : %d;", RCONST_BATCH, RCONST_BATCH);
+    F90_Inline("  DO ic0 = 1, Ncell, %d", RCONST_BATCH);
+    F90_Inline("    nb = MIN( %d, Ncell-ic0+1 )", RCONST_BATCH);
+    if( nscalar + nconst < EqnNr ) {
+      C_Inline("    for( ib = 0; ib < nb; ib++ ) {");
+      C_Inline("      Tinv[ib] = 1.0/TEMPb[ic0+ib];");
+      C_Inline("      LogT[ib] = log( TEMPb[ic0+ib]/300.0 );");
+      C_Inline("    }");
+      F90_Inline("    Tinv(1:nb) = 1.0_dp/TEMPb(ic0:ic0+nb-1)");
+      F90_Inline("    LogT(1:nb) = LOG( TEMPb(ic0:ic0+nb-1)/300.0_dp )");
+    }
+    ident++;
+
+    for( i = 0; i < EqnNr; i++ ) {
+      if( !batch[i] ) continue;
+      s = kr[i].val.st;
+      if( kr[i].type == NUMBER ) {
+        BatchAssign( -i-1, BatchNum( kr[i].val.f, 1 ) );
+      } else if( RateLawArgs( s, "", tok, a, 1 ) == 1 ) {
+        /* (number) */
+        sprintf( r0, "%s%s", (a[0] < 0) ? "-" : "", BatchLit( tok[0], 0 ) );
+        BatchAssign( -i-1, r0 );
+      } else if( RateLawArgs( s, "ARR", tok, a, 3 ) == 3 ) {
+        BatchArr( r0, tok, a, 3, -1 );
+        BatchAssign( -i-1, r0 );
+      } else if( RateLawArgs( s, "ARR2", tok, a, 2 ) == 2 ) {
+        BatchArr( r0, tok, a, 2, 1 );
+        BatchAssign( -i-1, r0 );
+      } else if( RateLawArgs( s, "EP2", tok, a, 6 ) == 6 ) {
+        /* K0 + K3/(1+K3/K2) */
+        BatchArr( r0, tok, a, 2, -1 );
+        BatchAssign( 0, r0 );
+        BatchArr( r0, tok+2, a+2, 2, -1 );
+        BatchAssign( 1, r0 );
+        BatchArr( r0, tok+4, a+4, 2, -1 );
+        sprintf( r2, (useLang == C_LANG) ? "%s*CFACTOR*1.0e+6" : "%s*CFACTOR*1.0E6_dp", r0 );
+        BatchAssign( 2, r2 );
+        BatchAssign( -i-1, (useLang == C_LANG) ? "K0[ib] + K2[ib]/( 1.0+K2[ib]/K1[ib] )" 
+                                   : "K0(1:nb) + K2(1:nb)/( 1.0_dp+K2(1:nb)/K1(1:nb) )" );
+      } else if( RateLawArgs( s, "EP3", tok, a, 4 ) == 4 ) {
+        /* K1 + K2*(1.0e6*CFACTOR) */
+        BatchArr( r0, tok, a, 2, -1 );
+        BatchArr( r1, tok+2, a+2, 2, -1 );
+        sprintf( r2, (useLang == C_LANG) ? "%s + %s*(1.0e+6*CFACTOR)" 
+                                         : "%s + %s*(1.0E6_dp*CFACTOR)", r0, r1 );
+        BatchAssign( -i-1, r2 );
+      } else if( RateLawArgs( s, "FALL", tok, a, 7 ) == 7 ) {
+        /* K0/(1+K1)*CF**(1/(1+log10(K1)**2)), K1 = K0/Kinf */
+        BatchArr( r0, tok, a, 3, -1 );
+        sprintf( r2, (useLang == C_LANG) ? "%s*CFACTOR*1.0e+6" : "%s*CFACTOR*1.0E6_dp", r0 );
+        BatchAssign( 0, r2 );
+        BatchArr( r1, tok+3, a+3, 3, -1 );
+        sprintf( r2, (useLang == C_LANG) ? "K0[ib]/( %s )" : "K0(1:nb)/( %s )", r1 );
+        BatchAssign( 1, r2 );
+        BatchAssign( 2, (useLang == C_LANG) ? "log10( K1[ib] )" : "LOG10( K1(1:nb) )" );
+        lcf = log( a[6] );
+        if( lcf == 0 ) 
+          sprintf( r2, (useLang == C_LANG) ? "K0[ib]/( 1.0+K1[ib] )" 
+                                           : "K0(1:nb)/( 1.0_dp+K1(1:nb) )" );
+        else
+          sprintf( r2, (useLang == C_LANG) ? "K0[ib]/( 1.0+K1[ib] )*exp( %s/( 1.0+K2[ib]*K2[ib] ) )"
+                   : "K0(1:nb)/( 1.0_dp+K1(1:nb) )*EXP( %s/( 1.0_dp+K2(1:nb)**2 ) )", BatchNum( lcf, 0 ) );
+        BatchAssign( -i-1, r2 );
+      }
+    }
+
+    ident--;
+    C_Inline("  }");
+    F90_Inline("  END DO");
+  }
+
+  if( nscalar > 0 ) {
+    NewLines(1);
+    WriteComment("Other rate laws, cell by cell");
+    C_Inline("  for( ic = 0; ic < Ncell; ic++ ) {");
+    C_Inline("    TEMP = TEMPb[ic];");
+    C_Inline("    SUN  = SUNb[ic];");
+    F90_Inline("  TEMP0 = TEMP");
+    F90_Inline("  SUN0  = SUN");
+    F90_Inline("  DO ic = 1, Ncell");
+    F90_Inline("    TEMP = TEMPb(ic)");
+    F90_Inline("    SUN  = SUNb(ic)");
+    ident++;
+    inl = InlineCode[ (useLang == C_LANG) ? C_RCONST : F90_RCONST ].code;
+    if( inl && *inl ) {
+      WriteComment("Begin INLINED RCONST");
+      bprintf( inl );
+      FlushBuf();
+      WriteComment("End INLINED RCONST");
+    }
+    for( i = 0; i < EqnNr; i++ ) {
+      if( batch[i] ) continue;
+      if( useLang == C_LANG ) sprintf( r0, "RCb[%d*Ncell+ic]", i );
+                         else sprintf( r0, "RCb(ic,%d)", i+1 );
+      WriteAssign( r0, kr[i].val.st );
+    }
+    ident--;
+    C_Inline("  }");
+    C_Inline("  TEMP = TEMP0;");
+    C_Inline("  SUN  = SUN0;");
+    F90_Inline("  END DO");
+    F90_Inline("  TEMP = TEMP0");
+    F90_Inline("  SUN  = SUN0");
+  }
+
+  FunctionEnd( UPDATE_RCONST_BATCH );
+  FreeVariable( UPDATE_RCONST_BATCH );
+  FreeVariable( RCB );
+  FreeVariable( SUNB );
+  FreeVariable( TEMPB );
+  FreeVariable( NCELL );
+  free( batch );
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* #RATETABLE: the rate constants that depend only on TEMP are          */
+/* tabulated by Init_RATETABLE on the grid rtabTmin:rtabTmax:rtabStep,  */
+/* extended by one point at each end. Update_RCONST interpolates them   */
+/* (4-point Lagrange, error O(dT^4)) while TEMP stays on the grid and   */
+/* evaluates them exactly otherwise. RTAB holds one row of all the      */
+/* tabulated reactions per temperature, so an interpolation reads four  */
+/* contiguous rows.                                                     */
+
+/* 1 if rate expression s depends on TEMP and on nothing that can       */
+/* change after Initialize: numbers, TEMP, CFACTOR, the standard rate   */
+/* laws and elementary functions                                        */
+int TempOnlyRate( char *s )
+{
+static char *known[] = { "TEMP", "CFACTOR", "ARR", "ARR2", "EP2", "EP3", "FALL",
+                         "K_ARR", "EXP", "LOG", "LOG10", "SQRT", "POW", 0 };
+char id[ 40 ], uid[ 40 ];
+int k, n, temp;
+
+  temp = 0;
+  while( *s ) {
+    if( isdigit( *s ) || ( (*s == '.') && isdigit( s[1] ) ) ) {
+      /* number, with exponent and kind: 1.0, 2.e-12, 3.5d0, 1.0_dp */
+      while( isdigit( *s ) || (*s == '.') ) s++;
+      if( *s && strchr( "eEdD", *s ) && 
+          ( isdigit( s[1] ) || ( s[1] && strchr( "+-", s[1] ) && isdigit( s[2] ) ) ) ) {
+        s += 2;
+        while( isdigit( *s ) ) s++;
+      }
+      if( *s == '_' ) 
+        for( s++; isalnum( *s ) || (*s == '_'); s++ );
+      continue;
+    }
+    if( isalpha( *s ) || (*s == '_') ) {
+      for( n = 0; isalnum( *s ) || (*s == '_'); s++ ) 
+        if( n < 39 ) {
+          id[n] = *s;
+          uid[n++] = toupper( *s );
+        }
+      id[n] = uid[n] = 0;
+      /* C is case sensitive, except for the names of the math functions */
+      for( k = 0; known[k]; k++ )
+        if( strcmp( ( (useLang == C_LANG) && (k < 8) ) ? id : uid, known[k] ) == 0 ) break;
+      if( known[k] == 0 ) return 0;
+      if( (k == 0) || (k > 1 && k < 8) ) temp = 1;
+      continue;
+    }
+    s++;
+  }
+  return temp;
+}
+
+/* Reactions tabulated by #RATETABLE: fills rct[] (if not 0) with */
+/* their numbers and returns how many there are                   */
+int RateTableList( int *rct )
+{
+int i, n;
+
+  if( !useRatetable || ( (useLang != C_LANG) && (useLang != F90_LANG) ) ) 
+    return 0;
+  n = 0;
+  for( i = 0; i < EqnNr; i++ )
+    if( (kr[i].type == EXPRESION) && TempOnlyRate( kr[i].val.st ) ) {
+      if( rct ) rct[n] = i;
+      n++;
+    }
+  return n;
+}
+
+/* Number of grid temperatures of #RATETABLE in [rtabTmin, rtabTmax] */
+int RateTableRows()
+{
+  return (int)( (rtabTmax - rtabTmin)/rtabStep + 1.0e-6 ) + 1;
+}
+
+/* The table RTAB and the index RTAB_RCT of the tabulated reactions; */
+/* module data of KPP_ROOT_Rates in Fortran90                        */
+void DeclareRateTable()
+{
+int *rct;
+int i, n, RTAB_RCT;
+
+  n = RateTableList( 0 );
+  if( n == 0 ) return;
+  rct = (int*)malloc( n*sizeof(int) );
+  RateTableList( rct );
+  for( i = 0; i < n; i++ ) rct[i] = Index( rct[i] );
+
+  NewLines(1);
+  WriteComment("RTAB - rate constants of #RATETABLE, one row per temperature");
+  WriteComment("       (row k at TEMP = %g + (k-%d)*%g)", rtabTmin,
+               (useLang == C_LANG) ? 1 : 2, rtabStep );
+  C_Inline("  static %s RTAB[%d][%d];", C_types[real], RateTableRows()+2, n );
+  F90_Inline("  %s, SAVE :: RTAB(%d,%d)", F90_types[real], n, RateTableRows()+2 );
+  RTAB_RCT = DefvElm( "RTAB_RCT", INT, -NREACT, "Reactions tabulated in RTAB" );
+  InitDeclare( RTAB_RCT, n, (void*)rct );
+  FreeVariable( RTAB_RCT );
+  free( rct );
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void GenerateRateTable()
+{
+int *rct;
+int j, n, nrow;
+int INIT_RATETABLE, INTERP_RATETABLE, CHECK_RATETABLE;
+char name[ 40 ];
+
+  n = RateTableList( 0 );
+  if( n == 0 ) {
+    if( !useRatetable ) return;
+    printf("\n");
+    if( (useLang != C_LANG) && (useLang != F90_LANG) ) 
+      Warning("#RATETABLE is ignored: supported in C and Fortran90 only");
+    else  
+      Warning("#RATETABLE: no rate constant depends on TEMP only");
+    return;
+  }
+  rct = (int*)malloc( n*sizeof(int) );
+  RateTableList( rct );
+  nrow = RateTableRows();
+  printf("\n    - %d of %d rate constants tabulated for %g <= TEMP <= %g",
+         n, EqnNr, rtabTmin, rtabTmin + (nrow-1)*rtabStep );
+
+  UseFile( rateFile );
+  if( useLang == C_LANG ) DeclareRateTable();
+
+  /* Init_RATETABLE */
+  INIT_RATETABLE = DefFnc( "Init_RATETABLE", 0, 
+                     "function to tabulate the rate constants of #RATETABLE");
+  FunctionBegin( INIT_RATETABLE );
+  C_Inline("  %s TEMP0 = TEMP;", C_types[real] );
+  C_Inline("  int k;");
+  F90_Inline("  %s :: TEMP0", F90_types[real] );
+  F90_Inline("  INTEGER :: k");
+  NewLines(1);
+  C_Inline("  for( k = 0; k < %d; k++ ) {", nrow+2 );
+  C_Inline("    TEMP = %s + (k-1)*%s;", BatchNum( rtabTmin, 0 ), BatchNum( rtabStep, 0 ) );
+  F90_Inline("  TEMP0 = TEMP");
+  F90_Inline("  DO k = 1, %d", nrow+2 );
+  F90_Inline("    TEMP = %s + (k-2)*%s", BatchNum( rtabTmin, 0 ), BatchNum( rtabStep, 0 ) );
+  ident++;
+  for( j = 0; j < n; j++ ) {
+    if( useLang == C_LANG ) sprintf( name, "RTAB[k][%d]", j );
+                       else sprintf( name, "RTAB(%d,k)", j+1 );
+    WriteAssign( name, kr[ rct[j] ].val.st );
+  }
+  ident--;
+  C_Inline("  }");
+  C_Inline("  TEMP = TEMP0;");
+  F90_Inline("  END DO");
+  F90_Inline("  TEMP = TEMP0");
+  FunctionEnd( INIT_RATETABLE );
+  FreeVariable( INIT_RATETABLE );
+
+  /* Interp_RATETABLE */
+  INTERP_RATETABLE = DefFnc( "Interp_RATETABLE", 0, 
+                     "function to interpolate the rate constants of #RATETABLE at TEMP");
+  FunctionBegin( INTERP_RATETABLE );
+  C_Inline("  %s x, u, w0, w1, w2, w3;", C_types[real] );
+  C_Inline("  %s *R0, *R1, *R2, *R3;", C_types[real] );
+  C_Inline("  int j, k;");
+  F90_Inline("  %s :: x, u, w0, w1, w2, w3", F90_types[real] );
+  F90_Inline("  INTEGER :: j, k");
+  NewLines(1);
+  WriteComment("TEMP lies in interval k of the grid, at fraction u of its length");
+  C_Inline("  x = (TEMP - %s)*%s;", BatchNum( rtabTmin, 0 ), BatchNum( 1.0/rtabStep, 0 ) );
+  C_Inline("  k = (int)x;");
+  C_Inline("  if( k > %d ) k = %d;", nrow-2, nrow-2 );
+  C_Inline("  u = x - k;");
+  C_Inline("  w0 = -u*(u-1.0)*(u-2.0)/6.0;");
+  C_Inline("  w1 = (u+1.0)*(u-1.0)*(u-2.0)/2.0;");
+  C_Inline("  w2 = -(u+1.0)*u*(u-2.0)/2.0;");
+  C_Inline("  w3 = (u+1.0)*u*(u-1.0)/6.0;");
+  C_Inline("  R0 = RTAB[k];");
+  C_Inline("  R1 = RTAB[k+1];");
+  C_Inline("  R2 = RTAB[k+2];");
+  C_Inline("  R3 = RTAB[k+3];");
+  C_Inline("  for( j = 0; j < %d; j++ )", n );
+  C_Inline("    RCONST[RTAB_RCT[j]] = w0*R0[j] + w1*R1[j] + w2*R2[j] + w3*R3[j];");
+  F90_Inline("  x = (TEMP - %s)*%s", BatchNum( rtabTmin, 0 ), BatchNum( 1.0/rtabStep, 0 ) );
+  F90_Inline("  k = MIN( INT(x), %d )", nrow-2 );
+  F90_Inline("  u = x - k");
+  F90_Inline("  w0 = -u*(u-1.0_dp)*(u-2.0_dp)/6.0_dp");
+  F90_Inline("  w1 = (u+1.0_dp)*(u-1.0_dp)*(u-2.0_dp)/2.0_dp");
+  F90_Inline("  w2 = -(u+1.0_dp)*u*(u-2.0_dp)/2.0_dp");
+  F90_Inline("  w3 = (u+1.0_dp)*u*(u-1.0_dp)/6.0_dp");
+  F90_Inline("  DO j = 1, %d", n );
+  F90_Inline("    RCONST(RTAB_RCT(j)) = w0*RTAB(j,k+1) + w1*RTAB(j,k+2) &");
+  F90_Inline("                        + w2*RTAB(j,k+3) + w3*RTAB(j,k+4)");
+  F90_Inline("  END DO");
+  FunctionEnd( INTERP_RATETABLE );
+  FreeVariable( INTERP_RATETABLE );
+
+  /* Check_RATETABLE */
+  CHECK_RATETABLE = DefFnc( "Check_RATETABLE", 0, 
+                     "function to report the interpolation error of #RATETABLE");
+  FunctionBegin( CHECK_RATETABLE );
+  C_Inline("  %s TEMP0 = TEMP, RCT0[NREACT], RX[%d];", C_types[real], n );
+  C_Inline("  %s e, emax = 0.0, Tmax = TEMP;", C_types[real] );
+  C_Inline("  int j, k, jmax = 0;");
+  F90_Inline("  %s :: TEMP0, RCT0(NREACT), RX(%d)", F90_types[real], n );
+  F90_Inline("  %s :: e, emax, Tmax", F90_types[real] );
+  F90_Inline("  INTEGER :: j, k, jmax");
+  NewLines(1);
+  WriteComment("Largest relative error at the midpoints of the grid intervals");
+  C_Inline("  for( j = 0; j < NREACT; j++ ) RCT0[j] = RCONST[j];");
+  C_Inline("  for( k = 0; k < %d; k++ ) {", nrow-1 );
+  C_Inline("    TEMP = %s + (k+0.5)*%s;", BatchNum( rtabTmin, 0 ), BatchNum( rtabStep, 0 ) );
+  F90_Inline("  TEMP0 = TEMP");
+  F90_Inline("  RCT0(:) = RCONST(:)");
+  F90_Inline("  emax = 0.0_dp");
+  F90_Inline("  Tmax = TEMP");
+  F90_Inline("  jmax = 1");
+  F90_Inline("  DO k = 1, %d", nrow-1 );
+  F90_Inline("    TEMP = %s + (k-0.5_dp)*%s", BatchNum( rtabTmin, 0 ), BatchNum( rtabStep, 0 ) );
+  ident++;
+  for( j = 0; j < n; j++ ) {
+    if( useLang == C_LANG ) sprintf( name, "RX[%d]", j );
+                       else sprintf( name, "RX(%d)", j+1 );
+    WriteAssign( name, kr[ rct[j] ].val.st );
+  }
+  ident--;
+  C_Inline("    Interp_RATETABLE();");
+  C_Inline("    for( j = 0; j < %d; j++ ) {", n );
+  C_Inline("      if( RX[j] == 0.0 ) continue;");
+  C_Inline("      e = fabs( RCONST[RTAB_RCT[j]] - RX[j] )/fabs( RX[j] );");
+  C_Inline("      if( e > emax ) {");
+  C_Inline("        emax = e;");
+  C_Inline("        jmax = j;");
+  C_Inline("        Tmax = TEMP;");
+  C_Inline("      }");
+  C_Inline("    }");
+  C_Inline("  }");
+  C_Inline("  printf(\"\\n#RATETABLE: %d rate constants, max. relative error %%%%.2e\"", n );
+  C_Inline("         \" (reaction %%%%d at TEMP = %%%%g)\\n\", emax, RTAB_RCT[jmax]+1, Tmax );");
+  C_Inline("  TEMP = TEMP0;");
+  C_Inline("  for( j = 0; j < NREACT; j++ ) RCONST[j] = RCT0[j];");
+  F90_Inline("    CALL Interp_RATETABLE()");
+  F90_Inline("    DO j = 1, %d", n );
+  F90_Inline("      IF ( RX(j) == 0.0_dp ) CYCLE");
+  F90_Inline("      e = ABS( RCONST(RTAB_RCT(j)) - RX(j) )/ABS( RX(j) )");
+  F90_Inline("      IF ( e > emax ) THEN");
+  F90_Inline("        emax = e");
+  F90_Inline("        jmax = j");
+  F90_Inline("        Tmax = TEMP");
+  F90_Inline("      END IF");
+  F90_Inline("    END DO");
+  F90_Inline("  END DO");
+  F90_Inline("  WRITE(6,'(A,I5,A,ES9.2,A,I5,A,F8.2,A)') ' #RATETABLE:', %d, &", n );
+  F90_Inline("       ' rate constants, max. relative error', emax, &");
+  F90_Inline("       ' (reaction', RTAB_RCT(jmax), ' at TEMP =', Tmax, ')'");
+  F90_Inline("  TEMP = TEMP0");
+  F90_Inline("  RCONST(:) = RCT0(:)");
+  FunctionEnd( CHECK_RATETABLE );
+  FreeVariable( CHECK_RATETABLE );
+
+  free( rct );
+}
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 void GenerateUpdateRconst()
 {
-int i;
+int i, n, nrow;
+int *tab, *rct;
 int UPDATE_RCONST;
 
   UseFile( rateFile );
@@ -2008,7 +3221,36 @@ int UPDATE_RCONST;
   WriteComment("End INLINED RCONST");
   NewLines(1);
 
+  /* tab[i] = 1 if reaction i is tabulated (#RATETABLE) */
+  tab = (int*)calloc( EqnNr+1, sizeof(int) );
+  n = RateTableList( 0 );
+  if( n > 0 ) {
+    rct = (int*)malloc( n*sizeof(int) );
+    RateTableList( rct );
+    for( i = 0; i < n; i++ ) tab[ rct[i] ] = 1;
+    free( rct );
+    nrow = RateTableRows();
+    WriteComment("Rate constants of #RATETABLE: interpolated inside the table");
+    C_Inline("  if( (TEMP >= %s) && (TEMP <= %s) ) {", BatchNum( rtabTmin, 0 ),
+             BatchNum( rtabTmin + (nrow-1)*rtabStep, 0 ) );
+    C_Inline("    Interp_RATETABLE();");
+    C_Inline("  } else {");
+    F90_Inline("  IF ( (TEMP >= %s) .AND. (TEMP <= %s) ) THEN", BatchNum( rtabTmin, 0 ),
+             BatchNum( rtabTmin + (nrow-1)*rtabStep, 0 ) );
+    F90_Inline("    CALL Interp_RATETABLE()");
+    F90_Inline("  ELSE");
+    ident++;
+    for( i = 0; i < EqnNr; i++ )
+      if( tab[i] ) 
+        Assign( Elm( RCONST, i ), Elm( KR, kr[i].val.st ) );  
+    ident--;
+    C_Inline("  }");
+    F90_Inline("  END IF");
+    NewLines(1);
+  }
+
   for( i = 0; i < EqnNr; i++) {
+    if( tab[i] ) continue;
     if( kr[i].type == EXPRESION )
       Assign( Elm( RCONST, i ), Elm( KR, kr[i].val.st ) );  
     if( kr[i].type == PHOTO )
@@ -2026,10 +3268,49 @@ int UPDATE_RCONST;
   
   FunctionEnd( UPDATE_RCONST );
   FreeVariable( UPDATE_RCONST );
+  free( tab );
 }
 
 
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* Update_TOT sets the totals of the conservation laws from C; Update_DEP */
+/* recomputes the dependent species of #REDUCE CONSERVED and the QSSA     */
+/* species from VAR.  Both are generated (empty) without them too, for    */
+/* the drivers                                                             */
+void GenerateUpdateCons()
+{
+int l, j, d;
+int UPDATE_TOT, UPDATE_DEP;
+
+  if ( (useLang != C_LANG) && (useLang != F90_LANG) ) return;
+
+  UseFile( rateFile );
+
+  UPDATE_TOT = DefFnc( "Update_TOT", 0, "totals of the conservation laws from C");
+  FunctionBegin( UPDATE_TOT );
+  if ( ConsNr > 0 ) {
+    NewLines(1);
+    for( l = 0; l < ConsNr; l++ ) {
+      d = ReverseCode[ ConsDep[l] ];
+      sum = Elm( FIX, d - VarNr );
+      for( j = 0; j < VarNr; j++ )
+        if( ConsCoef[l][ Code[j] ] != 0 )
+          sum = Add( sum, Mul( Const( ConsCoef[l][ Code[j] ] ), Elm( VAR, j ) ) );
+      Assign( Elm( TOT, l ), sum );
+    }
+  }
+  FunctionEnd( UPDATE_TOT );
+  FreeVariable( UPDATE_TOT );
+
+  UPDATE_DEP = DefFnc( "Update_DEP", 0, "dependent species of the conservation laws and the QSSA");
+  FunctionBegin( UPDATE_DEP );
+  GenerateConsDep( VAR, FIX );
+  GenerateQssaDep( VAR, FIX, RCONST );
+  FunctionEnd( UPDATE_DEP );
+  FreeVariable( UPDATE_DEP );
+}
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 void GenerateUpdatePhoto()
 {
@@ -2171,17 +3452,28 @@ int j,dummy_species;
   DeclareConstant( NONZERO, ascii( max(Jac_NZ, 1) ) );
   DeclareConstant( LU_NONZERO, ascii( max(LU_Jac_NZ, 1) ) );
   DeclareConstant( CNVAR,   ascii( VarNr+1 ) );
+  if ( (useLang == C_LANG) && useJacSparse && (useJacobian == JAC_LU_ROW) ) {
+        DeclareConstant( LU_NLEV,  ascii( LU_Nlev ) );
+        DeclareConstant( LU_NBLEV, ascii( LU_Nblev ) );
+  }
   if ( useStoicmat ) { 
         DeclareConstant( CNEQN,   ascii( EqnNr+1 ) );
   }	
   if ( useHessian ) { 
         DeclareConstant( NHESS,   ascii( max(Hess_NZ, 1) ) );
   }
+  if ( ConsNr > 0 ) { 
+        DeclareConstant( NCONS,   ascii( ConsNr ) );
+  }
 
   DeclareConstant( NLOOKAT,  ascii( nlookat ) );
   DeclareConstant( NMONITOR,  ascii( nmoni ) );
   DeclareConstant( NMASS, ascii( nmass ) );
 
+  C_Inline("\n/* Alignment of the read-only sparse index tables */");
+  C_Inline("#if defined(__GNUC__)\n#define KPP_ALIGN __attribute__ ((aligned (64)))");
+  C_Inline("#else\n#define KPP_ALIGN\n#endif");
+
   /* DeclareConstant( PI, "3.14159265358979" ); */
 
   NewLines(1);
@@ -2257,7 +3549,16 @@ int mxyz;
 
  /* ExternDeclare( C_DEFAULT ); */
 
-  ExternDeclare( C );
+  if( (useLang == F90_LANG) && useThreadsafe ) {
+     /* THREADPRIVATE data can not be EQUIVALENCEd: VAR, FIX point into C */
+     WriteComment("%s - %s", varTable[C]->name, varTable[C]->comment );
+     F90_Inline("  REAL(kind=dp), TARGET :: %s(%s)", varTable[C]->name,
+            useDeclareValues ? ascii(SpcNr) : varTable[NSPEC]->name );
+     WriteComment("VAR, FIX are chunks of array C (see KppThreadInit)");
+     F90_Inline("  REAL(kind=dp), POINTER :: %s(:) => NULL()", varTable[VAR]->name );
+     F90_Inline("  REAL(kind=dp), POINTER :: %s(:) => NULL()", varTable[FIX]->name );
+  } else
+    ExternDeclare( C );
   
   if( useLang == F77_LANG ) {
  
@@ -2272,7 +3573,7 @@ int mxyz;
    }
   }
   
-  if( useLang == F90_LANG ) { 
+  if( (useLang == F90_LANG) && !useThreadsafe ) { 
      ExternDeclare( VAR );
      ExternDeclare( FIX );
      WriteComment("VAR, FIX are chunks of array C");
@@ -2306,8 +3607,27 @@ int mxyz;
   ExternDeclare( STEPMIN );
   ExternDeclare( STEPMAX );
   ExternDeclare( CFACTOR );
-  if (useStochastic)
+  if ( ConsNr > 0 )
+      ExternDeclare( TOT );
+  if (useStochastic) {
       ExternDeclare( VOLUME );
+      NewLines(1);
+      WriteComment("State of a random number stream (see KppRandInit)");
+      C_Inline("typedef struct {");
+      C_Inline("  unsigned int key[2];                        /* Generator seed */");
+      C_Inline("  unsigned int ctr[4];                        /* Block counter, stream id */");
+      C_Inline("  unsigned int buf[4];                        /* Current block */");
+      C_Inline("  int pos;                                    /* Next unused word in buf */");
+      C_Inline("} KPP_RNG;");
+  }
+
+  if( useThreadsafe ) {
+     /* The state of a box is private to each OpenMP thread */
+     NewLines(1);
+     F90_Inline("!$OMP THREADPRIVATE(%s)", ThreadPrivateList() );
+     C_Inline("#ifdef _OPENMP\n#pragma omp threadprivate( %s )\n#endif", ThreadPrivateList() );
+     C_Inline("void KppThreadInit();" );
+  }
   
   CommonName = "INTGDATA";
   if ( useHessian ) { 
@@ -2434,11 +3754,38 @@ char lhsbuf[MAX_EQNLEN], rhsbuf[MAX_EQNLEN];
 }
 
 
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* Conservation law l of #REDUCE CONSERVED as text, e.g. "NO2 + NO" */
+void ConsStr( int l, char * buf )
+{
+int j;
+double c;
+char s[MAX_SPNAME+40];
+
+  strcpy( buf, SpeciesTable[ ConsDep[l] ].name );
+  for( j = 0; j < VarNr; j++ ) {
+    c = ConsCoef[l][ Code[j] ];
+    if( c == 0 ) continue;
+    if( fabs(c) == 1 ) snprintf( s, sizeof(s), "%s %s", (c > 0) ? "+" : "-",
+                                 SpeciesTable[ Code[j] ].name );
+    else snprintf( s, sizeof(s), "%s %g %s", (c > 0) ? "+" : "-", fabs(c),
+                   SpeciesTable[ Code[j] ].name );
+    if( strlen(buf) + strlen(s) + 10 > MAX_EQNLEN ) { /* truncate if too long */
+      strcat( buf, " ... etc." );
+      break;
+    }
+    strcat( buf, " " );
+    strcat( buf, s );
+  }
+}
+
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 void GenerateMap()
 {
 int i;
 int dn;
+char buf[ MAX_EQNLEN ];
+int nblk, nmax, n1;
 
   UseFile( mapFile );
 
@@ -2456,6 +3803,10 @@ int dn;
 		    else WriteAll("DOUBLE   - OFF\n");
   if( useReorder )        WriteAll("REORDER  - ON\n");
 		    else WriteAll("REORDER  - OFF\n");
+  if( useJacobian == JAC_LU_ROW ) {
+    nblk = LUBlocks( &nmax, &n1 );
+    WriteAll("LU BLOCKS- %d (%d of size 1, largest %d)\n", nblk, n1, nmax );
+  }
   NewLines(1);
   
   WriteAll("### Parameters ----------------------------------------\n");
@@ -2497,6 +3848,23 @@ int dn;
     i += dn; if( i < FixNr ) WriteSpec( i, i + VarNr );
     i -= 2*dn; WriteAll("\n"); 
   }
+
+  if( ConsNr > 0 ) {
+    NewLines(1);
+    WriteAll("Conservation laws (first the dependent species)\n");
+    for( i = 0; i < ConsNr; i++ ) {
+      ConsStr( i, buf );
+      WriteAll("%3d : %s\n", 1 + i, buf );
+    }
+  }
+
+  if( QssaNr > 0 ) {
+    NewLines(1);
+    WriteAll("Quasi-steady-state species (in the order of their solution)\n");
+    for( i = 0; i < QssaNr; i++ )
+      WriteAll("%3d = %s\n", Index( ReverseCode[ QssaSpc[i] ] ),
+               SpeciesTable[ QssaSpc[i] ].name );
+  }
     
   NewLines(1);
   WriteAll("### Subroutines ---------------------------------------\n");
@@ -2517,9 +3885,17 @@ int INITVAL;
       UseFile( initFile );
 
   INITVAL    = DefFnc( "Initialize",    0, "function to initialize concentrations");
+  if( RateTableList( 0 ) > 0 )
+    C_Inline("void Init_RATETABLE();");
+  if( ConsNr > 0 )
+    C_Inline("void Update_TOT();");
   FunctionBegin( INITVAL );
   F77_Inline("      INCLUDE '%s_Global.h'", rootFileName);
   F90_Inline("  USE %s_Global\n", rootFileName);
+  if( RateTableList( 0 ) > 0 )
+    F90_Inline("  USE %s_Rates, ONLY: Init_RATETABLE\n", rootFileName);
+  if( ConsNr > 0 )
+    F90_Inline("  USE %s_Rates, ONLY: Update_TOT\n", rootFileName);
   MATLAB_Inline("global CFACTOR VAR FIX NVAR NFIX", rootFileName);
   
   I = DefElm( "i", INT, 0);
@@ -2527,6 +3903,10 @@ int INITVAL;
   Declare( I );
   Declare( X );
 
+  if ( useThreadsafe ) {
+    F90_Inline("\n  CALL KppThreadInit()");
+    C_Inline("\n  KppThreadInit();");
+  }
   NewLines(1);
   WriteAssign( varTable[CFACTOR]->name , ascid( (double)cfactor ) );
   NewLines(1);
@@ -2612,6 +3992,20 @@ int INITVAL;
   WriteComment("End INLINED initializations");
   NewLines(1);
 
+  if( RateTableList( 0 ) > 0 ) {
+    WriteComment("Rate constant table of #RATETABLE (uses CFACTOR)");
+    C_Inline("  Init_RATETABLE();");
+    F90_Inline("  CALL Init_RATETABLE()");
+    NewLines(1);
+  }
+
+  if( ConsNr > 0 ) {
+    WriteComment("Totals of the conservation laws (#REDUCE)");
+    C_Inline("  Update_TOT();");
+    F90_Inline("  CALL Update_TOT()");
+    NewLines(1);
+  }
+
   MATLAB_Inline("   VAR = VAR(:);\n   FIX = FIX(:);\n" );
 
   FreeVariable( X );
@@ -2887,7 +4281,8 @@ case 'h':
     if ( useDeclareValues )
       F90_Inline("  USE %s_Precision", rootFileName );
     else
-      F90_Inline("  USE %s_Parameters, ONLY: dp, NSPEC, NVAR, NFIX, NREACT", rootFileName);
+      F90_Inline("  USE %s_Parameters, ONLY: dp, NSPEC, NVAR, NFIX, NREACT%s", rootFileName,
+                 (ConsNr > 0) ? ", NCONS" : "" );
     F90_Inline("  PUBLIC\n  SAVE\n");
  
   UseFile( functionFile ); 
@@ -2896,8 +4291,11 @@ case 'h':
       F90_Inline("  USE %s_Precision", rootFileName );
     else
       F90_Inline("  USE %s_Parameters", rootFileName );
+    if ( ConsNr > 0 )
+      F90_Inline("  USE %s_Global, ONLY: TOT", rootFileName );
     F90_Inline("  IMPLICIT NONE\n", rootFileName );
-    Declare( A ); /*  mz_rs_20050117 */
+    if ( !useThreadsafe ) /* Otherwise A is local to Fun */
+      Declare( A ); /*  mz_rs_20050117 */
     F90_Inline("\nCONTAINS\n\n");
 
   UseFile( rateFile );
@@ -2908,6 +4306,7 @@ case 'h':
       F90_Inline("  USE %s_Parameters", rootFileName );
     F90_Inline("  USE %s_Global", rootFileName );
     F90_Inline("  IMPLICIT NONE", rootFileName );
+    DeclareRateTable();
     F90_Inline("\nCONTAINS\n\n");
 
   if ( useStochastic ) {
@@ -2916,8 +4315,14 @@ case 'h':
     if ( useDeclareValues )
       F90_Inline("  USE %s_Precision", rootFileName );
     else
-      F90_Inline("  USE %s_Parameters, ONLY: NVAR, NFIX, NREACT", rootFileName );
+      F90_Inline("  USE %s_Parameters, ONLY: dp, NVAR, NFIX, NREACT%s", rootFileName,
+                 useJacSparse ? ", LU_NONZERO" : "" );
     F90_Inline("  PUBLIC\n  SAVE\n");
+    F90_Inline("! State of a random number stream (see KppRandInit)");
+    F90_Inline("  TYPE KPP_RNG");
+    F90_Inline("    INTEGER(kind=8) :: Key(2), Ctr(4), Buf(4)");
+    F90_Inline("    INTEGER :: Pos");
+    F90_Inline("  END TYPE KPP_RNG");
     F90_Inline("\nCONTAINS\n\n");
   }
 
@@ -2935,6 +4340,8 @@ case 'h':
       F90_Inline("  USE %s_Parameters", rootFileName );
     if ( useJacSparse )
       F90_Inline("  USE %s_JacobianSP\n", rootFileName);
+    if ( ConsNr > 0 )
+      F90_Inline("  USE %s_Global, ONLY: TOT", rootFileName );
     F90_Inline("  IMPLICIT NONE", rootFileName );
     F90_Inline("\nCONTAINS\n\n");
   
@@ -3046,6 +4453,18 @@ case 't':
   F90_Inline("\nEND MODULE %s_Parameters\n", rootFileName );
   
   UseFile( global_dataFile );
+  if ( useThreadsafe ) {
+    F90_Inline("\nCONTAINS\n");
+    F90_Inline("! KppThreadInit - associate VAR and FIX with the C of the calling");
+    F90_Inline("!   thread; call it in every thread before using them (Initialize does)");
+    F90_Inline("  SUBROUTINE KppThreadInit()");
+    F90_Inline("    %s => %s(1:%s)", varTable[VAR]->name, varTable[C]->name,
+               useDeclareValues ? ascii(VarNr) : varTable[NVAR]->name );
+    F90_Inline("    %s => %s(%s+1:%s)", varTable[FIX]->name, varTable[C]->name,
+               useDeclareValues ? ascii(VarNr) : varTable[NVAR]->name,
+               useDeclareValues ? ascii(SpcNr) : varTable[NSPEC]->name );
+    F90_Inline("  END SUBROUTINE KppThreadInit");
+  }
   F90_Inline("\nEND MODULE %s_Global\n", rootFileName );
 
   UseFile( functionFile ); 
@@ -3163,6 +4582,7 @@ int n;
     printf("\nKPP is generating the Stochastic description:");
     printf("\n    - %s_Function",rootFileName);
     GenerateStochastic();  
+    GenerateRandomUtil();
   }  
   
   if ( useJacobian ) {
@@ -3205,8 +4625,11 @@ int n;
   
   GenerateRateLaws();  
   GenerateUpdateSun();  
+  GenerateRateTable();  
   GenerateUpdateRconst();  
+  GenerateUpdateRconstBatch();  
   GenerateUpdatePhoto();
+  GenerateUpdateCons();
   GenerateGetMass(); 
 
 
@@ -3242,6 +4665,7 @@ int n;
         GenerateStoicmSparseHeader(); 
     GenerateDFunDRcoeff();
     GenerateDJacDRcoeff();
+    GenerateStoicmKernels();
   }  
 
   printf("\nKPP is generating the driver from %s.f90:", driver);
@@ -32,6 +32,8 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <ctype.h>
 #include "gdata.h"
 #include "scan.h"
 
@@ -46,6 +48,20 @@ short int *Stru;
 
 enum stru_criteria { UNSORT, LINSORT, COLSORT, BESTSORT };
 
+/* Conservation laws of #REDUCE CONSERVED: law l keeps              */
+/* sum ConsCoef[l][code]*C(code) constant; its dependent species     */
+/* ConsDep[l] has the coefficient 1 and is turned into a fixed one   */
+int ConsNr = 0;
+CODE ConsDep[ MAX_SPECIES ];
+double *ConsCoef[ MAX_SPECIES ];
+
+/* Species of #REDUCE QSSA, turned into fixed species, the upstream */
+/* ones first; QssaDep[l][code] flags the variable species that the  */
+/* value of QSSA species l depends on                                */
+int QssaNr = 0;
+CODE QssaSpc[ MAX_SPECIES ];
+char *QssaDep[ MAX_SPECIES ];
+
 void EqCopy( EQ_VECT e1, EQ_VECT e2 )
 {
 int i;
@@ -110,6 +126,54 @@ short int sc1, sc2;
   return 0;
 }
 
+/* A species i that reacts with the dependent species of a         */
+/* conservation law depends on all the species of the law           */
+void ConservedStructJ()
+{
+int i,j,k,l,d;
+
+  for ( l=0; l<ConsNr; l++ ) {
+    d = ReverseCode[ ConsDep[l] ];
+    for (i = 0; i < VarNr; i++)
+      for (k = 0; k < EqnNr; k++)
+        if ( Stoich[i][k]*((Stoich_Left[d][k])?1:0) != 0.0 ) {
+          for (j = 0; j < VarNr; j++)
+            if ( ConsCoef[l][ Code[j] ] != 0.0 )
+              structJ[i][j]=1;
+          break;
+        }
+  }
+}
+
+/* A species i that reacts with a QSSA species depends on the      */
+/* species that the QSSA species depends on                          */
+void QssaStructJ()
+{
+int i,j,k,l,q;
+
+  for ( l=0; l<QssaNr; l++ ) {
+    q = ReverseCode[ QssaSpc[l] ];
+    for (i = 0; i < VarNr; i++)
+      for (k = 0; k < EqnNr; k++)
+        if ( Stoich[i][k]*((Stoich_Left[q][k])?1:0) != 0.0 ) {
+          for (j = 0; j < VarNr; j++)
+            if ( QssaDep[l][ Code[j] ] )
+              structJ[i][j]=1;
+          break;
+        }
+  }
+}
+
+/* True if the value of a QSSA species depends on species code */
+int QssaUses( CODE code )
+{
+int l;
+
+  for ( l=0; l<QssaNr; l++ )
+    if ( QssaDep[l][code] ) return 1;
+  return 0;
+}
+
 void UpdateStructJ()
 {
 int i,j,k;
@@ -123,6 +187,8 @@ int i,j,k;
       for (k = 0; k < EqnNr; k++)
         if ( Stoich[i][k]*((Stoich_Left[j][k])?1:0) != 0.0 )
           structJ[i][j]=1;
+  ConservedStructJ();
+  QssaStructJ();
 
   for ( i=0; i<VarNr; i++ )
     for ( j=0; j<VarNr; j++ )
@@ -196,6 +262,8 @@ FILE * fff;
       for (k = 0; k < EqnNr; k++)
         if ( Stoich[i][k]*((Stoich_Left[j][k])?1:0) != 0.0 )
           structJ[i][j]=1;
+  ConservedStructJ();
+  QssaStructJ();
 
   for ( i=0; i<VarNr; i++ ) {
     linStru[i] = 0;
@@ -220,7 +288,77 @@ FILE * fff;
   } 
 }
 
-void BestSparsity()
+/* Tarjan's algorithm on the species dependency graph, with an edge */
+/* i -> j if species i depends on species j ( structJ[i][j] )        */
+static int sccIndex[ MAX_SPECIES ];
+static int sccLow[ MAX_SPECIES ];
+static int sccStack[ MAX_SPECIES ];
+static int sccComp[ MAX_SPECIES ];
+static int sccCount, sccTop, sccNr;
+
+void SccVisit( int i )
+{
+int j, k;
+
+  sccIndex[i] = sccLow[i] = sccCount++;
+  sccStack[ sccTop++ ] = i;
+  sccComp[i] = -1;
+
+  for ( j=0; j<VarNr; j++ ) {
+    if( (j == i) || !structJ[i][j] ) continue;
+    if( sccIndex[j] < 0 ) {
+      SccVisit( j );
+      if( sccLow[j] < sccLow[i] ) sccLow[i] = sccLow[j];
+    } else if( (sccComp[j] < 0) && (sccIndex[j] < sccLow[i]) ) {
+      sccLow[i] = sccIndex[j];
+    }
+  }
+
+  if( sccLow[i] == sccIndex[i] ) {
+    do {
+      k = sccStack[ --sccTop ];
+      sccComp[k] = sccNr;
+    } while( k != i );
+    sccNr++;
+  }
+}
+
+int BlockTriangular( int *blkEnd )
+{
+int i,j,b,k;
+int perm[ MAX_SPECIES ];
+
+  /* The strongly connected components of the dependency graph become */
+  /* the diagonal blocks of a block upper triangular Jacobian.  Tarjan */
+  /* completes a component after all the components it depends on, so */
+  /* the blocks are taken in the reverse order.  bestStru and LUstructJ */
+  /* get the permuted species, blkEnd[s] the end of the block of row s. */
+  /* Returns the number of blocks                                       */
+  sccCount = 0; sccTop = 0; sccNr = 0;
+  for ( i=0; i<VarNr; i++ )
+    sccIndex[i] = -1;
+  for ( i=0; i<VarNr; i++ )
+    if( sccIndex[i] < 0 ) SccVisit( i );
+
+  k = 0;
+  for ( b=sccNr-1; b>=0; b-- ) {
+    for ( i=0; i<VarNr; i++ )
+      if( sccComp[i] == b ) perm[k++] = i;
+  }
+
+  for ( i=0; i<VarNr; i++ ) {
+    bestStru[i] = Code[ perm[i] ];
+    blkEnd[i] = VarNr;
+    for ( j=0; j<VarNr; j++ )
+      LUstructJ[i][j] = structJ[ perm[i] ][ perm[j] ];
+  }
+  for ( i=VarNr-2; i>=0; i-- )
+    blkEnd[i] = ( sccComp[ perm[i] ] == sccComp[ perm[i+1] ] ) ? blkEnd[i+1] : i+1;
+
+  return sccNr;
+}
+
+int MarkowitzSparsity( int *blkEnd )
 {
 int i,j,k;
 int cnz, lnz;
@@ -228,15 +366,14 @@ int best, crt;
 int best_i;
 int tmp;
 int s;
+int nz;
 
-  UpdateStructJ();
-      
-  for ( i=0; i<VarNr; i++ )
-    bestStru[i] = Code[i];
-
+  /* Markowitz pivoting on LUstructJ and bestStru; the pivot of row s */
+  /* is searched in the rows s..blkEnd[s]-1.  Returns the number of   */
+  /* nonzeros of the LU factorization                                 */
   for ( s=0; s<VarNr-1; s++ ) {
-    best = MAX_SPECIES*MAX_SPECIES; best_i = 0;
-    for ( i=s; i<VarNr; i++ ) {
+    best = MAX_SPECIES*MAX_SPECIES; best_i = s;
+    for ( i=s; i<blkEnd[s]; i++ ) {
       cnz = 0;lnz = 0;
       for (j = s; j < VarNr; j++) {
         cnz += (LUstructJ[i][j]?1:0);
@@ -270,6 +407,40 @@ int s;
     }
   }
 
+  nz = 0;
+  for ( i=0; i<VarNr; i++ )
+    for ( j=0; j<VarNr; j++ )
+      nz += (LUstructJ[i][j]?1:0);
+  return nz;
+}
+
+void BestSparsity()
+{
+int i;
+int nzglb, nzblk;
+int blkEnd[ MAX_SPECIES ];
+short int glbStru[ MAX_SPECIES ];
+
+  /* Markowitz ordering of the whole Jacobian */
+  UpdateStructJ();
+  for ( i=0; i<VarNr; i++ ) {
+    bestStru[i] = Code[i];
+    blkEnd[i] = VarNr;
+  }
+  nzglb = MarkowitzSparsity( blkEnd );
+  for ( i=0; i<VarNr; i++ )
+    glbStru[i] = bestStru[i];
+
+  /* Markowitz ordering inside the diagonal blocks of the block   */
+  /* triangular form, where the fill-in stays in the blocks.  The */
+  /* ordering with fewer LU nonzeros is kept                      */
+  UpdateStructJ();
+  BlockTriangular( blkEnd );
+  nzblk = MarkowitzSparsity( blkEnd );
+  if( nzglb < nzblk )
+    for ( i=0; i<VarNr; i++ )
+      bestStru[i] = glbStru[i];
+
   Stru = bestStru;
 }
 
@@ -395,6 +566,828 @@ int dummyNr;
   fflush(stdout);
 }
 
+/* Rational approximation p/q, q <= 100, of a law coefficient */
+double ConsRound( double x )
+{
+int q;
+double p;
+
+  if ( fabs(x) < 1.0e-8 ) return 0.0;
+  for ( q = 1; q <= 100; q++ ) {
+    p = floor( x*q + 0.5 );
+    if ( fabs( x*q - p ) < 1.0e-6*q ) return p/q;
+  }
+  return x;
+}
+
+/* #REDUCE CONSERVED: finds a basis of the conservation laws of the  */
+/* variable species (the left null space of Stoich) and turns one    */
+/* dependent species per law into a fixed species, recomputed from  */
+/* the law.  The dependent species are chosen to add few nonzeros    */
+/* to the Jacobian, and are not used by the QSSA species             */
+void ReduceConserved()
+{
+int i, j, k, l, m, p, n, d, rank, ok;
+double **M, *B, t, amax, bmax, tol, res, mag;
+int score[ MAX_SPECIES ];
+int used[ MAX_SPECIES ];
+
+  if ( useReduce == 0 ) return;
+  if ( (useLang != C_LANG) && (useLang != F90_LANG) ) {
+    Warning("#REDUCE CONSERVED is only available for C and Fortran90, ignored");
+    return;
+  }
+  if ( useStochastic ) {
+    Warning("#REDUCE CONSERVED is not available with #STOCHASTIC, ignored");
+    return;
+  }
+  if ( VarNr == 0 ) return;
+
+  /* Row echelon form of [ Stoich | I ]: the rows with a zero       */
+  /* stoichiometric part hold the conservation laws                  */
+  n = EqnNr + VarNr;
+  M = (double**)malloc( VarNr * sizeof(double*) );
+  amax = 0;
+  for ( i = 0; i < VarNr; i++ ) {
+    M[i] = (double*)calloc( n, sizeof(double) );
+    for ( k = 0; k < EqnNr; k++ ) {
+      M[i][k] = Stoich[i][k];
+      if ( fabs( M[i][k] ) > amax ) amax = fabs( M[i][k] );
+    }
+    M[i][EqnNr+i] = 1.0;
+  }
+  tol = 1.0e-5 * ( (amax > 0) ? amax : 1.0 );
+
+  rank = 0;
+  for ( k = 0; (k < EqnNr) && (rank < VarNr); k++ ) {
+    p = rank;
+    for ( i = rank+1; i < VarNr; i++ )
+      if ( fabs( M[i][k] ) > fabs( M[p][k] ) ) p = i;
+    if ( fabs( M[p][k] ) <= tol ) continue;
+    B = M[p]; M[p] = M[rank]; M[rank] = B;
+    for ( i = rank+1; i < VarNr; i++ ) {
+      t = M[i][k] / M[rank][k];
+      if ( t == 0 ) continue;
+      for ( j = k; j < n; j++ )
+        M[i][j] -= t * M[rank][j];
+    }
+    rank++;
+  }
+
+  /* Score of a species: the number of species that depend on it */
+  for ( j = 0; j < VarNr; j++ ) {
+    score[j] = 0;
+    used[j] = 0;
+    for ( i = 0; i < VarNr; i++ )
+      for ( k = 0; k < EqnNr; k++ )
+        if ( Stoich[i][k]*((Stoich_Left[j][k])?1:0) != 0.0 ) {
+          score[j]++;
+          break;
+        }
+  }
+
+  /* Reduced row echelon form of the laws, with the pivot of each   */
+  /* law (its dependent species) of lowest score                     */
+  for ( l = rank; l < VarNr; l++ ) {
+    B = M[l] + EqnNr;
+    bmax = 0;
+    for ( j = 0; j < VarNr; j++ )
+      if ( fabs( B[j] ) > bmax ) bmax = fabs( B[j] );
+    d = -1;
+    for ( j = 0; j < VarNr; j++ ) {
+      if ( used[j] || ( fabs( B[j] ) < 1.0e-3 * bmax ) ) continue;
+      if ( QssaUses( Code[j] ) ) continue;
+      if ( ( d < 0 ) || ( score[j] < score[d] ) ||
+           ( ( score[j] == score[d] ) && ( fabs( B[j] ) > fabs( B[d] ) ) ) )
+        d = j;
+    }
+    if ( d < 0 ) continue;
+    used[d] = l+1;
+    t = B[d];
+    for ( j = 0; j < VarNr; j++ )
+      B[j] /= t;
+    for ( m = rank; m < VarNr; m++ ) {
+      if ( m == l ) continue;
+      t = M[m][EqnNr+d];
+      if ( t == 0 ) continue;
+      for ( j = 0; j < VarNr; j++ )
+        M[m][EqnNr+j] -= t * B[j];
+    }
+  }
+
+  /* Keep the laws that hold with the rounded coefficients */
+  for ( d = 0; d < VarNr; d++ ) {
+    if ( used[d] == 0 ) continue;
+    B = M[ used[d]-1 ] + EqnNr;
+    for ( j = 0; j < VarNr; j++ )
+      B[j] = ( j == d ) ? 1.0 : ConsRound( B[j] );
+    ok = 1;
+    for ( k = 0; k < EqnNr; k++ ) {
+      res = 0; mag = 0;
+      for ( j = 0; j < VarNr; j++ ) {
+        res += B[j] * Stoich[j][k];
+        mag += fabs( B[j] * Stoich[j][k] );
+      }
+      if ( fabs( res ) > 1.0e-5 * mag ) ok = 0;
+    }
+    if ( !ok ) {
+      Warning("#REDUCE CONSERVED: inexact conservation law for %s, not used",
+              SpeciesTable[ Code[d] ].name );
+      continue;
+    }
+    ConsCoef[ ConsNr ] = (double*)calloc( MAX_SPECIES, sizeof(double) );
+    for ( j = 0; j < VarNr; j++ )
+      ConsCoef[ ConsNr ][ Code[j] ] = B[j];
+    ConsDep[ ConsNr ] = Code[d];
+    ConsNr++;
+  }
+
+  for ( i = 0; i < VarNr; i++ )
+    free( M[i] );
+  free( M );
+
+  /* The dependent species become fixed: the next ReorderSpecies */
+  /* moves them after the variable ones                           */
+  for ( l = 0; l < ConsNr; l++ )
+    SpeciesTable[ ConsDep[l] ].type = FIX_SPC;
+
+  if ( ConsNr > 0 ) {
+    printf("\nKPP is eliminating %d species with conservation laws.", ConsNr);
+    if ( useHessian || useStoicmat )
+      printf("\nKPP will not generate the Hessian and stoichiometric files.");
+    useHessian = 0;
+    useStoicmat = 0;
+  }
+}
+
+/* #REDUCE DRG: evaluation of the rate coefficients and initial     */
+/* values at the #SAMPLE conditions.  Numbers, + - * / ** ^, the    */
+/* rate laws of UserRateLaws and the usual intrinsics; TEMP, SUN,   */
+/* CFACTOR and all other names take their values from the sample    */
+char *drgPos;
+int drgSet;
+int drgBad;
+
+int DrgSample( int s, char *name, double *val )
+{
+int i;
+
+  for ( i = 0; i < SampleNr; i++ )
+    if ( ( SampleTable[i].set == s ) && EqNoCase( SampleTable[i].name, name ) ) {
+      *val = SampleTable[i].val;
+      return 1;
+    }
+  return 0;
+}
+
+double DrgName( char *name )
+{
+double v;
+
+  if ( DrgSample( drgSet, name, &v ) ) return v;
+  if ( EqNoCase( name, "TEMP" ) ) return 298.0;
+  if ( EqNoCase( name, "SUN" ) ) return 1.0;
+  if ( EqNoCase( name, "CFACTOR" ) ) return cfactor;
+  drgBad = 1;
+  return 0;
+}
+
+double DrgFunc( char *name, double *a, int n )
+{
+double T, cf, k0, k1, k2, k3;
+
+  T = DrgName( "TEMP" );
+  cf = DrgName( "CFACTOR" );
+  if ( EqNoCase( name, "ARR" ) && ( n == 3 ) )
+    return a[0] * exp( -a[1]/T ) * pow( T/300.0, a[2] );
+  if ( EqNoCase( name, "ARR2" ) && ( n == 2 ) )
+    return a[0] * exp( a[1]/T );
+  if ( EqNoCase( name, "EP2" ) && ( n == 6 ) ) {
+    k0 = a[0] * exp( -a[1]/T );
+    k2 = a[2] * exp( -a[3]/T );
+    k3 = a[4] * exp( -a[5]/T ) * cf * 1.0e+6;
+    return k0 + k3/( 1.0 + k3/k2 );
+  }
+  if ( EqNoCase( name, "EP3" ) && ( n == 4 ) )
+    return a[0] * exp( -a[1]/T ) + a[2] * exp( -a[3]/T ) * 1.0e+6 * cf;
+  if ( EqNoCase( name, "FALL" ) && ( n == 7 ) ) {
+    k0 = a[0] * exp( -a[1]/T ) * pow( T/300.0, a[2] ) * cf * 1.0e+6;
+    k1 = k0 / ( a[3] * exp( -a[4]/T ) * pow( T/300.0, a[5] ) );
+    return ( k0/( 1.0+k1 ) ) * pow( a[6], 1.0/( 1.0+pow( log10(k1), 2 ) ) );
+  }
+  if ( EqNoCase( name, "K_ARR" ) && ( n == 3 ) )
+    return a[0] * exp( a[1]*( 1.0/a[2] - 3.3540e-3 ) );
+  if ( EqNoCase( name, "EXP" ) && ( n == 1 ) )   return exp( a[0] );
+  if ( EqNoCase( name, "LOG" ) && ( n == 1 ) )   return log( a[0] );
+  if ( EqNoCase( name, "LOG10" ) && ( n == 1 ) ) return log10( a[0] );
+  if ( EqNoCase( name, "SQRT" ) && ( n == 1 ) )  return sqrt( a[0] );
+  if ( EqNoCase( name, "ABS" ) && ( n == 1 ) )   return fabs( a[0] );
+  if ( EqNoCase( name, "POW" ) && ( n == 2 ) )   return pow( a[0], a[1] );
+  if ( EqNoCase( name, "MIN" ) && ( n == 2 ) )   return ( a[0] < a[1] ) ? a[0] : a[1];
+  if ( EqNoCase( name, "MAX" ) && ( n == 2 ) )   return ( a[0] > a[1] ) ? a[0] : a[1];
+  drgBad = 1;
+  return 0;
+}
+
+double DrgExpr();
+
+double DrgPrimary()
+{
+char buf[ MAX_K ];
+double a[ 10 ], v;
+int n;
+
+  while ( isspace( *drgPos ) ) drgPos++;
+  if ( *drgPos == '(' ) {
+    drgPos++;
+    v = DrgExpr();
+    if ( *drgPos == ')' ) drgPos++; else drgBad = 1;
+    return v;
+  }
+  n = 0;
+  if ( isdigit( *drgPos ) || ( *drgPos == '.' ) ) {
+    while ( ( isdigit( *drgPos ) || ( *drgPos == '.' ) ) && ( n < MAX_K-8 ) )
+      buf[ n++ ] = *drgPos++;
+    /* Fortran exponents (1.0d-8) and kind parameters (1.0_dp) */
+    if ( ( *drgPos ) && strchr( "eEdD", *drgPos ) &&
+         ( isdigit( drgPos[1] ) || ( ( ( drgPos[1] == '+' ) || ( drgPos[1] == '-' ) )
+                                    && isdigit( drgPos[2] ) ) ) ) {
+      buf[ n++ ] = 'e';
+      drgPos++;
+      if ( ( *drgPos == '+' ) || ( *drgPos == '-' ) ) buf[ n++ ] = *drgPos++;
+      while ( isdigit( *drgPos ) && ( n < MAX_K-1 ) ) buf[ n++ ] = *drgPos++;
+    }
+    buf[ n ] = '\0';
+    if ( *drgPos == '_' )
+      while ( isalnum( *drgPos ) || ( *drgPos == '_' ) ) drgPos++;
+    return atof( buf );
+  }
+  if ( isalpha( *drgPos ) || ( *drgPos == '_' ) ) {
+    while ( ( isalnum( *drgPos ) || ( *drgPos == '_' ) ) && ( n < MAX_K-1 ) )
+      buf[ n++ ] = *drgPos++;
+    buf[ n ] = '\0';
+    while ( isspace( *drgPos ) ) drgPos++;
+    if ( *drgPos != '(' ) return DrgName( buf );
+    drgPos++;
+    n = 0;
+    while ( isspace( *drgPos ) ) drgPos++;
+    if ( *drgPos != ')' ) {
+      for (;;) {
+        v = DrgExpr();
+        if ( n < 10 ) a[ n ] = v;
+        n++;
+        if ( *drgPos != ',' ) break;
+        drgPos++;
+      }
+    }
+    if ( *drgPos == ')' ) drgPos++; else drgBad = 1;
+    return DrgFunc( buf, a, n );
+  }
+  drgBad = 1;
+  return 0;
+}
+
+double DrgUnary()
+{
+double v;
+
+  while ( isspace( *drgPos ) ) drgPos++;
+  if ( *drgPos == '-' ) { drgPos++; return -DrgUnary(); }
+  if ( *drgPos == '+' ) { drgPos++; return DrgUnary(); }
+  v = DrgPrimary();
+  while ( isspace( *drgPos ) ) drgPos++;
+  if ( ( drgPos[0] == '*' ) && ( drgPos[1] == '*' ) ) {
+    drgPos += 2;
+    return pow( v, DrgUnary() );
+  }
+  if ( *drgPos == '^' ) {
+    drgPos++;
+    return pow( v, DrgUnary() );
+  }
+  return v;
+}
+
+double DrgTerm()
+{
+double v;
+
+  v = DrgUnary();
+  for (;;) {
+    if ( *drgPos == '*' ) { drgPos++; v *= DrgUnary(); }
+    else if ( *drgPos == '/' ) { drgPos++; v /= DrgUnary(); }
+    else return v;
+  }
+}
+
+double DrgExpr()
+{
+double v;
+
+  v = DrgTerm();
+  for (;;) {
+    if ( *drgPos == '+' ) { drgPos++; v += DrgTerm(); }
+    else if ( *drgPos == '-' ) { drgPos++; v -= DrgTerm(); }
+    else return v;
+  }
+}
+
+/* Value of expression s in sample set drgSet; 0 if it cannot be evaluated */
+int DrgEval( char *s, double *val )
+{
+  drgPos = s;
+  drgBad = 0;
+  *val = DrgExpr();
+  while ( isspace( *drgPos ) || ( *drgPos == ';' ) ) drgPos++;
+  return !drgBad && ( *drgPos == '\0' ) && ( fabs( *val ) < HUGE_VAL );
+}
+
+/* Reactions that change each species row, and the species rows of */
+/* each reaction, for the interaction coefficients                   */
+int *drgSpcPtr, *drgSpcEqn;
+int *drgEqnPtr, *drgEqnSpc;
+int *drgMark, drgStamp;
+
+/* Interaction coefficients r(A,B) of species row a with the rows B  */
+/* of its reactions (returned in list) for the reaction rates w.     */
+/* DRG:   r = sum_{k with B} |nu_Ak w_k| / sum_k |nu_Ak w_k|         */
+/* DRGEP: r = |sum_{k with B} nu_Ak w_k| / max( prod_A, cons_A )     */
+/* A rate that could not be evaluated (unk) gives r = 1              */
+int DrgEdges( int a, double *w, char *unk, double *r, int *list )
+{
+int i, j, k, b, n;
+double v, prod, cons, den;
+
+  drgStamp++;
+  n = 0; prod = 0; cons = 0;
+  for ( j = drgSpcPtr[a]; j < drgSpcPtr[a+1]; j++ ) {
+    k = drgSpcEqn[j];
+    v = Stoich[a][k] * w[k];
+    if ( v > 0 ) prod += v; else cons -= v;
+    for ( i = drgEqnPtr[k]; i < drgEqnPtr[k+1]; i++ ) {
+      b = drgEqnSpc[i];
+      if ( drgMark[b] != drgStamp ) {
+        drgMark[b] = drgStamp;
+        r[b] = 0;
+        list[ n++ ] = b;
+      }
+      r[b] += ( useDrg == DRGEP_ON ) ? v : fabs( v );
+    }
+  }
+  den = ( useDrg == DRGEP_ON ) ? ( ( prod > cons ) ? prod : cons ) : prod + cons;
+  for ( i = 0; i < n; i++ )
+    r[ list[i] ] = ( den > 0 ) ? fabs( r[ list[i] ] ) / den : 0;
+  for ( j = drgSpcPtr[a]; j < drgSpcPtr[a+1]; j++ ) {
+    k = drgSpcEqn[j];
+    if ( unk[k] )
+      for ( i = drgEqnPtr[k]; i < drgEqnPtr[k+1]; i++ )
+        r[ drgEqnSpc[i] ] = 1.0;
+  }
+  return n;
+}
+
+/* Builds the lists of drgSpcPtr and drgEqnPtr for the current      */
+/* Stoich; only the variable species have reactions in drgSpcEqn     */
+void DrgLists()
+{
+int i, k, n;
+
+  free( drgSpcPtr ); free( drgSpcEqn );
+  free( drgEqnPtr ); free( drgEqnSpc );
+  drgSpcPtr = (int*)malloc( (SpcNr+1) * sizeof(int) );
+  drgEqnPtr = (int*)malloc( (EqnNr+1) * sizeof(int) );
+
+  n = 0;
+  for ( i = 0; i < SpcNr; i++ )
+    if ( SpeciesTable[ Code[i] ].type == VAR_SPC )
+      for ( k = 0; k < EqnNr; k++ )
+        if ( Stoich[i][k] != 0 ) n++;
+  drgSpcEqn = (int*)malloc( (n+1) * sizeof(int) );
+  n = 0;
+  for ( i = 0; i < SpcNr; i++ ) {
+    drgSpcPtr[i] = n;
+    if ( SpeciesTable[ Code[i] ].type == VAR_SPC )
+      for ( k = 0; k < EqnNr; k++ )
+        if ( Stoich[i][k] != 0 ) drgSpcEqn[ n++ ] = k;
+  }
+  drgSpcPtr[ SpcNr ] = n;
+
+  n = 0;
+  for ( k = 0; k < EqnNr; k++ )
+    for ( i = 0; i < SpcNr; i++ )
+      if ( Stoich_Left[i][k] || Stoich_Right[i][k] ) n++;
+  drgEqnSpc = (int*)malloc( (n+1) * sizeof(int) );
+  n = 0;
+  for ( k = 0; k < EqnNr; k++ ) {
+    drgEqnPtr[k] = n;
+    for ( i = 0; i < SpcNr; i++ )
+      if ( Stoich_Left[i][k] || Stoich_Right[i][k] ) drgEqnSpc[ n++ ] = i;
+  }
+  drgEqnPtr[ EqnNr ] = n;
+}
+
+/* Cost estimate of the mechanism: the reaction rates plus the      */
+/* nonzeros of the Jacobian of the variable species                  */
+int DrgCost()
+{
+int i, j, k, b, nz;
+
+  DrgLists();
+  nz = EqnNr;
+  for ( i = 0; i < SpcNr; i++ ) {
+    if ( SpeciesTable[ Code[i] ].type != VAR_SPC ) continue;
+    drgStamp++;
+    drgMark[i] = drgStamp;
+    nz++;
+    for ( j = drgSpcPtr[i]; j < drgSpcPtr[i+1]; j++ ) {
+      k = drgSpcEqn[j];
+      for ( b = drgEqnPtr[k]; b < drgEqnPtr[k+1]; b++ )
+        if ( Stoich_Left[ drgEqnSpc[b] ][k] &&
+             ( SpeciesTable[ Code[ drgEqnSpc[b] ] ].type == VAR_SPC ) &&
+             ( drgMark[ drgEqnSpc[b] ] != drgStamp ) ) {
+          drgMark[ drgEqnSpc[b] ] = drgStamp;
+          nz++;
+        }
+    }
+  }
+  return nz;
+}
+
+/* Rate coefficient of reaction k in sample set drgSet; 0, with      */
+/* *bad = 1, if it cannot be evaluated                                */
+double DrgRate( int k, int *bad )
+{
+double v;
+
+  if ( kr[k].type == NUMBER ) return kr[k].val.f;
+  if ( DrgEval( kr[k].val.st, &v ) ) return v;
+  *bad = 1;
+  return 0;
+}
+
+/* Concentration of species row i in sample set drgSet: its #SAMPLE */
+/* value, else its initial value, times CFACTOR                      */
+double DrgConc( int i )
+{
+double v;
+char *ival;
+
+  if ( SpeciesTable[ Code[i] ].type == DUMMY_SPC ) return 1.0;
+  if ( !DrgSample( drgSet, SpeciesTable[ Code[i] ].name, &v ) ) {
+    ival = SpeciesTable[ Code[i] ].ival;
+    if ( *ival == '\0' )
+      ival = ( SpeciesTable[ Code[i] ].type == VAR_SPC ) ? varDefault : fixDefault;
+    if ( !DrgEval( ival, &v ) ) v = 0;
+  }
+  return v * cfactor;
+}
+
+int DrgVarNr()
+{
+int i, n;
+
+  n = 0;
+  for ( i = 0; i < SpcNr; i++ )
+    if ( SpeciesTable[ Code[i] ].type == VAR_SPC ) n++;
+  return n;
+}
+
+/* #REDUCE DRG / DRGEP: directed relation graph reduction.  For each */
+/* #SAMPLE, the importance R of a variable species is 1 for the       */
+/* #TARGETS and, along the paths of the graph of the interaction     */
+/* coefficients, the largest path product (DRGEP) or 1 when a path    */
+/* of coefficients of at least drgEps reaches it (DRG).  The species  */
+/* with R < drgEps in all samples are removed with their reactions    */
+void ReduceDRG()
+{
+int s, nset, i, j, k, m, n, a, used, bad, nunk, var0, eqn0, cost0, cost1;
+int *list;
+double *conc, *w, *r, *R, *Rmax, v;
+char *unk, *done;
+
+  if ( useDrg == DRG_OFF ) return;
+  n = 0;
+  for ( i = 0; i < SpcNr; i++ )
+    if ( ( SpeciesTable[ Code[i] ].type == VAR_SPC ) && SpeciesTable[ Code[i] ].target ) n++;
+  if ( n == 0 ) {
+    Warning("#REDUCE DRG needs the variable species to keep in #TARGETS, ignored");
+    return;
+  }
+
+  conc = (double*)malloc( SpcNr * sizeof(double) );
+  r    = (double*)malloc( SpcNr * sizeof(double) );
+  R    = (double*)malloc( SpcNr * sizeof(double) );
+  Rmax = (double*)calloc( SpcNr, sizeof(double) );
+  list = (int*)malloc( SpcNr * sizeof(int) );
+  done = (char*)malloc( SpcNr * sizeof(char) );
+  drgMark = (int*)calloc( SpcNr, sizeof(int) );
+  w    = (double*)malloc( (EqnNr+1) * sizeof(double) );
+  unk  = (char*)calloc( EqnNr+1, sizeof(char) );
+
+  var0 = DrgVarNr();
+  eqn0 = EqnNr;
+  cost0 = DrgCost();
+
+  nset = ( SampleSetNr > 0 ) ? SampleSetNr : 1;
+  nunk = 0;
+  for ( s = 0; s < nset; s++ ) {
+    drgSet = s;
+    for ( i = 0; i < SpcNr; i++ )
+      conc[i] = DrgConc( i );
+    for ( k = 0; k < EqnNr; k++ ) {
+      bad = 0;
+      v = DrgRate( k, &bad );
+      if ( bad && !unk[k] ) nunk++;
+      if ( bad ) unk[k] = 1;
+      for ( j = drgEqnPtr[k]; j < drgEqnPtr[k+1]; j++ )
+        if ( Stoich_Left[ drgEqnSpc[j] ][k] )
+          v *= pow( conc[ drgEqnSpc[j] ], Stoich_Left[ drgEqnSpc[j] ][k] );
+      w[k] = v;
+    }
+
+    /* Search from the targets, the most important species first */
+    for ( i = 0; i < SpcNr; i++ ) {
+      R[i] = ( ( SpeciesTable[ Code[i] ].type == VAR_SPC ) &&
+               SpeciesTable[ Code[i] ].target ) ? 1.0 : 0.0;
+      done[i] = 0;
+    }
+    for (;;) {
+      a = -1;
+      for ( i = 0; i < SpcNr; i++ )
+        if ( !done[i] && ( R[i] > 0 ) && ( ( a < 0 ) || ( R[i] > R[a] ) ) ) a = i;
+      if ( a < 0 ) break;
+      done[a] = 1;
+      n = DrgEdges( a, w, unk, r, list );
+      for ( j = 0; j < n; j++ ) {
+        i = list[j];
+        if ( done[i] || ( SpeciesTable[ Code[i] ].type != VAR_SPC ) ) continue;
+        v = ( useDrg == DRGEP_ON ) ? R[a] * r[i] : ( ( r[i] >= drgEps ) ? 1.0 : 0.0 );
+        if ( ( v >= drgEps ) && ( v > R[i] ) ) R[i] = v;
+      }
+    }
+    for ( i = 0; i < SpcNr; i++ )
+      if ( R[i] > Rmax[i] ) Rmax[i] = R[i];
+  }
+
+  /* Remove the reactions of the removed variable species */
+  m = 0;
+  for ( k = 0; k < EqnNr; k++ ) {
+    for ( j = drgEqnPtr[k]; j < drgEqnPtr[k+1]; j++ )
+      if ( ( SpeciesTable[ Code[ drgEqnSpc[j] ] ].type == VAR_SPC ) &&
+           ( Rmax[ drgEqnSpc[j] ] < drgEps ) ) break;
+    if ( j < drgEqnPtr[k+1] ) continue;
+    if ( m != k ) {
+      kr[m] = kr[k];
+      for ( i = 0; i < SpcNr; i++ ) {
+        Stoich_Left[i][m] = Stoich_Left[i][k];
+        Stoich_Right[i][m] = Stoich_Right[i][k];
+        Stoich[i][m] = Stoich[i][k];
+      }
+    }
+    m++;
+  }
+  for ( i = 0; i < SpcNr; i++ )
+    for ( k = m; k < EqnNr; k++ ) {
+      Stoich_Left[i][k] = 0;
+      Stoich_Right[i][k] = 0;
+      Stoich[i][k] = 0;
+    }
+  EqnNr = m;
+
+  /* Remove the species left without reactions, except the targets */
+  n = 0;
+  for ( i = 0; i < SpcNr; i++ ) {
+    used = ( SpeciesTable[ Code[i] ].type == VAR_SPC ) && SpeciesTable[ Code[i] ].target;
+    for ( k = 0; ( k < EqnNr ) && !used; k++ )
+      if ( Stoich_Left[i][k] || Stoich_Right[i][k] ) used = 1;
+    if ( !used ) {
+      ReverseCode[ Code[i] ] = NO_CODE;
+      continue;
+    }
+    Code[n] = Code[i];
+    ReverseCode[ Code[n] ] = n;
+    Reactive[n] = 0;
+    for ( k = 0; k < EqnNr; k++ ) {
+      Stoich_Left[n][k] = Stoich_Left[i][k];
+      Stoich_Right[n][k] = Stoich_Right[i][k];
+      Stoich[n][k] = Stoich[i][k];
+      if ( Stoich_Left[n][k] ) Reactive[n] = 1;
+    }
+    n++;
+  }
+  for ( i = n; i < SpcNr; i++ ) {
+    Code[i] = NO_CODE;
+    Reactive[i] = 0;
+    for ( k = 0; k < EqnNr; k++ ) {
+      Stoich_Left[i][k] = 0;
+      Stoich_Right[i][k] = 0;
+      Stoich[i][k] = 0;
+    }
+  }
+  SpcNr = n;
+
+  if ( nunk > 0 )
+    Warning("#REDUCE DRG: %d rate coefficients could not be evaluated at the #SAMPLE conditions; their reactions couple all their species", nunk);
+  cost1 = DrgCost();
+  printf("\nKPP has reduced the mechanism with %s (threshold %g):",
+         ( useDrg == DRGEP_ON ) ? "DRGEP" : "DRG", drgEps );
+  printf("\n    %d to %d variable species, %d to %d reactions.",
+         var0, DrgVarNr(), eqn0, EqnNr );
+  printf("\n    Estimated speedup %.1f (rates and Jacobian entries, before LU fill-in).",
+         (double)cost0 / ( ( cost1 > 0 ) ? cost1 : 1 ) );
+
+  free( drgSpcPtr ); free( drgSpcEqn );
+  free( drgEqnPtr ); free( drgEqnSpc );
+  drgSpcPtr = drgSpcEqn = drgEqnPtr = drgEqnSpc = NULL;
+  free( drgMark );
+  free( unk ); free( w );
+  free( done ); free( list );
+  free( Rmax ); free( R ); free( r ); free( conc );
+}
+
+/* DFS from row a over the dependencies on the QSSA species of inSet */
+/* (the reactants of the reactions that change a): true if it reaches */
+/* row c                                                               */
+int QssaReach( int a, int c, char *inSet, char *seen )
+{
+int i, j, k, b;
+
+  for ( j = drgSpcPtr[a]; j < drgSpcPtr[a+1]; j++ ) {
+    k = drgSpcEqn[j];
+    for ( i = drgEqnPtr[k]; i < drgEqnPtr[k+1]; i++ ) {
+      b = drgEqnSpc[i];
+      if ( ( b == a ) || ( Stoich_Left[b][k] == 0 ) ) continue;
+      if ( b == c ) return 1;
+      if ( inSet[b] && !seen[b] ) {
+        seen[b] = 1;
+        if ( QssaReach( b, c, inSet, seen ) ) return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+/* Appends row a to QssaSpc after the QSSA species it depends on */
+void QssaOrder( int a, char *inSet, char *seen )
+{
+int i, j, k, b;
+
+  seen[a] = 1;
+  for ( j = drgSpcPtr[a]; j < drgSpcPtr[a+1]; j++ ) {
+    k = drgSpcEqn[j];
+    for ( i = drgEqnPtr[k]; i < drgEqnPtr[k+1]; i++ ) {
+      b = drgEqnSpc[i];
+      if ( Stoich_Left[b][k] && inSet[b] && !seen[b] )
+        QssaOrder( b, inSet, seen );
+    }
+  }
+  QssaSpc[ QssaNr++ ] = Code[a];
+}
+
+/* #REDUCE QSSA: a variable species whose lifetime 1/D, with D its   */
+/* loss rate per molecule from Stoich_Left, is below qssaTau in all  */
+/* the #SAMPLE conditions becomes a quasi-steady-state species: a    */
+/* fixed species set to its production rate over D.  It must react   */
+/* linearly and have a thermal loss with fixed species only, so that  */
+/* D > 0.  The candidates are taken shortest lifetime first, as long  */
+/* as the QSSA species do not depend on each other in a cycle; they   */
+/* are then solved explicitly, the upstream ones first                */
+void ReduceQssa()
+{
+int s, nset, i, j, k, l, l2, m, n, a, b, ok, safe, bad, ncycle;
+int *cand;
+double *conc, *rc, *tau, d, p;
+char *inSet, *seen;
+
+  if ( !useQssa ) return;
+  if ( (useLang != C_LANG) && (useLang != F90_LANG) ) {
+    Warning("#REDUCE QSSA is only available for C and Fortran90, ignored");
+    return;
+  }
+  if ( useStochastic ) {
+    Warning("#REDUCE QSSA is not available with #STOCHASTIC, ignored");
+    return;
+  }
+  if ( VarNr == 0 ) return;
+
+  DrgLists();
+  conc  = (double*)malloc( SpcNr * sizeof(double) );
+  tau   = (double*)calloc( SpcNr, sizeof(double) );
+  rc    = (double*)malloc( (EqnNr+1) * sizeof(double) );
+  cand  = (int*)malloc( SpcNr * sizeof(int) );
+  inSet = (char*)calloc( SpcNr, sizeof(char) );
+  seen  = (char*)calloc( SpcNr, sizeof(char) );
+
+  /* Longest lifetime of each variable species in the samples */
+  nset = ( SampleSetNr > 0 ) ? SampleSetNr : 1;
+  for ( s = 0; s < nset; s++ ) {
+    drgSet = s;
+    for ( i = 0; i < SpcNr; i++ )
+      conc[i] = DrgConc( i );
+    bad = 0;
+    for ( k = 0; k < EqnNr; k++ )
+      rc[k] = DrgRate( k, &bad );
+    for ( i = 0; i < VarNr; i++ ) {
+      d = 0;
+      for ( k = 0; k < EqnNr; k++ ) {
+        if ( Stoich_Left[i][k] == 0 ) continue;
+        p = Stoich_Left[i][k] * rc[k];
+        for ( j = drgEqnPtr[k]; j < drgEqnPtr[k+1]; j++ ) {
+          m = drgEqnSpc[j];
+          if ( Stoich_Left[m][k] != 0 )
+            p *= pow( conc[m], Stoich_Left[m][k] - ( m == i ) );
+        }
+        d += p;
+      }
+      p = ( d > 0 ) ? 1.0/d : HUGE_VAL;
+      if ( p > tau[i] ) tau[i] = p;
+    }
+  }
+
+  /* Candidates, by increasing lifetime */
+  n = 0;
+  for ( i = 0; i < VarNr; i++ ) {
+    if ( SpeciesTable[ Code[i] ].target || !( tau[i] < qssaTau ) ) continue;
+    ok = 1; safe = 0;
+    for ( k = 0; k < EqnNr; k++ ) {
+      if ( Stoich_Left[i][k] == 0 ) continue;
+      if ( ( Stoich_Left[i][k] != 1 ) || ( Stoich_Right[i][k] != 0 ) ) ok = 0;
+      if ( kr[k].type == PHOTO ) continue;
+      for ( j = drgEqnPtr[k]; j < drgEqnPtr[k+1]; j++ ) {
+        m = drgEqnSpc[j];
+        if ( ( m != i ) && Stoich_Left[m][k] &&
+             ( SpeciesTable[ Code[m] ].type != FIX_SPC ) ) break;
+      }
+      if ( j == drgEqnPtr[k+1] ) safe = 1;
+    }
+    if ( !ok || !safe ) continue;
+    for ( j = n; ( j > 0 ) && ( tau[ cand[j-1] ] > tau[i] ); j-- )
+      cand[j] = cand[j-1];
+    cand[j] = i;
+    n++;
+  }
+
+  /* Keep the QSSA species free of cycles */
+  ncycle = 0;
+  for ( j = 0; j < n; j++ ) {
+    a = cand[j];
+    for ( i = 0; i < SpcNr; i++ ) seen[i] = 0;
+    if ( QssaReach( a, a, inSet, seen ) ) {
+      ncycle++;
+      continue;
+    }
+    inSet[a] = 1;
+  }
+
+  for ( i = 0; i < SpcNr; i++ ) seen[i] = 0;
+  QssaNr = 0;
+  for ( i = 0; i < VarNr; i++ )
+    if ( inSet[i] && !seen[i] ) QssaOrder( i, inSet, seen );
+
+  /* Variable species that each QSSA species depends on, directly */
+  /* or through the upstream QSSA species                          */
+  for ( l = 0; l < QssaNr; l++ ) {
+    a = ReverseCode[ QssaSpc[l] ];
+    QssaDep[l] = (char*)calloc( MAX_SPECIES, sizeof(char) );
+    for ( j = drgSpcPtr[a]; j < drgSpcPtr[a+1]; j++ ) {
+      k = drgSpcEqn[j];
+      for ( i = drgEqnPtr[k]; i < drgEqnPtr[k+1]; i++ ) {
+        b = drgEqnSpc[i];
+        if ( ( b == a ) || ( Stoich_Left[b][k] == 0 ) ) continue;
+        if ( !inSet[b] ) {
+          if ( b < VarNr ) QssaDep[l][ Code[b] ] = 1;
+          continue;
+        }
+        for ( l2 = 0; l2 < l; l2++ )
+          if ( QssaSpc[l2] == Code[b] )
+            for ( m = 0; m < MAX_SPECIES; m++ )
+              QssaDep[l][m] |= QssaDep[l2][m];
+      }
+    }
+  }
+
+  for ( l = 0; l < QssaNr; l++ )
+    SpeciesTable[ QssaSpc[l] ].type = FIX_SPC;
+
+  if ( QssaNr > 0 ) {
+    printf("\nKPP is eliminating %d species with the QSSA (lifetime < %g):",
+           QssaNr, qssaTau );
+    for ( l = 0; l < QssaNr; l++ )
+      printf("%s%s", ( l % 8 ) ? " " : "\n    ", SpeciesTable[ QssaSpc[l] ].name );
+    if ( ncycle > 0 )
+      printf("\n    %d more candidates are left out, to avoid cycles.", ncycle );
+    if ( useHessian || useStoicmat )
+      printf("\nKPP will not generate the Hessian and stoichiometric files.");
+    useHessian = 0;
+    useStoicmat = 0;
+  }
+
+  free( drgSpcPtr ); free( drgSpcEqn );
+  free( drgEqnPtr ); free( drgEqnSpc );
+  drgSpcPtr = drgSpcEqn = drgEqnPtr = drgEqnSpc = NULL;
+  free( seen ); free( inSet ); free( cand );
+  free( rc ); free( tau ); free( conc );
+}
+
 /* Allocate Internal Arrays */
 void  AllocInternalArrays( void )
 {
@@ -544,8 +1537,14 @@ int i,j;
   /* Allocate some internal data structures */
   AllocStructArrays();
 
+  ReduceDRG();
+
   printf("\nKPP is computing Jacobian sparsity structure.");
   ReorderSpecies( UNSORT );
+  ReduceQssa();
+  if ( QssaNr > 0 ) ReorderSpecies( UNSORT );
+  ReduceConserved();
+  if ( ConsNr > 0 ) ReorderSpecies( UNSORT );
   if (useReorder==1){
     BestSparsity(); 
     ReorderSpecies( BESTSORT );
@@ -2543,6 +2543,9 @@ void yyfree (void * ptr )
                          { "DOUBLE",     PRM_STATE, DOUBLE }, 
                          { "REORDER",    PRM_STATE, REORDER }, 
                          { "MEX",        PRM_STATE, MEX }, 
+                         { "THREADSAFE", PRM_STATE, THREADSAFE }, 
+                         { "RATETABLE",  PRM_STATE, RATETABLE }, 
+                         { "REDUCE",     PRM_STATE, REDUCE }, 
                          { "DUMMYINDEX", PRM_STATE, DUMMYINDEX}, 
                          { "EQNTAGS",    PRM_STATE, EQNTAGS}, 
                          { "FUNCTION",   PRM_STATE, FUNCTION }, 
@@ -2556,6 +2559,7 @@ void yyfree (void * ptr )
                          { "SETRAD",     SSP_STATE, SETVAR }, 
                          { "SETFIX",     SSP_STATE, SETFIX }, 
                          { "INITVALUES", INI_STATE, INITVALUES }, 
+                         { "SAMPLE",     INI_STATE, SAMPLE }, 
                          { "EQUATIONS",  EQN_STATE, EQUATIONS }, 
                          { "LUMP",       LMP_STATE, LUMP }, 
                          { "LOOKAT", 	 LKT_STATE, LOOKAT },
@@ -2567,6 +2571,7 @@ void yyfree (void * ptr )
                          { "YGRID",  	 PRM_STATE, YGRID },
                          { "ZGRID",  	 PRM_STATE, ZGRID },
                          { "MONITOR", 	 MNI_STATE, MONITOR },
+                         { "TARGETS", 	 MNI_STATE, TARGETS },
                          { "WRITE_ATM",  INITIAL,   WRITE_ATM },
                          { "WRITE_SPC",  INITIAL,   WRITE_SPC },
                          { "WRITE_MAT",  INITIAL,   WRITE_MAT },
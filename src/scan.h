@@ -68,6 +68,7 @@ extern int nWarning;
 extern int crt_section;
 
 int Parser( char * filename );  
+int EqNoCase( char *s1, char *s2 );
 void ScanError( char *fmt, ...  );
 void ParserError( char *fmt, ...  );
 void ScanWarning( char *fmt, ...  );
@@ -90,6 +91,9 @@ void AddLumpSpecies( char *spname );
 void CheckLump( char *spname );
 void AddLookAt( char *spname );
 void AddMonitor( char *spname );
+void AddTarget( char *spname );
+void AddSample( char *name, char *val );
+void EndSample();
 void AddTransport( char *spname );
 
 void WriteAtoms();
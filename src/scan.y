@@ -77,7 +77,7 @@
 %token HESSIAN STOICMAT STOCHASTIC DECLARE
 %token INITVALUES EQUATIONS LUMP INIEQUAL EQNEQUAL EQNCOLON 
 %token LMPCOLON LMPPLUS SPCPLUS SPCEQUAL ATOMDECL CHECK CHECKALL REORDER
-%token MEX DUMMYINDEX EQNTAGS
+%token MEX DUMMYINDEX EQNTAGS THREADSAFE RATETABLE REDUCE SAMPLE TARGETS
 %token LOOKAT LOOKATALL TRANSPORT TRANSPORTALL MONITOR USES SPARSEDATA
 %token WRITE_ATM WRITE_SPC WRITE_MAT WRITE_OPT INITIALIZE XGRID YGRID ZGRID
 %token USE LANGUAGE INTFILE DRIVER RUN INLINE ENDINLINE
@@ -117,6 +117,15 @@ section	        : JACOBIAN PARAMETER
                 | MEX PARAMETER
 		  { CmdMex( $2 );
                   }
+                | THREADSAFE PARAMETER
+		  { CmdThreadsafe( $2 );
+                  }
+                | RATETABLE PARAMETER
+		  { CmdRatetable( $2 );
+                  }
+                | REDUCE PARAMETER
+		  { CmdReduce( $2 );
+                  }
                 | DUMMYINDEX PARAMETER
 		  { CmdDummyindex( $2 );
                   }
@@ -147,6 +156,8 @@ section	        : JACOBIAN PARAMETER
                   {}  
                 | INITVALUES initvalues
                   {}
+                | SAMPLE initvalues
+                  { EndSample(); }
                 | EQUATIONS equations
                   {}
                 | LUMP lumps  
@@ -155,6 +166,8 @@ section	        : JACOBIAN PARAMETER
                   {}
                 | MONITOR monitorlist  
                   {}
+                | TARGETS monitorlist  
+                  {}
                 | TRANSPORT translist  
                   {}
                 | CHECKALL
@@ -234,7 +247,10 @@ monitorlist	: monitorlist monitorspc semicolon
                   { ParserErrorMessage(); }
                 ;
 monitorspc	: MNIID
-                  { AddMonitor( $1 );
+                  { switch( crt_section ) {
+                      case MONITOR: AddMonitor( $1 ); break;
+                      case TARGETS: AddTarget( $1 ); break;
+                    }
                   }
                 ;     
 translist	: translist transspc semicolon
@@ -308,7 +324,11 @@ initvalues      : initvalues assignment semicolon
                   { ParserErrorMessage(); }
                 ;
 assignment      : INISPC INIEQUAL INIVALUE
-                  { AssignInitialValue( $1, $3 ); }
+                  { switch( crt_section ) {
+                      case INITVALUES: AssignInitialValue( $1, $3 ); break;
+                      case SAMPLE:     AddSample( $1, $3 ); break;
+                    }
+                  }
                 ;
 equations       : equations equation semicolon
                 | equation semicolon
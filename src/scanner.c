@@ -61,6 +61,12 @@ CODE ReverseCode[ MAX_SPECIES ];
 CODE Code[ MAX_SPECIES ];
 KREACT kr[ MAX_EQN ];
 
+/* Sample conditions of #REDUCE DRG: the values of all #SAMPLE     */
+/* commands, each value tagged with the number of its command       */
+SAMPLE_DEF SampleTable[ MAX_SAMPLE ];
+int SampleNr = 0;
+int SampleSetNr = 0;
+
 float** Stoich_Left;
 float** Stoich;
 float** Stoich_Right;
@@ -104,6 +110,17 @@ int useDummyindex  = 0;
 int useEqntags     = 0;
 int useLang        = F77_LANG;
 int useStochastic  = 0;
+int useThreadsafe  = 0;
+int useRatetable   = 0;
+/* Temperature grid of #RATETABLE: Tmin, Tmax, step */
+double rtabTmin = 180.0, rtabTmax = 330.0, rtabStep = 0.5;
+int useReduce      = 0;
+int useDrg         = DRG_OFF;
+/* Threshold of #REDUCE DRG/DRGEP */
+double drgEps      = 0.01;
+int useQssa        = 0;
+/* Max. lifetime of the species of #REDUCE QSSA */
+double qssaTau     = 0.01;
 /* if useValues=1 KPP replaces parameters like NVAR etc. 
        by their values in vector/matrix declarations */
 int useDeclareValues = 0; 
@@ -252,6 +269,86 @@ void CmdStoicmat( char *cmd )
   ScanError("'%s': Unknown parameter for #STOICMAT [ON|OFF]", cmd );
 }
 
+void CmdThreadsafe( char *cmd )
+{
+  if( EqNoCase( cmd, "OFF" ) ) {
+    useThreadsafe = 0;
+    return;
+  }
+  if( EqNoCase( cmd, "ON" ) ) {
+    useThreadsafe = 1;
+    return;
+  }
+  ScanError("'%s': Unknown parameter for #THREADSAFE [ON|OFF]", cmd );
+}
+
+void CmdRatetable( char *cmd )
+{
+double t0, t1, dt;
+char c;
+
+  if( EqNoCase( cmd, "OFF" ) ) {
+    useRatetable = 0;
+    return;
+  }
+  if( EqNoCase( cmd, "ON" ) ) {
+    useRatetable = 1;
+    return;
+  }
+  if( sscanf( cmd, "%lf:%lf:%lf%c", &t0, &t1, &dt, &c ) == 3 ) {
+    if( (dt <= 0) || (t0 - dt <= 0) || (t1 - t0 < 2*dt) )
+      ScanError("'%s': Bad temperature grid for #RATETABLE, need dT > 0, Tmin > dT, Tmax >= Tmin+2*dT", cmd );
+    rtabTmin = t0;
+    rtabTmax = t1;
+    rtabStep = dt;
+    useRatetable = 1;
+    return;
+  }
+  ScanError("'%s': Unknown parameter for #RATETABLE [ON|OFF|Tmin:Tmax:dT]", cmd );
+}
+
+void CmdReduce( char *cmd )
+{
+char mode[ 10 ], c;
+double eps;
+int n;
+
+  if( EqNoCase( cmd, "OFF" ) ) {
+    useReduce = 0;
+    useDrg = DRG_OFF;
+    useQssa = 0;
+    return;
+  }
+  if( EqNoCase( cmd, "CONSERVED" ) ) {
+    useReduce = 1;
+    return;
+  }
+  /* DRG or DRGEP, with an optional threshold: DRGEP:0.05 */
+  n = sscanf( cmd, "%6[A-Za-z]:%lf%c", mode, &eps, &c );
+  if( ( (n == 1) && (strlen(mode) == strlen(cmd)) ) || (n == 2) ) {
+    if( EqNoCase( mode, "DRG" ) || EqNoCase( mode, "DRGEP" ) ) {
+      if( (n == 2) && ( (eps <= 0) || (eps >= 1) ) ) {
+        ScanError("'%s': Bad threshold for #REDUCE, need 0 < eps < 1", cmd );
+        return;
+      }
+      if( n == 2 ) drgEps = eps;
+      useDrg = EqNoCase( mode, "DRG" ) ? DRG_ON : DRGEP_ON;
+      return;
+    }
+    /* QSSA, with an optional max. lifetime: QSSA:1e-3 */
+    if( EqNoCase( mode, "QSSA" ) ) {
+      if( (n == 2) && (eps <= 0) ) {
+        ScanError("'%s': Bad lifetime for #REDUCE QSSA, need tau > 0", cmd );
+        return;
+      }
+      if( n == 2 ) qssaTau = eps;
+      useQssa = 1;
+      return;
+    }
+  }
+  ScanError("'%s': Unknown parameter for #REDUCE [CONSERVED|DRG[:eps]|DRGEP[:eps]|QSSA[:tau]|OFF]", cmd );
+}
+
 void CmdDouble( char *cmd )
 {
   if( EqNoCase( cmd, "OFF" ) ) {
@@ -470,6 +567,7 @@ int i;
   SpeciesTable[ index ].lookat = 0;
   SpeciesTable[ index ].moni = 0;
   SpeciesTable[ index ].trans = 0;
+  SpeciesTable[ index ].target = 0;
   if( (SpeciesTable[ index ].nratoms == 0) || ( crtAtomNr > 0 ) ) {
     SpeciesTable[ index ].nratoms = crtAtomNr;
     for( i = 0; i < crtAtomNr; i++ )
@@ -794,6 +892,38 @@ int code;
   SpeciesTable[ code ].trans = 1;   
 }
 
+void AddTarget( char *spname )
+{
+int code;  
+  
+  code = FindSpecies( spname );
+  if ( code < 0 ) {
+    ScanError("Undefined species %s.", spname );
+    return;
+  }
+
+  SpeciesTable[ code ].target = 1;   
+}
+
+/* A value of the current #SAMPLE: a concentration (in the units of */
+/* #INITVALUES), TEMP, SUN or a name used in the rate expressions    */
+void AddSample( char *name, char *val )
+{
+  if( SampleNr >= MAX_SAMPLE ) {
+    ScanError("Too many #SAMPLE values (max %d)", MAX_SAMPLE );
+    return;
+  }
+  strncpy( SampleTable[ SampleNr ].name, name, MAX_SPNAME-1 );
+  SampleTable[ SampleNr ].val = atof( val );
+  SampleTable[ SampleNr ].set = SampleSetNr;
+  SampleNr++;
+}
+
+void EndSample()
+{
+  SampleSetNr++;
+}
+
 void TransportAll()
 {
 int i;
@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.5.1.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -34,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -41,14 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
-
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.5.1"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -101,7 +102,7 @@
   void yyerror(char *);
 
 
-#line 105 "y.tab.c"
+#line 106 "y.tab.c"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -124,14 +125,6 @@
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
-
 /* Use api.header.include to #include this header
    instead of duplicating it here.  */
 #ifndef YY_YY_Y_TAB_H_INCLUDED
@@ -144,85 +137,95 @@
 extern int yydebug;
 #endif
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    JACOBIAN = 258,
-    DOUBLE = 259,
-    FUNCTION = 260,
-    DEFVAR = 261,
-    DEFRAD = 262,
-    DEFFIX = 263,
-    SETVAR = 264,
-    SETRAD = 265,
-    SETFIX = 266,
-    HESSIAN = 267,
-    STOICMAT = 268,
-    STOCHASTIC = 269,
-    DECLARE = 270,
-    INITVALUES = 271,
-    EQUATIONS = 272,
-    LUMP = 273,
-    INIEQUAL = 274,
-    EQNEQUAL = 275,
-    EQNCOLON = 276,
-    LMPCOLON = 277,
-    LMPPLUS = 278,
-    SPCPLUS = 279,
-    SPCEQUAL = 280,
-    ATOMDECL = 281,
-    CHECK = 282,
-    CHECKALL = 283,
-    REORDER = 284,
-    MEX = 285,
-    DUMMYINDEX = 286,
-    EQNTAGS = 287,
-    LOOKAT = 288,
-    LOOKATALL = 289,
-    TRANSPORT = 290,
-    TRANSPORTALL = 291,
-    MONITOR = 292,
-    USES = 293,
-    SPARSEDATA = 294,
-    WRITE_ATM = 295,
-    WRITE_SPC = 296,
-    WRITE_MAT = 297,
-    WRITE_OPT = 298,
-    INITIALIZE = 299,
-    XGRID = 300,
-    YGRID = 301,
-    ZGRID = 302,
-    USE = 303,
-    LANGUAGE = 304,
-    INTFILE = 305,
-    DRIVER = 306,
-    RUN = 307,
-    INLINE = 308,
-    ENDINLINE = 309,
-    PARAMETER = 310,
-    SPCSPC = 311,
-    INISPC = 312,
-    INIVALUE = 313,
-    EQNSPC = 314,
-    EQNSIGN = 315,
-    EQNCOEF = 316,
-    RATE = 317,
-    LMPSPC = 318,
-    SPCNR = 319,
-    ATOMID = 320,
-    LKTID = 321,
-    MNIID = 322,
-    INLCTX = 323,
-    INCODE = 324,
-    SSPID = 325,
-    EQNLESS = 326,
-    EQNTAG = 327,
-    EQNGREATER = 328,
-    TPTID = 329,
-    USEID = 330
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    JACOBIAN = 258,                /* JACOBIAN  */
+    DOUBLE = 259,                  /* DOUBLE  */
+    FUNCTION = 260,                /* FUNCTION  */
+    DEFVAR = 261,                  /* DEFVAR  */
+    DEFRAD = 262,                  /* DEFRAD  */
+    DEFFIX = 263,                  /* DEFFIX  */
+    SETVAR = 264,                  /* SETVAR  */
+    SETRAD = 265,                  /* SETRAD  */
+    SETFIX = 266,                  /* SETFIX  */
+    HESSIAN = 267,                 /* HESSIAN  */
+    STOICMAT = 268,                /* STOICMAT  */
+    STOCHASTIC = 269,              /* STOCHASTIC  */
+    DECLARE = 270,                 /* DECLARE  */
+    INITVALUES = 271,              /* INITVALUES  */
+    EQUATIONS = 272,               /* EQUATIONS  */
+    LUMP = 273,                    /* LUMP  */
+    INIEQUAL = 274,                /* INIEQUAL  */
+    EQNEQUAL = 275,                /* EQNEQUAL  */
+    EQNCOLON = 276,                /* EQNCOLON  */
+    LMPCOLON = 277,                /* LMPCOLON  */
+    LMPPLUS = 278,                 /* LMPPLUS  */
+    SPCPLUS = 279,                 /* SPCPLUS  */
+    SPCEQUAL = 280,                /* SPCEQUAL  */
+    ATOMDECL = 281,                /* ATOMDECL  */
+    CHECK = 282,                   /* CHECK  */
+    CHECKALL = 283,                /* CHECKALL  */
+    REORDER = 284,                 /* REORDER  */
+    MEX = 285,                     /* MEX  */
+    DUMMYINDEX = 286,              /* DUMMYINDEX  */
+    EQNTAGS = 287,                 /* EQNTAGS  */
+    THREADSAFE = 288,              /* THREADSAFE  */
+    RATETABLE = 289,               /* RATETABLE  */
+    REDUCE = 290,                  /* REDUCE  */
+    SAMPLE = 291,                  /* SAMPLE  */
+    TARGETS = 292,                 /* TARGETS  */
+    LOOKAT = 293,                  /* LOOKAT  */
+    LOOKATALL = 294,               /* LOOKATALL  */
+    TRANSPORT = 295,               /* TRANSPORT  */
+    TRANSPORTALL = 296,            /* TRANSPORTALL  */
+    MONITOR = 297,                 /* MONITOR  */
+    USES = 298,                    /* USES  */
+    SPARSEDATA = 299,              /* SPARSEDATA  */
+    WRITE_ATM = 300,               /* WRITE_ATM  */
+    WRITE_SPC = 301,               /* WRITE_SPC  */
+    WRITE_MAT = 302,               /* WRITE_MAT  */
+    WRITE_OPT = 303,               /* WRITE_OPT  */
+    INITIALIZE = 304,              /* INITIALIZE  */
+    XGRID = 305,                   /* XGRID  */
+    YGRID = 306,                   /* YGRID  */
+    ZGRID = 307,                   /* ZGRID  */
+    USE = 308,                     /* USE  */
+    LANGUAGE = 309,                /* LANGUAGE  */
+    INTFILE = 310,                 /* INTFILE  */
+    DRIVER = 311,                  /* DRIVER  */
+    RUN = 312,                     /* RUN  */
+    INLINE = 313,                  /* INLINE  */
+    ENDINLINE = 314,               /* ENDINLINE  */
+    PARAMETER = 315,               /* PARAMETER  */
+    SPCSPC = 316,                  /* SPCSPC  */
+    INISPC = 317,                  /* INISPC  */
+    INIVALUE = 318,                /* INIVALUE  */
+    EQNSPC = 319,                  /* EQNSPC  */
+    EQNSIGN = 320,                 /* EQNSIGN  */
+    EQNCOEF = 321,                 /* EQNCOEF  */
+    RATE = 322,                    /* RATE  */
+    LMPSPC = 323,                  /* LMPSPC  */
+    SPCNR = 324,                   /* SPCNR  */
+    ATOMID = 325,                  /* ATOMID  */
+    LKTID = 326,                   /* LKTID  */
+    MNIID = 327,                   /* MNIID  */
+    INLCTX = 328,                  /* INLCTX  */
+    INCODE = 329,                  /* INCODE  */
+    SSPID = 330,                   /* SSPID  */
+    EQNLESS = 331,                 /* EQNLESS  */
+    EQNTAG = 332,                  /* EQNTAG  */
+    EQNGREATER = 333,              /* EQNGREATER  */
+    TPTID = 334,                   /* TPTID  */
+    USEID = 335                    /* USEID  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
 /* Value type.  */
@@ -233,7 +236,7 @@ union YYSTYPE
 
   char str[80];
 
-#line 237 "y.tab.c"
+#line 240 "y.tab.c"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -244,9 +247,135 @@ typedef union YYSTYPE YYSTYPE;
 
 extern YYSTYPE yylval;
 
+
 int yyparse (void);
 
+
 #endif /* !YY_YY_Y_TAB_H_INCLUDED  */
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_JACOBIAN = 3,                   /* JACOBIAN  */
+  YYSYMBOL_DOUBLE = 4,                     /* DOUBLE  */
+  YYSYMBOL_FUNCTION = 5,                   /* FUNCTION  */
+  YYSYMBOL_DEFVAR = 6,                     /* DEFVAR  */
+  YYSYMBOL_DEFRAD = 7,                     /* DEFRAD  */
+  YYSYMBOL_DEFFIX = 8,                     /* DEFFIX  */
+  YYSYMBOL_SETVAR = 9,                     /* SETVAR  */
+  YYSYMBOL_SETRAD = 10,                    /* SETRAD  */
+  YYSYMBOL_SETFIX = 11,                    /* SETFIX  */
+  YYSYMBOL_HESSIAN = 12,                   /* HESSIAN  */
+  YYSYMBOL_STOICMAT = 13,                  /* STOICMAT  */
+  YYSYMBOL_STOCHASTIC = 14,                /* STOCHASTIC  */
+  YYSYMBOL_DECLARE = 15,                   /* DECLARE  */
+  YYSYMBOL_INITVALUES = 16,                /* INITVALUES  */
+  YYSYMBOL_EQUATIONS = 17,                 /* EQUATIONS  */
+  YYSYMBOL_LUMP = 18,                      /* LUMP  */
+  YYSYMBOL_INIEQUAL = 19,                  /* INIEQUAL  */
+  YYSYMBOL_EQNEQUAL = 20,                  /* EQNEQUAL  */
+  YYSYMBOL_EQNCOLON = 21,                  /* EQNCOLON  */
+  YYSYMBOL_LMPCOLON = 22,                  /* LMPCOLON  */
+  YYSYMBOL_LMPPLUS = 23,                   /* LMPPLUS  */
+  YYSYMBOL_SPCPLUS = 24,                   /* SPCPLUS  */
+  YYSYMBOL_SPCEQUAL = 25,                  /* SPCEQUAL  */
+  YYSYMBOL_ATOMDECL = 26,                  /* ATOMDECL  */
+  YYSYMBOL_CHECK = 27,                     /* CHECK  */
+  YYSYMBOL_CHECKALL = 28,                  /* CHECKALL  */
+  YYSYMBOL_REORDER = 29,                   /* REORDER  */
+  YYSYMBOL_MEX = 30,                       /* MEX  */
+  YYSYMBOL_DUMMYINDEX = 31,                /* DUMMYINDEX  */
+  YYSYMBOL_EQNTAGS = 32,                   /* EQNTAGS  */
+  YYSYMBOL_THREADSAFE = 33,                /* THREADSAFE  */
+  YYSYMBOL_RATETABLE = 34,                 /* RATETABLE  */
+  YYSYMBOL_REDUCE = 35,                    /* REDUCE  */
+  YYSYMBOL_SAMPLE = 36,                    /* SAMPLE  */
+  YYSYMBOL_TARGETS = 37,                   /* TARGETS  */
+  YYSYMBOL_LOOKAT = 38,                    /* LOOKAT  */
+  YYSYMBOL_LOOKATALL = 39,                 /* LOOKATALL  */
+  YYSYMBOL_TRANSPORT = 40,                 /* TRANSPORT  */
+  YYSYMBOL_TRANSPORTALL = 41,              /* TRANSPORTALL  */
+  YYSYMBOL_MONITOR = 42,                   /* MONITOR  */
+  YYSYMBOL_USES = 43,                      /* USES  */
+  YYSYMBOL_SPARSEDATA = 44,                /* SPARSEDATA  */
+  YYSYMBOL_WRITE_ATM = 45,                 /* WRITE_ATM  */
+  YYSYMBOL_WRITE_SPC = 46,                 /* WRITE_SPC  */
+  YYSYMBOL_WRITE_MAT = 47,                 /* WRITE_MAT  */
+  YYSYMBOL_WRITE_OPT = 48,                 /* WRITE_OPT  */
+  YYSYMBOL_INITIALIZE = 49,                /* INITIALIZE  */
+  YYSYMBOL_XGRID = 50,                     /* XGRID  */
+  YYSYMBOL_YGRID = 51,                     /* YGRID  */
+  YYSYMBOL_ZGRID = 52,                     /* ZGRID  */
+  YYSYMBOL_USE = 53,                       /* USE  */
+  YYSYMBOL_LANGUAGE = 54,                  /* LANGUAGE  */
+  YYSYMBOL_INTFILE = 55,                   /* INTFILE  */
+  YYSYMBOL_DRIVER = 56,                    /* DRIVER  */
+  YYSYMBOL_RUN = 57,                       /* RUN  */
+  YYSYMBOL_INLINE = 58,                    /* INLINE  */
+  YYSYMBOL_ENDINLINE = 59,                 /* ENDINLINE  */
+  YYSYMBOL_PARAMETER = 60,                 /* PARAMETER  */
+  YYSYMBOL_SPCSPC = 61,                    /* SPCSPC  */
+  YYSYMBOL_INISPC = 62,                    /* INISPC  */
+  YYSYMBOL_INIVALUE = 63,                  /* INIVALUE  */
+  YYSYMBOL_EQNSPC = 64,                    /* EQNSPC  */
+  YYSYMBOL_EQNSIGN = 65,                   /* EQNSIGN  */
+  YYSYMBOL_EQNCOEF = 66,                   /* EQNCOEF  */
+  YYSYMBOL_RATE = 67,                      /* RATE  */
+  YYSYMBOL_LMPSPC = 68,                    /* LMPSPC  */
+  YYSYMBOL_SPCNR = 69,                     /* SPCNR  */
+  YYSYMBOL_ATOMID = 70,                    /* ATOMID  */
+  YYSYMBOL_LKTID = 71,                     /* LKTID  */
+  YYSYMBOL_MNIID = 72,                     /* MNIID  */
+  YYSYMBOL_INLCTX = 73,                    /* INLCTX  */
+  YYSYMBOL_INCODE = 74,                    /* INCODE  */
+  YYSYMBOL_SSPID = 75,                     /* SSPID  */
+  YYSYMBOL_EQNLESS = 76,                   /* EQNLESS  */
+  YYSYMBOL_EQNTAG = 77,                    /* EQNTAG  */
+  YYSYMBOL_EQNGREATER = 78,                /* EQNGREATER  */
+  YYSYMBOL_TPTID = 79,                     /* TPTID  */
+  YYSYMBOL_USEID = 80,                     /* USEID  */
+  YYSYMBOL_81_ = 81,                       /* ';'  */
+  YYSYMBOL_YYACCEPT = 82,                  /* $accept  */
+  YYSYMBOL_program = 83,                   /* program  */
+  YYSYMBOL_section = 84,                   /* section  */
+  YYSYMBOL_semicolon = 85,                 /* semicolon  */
+  YYSYMBOL_atomlist = 86,                  /* atomlist  */
+  YYSYMBOL_atomdef = 87,                   /* atomdef  */
+  YYSYMBOL_lookatlist = 88,                /* lookatlist  */
+  YYSYMBOL_lookatspc = 89,                 /* lookatspc  */
+  YYSYMBOL_monitorlist = 90,               /* monitorlist  */
+  YYSYMBOL_monitorspc = 91,                /* monitorspc  */
+  YYSYMBOL_translist = 92,                 /* translist  */
+  YYSYMBOL_transspc = 93,                  /* transspc  */
+  YYSYMBOL_uselist = 94,                   /* uselist  */
+  YYSYMBOL_usefile = 95,                   /* usefile  */
+  YYSYMBOL_setspclist = 96,                /* setspclist  */
+  YYSYMBOL_setspcspc = 97,                 /* setspcspc  */
+  YYSYMBOL_species = 98,                   /* species  */
+  YYSYMBOL_spc = 99,                       /* spc  */
+  YYSYMBOL_spcname = 100,                  /* spcname  */
+  YYSYMBOL_spcdef = 101,                   /* spcdef  */
+  YYSYMBOL_atoms = 102,                    /* atoms  */
+  YYSYMBOL_atom = 103,                     /* atom  */
+  YYSYMBOL_initvalues = 104,               /* initvalues  */
+  YYSYMBOL_assignment = 105,               /* assignment  */
+  YYSYMBOL_equations = 106,                /* equations  */
+  YYSYMBOL_equation = 107,                 /* equation  */
+  YYSYMBOL_rate = 108,                     /* rate  */
+  YYSYMBOL_eqntag = 109,                   /* eqntag  */
+  YYSYMBOL_lefths = 110,                   /* lefths  */
+  YYSYMBOL_righths = 111,                  /* righths  */
+  YYSYMBOL_expresion = 112,                /* expresion  */
+  YYSYMBOL_term = 113,                     /* term  */
+  YYSYMBOL_lumps = 114,                    /* lumps  */
+  YYSYMBOL_lump = 115,                     /* lump  */
+  YYSYMBOL_inlinecode = 116                /* inlinecode  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
 
 
 
@@ -287,6 +416,18 @@ typedef int_least16_t yytype_int16;
 typedef short yytype_int16;
 #endif
 
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
 #if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
 typedef __UINT_LEAST8_TYPE__ yytype_uint8;
 #elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
@@ -346,6 +487,7 @@ typedef int yytype_uint16;
 
 #define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
 
+
 /* Stored state numbers (used for stacks). */
 typedef yytype_uint8 yy_state_t;
 
@@ -364,6 +506,7 @@ typedef int yy_state_fast_t;
 # endif
 #endif
 
+
 #ifndef YY_ATTRIBUTE_PURE
 # if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
 #  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
@@ -382,17 +525,23 @@ typedef int yy_state_fast_t;
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && ! defined __ICC && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                            \
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
     _Pragma ("GCC diagnostic push")                                     \
     _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
 # define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
@@ -421,7 +570,7 @@ typedef int yy_state_fast_t;
 
 #define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -486,8 +635,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -550,27 +698,29 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  124
+#define YYFINAL  134
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   192
+#define YYLAST   207
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  77
+#define YYNTOKENS  82
 /* YYNNTS -- Number of nonterminals.  */
 #define YYNNTS  35
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  111
+#define YYNRULES  116
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  202
+#define YYNSTATES  212
 
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   330
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   335
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex, with out-of-bounds checking.  */
-#define YYTRANSLATE(YYX)                                                \
-  (0 <= (YYX) && (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex.  */
@@ -581,7 +731,7 @@ static const yytype_int8 yytranslate[] =
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,    76,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,    81,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -609,39 +759,47 @@ static const yytype_int8 yytranslate[] =
       45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
       55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
       65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
-      75
+      75,    76,    77,    78,    79,    80
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
        0,    96,    96,    97,    99,   102,   105,   108,   111,   114,
-     117,   120,   123,   126,   129,   132,   134,   136,   138,   140,
-     142,   144,   146,   148,   150,   152,   154,   156,   158,   160,
-     162,   164,   166,   168,   170,   172,   174,   176,   178,   180,
-     182,   184,   186,   191,   193,   195,   197,   199,   201,   205,
-     208,   210,   211,   212,   215,   222,   223,   224,   227,   231,
-     232,   233,   236,   240,   241,   242,   245,   249,   250,   251,
-     254,   258,   259,   260,   263,   271,   272,   273,   276,   277,
-     279,   287,   295,   296,   298,   301,   305,   306,   307,   310,
-     313,   314,   315,   320,   325,   330,   334,   338,   342,   345,
-     348,   351,   354,   358,   362,   367,   368,   369,   372,   375,
-     380,   384
+     117,   120,   123,   126,   129,   132,   135,   138,   141,   143,
+     145,   147,   149,   151,   153,   155,   157,   159,   161,   163,
+     165,   167,   169,   171,   173,   175,   177,   179,   181,   183,
+     185,   187,   189,   191,   193,   195,   197,   199,   204,   206,
+     208,   210,   212,   214,   218,   221,   223,   224,   225,   228,
+     235,   236,   237,   240,   244,   245,   246,   249,   256,   257,
+     258,   261,   265,   266,   267,   270,   274,   275,   276,   279,
+     287,   288,   289,   292,   293,   295,   303,   311,   312,   314,
+     317,   321,   322,   323,   326,   333,   334,   335,   340,   345,
+     350,   354,   358,   362,   365,   368,   371,   374,   378,   382,
+     387,   388,   389,   392,   395,   400,   404
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 0
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "JACOBIAN", "DOUBLE", "FUNCTION",
-  "DEFVAR", "DEFRAD", "DEFFIX", "SETVAR", "SETRAD", "SETFIX", "HESSIAN",
-  "STOICMAT", "STOCHASTIC", "DECLARE", "INITVALUES", "EQUATIONS", "LUMP",
-  "INIEQUAL", "EQNEQUAL", "EQNCOLON", "LMPCOLON", "LMPPLUS", "SPCPLUS",
-  "SPCEQUAL", "ATOMDECL", "CHECK", "CHECKALL", "REORDER", "MEX",
-  "DUMMYINDEX", "EQNTAGS", "LOOKAT", "LOOKATALL", "TRANSPORT",
+  "\"end of file\"", "error", "\"invalid token\"", "JACOBIAN", "DOUBLE",
+  "FUNCTION", "DEFVAR", "DEFRAD", "DEFFIX", "SETVAR", "SETRAD", "SETFIX",
+  "HESSIAN", "STOICMAT", "STOCHASTIC", "DECLARE", "INITVALUES",
+  "EQUATIONS", "LUMP", "INIEQUAL", "EQNEQUAL", "EQNCOLON", "LMPCOLON",
+  "LMPPLUS", "SPCPLUS", "SPCEQUAL", "ATOMDECL", "CHECK", "CHECKALL",
+  "REORDER", "MEX", "DUMMYINDEX", "EQNTAGS", "THREADSAFE", "RATETABLE",
+  "REDUCE", "SAMPLE", "TARGETS", "LOOKAT", "LOOKATALL", "TRANSPORT",
   "TRANSPORTALL", "MONITOR", "USES", "SPARSEDATA", "WRITE_ATM",
   "WRITE_SPC", "WRITE_MAT", "WRITE_OPT", "INITIALIZE", "XGRID", "YGRID",
   "ZGRID", "USE", "LANGUAGE", "INTFILE", "DRIVER", "RUN", "INLINE",
@@ -656,25 +814,15 @@ static const char *const yytname[] =
   "rate", "eqntag", "lefths", "righths", "expresion", "term", "lumps",
   "lump", "inlinecode", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_int16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,   297,   298,   299,   300,   301,   302,   303,   304,
-     305,   306,   307,   308,   309,   310,   311,   312,   313,   314,
-     315,   316,   317,   318,   319,   320,   321,   322,   323,   324,
-     325,   326,   327,   328,   329,   330,    59
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF (-91)
+#define YYPACT_NINF (-95)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
@@ -684,200 +832,206 @@ static const yytype_int16 yytoknum[] =
 #define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-     112,    -6,    -3,     4,    11,    11,    11,     3,     3,     3,
-      30,    33,    39,    40,     8,     1,    21,     9,     9,   -91,
-      41,    42,    43,    45,     5,   -91,     6,   -91,    15,     0,
-      46,   -91,   -91,   -91,   -91,    48,    49,    51,    52,    54,
-      55,    57,    58,    76,    10,    63,   112,   -91,   -91,   -91,
-      56,   108,    14,    56,   -91,   -91,    14,    14,    56,   -91,
-      64,    56,    64,    64,   -91,   -91,   -91,   -91,    56,   116,
-      79,    56,    56,   -91,   -38,    78,    94,   -33,    56,   -20,
-     -20,    -7,   -91,    56,    34,   104,    56,    56,   -91,   103,
-      56,   103,   -91,   -91,   -91,   -91,    56,   -91,   105,    56,
-      56,   -91,    95,    56,    56,   -91,   106,    56,    56,   -91,
-      97,    56,   -91,   -91,   -91,   -91,   -91,   -91,   -91,   -91,
-     -91,   -91,   -91,   101,   -91,   -91,   -91,    98,   -32,    56,
-      98,    98,    56,    98,    98,   117,    56,    98,    98,   -91,
-     -91,   107,    56,    98,   -20,   114,    27,   -91,   -38,    98,
-     115,   104,    56,    98,    98,    56,    98,    98,    56,    98,
-      98,    56,    98,    98,    56,    98,    98,    56,    98,   -91,
-     -40,   -91,   -91,   121,   155,   -91,    98,    98,   -91,    98,
-     -91,    98,   114,   114,   -91,   -91,   -91,   -91,   -91,    98,
-      98,    98,    98,    98,    98,   -91,   -91,   -91,   -32,   -91,
-     -91,   -91
+     117,   -29,   -22,    -7,    11,    11,    11,     3,     3,     3,
+      -4,    30,    40,    41,     8,     1,    21,     9,     9,   -95,
+      42,    43,    45,    48,    49,    51,    52,     8,    15,     5,
+     -95,     6,   -95,    15,     0,    54,   -95,   -95,   -95,   -95,
+      55,    57,    58,    76,    77,    78,    79,    80,    81,    10,
+      61,   117,   -95,   -95,   -95,   -10,    16,    14,   -10,   -95,
+     -95,    14,    14,   -10,   -95,    67,   -10,    67,    67,   -95,
+     -95,   -95,   -95,   -10,   157,    44,   -10,   -10,   -95,   -40,
+     113,   101,   -37,   -10,    31,    31,    -6,   -95,   -10,    46,
+     111,   -10,   -10,   -95,   110,   -10,   110,   -95,   -95,   -95,
+     -95,   -95,   -95,   -95,    44,   -10,   -95,   109,   -10,   -10,
+     -95,   112,   -10,   -10,   -95,   103,   -10,   109,   -10,   -95,
+     104,   -10,   -95,   -95,   -95,   -95,   -95,   -95,   -95,   -95,
+     -95,   -95,   -95,   114,   -95,   -95,   -95,   105,   -26,   -10,
+     105,   105,   -10,   105,   105,   122,   -10,   105,   105,   -95,
+     -95,   115,   -10,   105,    31,   120,    -8,   -95,   -40,   105,
+     121,   111,   -10,   105,   105,   -10,   105,   105,   -10,   105,
+     105,   -10,   105,   105,   -10,   105,   105,   -10,   105,   -95,
+     -38,   -95,   -95,   129,   167,   -95,   105,   105,   -95,   105,
+     -95,   105,   120,   120,   -95,   -95,   -95,   -95,   -95,   105,
+     105,   105,   105,   105,   105,   -95,   -95,   -95,   -26,   -95,
+     -95,   -95
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
 static const yytype_int8 yydefact[] =
 {
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,    29,
-       0,     0,     0,     0,     0,    30,     0,    31,     0,     0,
-       0,    32,    33,    34,    35,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     2,     4,     8,    13,
-       0,    81,    17,     0,    78,    79,    18,    19,     0,    74,
-      20,     0,    21,    22,     5,     7,    14,     6,     0,     0,
-      23,     0,     0,   104,     0,     0,     0,    24,     0,     0,
-       0,     0,   102,     0,     0,    25,     0,     0,    54,    15,
-       0,    16,     9,    10,    11,    12,     0,    58,    26,     0,
-       0,    66,    28,     0,     0,    62,    27,     0,     0,    70,
-      47,     0,    48,    38,    39,    40,    41,    36,    37,    44,
-      45,    46,    43,     0,     1,     3,    50,    77,     0,     0,
-      76,    73,     0,    72,    88,     0,     0,    87,    92,   101,
-     103,     0,     0,    91,     0,     0,     0,    98,     0,   107,
-       0,     0,     0,   106,    53,     0,    52,    57,     0,    56,
-      65,     0,    64,    61,     0,    60,    69,     0,    68,   111,
-       0,    49,    85,     0,    80,    83,    75,    71,    89,    86,
-      97,    90,     0,    96,    94,    99,   100,   109,   108,   105,
-      51,    55,    63,    59,    67,    42,   110,    84,     0,    93,
-      95,    82
+       0,     0,     0,     0,     0,     0,     0,     0,     0,    34,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+      35,     0,    36,     0,     0,     0,    37,    38,    39,    40,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     2,     4,     8,    16,     0,    86,    20,     0,    83,
+      84,    21,    22,     0,    79,    23,     0,    24,    25,     5,
+       7,    17,     6,     0,     0,    26,     0,     0,   109,     0,
+       0,     0,    28,     0,     0,     0,     0,   107,     0,     0,
+      29,     0,     0,    59,    18,     0,    19,     9,    10,    14,
+      15,    11,    12,    13,    27,     0,    67,    32,     0,     0,
+      63,    30,     0,     0,    71,    33,     0,    31,     0,    75,
+      52,     0,    53,    43,    44,    45,    46,    41,    42,    49,
+      50,    51,    48,     0,     1,     3,    55,    82,     0,     0,
+      81,    78,     0,    77,    93,     0,     0,    92,    97,   106,
+     108,     0,     0,    96,     0,     0,     0,   103,     0,   112,
+       0,     0,     0,   111,    58,     0,    57,    66,     0,    65,
+      62,     0,    61,    70,     0,    69,    74,     0,    73,   116,
+       0,    54,    90,     0,    85,    88,    80,    76,    94,    91,
+     102,    95,     0,   101,    99,   104,   105,   114,   113,   110,
+      56,    64,    60,    68,    72,    47,   115,    89,     0,    98,
+     100,    87
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-     -91,   135,   -91,   -53,   164,   -25,   -91,    86,   -91,    77,
-     -91,    83,   -91,    80,    60,   -18,    85,   -21,   -91,   -91,
-     -91,   -12,   -91,   118,   -91,   110,   -90,   -91,   113,    47,
-     -63,   -71,   -91,   -65,   -91
+     -95,   141,   -95,   -58,   176,   -32,   -95,    84,   163,   -75,
+     -95,    82,   -95,    83,    65,   -19,    87,   -17,   -95,   -95,
+     -95,    -9,   171,   -52,   -95,   118,   -94,   -95,   123,    47,
+     -68,   -76,   -95,   -70,   -95
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int16 yydefgoto[] =
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
 {
-      -1,    45,    46,   127,    89,    90,    98,    99,   106,   107,
-     102,   103,   110,   111,    60,    61,    52,    53,    54,    55,
-     174,   175,    70,    71,    77,    78,   184,    79,    80,   145,
-      81,    82,    85,    86,   170
+       0,    50,    51,   137,    94,    95,   111,   112,   107,   108,
+     115,   116,   120,   121,    65,    66,    57,    58,    59,    60,
+     184,   185,    75,    76,    82,    83,   194,    84,    85,   155,
+      86,    87,    90,    91,   180
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_uint8 yytable[] =
 {
-     130,   108,    72,   139,    58,   131,    96,   100,   133,    68,
-      87,   122,    50,   147,   195,   134,   104,   146,   137,   138,
-     152,    73,    83,    75,   172,   143,    73,    74,    75,   196,
-     149,   129,   173,   153,   154,   129,   129,   156,    76,    73,
-      74,    75,   132,   157,   132,   132,   159,   160,   185,    47,
-     162,   163,    48,   148,   165,   166,   150,   151,   168,    49,
-      73,    74,    75,   124,   155,    69,   155,    51,    62,    63,
-      51,    97,    76,    59,    88,   109,   176,   186,   123,   177,
-     101,   146,   105,   179,    84,    64,   188,   148,    65,   181,
-      56,    57,   199,   200,    66,    67,    92,    93,    94,   189,
-      95,   112,   190,   113,   114,   191,   115,   116,   192,   117,
-     118,   193,   119,   120,   194,     1,     2,     3,     4,     5,
-       6,     7,     8,     9,    10,    11,    12,    13,    14,    15,
-      16,   121,   126,   128,    59,   135,    69,   140,    17,    18,
-      19,    20,    21,    22,    23,    24,    25,    26,    27,    28,
-      29,    30,    31,    32,    33,    34,    35,    36,    37,    38,
-      39,    40,    41,    42,    43,    44,   141,    84,    88,   101,
-     169,    97,   109,   105,   171,   178,   183,   197,   187,   198,
-     180,   125,    91,   164,   158,   161,   201,   142,   136,     0,
-     167,   182,   144
+     140,   118,    77,   149,    63,   141,   109,   113,   143,    73,
+      92,   132,    55,   195,   157,   144,   105,   156,   147,   148,
+     162,   205,    88,   146,    78,   153,    80,    78,    79,    80,
+     159,    52,   168,   163,   164,   182,   206,   166,    53,    81,
+     139,   138,   168,   183,   139,   139,   142,   167,   142,   142,
+     169,   170,   146,    54,   172,   173,    69,   158,   175,   158,
+     176,   134,   165,   178,   165,    78,    79,    80,   160,   161,
+      74,   136,    56,    67,    68,    56,   110,    81,    64,    93,
+     119,   186,   196,   133,   187,   114,   156,   106,   189,    89,
+      70,   198,    61,    62,   191,    78,    79,    80,   209,   210,
+      71,    72,    97,    98,   199,    99,    74,   200,   100,   101,
+     201,   102,   103,   202,   122,   123,   203,   124,   125,   204,
+       1,     2,     3,     4,     5,     6,     7,     8,     9,    10,
+      11,    12,    13,    14,    15,    16,   126,   127,   128,   129,
+     130,   131,    64,    17,    18,    19,    20,    21,    22,    23,
+      24,    25,    26,    27,    28,    29,    30,    31,    32,    33,
+      34,    35,    36,    37,    38,    39,    40,    41,    42,    43,
+      44,    45,    46,    47,    48,    49,   145,   150,   151,    89,
+      93,   106,   114,   110,   119,   188,   181,   193,   179,   197,
+     207,   208,   135,   190,    96,   171,   117,   174,   104,   211,
+     152,   192,     0,   177,     0,     0,     0,   154
 };
 
 static const yytype_int16 yycheck[] =
 {
-      53,     1,     1,    74,     1,    58,     1,     1,    61,     1,
-       1,     1,     1,    20,    54,    68,     1,    80,    71,    72,
-      85,    59,     1,    61,    56,    78,    59,    60,    61,    69,
-      83,    52,    64,    86,    87,    56,    57,    90,    71,    59,
-      60,    61,    60,    96,    62,    63,    99,   100,    21,    55,
-     103,   104,    55,    60,   107,   108,    22,    23,   111,    55,
-      59,    60,    61,     0,    89,    57,    91,    56,     8,     9,
-      56,    66,    71,    70,    65,    75,   129,   148,    68,   132,
-      74,   144,    67,   136,    63,    55,   151,    60,    55,   142,
-       5,     6,   182,   183,    55,    55,    55,    55,    55,   152,
-      55,    55,   155,    55,    55,   158,    55,    55,   161,    55,
-      55,   164,    55,    55,   167,     3,     4,     5,     6,     7,
-       8,     9,    10,    11,    12,    13,    14,    15,    16,    17,
-      18,    55,    76,    25,    70,    19,    57,    59,    26,    27,
-      28,    29,    30,    31,    32,    33,    34,    35,    36,    37,
-      38,    39,    40,    41,    42,    43,    44,    45,    46,    47,
-      48,    49,    50,    51,    52,    53,    72,    63,    65,    74,
-      69,    66,    75,    67,    76,    58,    62,    56,    63,    24,
-      73,    46,    18,   106,    98,   102,   198,    77,    70,    -1,
-     110,   144,    79
+      58,     1,     1,    79,     1,    63,     1,     1,    66,     1,
+       1,     1,     1,    21,    20,    73,     1,    85,    76,    77,
+      90,    59,     1,    75,    64,    83,    66,    64,    65,    66,
+      88,    60,   107,    91,    92,    61,    74,    95,    60,    76,
+      57,    25,   117,    69,    61,    62,    65,   105,    67,    68,
+     108,   109,   104,    60,   112,   113,    60,    65,   116,    65,
+     118,     0,    94,   121,    96,    64,    65,    66,    22,    23,
+      62,    81,    61,     8,     9,    61,    71,    76,    75,    70,
+      80,   139,   158,    73,   142,    79,   154,    72,   146,    68,
+      60,   161,     5,     6,   152,    64,    65,    66,   192,   193,
+      60,    60,    60,    60,   162,    60,    62,   165,    60,    60,
+     168,    60,    60,   171,    60,    60,   174,    60,    60,   177,
+       3,     4,     5,     6,     7,     8,     9,    10,    11,    12,
+      13,    14,    15,    16,    17,    18,    60,    60,    60,    60,
+      60,    60,    75,    26,    27,    28,    29,    30,    31,    32,
+      33,    34,    35,    36,    37,    38,    39,    40,    41,    42,
+      43,    44,    45,    46,    47,    48,    49,    50,    51,    52,
+      53,    54,    55,    56,    57,    58,    19,    64,    77,    68,
+      70,    72,    79,    71,    80,    63,    81,    67,    74,    68,
+      61,    24,    51,    78,    18,   111,    33,   115,    27,   208,
+      82,   154,    -1,   120,    -1,    -1,    -1,    84
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
        0,     3,     4,     5,     6,     7,     8,     9,    10,    11,
       12,    13,    14,    15,    16,    17,    18,    26,    27,    28,
       29,    30,    31,    32,    33,    34,    35,    36,    37,    38,
       39,    40,    41,    42,    43,    44,    45,    46,    47,    48,
-      49,    50,    51,    52,    53,    78,    79,    55,    55,    55,
-       1,    56,    93,    94,    95,    96,    93,    93,     1,    70,
-      91,    92,    91,    91,    55,    55,    55,    55,     1,    57,
-      99,   100,     1,    59,    60,    61,    71,   101,   102,   104,
-     105,   107,   108,     1,    63,   109,   110,     1,    65,    81,
-      82,    81,    55,    55,    55,    55,     1,    66,    83,    84,
-       1,    74,    87,    88,     1,    67,    85,    86,     1,    75,
-      89,    90,    55,    55,    55,    55,    55,    55,    55,    55,
-      55,    55,     1,    68,     0,    78,    76,    80,    25,    94,
-      80,    80,    92,    80,    80,    19,   100,    80,    80,   108,
-      59,    72,   102,    80,   105,   106,   107,    20,    60,    80,
-      22,    23,   110,    80,    80,    82,    80,    80,    84,    80,
-      80,    88,    80,    80,    86,    80,    80,    90,    80,    69,
-     111,    76,    56,    64,    97,    98,    80,    80,    58,    80,
-      73,    80,   106,    62,   103,    21,   108,    63,   110,    80,
-      80,    80,    80,    80,    80,    54,    69,    56,    24,   103,
-     103,    98
+      49,    50,    51,    52,    53,    54,    55,    56,    57,    58,
+      83,    84,    60,    60,    60,     1,    61,    98,    99,   100,
+     101,    98,    98,     1,    75,    96,    97,    96,    96,    60,
+      60,    60,    60,     1,    62,   104,   105,     1,    64,    65,
+      66,    76,   106,   107,   109,   110,   112,   113,     1,    68,
+     114,   115,     1,    70,    86,    87,    86,    60,    60,    60,
+      60,    60,    60,    60,   104,     1,    72,    90,    91,     1,
+      71,    88,    89,     1,    79,    92,    93,    90,     1,    80,
+      94,    95,    60,    60,    60,    60,    60,    60,    60,    60,
+      60,    60,     1,    73,     0,    83,    81,    85,    25,    99,
+      85,    85,    97,    85,    85,    19,   105,    85,    85,   113,
+      64,    77,   107,    85,   110,   111,   112,    20,    65,    85,
+      22,    23,   115,    85,    85,    87,    85,    85,    91,    85,
+      85,    89,    85,    85,    93,    85,    85,    95,    85,    74,
+     116,    81,    61,    69,   102,   103,    85,    85,    63,    85,
+      78,    85,   111,    67,   108,    21,   113,    68,   115,    85,
+      85,    85,    85,    85,    85,    59,    74,    61,    24,   108,
+     108,   103
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
-       0,    77,    78,    78,    79,    79,    79,    79,    79,    79,
-      79,    79,    79,    79,    79,    79,    79,    79,    79,    79,
-      79,    79,    79,    79,    79,    79,    79,    79,    79,    79,
-      79,    79,    79,    79,    79,    79,    79,    79,    79,    79,
-      79,    79,    79,    79,    79,    79,    79,    79,    79,    80,
-      80,    81,    81,    81,    82,    83,    83,    83,    84,    85,
-      85,    85,    86,    87,    87,    87,    88,    89,    89,    89,
-      90,    91,    91,    91,    92,    93,    93,    93,    94,    94,
-      95,    96,    97,    97,    98,    98,    99,    99,    99,   100,
-     101,   101,   101,   102,   102,   103,   103,   104,   105,   106,
-     107,   107,   107,   108,   108,   109,   109,   109,   110,   110,
-     111,   111
+       0,    82,    83,    83,    84,    84,    84,    84,    84,    84,
+      84,    84,    84,    84,    84,    84,    84,    84,    84,    84,
+      84,    84,    84,    84,    84,    84,    84,    84,    84,    84,
+      84,    84,    84,    84,    84,    84,    84,    84,    84,    84,
+      84,    84,    84,    84,    84,    84,    84,    84,    84,    84,
+      84,    84,    84,    84,    85,    85,    86,    86,    86,    87,
+      88,    88,    88,    89,    90,    90,    90,    91,    92,    92,
+      92,    93,    94,    94,    94,    95,    96,    96,    96,    97,
+      98,    98,    98,    99,    99,   100,   101,   102,   102,   103,
+     103,   104,   104,   104,   105,   106,   106,   106,   107,   107,
+     108,   108,   109,   110,   111,   112,   112,   112,   113,   113,
+     114,   114,   114,   115,   115,   116,   116
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     1,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     1,
-       1,     1,     1,     1,     1,     1,     2,     2,     2,     2,
-       2,     2,     4,     2,     2,     2,     2,     2,     2,     2,
-       1,     3,     2,     2,     1,     3,     2,     2,     1,     3,
-       2,     2,     1,     3,     2,     2,     1,     3,     2,     2,
-       1,     3,     2,     2,     1,     3,     2,     2,     1,     1,
-       3,     1,     3,     1,     2,     1,     3,     2,     2,     3,
-       3,     2,     2,     4,     3,     2,     1,     3,     2,     2,
-       3,     2,     1,     2,     1,     3,     2,     2,     3,     3,
-       2,     1
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     1,     1,     1,     1,     1,     1,
+       1,     2,     2,     2,     2,     2,     2,     4,     2,     2,
+       2,     2,     2,     2,     2,     1,     3,     2,     2,     1,
+       3,     2,     2,     1,     3,     2,     2,     1,     3,     2,
+       2,     1,     3,     2,     2,     1,     3,     2,     2,     1,
+       3,     2,     2,     1,     1,     3,     1,     3,     1,     2,
+       1,     3,     2,     2,     3,     3,     2,     2,     4,     3,
+       2,     1,     3,     2,     2,     3,     2,     1,     2,     1,
+       3,     2,     2,     3,     3,     2,     1
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
@@ -899,10 +1053,9 @@ static const yytype_int8 yyr2[] =
       }                                                           \
   while (0)
 
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 
 /* Enable debugging if requested.  */
@@ -919,19 +1072,16 @@ do {                                            \
     YYFPRINTF Args;                             \
 } while (0)
 
-/* This macro is provided for backward compatibility. */
-#ifndef YY_LOCATION_PRINT
-# define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-#endif
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value); \
+                  Kind, Value); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -942,18 +1092,15 @@ do {                                                                      \
 `-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
   FILE *yyoutput = yyo;
-  YYUSE (yyoutput);
+  YY_USE (yyoutput);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyo, yytoknum[yytype], *yyvaluep);
-# endif
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -963,12 +1110,13 @@ yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep)
 `---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
   YYFPRINTF (yyo, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyo, yytype, yyvaluep);
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
   YYFPRINTF (yyo, ")");
 }
 
@@ -1001,7 +1149,8 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, int yyrule)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -1013,9 +1162,8 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, int yyrule)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[+yyssp[yyi + 1 - yynrhs]],
-                       &yyvsp[(yyi + 1) - (yynrhs)]
-                                              );
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -1030,8 +1178,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -1054,259 +1202,30 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
-
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
-#  else
-/* Return the length of YYSTR.  */
-static YYPTRDIFF_T
-yystrlen (const char *yystr)
-{
-  YYPTRDIFF_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
-
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
-
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYPTRDIFF_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYPTRDIFF_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-        switch (*++yyp)
-          {
-          case '\'':
-          case ',':
-            goto do_not_strip_quotes;
-
-          case '\\':
-            if (*++yyp != '\\')
-              goto do_not_strip_quotes;
-            else
-              goto append;
-
-          append:
-          default:
-            if (yyres)
-              yyres[yyn] = *yyp;
-            yyn++;
-            break;
-
-          case '"':
-            if (yyres)
-              yyres[yyn] = '\0';
-            return yyn;
-          }
-    do_not_strip_quotes: ;
-    }
-
-  if (yyres)
-    return yystpcpy (yyres, yystr) - yyres;
-  else
-    return yystrlen (yystr);
-}
-# endif
-
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
-
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int
-yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
-                yy_state_t *yyssp, int yytoken)
-{
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat: reported tokens (one for the "unexpected",
-     one per "expected"). */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Actual size of YYARG. */
-  int yycount = 0;
-  /* Cumulated lengths of YYARG.  */
-  YYPTRDIFF_T yysize = 0;
-
-  /* There are many possibilities here to consider:
-     - If this state is a consistent state with a default action, then
-       the only way this function was invoked is if the default action
-       is an error action.  In that case, don't check for expected
-       tokens because there are none.
-     - The only way there can be no lookahead present (in yychar) is if
-       this state is a consistent state with a default action.  Thus,
-       detecting the absence of a lookahead is sufficient to determine
-       that there is no unexpected or expected token to report.  In that
-       case, just report a simple "syntax error".
-     - Don't assume there isn't a lookahead just because this state is a
-       consistent state with a default action.  There might have been a
-       previous inconsistent state, consistent state with a non-default
-       action, or user semantic action that manipulated yychar.
-     - Of course, the expected token list depends on states to have
-       correct lookahead information, and it depends on the parser not
-       to perform extra reductions after fetching a lookahead from the
-       scanner and before detecting a syntax error.  Thus, state merging
-       (from LALR or IELR) and default reductions corrupt the expected
-       token list.  However, the list is correct for canonical LR with
-       one exception: it will still contain any token that will not be
-       accepted due to an error action in a later state.
-  */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[+*yyssp];
-      YYPTRDIFF_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-      yysize = yysize0;
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYPTRDIFF_T yysize1
-                    = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-                    yysize = yysize1;
-                  else
-                    return 2;
-                }
-              }
-        }
-    }
-
-  switch (yycount)
-    {
-# define YYCASE_(N, S)                      \
-      case N:                               \
-        yyformat = S;                       \
-      break
-    default: /* Avoid compiler warnings. */
-      YYCASE_(0, YY_("syntax error"));
-      YYCASE_(1, YY_("syntax error, unexpected %s"));
-      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
 
-  {
-    /* Don't count the "%s"s in the final size, but reserve room for
-       the terminator.  */
-    YYPTRDIFF_T yysize1 = yysize + (yystrlen (yyformat) - 2 * yycount) + 1;
-    if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-      yysize = yysize1;
-    else
-      return 2;
-  }
 
-  if (*yymsg_alloc < yysize)
-    {
-      *yymsg_alloc = 2 * yysize;
-      if (! (yysize <= *yymsg_alloc
-             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
-    }
 
-  /* Avoid sprintf, as that infringes on the user's name space.
-     Don't have undefined behavior even if the translation
-     produced a string with the wrong number of "%s"s.  */
-  {
-    char *yyp = *yymsg;
-    int yyi = 0;
-    while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
-        {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
-          yyformat += 2;
-        }
-      else
-        {
-          ++yyp;
-          ++yyformat;
-        }
-  }
-  return 0;
-}
-#endif /* YYERROR_VERBOSE */
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
 {
-  YYUSE (yyvaluep);
+  YY_USE (yyvaluep);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-
-
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 /* The semantic value of the lookahead symbol.  */
@@ -1315,6 +1234,8 @@ YYSTYPE yylval;
 int yynerrs;
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1322,43 +1243,36 @@ int yynerrs;
 int
 yyparse (void)
 {
-    yy_state_fast_t yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
+    int yyerrstatus = 0;
 
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
-
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
     yy_state_t yyssa[YYINITDEPTH];
-    yy_state_t *yyss;
-    yy_state_t *yyssp;
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    /* The semantic value stack.  */
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
-
-    YYPTRDIFF_T yystacksize;
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
@@ -1366,16 +1280,10 @@ yyparse (void)
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   goto yysetstate;
 
 
@@ -1397,10 +1305,11 @@ yysetstate:
   YY_IGNORE_USELESS_CAST_BEGIN
   *yyssp = YY_CAST (yy_state_t, yystate);
   YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
 #if !defined yyoverflow && !defined YYSTACK_RELOCATE
-    goto yyexhaustedlab;
+    YYNOMEM;
 #else
     {
       /* Get the current used size of the three stacks, in elements.  */
@@ -1428,7 +1337,7 @@ yysetstate:
 # else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
@@ -1439,10 +1348,10 @@ yysetstate:
           YY_CAST (union yyalloc *,
                    YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
-# undef YYSTACK_RELOCATE
+#  undef YYSTACK_RELOCATE
         if (yyss1 != yyssa)
           YYSTACK_FREE (yyss1);
       }
@@ -1461,6 +1370,7 @@ yysetstate:
     }
 #endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
+
   if (yystate == YYFINAL)
     YYACCEPT;
 
@@ -1481,18 +1391,29 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex ();
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1561,576 +1482,616 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-  case 4:
+  case 4: /* section: JACOBIAN PARAMETER  */
 #line 100 "scan.y"
                   { CmdJacobian( (yyvsp[0].str) );
                   }
-#line 1569 "y.tab.c"
+#line 1490 "y.tab.c"
     break;
 
-  case 5:
+  case 5: /* section: HESSIAN PARAMETER  */
 #line 103 "scan.y"
                   { CmdHessian( (yyvsp[0].str) );
                   }
-#line 1576 "y.tab.c"
+#line 1497 "y.tab.c"
     break;
 
-  case 6:
+  case 6: /* section: DECLARE PARAMETER  */
 #line 106 "scan.y"
                   { CmdDeclareValues( (yyvsp[0].str) );
                   }
-#line 1583 "y.tab.c"
+#line 1504 "y.tab.c"
     break;
 
-  case 7:
+  case 7: /* section: STOICMAT PARAMETER  */
 #line 109 "scan.y"
                   { CmdStoicmat( (yyvsp[0].str) );
                   }
-#line 1590 "y.tab.c"
+#line 1511 "y.tab.c"
     break;
 
-  case 8:
+  case 8: /* section: DOUBLE PARAMETER  */
 #line 112 "scan.y"
                   { CmdDouble( (yyvsp[0].str) );
                   }
-#line 1597 "y.tab.c"
+#line 1518 "y.tab.c"
     break;
 
-  case 9:
+  case 9: /* section: REORDER PARAMETER  */
 #line 115 "scan.y"
                   { CmdReorder( (yyvsp[0].str) );
                   }
-#line 1604 "y.tab.c"
+#line 1525 "y.tab.c"
     break;
 
-  case 10:
+  case 10: /* section: MEX PARAMETER  */
 #line 118 "scan.y"
                   { CmdMex( (yyvsp[0].str) );
                   }
-#line 1611 "y.tab.c"
+#line 1532 "y.tab.c"
     break;
 
-  case 11:
+  case 11: /* section: THREADSAFE PARAMETER  */
 #line 121 "scan.y"
-                  { CmdDummyindex( (yyvsp[0].str) );
+                  { CmdThreadsafe( (yyvsp[0].str) );
                   }
-#line 1618 "y.tab.c"
+#line 1539 "y.tab.c"
     break;
 
-  case 12:
+  case 12: /* section: RATETABLE PARAMETER  */
 #line 124 "scan.y"
-                  { CmdEqntags( (yyvsp[0].str) );
+                  { CmdRatetable( (yyvsp[0].str) );
                   }
-#line 1625 "y.tab.c"
+#line 1546 "y.tab.c"
     break;
 
-  case 13:
+  case 13: /* section: REDUCE PARAMETER  */
 #line 127 "scan.y"
-                  { CmdFunction( (yyvsp[0].str) );
+                  { CmdReduce( (yyvsp[0].str) );
                   }
-#line 1632 "y.tab.c"
+#line 1553 "y.tab.c"
     break;
 
-  case 14:
+  case 14: /* section: DUMMYINDEX PARAMETER  */
 #line 130 "scan.y"
-                  { CmdStochastic( (yyvsp[0].str) );
+                  { CmdDummyindex( (yyvsp[0].str) );
                   }
-#line 1639 "y.tab.c"
+#line 1560 "y.tab.c"
     break;
 
-  case 15:
+  case 15: /* section: EQNTAGS PARAMETER  */
 #line 133 "scan.y"
+                  { CmdEqntags( (yyvsp[0].str) );
+                  }
+#line 1567 "y.tab.c"
+    break;
+
+  case 16: /* section: FUNCTION PARAMETER  */
+#line 136 "scan.y"
+                  { CmdFunction( (yyvsp[0].str) );
+                  }
+#line 1574 "y.tab.c"
+    break;
+
+  case 17: /* section: STOCHASTIC PARAMETER  */
+#line 139 "scan.y"
+                  { CmdStochastic( (yyvsp[0].str) );
+                  }
+#line 1581 "y.tab.c"
+    break;
+
+  case 18: /* section: ATOMDECL atomlist  */
+#line 142 "scan.y"
                   {}
-#line 1645 "y.tab.c"
+#line 1587 "y.tab.c"
     break;
 
-  case 16:
-#line 135 "scan.y"
+  case 19: /* section: CHECK atomlist  */
+#line 144 "scan.y"
                   {}
-#line 1651 "y.tab.c"
+#line 1593 "y.tab.c"
     break;
 
-  case 17:
-#line 137 "scan.y"
+  case 20: /* section: DEFVAR species  */
+#line 146 "scan.y"
                   {}
-#line 1657 "y.tab.c"
+#line 1599 "y.tab.c"
     break;
 
-  case 18:
-#line 139 "scan.y"
+  case 21: /* section: DEFRAD species  */
+#line 148 "scan.y"
                   {}
-#line 1663 "y.tab.c"
+#line 1605 "y.tab.c"
     break;
 
-  case 19:
-#line 141 "scan.y"
+  case 22: /* section: DEFFIX species  */
+#line 150 "scan.y"
                   {}
-#line 1669 "y.tab.c"
+#line 1611 "y.tab.c"
     break;
 
-  case 20:
-#line 143 "scan.y"
+  case 23: /* section: SETVAR setspclist  */
+#line 152 "scan.y"
                   {}
-#line 1675 "y.tab.c"
+#line 1617 "y.tab.c"
     break;
 
-  case 21:
-#line 145 "scan.y"
+  case 24: /* section: SETRAD setspclist  */
+#line 154 "scan.y"
                   {}
-#line 1681 "y.tab.c"
+#line 1623 "y.tab.c"
     break;
 
-  case 22:
-#line 147 "scan.y"
+  case 25: /* section: SETFIX setspclist  */
+#line 156 "scan.y"
                   {}
-#line 1687 "y.tab.c"
+#line 1629 "y.tab.c"
     break;
 
-  case 23:
-#line 149 "scan.y"
+  case 26: /* section: INITVALUES initvalues  */
+#line 158 "scan.y"
                   {}
-#line 1693 "y.tab.c"
+#line 1635 "y.tab.c"
     break;
 
-  case 24:
-#line 151 "scan.y"
+  case 27: /* section: SAMPLE initvalues  */
+#line 160 "scan.y"
+                  { EndSample(); }
+#line 1641 "y.tab.c"
+    break;
+
+  case 28: /* section: EQUATIONS equations  */
+#line 162 "scan.y"
+                  {}
+#line 1647 "y.tab.c"
+    break;
+
+  case 29: /* section: LUMP lumps  */
+#line 164 "scan.y"
                   {}
-#line 1699 "y.tab.c"
+#line 1653 "y.tab.c"
     break;
 
-  case 25:
-#line 153 "scan.y"
+  case 30: /* section: LOOKAT lookatlist  */
+#line 166 "scan.y"
                   {}
-#line 1705 "y.tab.c"
+#line 1659 "y.tab.c"
     break;
 
-  case 26:
-#line 155 "scan.y"
+  case 31: /* section: MONITOR monitorlist  */
+#line 168 "scan.y"
                   {}
-#line 1711 "y.tab.c"
+#line 1665 "y.tab.c"
     break;
 
-  case 27:
-#line 157 "scan.y"
+  case 32: /* section: TARGETS monitorlist  */
+#line 170 "scan.y"
                   {}
-#line 1717 "y.tab.c"
+#line 1671 "y.tab.c"
     break;
 
-  case 28:
-#line 159 "scan.y"
+  case 33: /* section: TRANSPORT translist  */
+#line 172 "scan.y"
                   {}
-#line 1723 "y.tab.c"
+#line 1677 "y.tab.c"
     break;
 
-  case 29:
-#line 161 "scan.y"
+  case 34: /* section: CHECKALL  */
+#line 174 "scan.y"
                   { CheckAll(); }
-#line 1729 "y.tab.c"
+#line 1683 "y.tab.c"
     break;
 
-  case 30:
-#line 163 "scan.y"
+  case 35: /* section: LOOKATALL  */
+#line 176 "scan.y"
                   { LookAtAll(); }
-#line 1735 "y.tab.c"
+#line 1689 "y.tab.c"
     break;
 
-  case 31:
-#line 165 "scan.y"
+  case 36: /* section: TRANSPORTALL  */
+#line 178 "scan.y"
                   { TransportAll(); }
-#line 1741 "y.tab.c"
+#line 1695 "y.tab.c"
     break;
 
-  case 32:
-#line 167 "scan.y"
+  case 37: /* section: WRITE_ATM  */
+#line 180 "scan.y"
                   { WriteAtoms(); }
-#line 1747 "y.tab.c"
+#line 1701 "y.tab.c"
     break;
 
-  case 33:
-#line 169 "scan.y"
+  case 38: /* section: WRITE_SPC  */
+#line 182 "scan.y"
                   { WriteSpecies(); }
-#line 1753 "y.tab.c"
+#line 1707 "y.tab.c"
     break;
 
-  case 34:
-#line 171 "scan.y"
+  case 39: /* section: WRITE_MAT  */
+#line 184 "scan.y"
                   { WriteMatrices(); }
-#line 1759 "y.tab.c"
+#line 1713 "y.tab.c"
     break;
 
-  case 35:
-#line 173 "scan.y"
+  case 40: /* section: WRITE_OPT  */
+#line 186 "scan.y"
                   { WriteOptions(); }
-#line 1765 "y.tab.c"
+#line 1719 "y.tab.c"
     break;
 
-  case 36:
-#line 175 "scan.y"
+  case 41: /* section: USE PARAMETER  */
+#line 188 "scan.y"
                   { CmdUse( (yyvsp[0].str) ); }
-#line 1771 "y.tab.c"
+#line 1725 "y.tab.c"
     break;
 
-  case 37:
-#line 177 "scan.y"
+  case 42: /* section: LANGUAGE PARAMETER  */
+#line 190 "scan.y"
                   { CmdLanguage( (yyvsp[0].str) ); }
-#line 1777 "y.tab.c"
+#line 1731 "y.tab.c"
     break;
 
-  case 38:
-#line 179 "scan.y"
+  case 43: /* section: INITIALIZE PARAMETER  */
+#line 192 "scan.y"
                   { DefineInitializeNbr( (yyvsp[0].str) ); }
-#line 1783 "y.tab.c"
+#line 1737 "y.tab.c"
     break;
 
-  case 39:
-#line 181 "scan.y"
+  case 44: /* section: XGRID PARAMETER  */
+#line 194 "scan.y"
                   { DefineXGrid( (yyvsp[0].str) ); }
-#line 1789 "y.tab.c"
+#line 1743 "y.tab.c"
     break;
 
-  case 40:
-#line 183 "scan.y"
+  case 45: /* section: YGRID PARAMETER  */
+#line 196 "scan.y"
                   { DefineYGrid( (yyvsp[0].str) ); }
-#line 1795 "y.tab.c"
+#line 1749 "y.tab.c"
     break;
 
-  case 41:
-#line 185 "scan.y"
+  case 46: /* section: ZGRID PARAMETER  */
+#line 198 "scan.y"
                   { DefineZGrid( (yyvsp[0].str) ); }
-#line 1801 "y.tab.c"
+#line 1755 "y.tab.c"
     break;
 
-  case 42:
-#line 187 "scan.y"
+  case 47: /* section: INLINE INLCTX inlinecode ENDINLINE  */
+#line 200 "scan.y"
                   { 
 		    AddInlineCode( (yyvsp[-2].str), InlineBuf );
                     free( InlineBuf );
 		  }
-#line 1810 "y.tab.c"
+#line 1764 "y.tab.c"
     break;
 
-  case 43:
-#line 192 "scan.y"
+  case 48: /* section: INLINE error  */
+#line 205 "scan.y"
                   { ParserErrorMessage(); }
-#line 1816 "y.tab.c"
+#line 1770 "y.tab.c"
     break;
 
-  case 44:
-#line 194 "scan.y"
+  case 49: /* section: INTFILE PARAMETER  */
+#line 207 "scan.y"
                   { CmdIntegrator( (yyvsp[0].str) ); }
-#line 1822 "y.tab.c"
+#line 1776 "y.tab.c"
     break;
 
-  case 45:
-#line 196 "scan.y"
+  case 50: /* section: DRIVER PARAMETER  */
+#line 209 "scan.y"
                   { CmdDriver( (yyvsp[0].str) ); }
-#line 1828 "y.tab.c"
+#line 1782 "y.tab.c"
     break;
 
-  case 46:
-#line 198 "scan.y"
+  case 51: /* section: RUN PARAMETER  */
+#line 211 "scan.y"
                   { CmdRun( (yyvsp[0].str) ); }
-#line 1834 "y.tab.c"
+#line 1788 "y.tab.c"
     break;
 
-  case 47:
-#line 200 "scan.y"
+  case 52: /* section: USES uselist  */
+#line 213 "scan.y"
                   {}
-#line 1840 "y.tab.c"
+#line 1794 "y.tab.c"
     break;
 
-  case 48:
-#line 202 "scan.y"
+  case 53: /* section: SPARSEDATA PARAMETER  */
+#line 215 "scan.y"
                   { SparseData( (yyvsp[0].str) );
                   }
-#line 1847 "y.tab.c"
+#line 1801 "y.tab.c"
     break;
 
-  case 49:
-#line 206 "scan.y"
+  case 54: /* semicolon: semicolon ';'  */
+#line 219 "scan.y"
                   { ScanWarning("Unnecessary ';'");
                   }
-#line 1854 "y.tab.c"
+#line 1808 "y.tab.c"
     break;
 
-  case 53:
-#line 213 "scan.y"
+  case 58: /* atomlist: error semicolon  */
+#line 226 "scan.y"
                   { ParserErrorMessage(); }
-#line 1860 "y.tab.c"
+#line 1814 "y.tab.c"
     break;
 
-  case 54:
-#line 216 "scan.y"
+  case 59: /* atomdef: ATOMID  */
+#line 229 "scan.y"
                   { switch( crt_section ) {
                       case ATOMDECL: DeclareAtom( (yyvsp[0].str) ); break;
                       case CHECK:    SetAtomType( (yyvsp[0].str), DO_CHECK ); break;
                     }
                   }
-#line 1870 "y.tab.c"
+#line 1824 "y.tab.c"
     break;
 
-  case 57:
-#line 225 "scan.y"
+  case 62: /* lookatlist: error semicolon  */
+#line 238 "scan.y"
                   { ParserErrorMessage(); }
-#line 1876 "y.tab.c"
+#line 1830 "y.tab.c"
     break;
 
-  case 58:
-#line 228 "scan.y"
+  case 63: /* lookatspc: LKTID  */
+#line 241 "scan.y"
                   { AddLookAt( (yyvsp[0].str) );
                   }
-#line 1883 "y.tab.c"
+#line 1837 "y.tab.c"
     break;
 
-  case 61:
-#line 234 "scan.y"
+  case 66: /* monitorlist: error semicolon  */
+#line 247 "scan.y"
                   { ParserErrorMessage(); }
-#line 1889 "y.tab.c"
+#line 1843 "y.tab.c"
     break;
 
-  case 62:
-#line 237 "scan.y"
-                  { AddMonitor( (yyvsp[0].str) );
+  case 67: /* monitorspc: MNIID  */
+#line 250 "scan.y"
+                  { switch( crt_section ) {
+                      case MONITOR: AddMonitor( (yyvsp[0].str) ); break;
+                      case TARGETS: AddTarget( (yyvsp[0].str) ); break;
+                    }
                   }
-#line 1896 "y.tab.c"
+#line 1853 "y.tab.c"
     break;
 
-  case 65:
-#line 243 "scan.y"
+  case 70: /* translist: error semicolon  */
+#line 259 "scan.y"
                   { ParserErrorMessage(); }
-#line 1902 "y.tab.c"
+#line 1859 "y.tab.c"
     break;
 
-  case 66:
-#line 246 "scan.y"
+  case 71: /* transspc: TPTID  */
+#line 262 "scan.y"
                   { AddTransport( (yyvsp[0].str) );
                   }
-#line 1909 "y.tab.c"
+#line 1866 "y.tab.c"
     break;
 
-  case 69:
-#line 252 "scan.y"
+  case 74: /* uselist: error semicolon  */
+#line 268 "scan.y"
                   { ParserErrorMessage(); }
-#line 1915 "y.tab.c"
+#line 1872 "y.tab.c"
     break;
 
-  case 70:
-#line 255 "scan.y"
+  case 75: /* usefile: USEID  */
+#line 271 "scan.y"
                   { AddUseFile( (yyvsp[0].str) );
                   }
-#line 1922 "y.tab.c"
+#line 1879 "y.tab.c"
     break;
 
-  case 73:
-#line 261 "scan.y"
+  case 78: /* setspclist: error semicolon  */
+#line 277 "scan.y"
                   { ParserErrorMessage(); }
-#line 1928 "y.tab.c"
+#line 1885 "y.tab.c"
     break;
 
-  case 74:
-#line 264 "scan.y"
+  case 79: /* setspcspc: SSPID  */
+#line 280 "scan.y"
                   { switch( crt_section ) {
                       case SETVAR: SetSpcType( VAR_SPC, (yyvsp[0].str) ); break;
                       case SETRAD: SetSpcType( RAD_SPC, (yyvsp[0].str) ); break;
                       case SETFIX: SetSpcType( FIX_SPC, (yyvsp[0].str) ); break;
                     }
                   }
-#line 1939 "y.tab.c"
+#line 1896 "y.tab.c"
     break;
 
-  case 77:
-#line 274 "scan.y"
+  case 82: /* species: error semicolon  */
+#line 290 "scan.y"
                   { ParserErrorMessage(); }
-#line 1945 "y.tab.c"
+#line 1902 "y.tab.c"
     break;
 
-  case 80:
-#line 280 "scan.y"
+  case 85: /* spcname: SPCSPC SPCEQUAL atoms  */
+#line 296 "scan.y"
                   { switch( crt_section ) {
                       case DEFVAR: DeclareSpecies( VAR_SPC, (yyvsp[-2].str) ); break;
                       case DEFRAD: DeclareSpecies( RAD_SPC, (yyvsp[-2].str) ); break;
                       case DEFFIX: DeclareSpecies( FIX_SPC, (yyvsp[-2].str) ); break;
                     } 
                   }
-#line 1956 "y.tab.c"
+#line 1913 "y.tab.c"
     break;
 
-  case 81:
-#line 288 "scan.y"
+  case 86: /* spcdef: SPCSPC  */
+#line 304 "scan.y"
                   { switch( crt_section ) {
                       case DEFVAR: DeclareSpecies( VAR_SPC, (yyvsp[0].str) ); break;
                       case DEFRAD: DeclareSpecies( RAD_SPC, (yyvsp[0].str) ); break;
                       case DEFFIX: DeclareSpecies( FIX_SPC, (yyvsp[0].str) ); break;
                     } 
                   }
-#line 1967 "y.tab.c"
+#line 1924 "y.tab.c"
     break;
 
-  case 84:
-#line 299 "scan.y"
+  case 89: /* atom: SPCNR SPCSPC  */
+#line 315 "scan.y"
                   { AddAtom( (yyvsp[0].str), (yyvsp[-1].str) );
                   }
-#line 1974 "y.tab.c"
+#line 1931 "y.tab.c"
     break;
 
-  case 85:
-#line 302 "scan.y"
+  case 90: /* atom: SPCSPC  */
+#line 318 "scan.y"
                   { AddAtom( (yyvsp[0].str), "1" );
                   }
-#line 1981 "y.tab.c"
+#line 1938 "y.tab.c"
     break;
 
-  case 88:
-#line 308 "scan.y"
+  case 93: /* initvalues: error semicolon  */
+#line 324 "scan.y"
                   { ParserErrorMessage(); }
-#line 1987 "y.tab.c"
+#line 1944 "y.tab.c"
     break;
 
-  case 89:
-#line 311 "scan.y"
-                  { AssignInitialValue( (yyvsp[-2].str), (yyvsp[0].str) ); }
-#line 1993 "y.tab.c"
+  case 94: /* assignment: INISPC INIEQUAL INIVALUE  */
+#line 327 "scan.y"
+                  { switch( crt_section ) {
+                      case INITVALUES: AssignInitialValue( (yyvsp[-2].str), (yyvsp[0].str) ); break;
+                      case SAMPLE:     AddSample( (yyvsp[-2].str), (yyvsp[0].str) ); break;
+                    }
+                  }
+#line 1954 "y.tab.c"
     break;
 
-  case 92:
-#line 316 "scan.y"
+  case 97: /* equations: error semicolon  */
+#line 336 "scan.y"
                   { ParserErrorMessage();
                     eqState = LHS; 
                   }
-#line 2001 "y.tab.c"
+#line 1962 "y.tab.c"
     break;
 
-  case 93:
-#line 321 "scan.y"
+  case 98: /* equation: eqntag lefths righths rate  */
+#line 341 "scan.y"
                   { eqState = LHS;
                     StoreEquationRate( (yyvsp[0].str), (yyvsp[-3].str) ); 
                     CheckEquation();
                   }
-#line 2010 "y.tab.c"
+#line 1971 "y.tab.c"
     break;
 
-  case 94:
-#line 326 "scan.y"
+  case 99: /* equation: lefths righths rate  */
+#line 346 "scan.y"
                   { eqState = LHS;
                     StoreEquationRate( (yyvsp[0].str), "          " ); 
                     CheckEquation();
                   }
-#line 2019 "y.tab.c"
+#line 1980 "y.tab.c"
     break;
 
-  case 95:
-#line 331 "scan.y"
+  case 100: /* rate: RATE rate  */
+#line 351 "scan.y"
                   { strcpy( (yyval.str), (yyvsp[-1].str) );
                     strcat( (yyval.str), (yyvsp[0].str) ); 
                   }
-#line 2027 "y.tab.c"
+#line 1988 "y.tab.c"
     break;
 
-  case 96:
-#line 335 "scan.y"
+  case 101: /* rate: RATE  */
+#line 355 "scan.y"
                   { strcpy( (yyval.str), (yyvsp[0].str) );
                   }
-#line 2034 "y.tab.c"
+#line 1995 "y.tab.c"
     break;
 
-  case 97:
-#line 339 "scan.y"
+  case 102: /* eqntag: EQNLESS EQNTAG EQNGREATER  */
+#line 359 "scan.y"
                   { strcpy( (yyval.str), (yyvsp[-1].str) );
                   }
-#line 2041 "y.tab.c"
+#line 2002 "y.tab.c"
     break;
 
-  case 98:
-#line 343 "scan.y"
+  case 103: /* lefths: expresion EQNEQUAL  */
+#line 363 "scan.y"
                   { eqState = RHS; }
-#line 2047 "y.tab.c"
+#line 2008 "y.tab.c"
     break;
 
-  case 99:
-#line 346 "scan.y"
+  case 104: /* righths: expresion EQNCOLON  */
+#line 366 "scan.y"
                   { eqState = RAT; }
-#line 2053 "y.tab.c"
+#line 2014 "y.tab.c"
     break;
 
-  case 100:
-#line 349 "scan.y"
+  case 105: /* expresion: expresion EQNSIGN term  */
+#line 369 "scan.y"
                   { ProcessTerm( eqState, (yyvsp[-1].str), crt_coef, crt_term ); 
                   }
-#line 2060 "y.tab.c"
+#line 2021 "y.tab.c"
     break;
 
-  case 101:
-#line 352 "scan.y"
+  case 106: /* expresion: EQNSIGN term  */
+#line 372 "scan.y"
                   { ProcessTerm( eqState, (yyvsp[-1].str), crt_coef, crt_term );
                   }
-#line 2067 "y.tab.c"
+#line 2028 "y.tab.c"
     break;
 
-  case 102:
-#line 355 "scan.y"
+  case 107: /* expresion: term  */
+#line 375 "scan.y"
                   { ProcessTerm( eqState, "+", crt_coef, crt_term );
                   }
-#line 2074 "y.tab.c"
+#line 2035 "y.tab.c"
     break;
 
-  case 103:
-#line 359 "scan.y"
+  case 108: /* term: EQNCOEF EQNSPC  */
+#line 379 "scan.y"
                   { strcpy( crt_term, (yyvsp[0].str) );
                     strcpy( crt_coef, (yyvsp[-1].str) );  
                   }
-#line 2082 "y.tab.c"
+#line 2043 "y.tab.c"
     break;
 
-  case 104:
-#line 363 "scan.y"
+  case 109: /* term: EQNSPC  */
+#line 383 "scan.y"
                   { strcpy( crt_term, (yyvsp[0].str) );         
                     strcpy( crt_coef, "1" ); 
                   }
-#line 2090 "y.tab.c"
+#line 2051 "y.tab.c"
     break;
 
-  case 107:
-#line 370 "scan.y"
+  case 112: /* lumps: error semicolon  */
+#line 390 "scan.y"
                   { ParserErrorMessage(); }
-#line 2096 "y.tab.c"
+#line 2057 "y.tab.c"
     break;
 
-  case 108:
-#line 373 "scan.y"
+  case 113: /* lump: LMPSPC LMPPLUS lump  */
+#line 393 "scan.y"
                   { AddLumpSpecies( (yyvsp[-2].str) );
                   }
-#line 2103 "y.tab.c"
+#line 2064 "y.tab.c"
     break;
 
-  case 109:
-#line 376 "scan.y"
+  case 114: /* lump: LMPSPC LMPCOLON LMPSPC  */
+#line 396 "scan.y"
                   {
                     AddLumpSpecies( (yyvsp[-2].str) );
                     CheckLump( (yyvsp[0].str) );  
                   }
-#line 2112 "y.tab.c"
+#line 2073 "y.tab.c"
     break;
 
-  case 110:
-#line 381 "scan.y"
+  case 115: /* inlinecode: inlinecode INCODE  */
+#line 401 "scan.y"
                   {
 		    InlineBuf = AppendString( InlineBuf, (yyvsp[0].str), &InlineLen, MAX_INLINE );
 		  }
-#line 2120 "y.tab.c"
+#line 2081 "y.tab.c"
     break;
 
-  case 111:
-#line 385 "scan.y"
+  case 116: /* inlinecode: INCODE  */
+#line 405 "scan.y"
                   {
 		    InlineBuf = malloc( MAX_INLINE ); 
                     InlineLen = MAX_INLINE;
 		    strcpy( InlineBuf, (yyvsp[0].str));
 		  }
-#line 2130 "y.tab.c"
+#line 2091 "y.tab.c"
     break;
 
 
-#line 2134 "y.tab.c"
+#line 2095 "y.tab.c"
 
       default: break;
     }
@@ -2145,11 +2106,10 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
@@ -2173,50 +2133,14 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
-      {
-        char const *yymsgp = YY_("syntax error");
-        int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
-        if (yysyntax_error_status == 0)
-          yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
-          {
-            if (yymsg != yymsgbuf)
-              YYSTACK_FREE (yymsg);
-            yymsg = YY_CAST (char *, YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
-            if (!yymsg)
-              {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
-              }
-            else
-              {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
-              }
-          }
-        yyerror (yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
-      }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -2249,6 +2173,7 @@ yyerrorlab:
      label yyerrorlab therefore never appears in user code.  */
   if (0)
     YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -2265,13 +2190,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -2285,7 +2211,7 @@ yyerrlab1:
 
 
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2297,7 +2223,7 @@ yyerrlab1:
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2308,7 +2234,7 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
 /*-----------------------------------.
@@ -2316,24 +2242,22 @@ yyacceptlab:
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
 
-/*-----------------------------------------------------.
-| yyreturn -- parsing is finished, return the result.  |
-`-----------------------------------------------------*/
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2349,20 +2273,18 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[+*yyssp], yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
+
   return yyresult;
 }
-#line 391 "scan.y"
+
+#line 411 "scan.y"
 
 
 void yyerror( char * str )
@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.5.1.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -31,8 +31,9 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
 
 #ifndef YY_YY_Y_TAB_H_INCLUDED
 # define YY_YY_Y_TAB_H_INCLUDED
@@ -44,85 +45,95 @@
 extern int yydebug;
 #endif
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    JACOBIAN = 258,
-    DOUBLE = 259,
-    FUNCTION = 260,
-    DEFVAR = 261,
-    DEFRAD = 262,
-    DEFFIX = 263,
-    SETVAR = 264,
-    SETRAD = 265,
-    SETFIX = 266,
-    HESSIAN = 267,
-    STOICMAT = 268,
-    STOCHASTIC = 269,
-    DECLARE = 270,
-    INITVALUES = 271,
-    EQUATIONS = 272,
-    LUMP = 273,
-    INIEQUAL = 274,
-    EQNEQUAL = 275,
-    EQNCOLON = 276,
-    LMPCOLON = 277,
-    LMPPLUS = 278,
-    SPCPLUS = 279,
-    SPCEQUAL = 280,
-    ATOMDECL = 281,
-    CHECK = 282,
-    CHECKALL = 283,
-    REORDER = 284,
-    MEX = 285,
-    DUMMYINDEX = 286,
-    EQNTAGS = 287,
-    LOOKAT = 288,
-    LOOKATALL = 289,
-    TRANSPORT = 290,
-    TRANSPORTALL = 291,
-    MONITOR = 292,
-    USES = 293,
-    SPARSEDATA = 294,
-    WRITE_ATM = 295,
-    WRITE_SPC = 296,
-    WRITE_MAT = 297,
-    WRITE_OPT = 298,
-    INITIALIZE = 299,
-    XGRID = 300,
-    YGRID = 301,
-    ZGRID = 302,
-    USE = 303,
-    LANGUAGE = 304,
-    INTFILE = 305,
-    DRIVER = 306,
-    RUN = 307,
-    INLINE = 308,
-    ENDINLINE = 309,
-    PARAMETER = 310,
-    SPCSPC = 311,
-    INISPC = 312,
-    INIVALUE = 313,
-    EQNSPC = 314,
-    EQNSIGN = 315,
-    EQNCOEF = 316,
-    RATE = 317,
-    LMPSPC = 318,
-    SPCNR = 319,
-    ATOMID = 320,
-    LKTID = 321,
-    MNIID = 322,
-    INLCTX = 323,
-    INCODE = 324,
-    SSPID = 325,
-    EQNLESS = 326,
-    EQNTAG = 327,
-    EQNGREATER = 328,
-    TPTID = 329,
-    USEID = 330
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    JACOBIAN = 258,                /* JACOBIAN  */
+    DOUBLE = 259,                  /* DOUBLE  */
+    FUNCTION = 260,                /* FUNCTION  */
+    DEFVAR = 261,                  /* DEFVAR  */
+    DEFRAD = 262,                  /* DEFRAD  */
+    DEFFIX = 263,                  /* DEFFIX  */
+    SETVAR = 264,                  /* SETVAR  */
+    SETRAD = 265,                  /* SETRAD  */
+    SETFIX = 266,                  /* SETFIX  */
+    HESSIAN = 267,                 /* HESSIAN  */
+    STOICMAT = 268,                /* STOICMAT  */
+    STOCHASTIC = 269,              /* STOCHASTIC  */
+    DECLARE = 270,                 /* DECLARE  */
+    INITVALUES = 271,              /* INITVALUES  */
+    EQUATIONS = 272,               /* EQUATIONS  */
+    LUMP = 273,                    /* LUMP  */
+    INIEQUAL = 274,                /* INIEQUAL  */
+    EQNEQUAL = 275,                /* EQNEQUAL  */
+    EQNCOLON = 276,                /* EQNCOLON  */
+    LMPCOLON = 277,                /* LMPCOLON  */
+    LMPPLUS = 278,                 /* LMPPLUS  */
+    SPCPLUS = 279,                 /* SPCPLUS  */
+    SPCEQUAL = 280,                /* SPCEQUAL  */
+    ATOMDECL = 281,                /* ATOMDECL  */
+    CHECK = 282,                   /* CHECK  */
+    CHECKALL = 283,                /* CHECKALL  */
+    REORDER = 284,                 /* REORDER  */
+    MEX = 285,                     /* MEX  */
+    DUMMYINDEX = 286,              /* DUMMYINDEX  */
+    EQNTAGS = 287,                 /* EQNTAGS  */
+    THREADSAFE = 288,              /* THREADSAFE  */
+    RATETABLE = 289,               /* RATETABLE  */
+    REDUCE = 290,                  /* REDUCE  */
+    SAMPLE = 291,                  /* SAMPLE  */
+    TARGETS = 292,                 /* TARGETS  */
+    LOOKAT = 293,                  /* LOOKAT  */
+    LOOKATALL = 294,               /* LOOKATALL  */
+    TRANSPORT = 295,               /* TRANSPORT  */
+    TRANSPORTALL = 296,            /* TRANSPORTALL  */
+    MONITOR = 297,                 /* MONITOR  */
+    USES = 298,                    /* USES  */
+    SPARSEDATA = 299,              /* SPARSEDATA  */
+    WRITE_ATM = 300,               /* WRITE_ATM  */
+    WRITE_SPC = 301,               /* WRITE_SPC  */
+    WRITE_MAT = 302,               /* WRITE_MAT  */
+    WRITE_OPT = 303,               /* WRITE_OPT  */
+    INITIALIZE = 304,              /* INITIALIZE  */
+    XGRID = 305,                   /* XGRID  */
+    YGRID = 306,                   /* YGRID  */
+    ZGRID = 307,                   /* ZGRID  */
+    USE = 308,                     /* USE  */
+    LANGUAGE = 309,                /* LANGUAGE  */
+    INTFILE = 310,                 /* INTFILE  */
+    DRIVER = 311,                  /* DRIVER  */
+    RUN = 312,                     /* RUN  */
+    INLINE = 313,                  /* INLINE  */
+    ENDINLINE = 314,               /* ENDINLINE  */
+    PARAMETER = 315,               /* PARAMETER  */
+    SPCSPC = 316,                  /* SPCSPC  */
+    INISPC = 317,                  /* INISPC  */
+    INIVALUE = 318,                /* INIVALUE  */
+    EQNSPC = 319,                  /* EQNSPC  */
+    EQNSIGN = 320,                 /* EQNSIGN  */
+    EQNCOEF = 321,                 /* EQNCOEF  */
+    RATE = 322,                    /* RATE  */
+    LMPSPC = 323,                  /* LMPSPC  */
+    SPCNR = 324,                   /* SPCNR  */
+    ATOMID = 325,                  /* ATOMID  */
+    LKTID = 326,                   /* LKTID  */
+    MNIID = 327,                   /* MNIID  */
+    INLCTX = 328,                  /* INLCTX  */
+    INCODE = 329,                  /* INCODE  */
+    SSPID = 330,                   /* SSPID  */
+    EQNLESS = 331,                 /* EQNLESS  */
+    EQNTAG = 332,                  /* EQNTAG  */
+    EQNGREATER = 333,              /* EQNGREATER  */
+    TPTID = 334,                   /* TPTID  */
+    USEID = 335                    /* USEID  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
 /* Value type.  */
@@ -133,7 +144,7 @@ union YYSTYPE
 
   char str[80];
 
-#line 137 "y.tab.h"
+#line 148 "y.tab.h"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -144,6 +155,8 @@ typedef union YYSTYPE YYSTYPE;
 
 extern YYSTYPE yylval;
 
+
 int yyparse (void);
 
+
 #endif /* !YY_YY_Y_TAB_H_INCLUDED  */
@@ -1,6 +1,8 @@
 # Set here the desired C compiler and its optimization options
 CC   = gcc
 COPT = -O -Wall  
+# Add -fopenmp to COPT for the parallel drivers (general_stochastic_ensemble, general_grid)
+# Add -DKPP_BINARY_OUTPUT to COPT to save the results in KPP_ROOT.bin
 
 # To create Matlab gateway routines
 # Note: use $(CC) as the mex C compiler
@@ -8,27 +10,38 @@ MEX  = mex
 
 HEADERS = KPP_ROOT_Global.h  KPP_ROOT_Parameters.h  KPP_ROOT_Sparse.h
 
+# The Hessian and stoichiometric files exist only with #HESSIAN ON
+# and #STOICMAT ON (#REDUCE turns both off)
+HESSPSRC_ON = KPP_ROOT_HessianSP.c
+HESSPOBJ_ON = KPP_ROOT_HessianSP.o
+HESSRC_ON   = KPP_ROOT_Hessian.c
+HESOBJ_ON   = KPP_ROOT_Hessian.o
+STMSPSRC_ON = KPP_ROOT_StoichiomSP.c
+STMSPOBJ_ON = KPP_ROOT_StoichiomSP.o
+STMSRC_ON   = KPP_ROOT_Stoichiom.c
+STMOBJ_ON   = KPP_ROOT_Stoichiom.o
+
 SPSRC = KPP_ROOT_JacobianSP.c \
-	KPP_ROOT_HessianSP.c  \
-	KPP_ROOT_StoichiomSP.c
+	$(HESSPSRC_KPP_HESSIAN) \
+	$(STMSPSRC_KPP_STOICMAT)
 
 SPOBJ = KPP_ROOT_JacobianSP.o \
-	KPP_ROOT_HessianSP.o  \
-	KPP_ROOT_StoichiomSP.o
+	$(HESSPOBJ_KPP_HESSIAN) \
+	$(STMSPOBJ_KPP_STOICMAT)
 
 
 SRC =   KPP_ROOT_Main.c      KPP_ROOT_Integrator.c   \
 	KPP_ROOT_Function.c  KPP_ROOT_Initialize.c   \
 	KPP_ROOT_Jacobian.c  KPP_ROOT_LinearAlgebra.c\
-	KPP_ROOT_Rates.c     KPP_ROOT_Hessian.c      \
-	KPP_ROOT_Stoichiom.c KPP_ROOT_Util.c         \
+	KPP_ROOT_Rates.c     $(HESSRC_KPP_HESSIAN)   \
+	$(STMSRC_KPP_STOICMAT) KPP_ROOT_Util.c       \
 	KPP_ROOT_Monitor.c
 
 OBJ =   KPP_ROOT_Main.o      KPP_ROOT_Integrator.o   \
 	KPP_ROOT_Function.o  KPP_ROOT_Initialize.o   \
 	KPP_ROOT_Jacobian.o  KPP_ROOT_LinearAlgebra.o\
-	KPP_ROOT_Rates.o     KPP_ROOT_Hessian.o      \
-	KPP_ROOT_Stoichiom.o KPP_ROOT_Util.o         \
+	KPP_ROOT_Rates.o     $(HESOBJ_KPP_HESSIAN)   \
+	$(STMOBJ_KPP_STOICMAT) KPP_ROOT_Util.o       \
 	KPP_ROOT_Monitor.o
 
 STOCHSRC = KPP_ROOT_Stochastic.c 
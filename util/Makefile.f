@@ -24,27 +24,38 @@ MEX  = mex
 
 HEADERS = KPP_ROOT_Global.h  KPP_ROOT_Parameters.h  KPP_ROOT_Sparse.h
 
+# The Hessian and stoichiometric files exist only with #HESSIAN ON
+# and #STOICMAT ON
+HESSPSRC_ON = KPP_ROOT_HessianSP.f
+HESSPOBJ_ON = KPP_ROOT_HessianSP.o
+HESSRC_ON   = KPP_ROOT_Hessian.f
+HESOBJ_ON   = KPP_ROOT_Hessian.o
+STMSPSRC_ON = KPP_ROOT_StoichiomSP.f
+STMSPOBJ_ON = KPP_ROOT_StoichiomSP.o
+STMSRC_ON   = KPP_ROOT_Stoichiom.f
+STMOBJ_ON   = KPP_ROOT_Stoichiom.o
+
 SPSRC = KPP_ROOT_JacobianSP.f \
-	KPP_ROOT_HessianSP.f  \
-	KPP_ROOT_StoichiomSP.f
+	$(HESSPSRC_KPP_HESSIAN) \
+	$(STMSPSRC_KPP_STOICMAT)
 
 SPOBJ = KPP_ROOT_JacobianSP.o \
-	KPP_ROOT_HessianSP.o  \
-	KPP_ROOT_StoichiomSP.o
+	$(HESSPOBJ_KPP_HESSIAN) \
+	$(STMSPOBJ_KPP_STOICMAT)
 
 
 SRC =   KPP_ROOT_Main.f      KPP_ROOT_Integrator.f   \
         KPP_ROOT_Function.f  KPP_ROOT_Initialize.f   \
 	KPP_ROOT_Jacobian.f  KPP_ROOT_LinearAlgebra.f\
-	KPP_ROOT_Rates.f     KPP_ROOT_Hessian.f      \
-	KPP_ROOT_Stoichiom.f KPP_ROOT_Util.f         \
+	KPP_ROOT_Rates.f     $(HESSRC_KPP_HESSIAN)   \
+	$(STMSRC_KPP_STOICMAT) KPP_ROOT_Util.f       \
 	KPP_ROOT_Monitor.f   
 
 OBJ =   KPP_ROOT_Main.o      KPP_ROOT_Integrator.o   \
         KPP_ROOT_Function.o  KPP_ROOT_Initialize.o   \
 	KPP_ROOT_Jacobian.o  KPP_ROOT_LinearAlgebra.o\
-	KPP_ROOT_Rates.o     KPP_ROOT_Hessian.o      \
-	KPP_ROOT_Stoichiom.o KPP_ROOT_Util.o         \
+	KPP_ROOT_Rates.o     $(HESOBJ_KPP_HESSIAN)   \
+	$(STMOBJ_KPP_STOICMAT) KPP_ROOT_Util.o       \
 	KPP_ROOT_Monitor.o
 
 all:    exe mex
@@ -64,11 +64,17 @@ FUNOBJ = KPP_ROOT_Function.o
 JACSRC = KPP_ROOT_JacobianSP.f90  KPP_ROOT_Jacobian.f90
 JACOBJ = KPP_ROOT_JacobianSP.o    KPP_ROOT_Jacobian.o
 
-HESSRC = KPP_ROOT_HessianSP.f90   KPP_ROOT_Hessian.f90
-HESOBJ = KPP_ROOT_HessianSP.o     KPP_ROOT_Hessian.o
-
-STMSRC = KPP_ROOT_StoichiomSP.f90 KPP_ROOT_Stoichiom.f90 
-STMOBJ = KPP_ROOT_StoichiomSP.o   KPP_ROOT_Stoichiom.o
+# The Hessian and stoichiometric files exist only with #HESSIAN ON
+# and #STOICMAT ON (#REDUCE turns both off)
+HESSRC_ON = KPP_ROOT_HessianSP.f90   KPP_ROOT_Hessian.f90
+HESOBJ_ON = KPP_ROOT_HessianSP.o     KPP_ROOT_Hessian.o
+HESSRC = $(HESSRC_KPP_HESSIAN)
+HESOBJ = $(HESOBJ_KPP_HESSIAN)
+
+STMSRC_ON = KPP_ROOT_StoichiomSP.f90 KPP_ROOT_Stoichiom.f90 
+STMOBJ_ON = KPP_ROOT_StoichiomSP.o   KPP_ROOT_Stoichiom.o
+STMSRC = $(STMSRC_KPP_STOICMAT)
+STMOBJ = $(STMOBJ_KPP_STOICMAT)
 
 UTLSRC = KPP_ROOT_Rates.f90 KPP_ROOT_Util.f90 KPP_ROOT_Monitor.f90
 UTLOBJ = KPP_ROOT_Rates.o   KPP_ROOT_Util.o   KPP_ROOT_Monitor.o
@@ -132,7 +138,7 @@ KPP_ROOT_Global.o: KPP_ROOT_Global.f90 \
 	            KPP_ROOT_Parameters.o KPP_ROOT_Precision.o
 	$(FC) $(FOPT) -c $<
 
-KPP_ROOT_Initialize.o: KPP_ROOT_Initialize.f90  $(GENOBJ) 
+KPP_ROOT_Initialize.o: KPP_ROOT_Initialize.f90  $(GENOBJ) KPP_ROOT_Rates.o
 	$(FC) $(FOPT) -c $<
 
 KPP_ROOT_Function.o: KPP_ROOT_Function.f90  $(GENOBJ) 
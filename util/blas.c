@@ -159,6 +159,9 @@ KPP_REAL WLAMCH( char C )
       KPP_REAL Suma;
       static KPP_REAL Eps;
       static char First = 1;
+#ifdef _OPENMP
+      #pragma omp threadprivate( Eps, First )
+#endif
       
       if (First) {
         First = 0;
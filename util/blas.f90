@@ -162,6 +162,7 @@
       KPP_REAL  ::  Suma
       KPP_REAL, PARAMETER  ::  ONE=1.0_dp, HALF=0.5_dp
       LOGICAL, SAVE   ::  First=.TRUE.
+!$OMP THREADPRIVATE(Eps, First)
       
       IF (First) THEN
         First = .FALSE.
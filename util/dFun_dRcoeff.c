@@ -0,0 +1,67 @@
+/*--------------------------------------------------------------
+
+  Derivatives of Fun with respect to rate coefficients
+
+  With mass action kinetics Fun = STOICM * ( RCONST .* ARP ), so
+  d Fun / d RCONST(r) is column r of the stoichiometric matrix
+  times the reactant product ARP(r) of reaction r.  Its nonzeros
+  are those of the column, whatever the concentrations.
+
+--------------------------------------------------------------*/
+
+void ReactantProd( KPP_REAL V[], KPP_REAL F[], KPP_REAL ARP[] );
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void dFun_dRcoeff( KPP_REAL V[], KPP_REAL F[], int NCOEFF, int JCOEFF[],
+                   KPP_REAL DFDR[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    V, F   - concentrations of variable and fixed species
+    JCOEFF - the indices of the NCOEFF reactions (rate coefficients)
+             with respect to which we differentiate
+    DFDR   - column j, DFDR[j*NVAR:j*NVAR+NVAR-1], holds
+             d Fun(0:NVAR-1) / d RCONST(JCOEFF[j])
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL ARP[NREACT], aj;
+int i, j, k;
+
+  ReactantProd( V, F, ARP );
+
+  for( j = 0; j < NCOEFF; j++ ) {
+    for( i = 0; i < NVAR; i++ )
+      DFDR[j*NVAR+i] = (KPP_REAL)0.0;
+    aj = ARP[ JCOEFF[j] ];
+    for( k = CCOL_STOICM[JCOEFF[j]]; k < CCOL_STOICM[JCOEFF[j]+1]; k++ )
+      DFDR[ j*NVAR+IROW_STOICM[k] ] = STOICM[k]*aj;
+  }
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int dFun_dRcoeff_SP( KPP_REAL V[], KPP_REAL F[], int NCOEFF, int JCOEFF[],
+                     int CROW_DFDR[], int ICOL_DFDR[], KPP_REAL DFDR[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    The derivatives of dFun_dRcoeff, compressed by rows: row j holds
+    the nonzeros of d Fun / d RCONST(JCOEFF[j]), in
+    DFDR[CROW_DFDR[j]:CROW_DFDR[j+1]-1], for the species
+    ICOL_DFDR[CROW_DFDR[j]:CROW_DFDR[j+1]-1].  CROW_DFDR has NCOEFF+1
+    entries; ICOL_DFDR and DFDR need at most NSTOICM (fewer for
+    fewer coefficients).  Returns the number of nonzeros
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL ARP[NREACT], aj;
+int j, k, nz;
+
+  ReactantProd( V, F, ARP );
+
+  nz = 0;
+  for( j = 0; j < NCOEFF; j++ ) {
+    CROW_DFDR[j] = nz;
+    aj = ARP[ JCOEFF[j] ];
+    for( k = CCOL_STOICM[JCOEFF[j]]; k < CCOL_STOICM[JCOEFF[j]+1]; k++ ) {
+      ICOL_DFDR[nz] = IROW_STOICM[k];
+      DFDR[nz++]    = STOICM[k]*aj;
+    }
+  }
+  CROW_DFDR[NCOEFF] = nz;
+  return nz;
+}
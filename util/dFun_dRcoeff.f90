@@ -23,25 +23,67 @@
 
 ! Local vector with reactant products
       KPP_REAL A_RPROD(NREACT)
-      KPP_REAL aj
-      INTEGER i,j,k
+      INTEGER j,k1,k2
       
 ! Compute the reactant products of all reactions     
       CALL ReactantProd ( V, F, A_RPROD )
 
 ! Compute the derivatives by multiplying column JCOEFF(j) of the stoichiometric matrix with A_RPROD       
       DO j=1,NCOEFF
-!                  Initialize the j-th column of derivative matrix to zero       
-         DO i=1,NVAR
-           DFDR(i+NVAR*(j-1)) = 0.0_dp 
-         END DO
 !                  Column JCOEFF(j) in the stoichiometric matrix times the
 !                  reactant product  of the JCOEFF(j)-th reaction      
 !                  give the j-th column of the derivative matrix   
-         aj = A_RPROD(JCOEFF(j))
-         DO k=CCOL_STOICM(JCOEFF(j)),CCOL_STOICM(JCOEFF(j)+1)-1
-           DFDR(IROW_STOICM(k)+NVAR*(j-1)) = STOICM(k)*aj
-         END DO
+         k1 = CCOL_STOICM(JCOEFF(j))
+         k2 = CCOL_STOICM(JCOEFF(j)+1)-1
+         DFDR(NVAR*(j-1)+1:NVAR*j) = 0.0_dp
+         DFDR(IROW_STOICM(k1:k2)+NVAR*(j-1)) = STOICM(k1:k2)*A_RPROD(JCOEFF(j))
       END DO
       
       END SUBROUTINE  dFun_dRcoeff
+
+
+! ------------------------------------------------------------------------------
+! Derivative of Fun with respect to rate coefficients, compressed by rows:
+! row j holds the nonzeros of d Fun / d RCT( JCOEFF(j) )
+! -----------------------------------------------------------------------------
+
+      SUBROUTINE  dFun_dRcoeff_SP( V, F, NCOEFF, JCOEFF, CROW_DFDR, ICOL_DFDR, DFDR, NZ )
+       
+      USE KPP_ROOT_Parameters
+      USE KPP_ROOT_StoichiomSP
+      IMPLICIT NONE 
+
+! V - Concentrations of variable/radical/fixed species            
+      KPP_REAL V(NVAR), F(NFIX)
+! NCOEFF - the number of rate coefficients with respect to which we differentiate
+      INTEGER NCOEFF       
+! JCOEFF - a vector of integers containing the indices of reactions (rate
+!          coefficients) with respect to which we differentiate
+      INTEGER JCOEFF(NCOEFF)       
+! CROW_DFDR, ICOL_DFDR, DFDR - the derivatives compressed by rows:
+!          DFDR(CROW_DFDR(j):CROW_DFDR(j+1)-1) are the nonzeros of
+!          d Fun / d RCT( JCOEFF(j) ) for the species ICOL_DFDR(same range)
+! NZ     - the number of nonzeros (at most NSTOICM)
+      INTEGER CROW_DFDR(NCOEFF+1), ICOL_DFDR(NSTOICM), NZ
+      KPP_REAL DFDR(NSTOICM)
+
+! Local vector with reactant products
+      KPP_REAL A_RPROD(NREACT)
+      INTEGER j,k1,k2,n
+      
+! Compute the reactant products of all reactions     
+      CALL ReactantProd ( V, F, A_RPROD )
+
+      NZ = 0
+      DO j=1,NCOEFF
+         CROW_DFDR(j) = NZ+1
+         k1 = CCOL_STOICM(JCOEFF(j))
+         k2 = CCOL_STOICM(JCOEFF(j)+1)-1
+         n  = k2-k1+1
+         ICOL_DFDR(NZ+1:NZ+n) = IROW_STOICM(k1:k2)
+         DFDR(NZ+1:NZ+n) = STOICM(k1:k2)*A_RPROD(JCOEFF(j))
+         NZ = NZ+n
+      END DO
+      CROW_DFDR(NCOEFF+1) = NZ+1
+      
+      END SUBROUTINE  dFun_dRcoeff_SP
@@ -0,0 +1,83 @@
+/*--------------------------------------------------------------
+
+  Derivatives of Jac with respect to rate coefficients, times a
+  user vector U
+
+  d Jac / d RCONST(r) is the outer product of column r of the
+  stoichiometric matrix with row r of JVRP, the Jacobian of the
+  reactant products.  Times U it is that column scaled by the
+  sparse dot product JVRP(r,:) * U, so the nonzeros are those of
+  dFun_dRcoeff.
+
+--------------------------------------------------------------*/
+
+void JacReactantProd( KPP_REAL V[], KPP_REAL F[], KPP_REAL JVRP[] );
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void dJac_dRcoeff( KPP_REAL V[], KPP_REAL F[], KPP_REAL U[], int NCOEFF,
+                   int JCOEFF[], KPP_REAL DJDR[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    V, F   - concentrations of variable and fixed species
+    U      - user-supplied vector
+    JCOEFF - the indices of the NCOEFF reactions (rate coefficients)
+             with respect to which we differentiate
+    DJDR   - column j, DJDR[j*NVAR:j*NVAR+NVAR-1], holds
+             d Jac / d RCONST(JCOEFF[j]) * U
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL JVRP[NJVRP], aj;
+int i, j, k;
+
+  JacReactantProd( V, F, JVRP );
+
+  for( j = 0; j < NCOEFF; j++ ) {
+    for( i = 0; i < NVAR; i++ )
+      DJDR[j*NVAR+i] = (KPP_REAL)0.0;
+    aj = (KPP_REAL)0.0;
+    for( k = CROW_JVRP[JCOEFF[j]]; k < CROW_JVRP[JCOEFF[j]+1]; k++ )
+      aj += JVRP[k]*U[ ICOL_JVRP[k] ];
+    for( k = CCOL_STOICM[JCOEFF[j]]; k < CCOL_STOICM[JCOEFF[j]+1]; k++ )
+      DJDR[ j*NVAR+IROW_STOICM[k] ] = STOICM[k]*aj;
+  }
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int dJac_dRcoeff_SP( KPP_REAL V[], KPP_REAL F[], int NU, KPP_REAL U[],
+                     int NCOEFF, int JCOEFF[], int CROW_DJDR[],
+                     int ICOL_DJDR[], KPP_REAL DJDR[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    d Jac / d RCONST(JCOEFF[j]) times the NU vectors U at once, with
+    U[i*NU+d] component i of vector d, compressed by rows as in
+    dFun_dRcoeff_SP: the product for nonzero CROW_DJDR[j] <= k <
+    CROW_DJDR[j+1], species ICOL_DJDR[k], and vector d is
+    DJDR[k*NU+d].  JacReactantProd is evaluated once for all the
+    coefficients and vectors.  Returns the number of nonzeros
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL JVRP[NJVRP], aj[NU], s;
+KPP_REAL *Ui;
+int j, k, d, nz;
+
+  JacReactantProd( V, F, JVRP );
+
+  nz = 0;
+  for( j = 0; j < NCOEFF; j++ ) {
+    CROW_DJDR[j] = nz;
+    for( d = 0; d < NU; d++ )
+      aj[d] = (KPP_REAL)0.0;
+    for( k = CROW_JVRP[JCOEFF[j]]; k < CROW_JVRP[JCOEFF[j]+1]; k++ ) {
+      s  = JVRP[k];
+      Ui = &U[ ICOL_JVRP[k]*NU ];
+      for( d = 0; d < NU; d++ )
+        aj[d] += s*Ui[d];
+    }
+    for( k = CCOL_STOICM[JCOEFF[j]]; k < CCOL_STOICM[JCOEFF[j]+1]; k++ ) {
+      ICOL_DJDR[nz] = IROW_STOICM[k];
+      for( d = 0; d < NU; d++ )
+        DJDR[nz*NU+d] = STOICM[k]*aj[d];
+      nz++;
+    }
+  }
+  CROW_DJDR[NCOEFF] = nz;
+  return nz;
+}
@@ -27,30 +27,80 @@
 ! Local vector for Jacobian of reactant products
       KPP_REAL JV_RPROD(NJVRP)
       KPP_REAL aj
-      INTEGER i,j,k
+      INTEGER j,k1,k2
       
 ! Compute the Jacobian of all reactant products   
       CALL JacReactantProd( V, F, JV_RPROD )
 
 ! Compute the derivatives by multiplying column JCOEFF(j) of the stoichiometric matrix with A_PROD       
       DO j=1,NCOEFF
-!                  Initialize the j-th column of derivative matrix to zero       
-         DO i=1,NVAR
-           DJDR(i+NVAR*(j-1)) = 0.0_dp
-         END DO
-!                  Column JCOEFF(j) in the stoichiometric matrix times the
-!                  ( Gradient of reactant product of the JCOEFF(j)-th reaction X user vector )    
-!                  give the j-th column of the derivative matrix   
-!
 !          Row JCOEFF(j) of JV_RPROD times the user vector
-         aj = 0.0_dp
+         k1 = CROW_JVRP(JCOEFF(j))
+         k2 = CROW_JVRP(JCOEFF(j)+1)-1
+         aj = DOT_PRODUCT( JV_RPROD(k1:k2), U(ICOL_JVRP(k1:k2)) )
+!          Column JCOEFF(j) of Stoichiom. matrix times aj         
+         k1 = CCOL_STOICM(JCOEFF(j))
+         k2 = CCOL_STOICM(JCOEFF(j)+1)-1
+         DJDR(NVAR*(j-1)+1:NVAR*j) = 0.0_dp
+         DJDR(IROW_STOICM(k1:k2)+NVAR*(j-1)) = STOICM(k1:k2)*aj
+      END DO
+      
+      END SUBROUTINE  dJac_dRcoeff
+
+
+! ------------------------------------------------------------------------------
+! Derivative of Jac with respect to rate coefficients times NU user vectors,
+! compressed by rows as in dFun_dRcoeff_SP
+! -----------------------------------------------------------------------------
+
+      SUBROUTINE  dJac_dRcoeff_SP( V, F, NU, U, NCOEFF, JCOEFF, CROW_DJDR, ICOL_DJDR, DJDR, NZ )
+       
+      USE KPP_ROOT_Parameters
+      USE KPP_ROOT_StoichiomSP
+      IMPLICIT NONE 
+
+! V - Concentrations of variable/fixed species            
+      KPP_REAL V(NVAR), F(NFIX)
+! U - NU user-supplied vectors
+      INTEGER NU
+      KPP_REAL U(NVAR,NU)
+! NCOEFF - the number of rate coefficients with respect to which we differentiate
+      INTEGER NCOEFF       
+! JCOEFF - a vector of integers containing the indices of reactions (rate
+!          coefficients) with respect to which we differentiate
+      INTEGER JCOEFF(NCOEFF)       
+! CROW_DJDR, ICOL_DJDR, DJDR - the products compressed by rows:
+!          DJDR(k,1:NU), CROW_DJDR(j) <= k < CROW_DJDR(j+1), are the nonzeros of
+!          d Jac / d RCT( JCOEFF(j) ) * U(:,1:NU) for the species ICOL_DJDR(k)
+! NZ     - the number of nonzeros (at most NSTOICM)
+      INTEGER CROW_DJDR(NCOEFF+1), ICOL_DJDR(NSTOICM), NZ
+      KPP_REAL DJDR(NSTOICM,NU)
+
+! Local vector for Jacobian of reactant products
+      KPP_REAL JV_RPROD(NJVRP)
+      KPP_REAL aj(NU)
+      INTEGER j,k,k1,k2
+      
+! Compute the Jacobian of all reactant products   
+      CALL JacReactantProd( V, F, JV_RPROD )
+
+      NZ = 0
+      DO j=1,NCOEFF
+         CROW_DJDR(j) = NZ+1
+!          Row JCOEFF(j) of JV_RPROD times the user vectors
+         aj(1:NU) = 0.0_dp
          DO k=CROW_JVRP(JCOEFF(j)),CROW_JVRP(JCOEFF(j)+1)-1
-             aj = aj + JV_RPROD(k)*U(ICOL_JVRP(k))
+           aj(1:NU) = aj(1:NU) + JV_RPROD(k)*U(ICOL_JVRP(k),1:NU)
          END DO
 !          Column JCOEFF(j) of Stoichiom. matrix times aj         
-         DO k=CCOL_STOICM(JCOEFF(j)),CCOL_STOICM(JCOEFF(j)+1)-1
-           DJDR(IROW_STOICM(k)+NVAR*(j-1)) = STOICM(k)*aj
+         k1 = CCOL_STOICM(JCOEFF(j))
+         k2 = CCOL_STOICM(JCOEFF(j)+1)-1
+         DO k=k1,k2
+           NZ = NZ+1
+           ICOL_DJDR(NZ) = IROW_STOICM(k)
+           DJDR(NZ,1:NU) = STOICM(k)*aj(1:NU)
          END DO
       END DO
+      CROW_DJDR(NCOEFF+1) = NZ+1
       
-      END SUBROUTINE  dJac_dRcoeff
+      END SUBROUTINE  dJac_dRcoeff_SP
@@ -0,0 +1,389 @@
+/*--------------------------------------------------------------
+
+  Preconditioned Krylov solvers for the linear systems of the
+  implicit integrators
+
+     ( Shift*I - JVS ) X = B
+
+  with JVS the sparse Jacobian (LU storage, see Jac_SP) and Shift
+  = 1/(h*gamma), real or complex.  The matrix is applied through
+  Jac_SP_Vec, so the fill-in positions of the LU storage are never
+  touched.  The preconditioner Prec is an incomplete factorization
+  ILU(0) of Shift*I - JVS that keeps its nonzero pattern (KppILU0);
+  it is applied with KppSolve and may be reused over several steps.
+
+  Method = 1: restarted GMRES(KRYLOV_M)
+         = 2: BiCGStab
+  both right-preconditioned, so the residual monitored is the true
+  one.  The system is scaled by W (e.g. h*gamma/(AbsTol+RelTol*|Y|))
+  and the iteration stops when the RMS norm of W*(B - A*X) is below
+  Tol, or after KRYLOV_MAXIT iterations.
+
+  Y. Saad, "Iterative methods for sparse linear systems", SIAM 2003.
+
+--------------------------------------------------------------*/
+
+#define KRYLOV_M       20     /* GMRES restart length            */
+#define KRYLOV_MAXIT   100    /* Max. no. of iterations per solve */
+
+void Jac_SP_Vec( KPP_REAL JVS[], KPP_REAL UV[], KPP_REAL JUV[] );
+void KppSolve( KPP_REAL JVS[], KPP_REAL X[] );
+void KppSolveCmplxR( KPP_REAL JVSR[], KPP_REAL JVSI[], KPP_REAL XR[], KPP_REAL XI[] );
+
+typedef struct {
+  int       Cmplx;            /* complex system: vectors are [XR, XI] */
+  KPP_REAL  ShiftR, ShiftI;
+  KPP_REAL *JVS, *PrecR, *PrecI, *W;
+} KPP_KRYLOV;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int KppILU0( KPP_REAL JVS[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Incomplete LU factorization ILU(0), in place: as KppDecomp, but
+    only the nonzero entries of JVS are updated; the fill-in positions
+    stay zero.  Returns 0, or k+1 for a zero pivot in row k
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL W[KPP_NVAR];
+char Nz[KPP_NVAR];
+KPP_REAL a;
+int k, kk, j, jj;
+
+  for( k = 0; k < KPP_NVAR; k++ ) {
+    for( kk = LU_CROW[k]; kk < LU_CROW[k+1]; kk++ ) {
+      W[ LU_ICOL[kk] ] = JVS[kk];
+      Nz[ LU_ICOL[kk] ] = ( JVS[kk] != 0.0 );
+    }
+    for( kk = LU_CROW[k]; kk < LU_DIAG[k]; kk++ ) {
+      j = LU_ICOL[kk];
+      if( !Nz[j] ) continue;
+      a = -W[j] / JVS[ LU_DIAG[j] ];
+      W[j] = -a;
+      for( jj = LU_DIAG[j]+1; jj < LU_CROW[j+1]; jj++ )
+        if( Nz[ LU_ICOL[jj] ] ) W[ LU_ICOL[jj] ] += a*JVS[jj];
+    }
+    for( kk = LU_CROW[k]; kk < LU_CROW[k+1]; kk++ )
+      JVS[kk] = W[ LU_ICOL[kk] ];
+    if( JVS[ LU_DIAG[k] ] == 0.0 ) return k+1;
+  }
+  return 0;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int KppILU0CmplxR( KPP_REAL JVSR[], KPP_REAL JVSI[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    ILU(0) of the complex matrix JVSR + i*JVSI, see KppDecompCmplxR
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL WR[KPP_NVAR], WI[KPP_NVAR];
+char Nz[KPP_NVAR];
+KPP_REAL ar, ai, den;
+int k, kk, j, jj, l;
+
+  for( k = 0; k < KPP_NVAR; k++ ) {
+    for( kk = LU_CROW[k]; kk < LU_CROW[k+1]; kk++ ) {
+      WR[ LU_ICOL[kk] ] = JVSR[kk];
+      WI[ LU_ICOL[kk] ] = JVSI[kk];
+      Nz[ LU_ICOL[kk] ] = ( JVSR[kk] != 0.0 ) || ( JVSI[kk] != 0.0 );
+    }
+    for( kk = LU_CROW[k]; kk < LU_DIAG[k]; kk++ ) {
+      j = LU_ICOL[kk];
+      if( !Nz[j] ) continue;
+      den = JVSR[LU_DIAG[j]]*JVSR[LU_DIAG[j]] + JVSI[LU_DIAG[j]]*JVSI[LU_DIAG[j]];
+      ar = -(WR[j]*JVSR[LU_DIAG[j]] + WI[j]*JVSI[LU_DIAG[j]])/den;
+      ai = -(WI[j]*JVSR[LU_DIAG[j]] - WR[j]*JVSI[LU_DIAG[j]])/den;
+      WR[j] = -ar;
+      WI[j] = -ai;
+      for( jj = LU_DIAG[j]+1; jj < LU_CROW[j+1]; jj++ ) {
+        l = LU_ICOL[jj];
+        if( !Nz[l] ) continue;
+        WR[l] = WR[l] + ar*JVSR[jj] - ai*JVSI[jj];
+        WI[l] = WI[l] + ar*JVSI[jj] + ai*JVSR[jj];
+      }
+    }
+    for( kk = LU_CROW[k]; kk < LU_CROW[k+1]; kk++ ) {
+      JVSR[kk] = WR[ LU_ICOL[kk] ];
+      JVSI[kk] = WI[ LU_ICOL[kk] ];
+    }
+    if( (JVSR[ LU_DIAG[k] ] == 0.0) && (JVSI[ LU_DIAG[k] ] == 0.0) ) return k+1;
+  }
+  return 0;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static void KrylovAmul( KPP_KRYLOV *K, KPP_REAL X[], KPP_REAL Y[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Y <- D*(Shift*I - JVS)*D^{-1}*X, with D = diag(W)
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL T[KPP_NVAR], JT[KPP_NVAR];
+int i, p;
+
+  for( p = 0; p <= K->Cmplx; p++ ) {
+    for( i = 0; i < KPP_NVAR; i++ )
+      T[i] = X[p*KPP_NVAR+i] / K->W[i];
+    Jac_SP_Vec( K->JVS, T, JT );
+    for( i = 0; i < KPP_NVAR; i++ )
+      Y[p*KPP_NVAR+i] = K->ShiftR*X[p*KPP_NVAR+i] - K->W[i]*JT[i];
+  }
+  if( K->Cmplx )
+    for( i = 0; i < KPP_NVAR; i++ ) {
+      Y[i]          -= K->ShiftI*X[KPP_NVAR+i];
+      Y[KPP_NVAR+i] += K->ShiftI*X[i];
+    }
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static void KrylovPrec( KPP_KRYLOV *K, KPP_REAL X[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    X <- D*Prec^{-1}*D^{-1}*X
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+int i;
+
+  for( i = 0; i < KPP_NVAR; i++ ) {
+    X[i] /= K->W[i];
+    if( K->Cmplx ) X[KPP_NVAR+i] /= K->W[i];
+  }
+  if( K->Cmplx )
+    KppSolveCmplxR( K->PrecR, K->PrecI, X, &X[KPP_NVAR] );
+  else
+    KppSolve( K->PrecR, X );
+  for( i = 0; i < KPP_NVAR; i++ ) {
+    X[i] *= K->W[i];
+    if( K->Cmplx ) X[KPP_NVAR+i] *= K->W[i];
+  }
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static KPP_REAL KrylovDot( int N, KPP_REAL X[], KPP_REAL Y[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL s = 0.0;
+int i;
+
+  for( i = 0; i < N; i++ )
+    s += X[i]*Y[i];
+  return s;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static int KrylovFinite( KPP_REAL x )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    False for NaN and Inf, which otherwise fail every "> Tol" test
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+  return ( x == x ) && ( x - x == 0.0 );
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static int KrylovGMRES( KPP_KRYLOV *K, int N, KPP_REAL B[], KPP_REAL Tol, int *Nit )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Right-preconditioned GMRES(KRYLOV_M) for the scaled system, with
+    modified Gram-Schmidt and Givens rotations.  B: right-hand side
+    on input, solution on output.  Returns 0 if converged, 1 if not
+    or on a non-finite residual
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL V[(KRYLOV_M+1)*N], X[N], U[N];
+KPP_REAL Hm[KRYLOV_M+1][KRYLOV_M], Cs[KRYLOV_M], Sn[KRYLOV_M], G[KRYLOV_M+1];
+KPP_REAL beta, h, t;
+int i, j, m, restart;
+
+  Tol = Tol*sqrt((KPP_REAL)N);
+  for( i = 0; i < N; i++ ) X[i] = 0.0;
+
+  for( restart = 0; ; restart++ ) {
+
+    /* r = B - A*X */
+    if( restart == 0 ) {
+      for( i = 0; i < N; i++ ) V[i] = B[i];
+    } else {
+      KrylovAmul( K, X, V );
+      for( i = 0; i < N; i++ ) V[i] = B[i] - V[i];
+    }
+    beta = sqrt( KrylovDot( N, V, V ) );
+    if( !KrylovFinite( beta ) ) return 1;
+    if( beta <= Tol ) break;
+    if( *Nit >= KRYLOV_MAXIT ) return 1;
+
+    for( i = 0; i < N; i++ ) V[i] /= beta;
+    G[0] = beta;
+
+    for( m = 0; (m < KRYLOV_M) && (*Nit < KRYLOV_MAXIT); ) {
+      /* V(m+1) = A*M^{-1}*V(m), orthogonalized against V(0:m) */
+      for( i = 0; i < N; i++ ) U[i] = V[m*N+i];
+      KrylovPrec( K, U );
+      KrylovAmul( K, U, &V[(m+1)*N] );
+      for( j = 0; j <= m; j++ ) {
+        Hm[j][m] = KrylovDot( N, &V[(m+1)*N], &V[j*N] );
+        for( i = 0; i < N; i++ ) V[(m+1)*N+i] -= Hm[j][m]*V[j*N+i];
+      }
+      h = sqrt( KrylovDot( N, &V[(m+1)*N], &V[(m+1)*N] ) );
+      if( h > 0.0 )
+        for( i = 0; i < N; i++ ) V[(m+1)*N+i] /= h;
+      Hm[m+1][m] = h;
+
+      /* Least squares problem: Givens rotations */
+      for( j = 0; j < m; j++ ) {
+        t          =  Cs[j]*Hm[j][m] + Sn[j]*Hm[j+1][m];
+        Hm[j+1][m] = -Sn[j]*Hm[j][m] + Cs[j]*Hm[j+1][m];
+        Hm[j][m]   = t;
+      }
+      t = sqrt( Hm[m][m]*Hm[m][m] + h*h );
+      Cs[m] = Hm[m][m]/t;
+      Sn[m] = h/t;
+      Hm[m][m] = t;
+      G[m+1] = -Sn[m]*G[m];
+      G[m]   =  Cs[m]*G[m];
+
+      m++;
+      (*Nit)++;
+      if( !KrylovFinite( G[m] ) ) return 1;
+      if( (fabs(G[m]) <= Tol) || (h == 0.0) ) break;
+    }
+
+    /* X = X + M^{-1}*V(0:m-1)*y, with Hm(0:m-1,0:m-1)*y = G(0:m-1) */
+    for( j = m-1; j >= 0; j-- ) {
+      t = G[j];
+      for( i = j+1; i < m; i++ ) t -= Hm[j][i]*G[i];
+      G[j] = t/Hm[j][j];
+    }
+    for( i = 0; i < N; i++ ) U[i] = 0.0;
+    for( j = 0; j < m; j++ )
+      for( i = 0; i < N; i++ ) U[i] += G[j]*V[j*N+i];
+    KrylovPrec( K, U );
+    for( i = 0; i < N; i++ ) X[i] += U[i];
+  }
+
+  for( i = 0; i < N; i++ ) B[i] = X[i];
+  return 0;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static int KrylovBiCGStab( KPP_KRYLOV *K, int N, KPP_REAL B[], KPP_REAL Tol, int *Nit )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Right-preconditioned BiCGStab for the scaled system.  B: right-hand
+    side on input, solution on output.  Returns 0 if converged, 1 if
+    not, on breakdown or on a non-finite residual
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL X[N], R[N], R0[N], P[N], Ph[N], S[N], Sh[N], V[N], T[N];
+KPP_REAL rho, rho1, alpha, omega, beta, tt, rv, rn;
+int i;
+
+  Tol = Tol*sqrt((KPP_REAL)N);
+  for( i = 0; i < N; i++ ) {
+    X[i] = 0.0;
+    R[i] = R0[i] = B[i];
+    P[i] = V[i] = 0.0;
+  }
+  rho = alpha = omega = 1.0;
+
+  for( ;; ) {
+    rn = sqrt( KrylovDot( N, R, R ) );
+    if( !KrylovFinite( rn ) ) return 1;
+    if( rn <= Tol ) break;
+    if( *Nit >= KRYLOV_MAXIT ) return 1;
+    (*Nit)++;
+
+    rho1 = KrylovDot( N, R0, R );
+    if( rho1 == 0.0 ) return 1;
+    beta = (rho1/rho)*(alpha/omega);
+    rho = rho1;
+    for( i = 0; i < N; i++ ) Ph[i] = P[i] = R[i] + beta*(P[i] - omega*V[i]);
+    KrylovPrec( K, Ph );
+    KrylovAmul( K, Ph, V );
+    rv = KrylovDot( N, R0, V );
+    if( rv == 0.0 ) return 1;
+    alpha = rho/rv;
+    for( i = 0; i < N; i++ ) Sh[i] = S[i] = R[i] - alpha*V[i];
+    rn = sqrt( KrylovDot( N, S, S ) );
+    if( !KrylovFinite( rn ) ) return 1;
+    if( rn <= Tol ) {
+      for( i = 0; i < N; i++ ) X[i] += alpha*Ph[i];
+      break;
+    }
+    KrylovPrec( K, Sh );
+    KrylovAmul( K, Sh, T );
+    tt = KrylovDot( N, T, T );
+    if( tt == 0.0 ) return 1;
+    omega = KrylovDot( N, T, S )/tt;
+    for( i = 0; i < N; i++ ) {
+      X[i] += alpha*Ph[i] + omega*Sh[i];
+      R[i] = S[i] - omega*T[i];
+    }
+  }
+
+  for( i = 0; i < N; i++ ) B[i] = X[i];
+  return 0;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int KppKrylov( int Method, KPP_REAL Shift, KPP_REAL JVS[], KPP_REAL Prec[],
+               KPP_REAL W[], KPP_REAL Tol, KPP_REAL X[], int *Nit )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Solves (Shift*I - JVS)*X = B.  X: B on input, the solution on
+    output (as in KppSolve).  Nit is incremented by the number of
+    iterations.  Returns 0 if the solve converged
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_KRYLOV K;
+int i, ierr, it = 0;
+
+  K.Cmplx  = 0;
+  K.ShiftR = Shift;
+  K.ShiftI = 0.0;
+  K.JVS    = JVS;
+  K.PrecR  = Prec;
+  K.PrecI  = 0;
+  K.W      = W;
+
+  for( i = 0; i < KPP_NVAR; i++ ) X[i] *= W[i];
+  if( Method == 2 )
+    ierr = KrylovBiCGStab( &K, KPP_NVAR, X, Tol, &it );
+  else
+    ierr = KrylovGMRES( &K, KPP_NVAR, X, Tol, &it );
+  for( i = 0; i < KPP_NVAR; i++ ) X[i] /= W[i];
+
+  *Nit += it;
+  return ierr;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int KppKrylovCmplxR( int Method, KPP_REAL ShiftR, KPP_REAL ShiftI, KPP_REAL JVS[],
+               KPP_REAL PrecR[], KPP_REAL PrecI[], KPP_REAL W[], KPP_REAL Tol,
+               KPP_REAL XR[], KPP_REAL XI[], int *Nit )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Complex version of KppKrylov: ((ShiftR + i*ShiftI)*I - JVS)*X = B,
+    X = XR + i*XI, preconditioned by the complex ILU(0) PrecR + i*PrecI
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_KRYLOV K;
+KPP_REAL X[2*KPP_NVAR];
+int i, ierr, it = 0;
+
+  K.Cmplx  = 1;
+  K.ShiftR = ShiftR;
+  K.ShiftI = ShiftI;
+  K.JVS    = JVS;
+  K.PrecR  = PrecR;
+  K.PrecI  = PrecI;
+  K.W      = W;
+
+  for( i = 0; i < KPP_NVAR; i++ ) {
+    X[i]          = XR[i]*W[i];
+    X[KPP_NVAR+i] = XI[i]*W[i];
+  }
+  if( Method == 2 )
+    ierr = KrylovBiCGStab( &K, 2*KPP_NVAR, X, Tol, &it );
+  else
+    ierr = KrylovGMRES( &K, 2*KPP_NVAR, X, Tol, &it );
+  for( i = 0; i < KPP_NVAR; i++ ) {
+    XR[i] = X[i]/W[i];
+    XI[i] = X[KPP_NVAR+i]/W[i];
+  }
+
+  *Nit += it;
+  return ierr;
+}
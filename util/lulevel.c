@@ -0,0 +1,205 @@
+/*--------------------------------------------------------------
+
+  Level-scheduled sparse LU factorization and substitutions
+
+  KPP sorts the rows of the LU factorization into levels
+  (LU_LEVROW, LU_LEVPTR): the elimination of a row needs only
+  rows of lower levels, so the rows of one level are independent.
+  The forward substitution has the same levels, the back
+  substitution its own (LU_BLEVROW, LU_BLEVPTR).  KppDecompLev
+  and KppSolveLev process the levels in order on the threads of
+  an OpenMP parallel region; a run of consecutive levels with
+  fewer than KPP_LEV_MINROWS rows is done by one thread, without
+  barriers.  The results are identical to KppDecomp / KppSolve.
+
+  The serial KppDecomp and KppSolve are called instead without
+  OpenMP, with one thread, from inside a parallel region (e.g.
+  one box per thread) and for less than KPP_LEV_MINVAR variables.
+
+--------------------------------------------------------------*/
+#ifndef KPP_LEV_MINVAR
+#define KPP_LEV_MINVAR   500    /* Min. no. of variables for the threaded path */
+#endif
+#ifndef KPP_LEV_MINROWS
+#define KPP_LEV_MINROWS  16     /* Min. no. of rows of a level shared by threads */
+#endif
+
+int  KppDecomp( KPP_REAL JVS[] );
+void KppSolve( KPP_REAL JVS[], KPP_REAL X[] );
+
+#ifdef _OPENMP
+#include <omp.h>
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static int KppLevThreads( void )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    True if the threaded path is worth taking
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+  return ( KPP_NVAR >= KPP_LEV_MINVAR ) && !omp_in_parallel()
+         && ( omp_get_max_threads() > 1 );
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static int KppLevRows( int Back, int l )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    No. of rows of level l (Back: of the back substitution)
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+  return Back ? LU_BLEVPTR[l+1]-LU_BLEVPTR[l] : LU_LEVPTR[l+1]-LU_LEVPTR[l];
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static int KppLevEnd( int Back, int l )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Level after l: l+1 for a level shared by the threads, else the
+    end of the run of small levels starting at l
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+int nlev = Back ? LU_NBLEV : LU_NLEV;
+
+  if( KppLevRows( Back, l ) >= KPP_LEV_MINROWS ) return l+1;
+  do l++; while( ( l < nlev ) && ( KppLevRows( Back, l ) < KPP_LEV_MINROWS ) );
+  return l;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static void KppDecompRow( KPP_REAL JVS[], KPP_REAL W[], int k )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Elimination of row k, as in KppDecomp
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL a;
+int kk, j, jj;
+
+  if( LU_CROW[k] == LU_DIAG[k] ) return; /* no L part */
+  for( kk = LU_CROW[k]; kk < LU_CROW[k+1]; kk++ )
+    W[ LU_ICOL[kk] ] = JVS[kk];
+  for( kk = LU_CROW[k]; kk < LU_DIAG[k]; kk++ ) {
+    j = LU_ICOL[kk];
+    a = -W[j] / JVS[ LU_DIAG[j] ];
+    W[j] = -a;
+    for( jj = LU_DIAG[j]+1; jj < LU_CROW[j+1]; jj++ )
+      W[ LU_ICOL[jj] ] += a*JVS[jj];
+  }
+  for( kk = LU_CROW[k]; kk < LU_CROW[k+1]; kk++ )
+    JVS[kk] = W[ LU_ICOL[kk] ];
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int KppDecompLev( KPP_REAL JVS[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Sparse LU factorization in place, threaded over the rows of each
+    level.  Returns 0, or k+1 for a zero pivot in row k
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+int k;
+
+  if( !KppLevThreads() ) return KppDecomp( JVS );
+
+#pragma omp parallel
+  {
+    KPP_REAL W[KPP_NVAR];
+    int l, l1, r;
+
+    for( l = 0; l < LU_NLEV; l = l1 ) {
+      l1 = KppLevEnd( 0, l );
+      if( KppLevRows( 0, l ) >= KPP_LEV_MINROWS ) {
+#pragma omp for schedule(dynamic,4)
+        for( r = LU_LEVPTR[l]; r < LU_LEVPTR[l+1]; r++ )
+          KppDecompRow( JVS, W, LU_LEVROW[r] );
+      } else {
+#pragma omp single
+        for( r = LU_LEVPTR[l]; r < LU_LEVPTR[l1]; r++ )
+          KppDecompRow( JVS, W, LU_LEVROW[r] );
+      }
+    }
+  }
+
+  for( k = 0; k < KPP_NVAR; k++ )
+    if( JVS[ LU_DIAG[k] ] == 0.0 ) return k+1;
+  return 0;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static void KppSolveRowL( KPP_REAL JVS[], KPP_REAL X[], int i )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL sum = X[i];
+int j;
+
+  for( j = LU_CROW[i]; j < LU_DIAG[i]; j++ )
+    sum -= JVS[j]*X[ LU_ICOL[j] ];
+  X[i] = sum;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static void KppSolveRowU( KPP_REAL JVS[], KPP_REAL X[], int i )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL sum = X[i];
+int j;
+
+  for( j = LU_DIAG[i]+1; j < LU_CROW[i+1]; j++ )
+    sum -= JVS[j]*X[ LU_ICOL[j] ];
+  X[i] = sum / JVS[ LU_DIAG[i] ];
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void KppSolveLev( KPP_REAL JVS[], KPP_REAL X[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Forward and back substitution with the factor of KppDecompLev
+    (or KppDecomp), threaded over the rows of each level
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+  if( !KppLevThreads() ) {
+    KppSolve( JVS, X );
+    return;
+  }
+
+#pragma omp parallel
+  {
+    int l, l1, r;
+
+    for( l = 0; l < LU_NLEV; l = l1 ) {
+      l1 = KppLevEnd( 0, l );
+      if( KppLevRows( 0, l ) >= KPP_LEV_MINROWS ) {
+#pragma omp for schedule(static)
+        for( r = LU_LEVPTR[l]; r < LU_LEVPTR[l+1]; r++ )
+          KppSolveRowL( JVS, X, LU_LEVROW[r] );
+      } else {
+#pragma omp single
+        for( r = LU_LEVPTR[l]; r < LU_LEVPTR[l1]; r++ )
+          KppSolveRowL( JVS, X, LU_LEVROW[r] );
+      }
+    }
+
+    for( l = 0; l < LU_NBLEV; l = l1 ) {
+      l1 = KppLevEnd( 1, l );
+      if( KppLevRows( 1, l ) >= KPP_LEV_MINROWS ) {
+#pragma omp for schedule(static)
+        for( r = LU_BLEVPTR[l]; r < LU_BLEVPTR[l+1]; r++ )
+          KppSolveRowU( JVS, X, LU_BLEVROW[r] );
+      } else {
+#pragma omp single
+        for( r = LU_BLEVPTR[l]; r < LU_BLEVPTR[l1]; r++ )
+          KppSolveRowU( JVS, X, LU_BLEVROW[r] );
+      }
+    }
+  }
+}
+
+#else
+
+/*~~~> Without OpenMP: the serial factorization and substitutions */
+int KppDecompLev( KPP_REAL JVS[] )
+{
+  return KppDecomp( JVS );
+}
+
+void KppSolveLev( KPP_REAL JVS[], KPP_REAL X[] )
+{
+  KppSolve( JVS, X );
+}
+
+#endif
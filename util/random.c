@@ -0,0 +1,196 @@
+/*--------------------------------------------------------------
+
+  Reproducible random number streams for the stochastic solvers
+
+  Philox4x32-10 counter-based generator (Salmon et al., SC'11).
+  A stream is fully described by (seed, stream id, block counter):
+  every trajectory or thread owns a KPP_RNG and draws from its own
+  stream, so results do not depend on the order in which streams
+  are advanced.  Skipping ahead is an O(1) counter update.
+
+  The same streams are produced by the Fortran90 version.
+
+--------------------------------------------------------------*/
+
+#define KPP_PHILOX_M0   0xD2511F53U
+#define KPP_PHILOX_M1   0xCD9E8D57U
+#define KPP_PHILOX_W0   0x9E3779B9U
+#define KPP_PHILOX_W1   0xBB67AE85U
+#define KPP_RAND_2P26   67108864.0
+#define KPP_RAND_2M53   (1.0/9007199254740992.0)
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static void KppPhilox( unsigned int c0, unsigned int c1, unsigned int c2,
+                       unsigned int c3, unsigned int k0, unsigned int k1,
+                       unsigned int out[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    ten Philox rounds: out <- Philox4x32_10( counter=(c0..c3), key=(k0,k1) )
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+      unsigned long long p0, p1;
+      int r;
+
+      for ( r = 0; r < 10; r++ ) {
+        p0 = (unsigned long long)KPP_PHILOX_M0 * c0;
+        p1 = (unsigned long long)KPP_PHILOX_M1 * c2;
+        c0 = (unsigned int)(p1 >> 32) ^ c1 ^ k0;
+        c2 = (unsigned int)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (unsigned int)p1;
+        c3 = (unsigned int)p0;
+        k0 += KPP_PHILOX_W0;
+        k1 += KPP_PHILOX_W1;
+      }
+      out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void KppRandInit( KPP_RNG *rng, unsigned long seed, unsigned long stream )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    positions rng at the beginning of stream number "stream" of
+    generator "seed". Use e.g. the trajectory number as stream id.
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+      rng->key[0] = (unsigned int)(seed & 0xFFFFFFFFUL);
+      rng->key[1] = (unsigned int)(((seed >> 16) >> 16) & 0xFFFFFFFFUL);
+      rng->ctr[0] = 0;
+      rng->ctr[1] = 0;
+      rng->ctr[2] = (unsigned int)(stream & 0xFFFFFFFFUL);
+      rng->ctr[3] = (unsigned int)(((stream >> 16) >> 16) & 0xFFFFFFFFUL);
+      rng->pos = 4;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void KppRandSkip( KPP_RNG *rng, unsigned long nblocks )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    jumps ahead by nblocks blocks (2 uniforms per block) in O(1)
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+      unsigned long long c;
+
+      c = ((unsigned long long)rng->ctr[1] << 32) + rng->ctr[0] + nblocks;
+      rng->ctr[0] = (unsigned int)c;
+      rng->ctr[1] = (unsigned int)(c >> 32);
+      rng->pos = 4;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+static unsigned int KppRandWord( KPP_RNG *rng )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    next 32-bit word of the stream; a new block is generated every 4 words
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+      if ( rng->pos >= 4 ) {
+        KppPhilox( rng->ctr[0], rng->ctr[1], rng->ctr[2], rng->ctr[3],
+                   rng->key[0], rng->key[1], rng->buf );
+        if ( ++rng->ctr[0] == 0 ) rng->ctr[1]++;
+        rng->pos = 0;
+      }
+      return rng->buf[ rng->pos++ ];
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+KPP_REAL KppRandUniform( KPP_RNG *rng )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    uniform deviate in the open interval (0,1), 53 random bits
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+      unsigned int a, b;
+
+      a = KppRandWord( rng );
+      b = KppRandWord( rng );
+      return (KPP_REAL)( ((a >> 5)*KPP_RAND_2P26 + (b >> 6) + 0.5)*KPP_RAND_2M53 );
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+KPP_REAL KppRandExponential( KPP_RNG *rng )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    exponential deviate with unit mean
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+      return -log( KppRandUniform( rng ) );
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void KppRandUniformVec( KPP_RNG *rng, int n, KPP_REAL u[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    fills u[0..n-1] with uniform deviates in (0,1); the sequence is
+    identical to n calls of KppRandUniform. Whole blocks are computed
+    in a loop with independent iterations, which vectorizes
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+      unsigned long long c, cb;
+      unsigned int w[4];
+      int i, k, nb;
+
+      /* Use up the current block first */
+      for ( k = 0; (k < n) && (rng->pos < 4); k++ )
+        u[k] = KppRandUniform( rng );
+
+      nb = (n-k)/2;
+      c = ((unsigned long long)rng->ctr[1] << 32) + rng->ctr[0];
+      for ( i = 0; i < nb; i++ ) {
+        cb = c + i;
+        KppPhilox( (unsigned int)cb, (unsigned int)(cb >> 32),
+                   rng->ctr[2], rng->ctr[3], rng->key[0], rng->key[1], w );
+        u[k+2*i]   = (KPP_REAL)( ((w[0] >> 5)*KPP_RAND_2P26 + (w[1] >> 6) + 0.5)*KPP_RAND_2M53 );
+        u[k+2*i+1] = (KPP_REAL)( ((w[2] >> 5)*KPP_RAND_2P26 + (w[3] >> 6) + 0.5)*KPP_RAND_2M53 );
+      }
+      c += nb;
+      rng->ctr[0] = (unsigned int)c;
+      rng->ctr[1] = (unsigned int)(c >> 32);
+
+      for ( k += 2*nb; k < n; k++ )
+        u[k] = KppRandUniform( rng );
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void KppRandExponentialVec( KPP_RNG *rng, int n, KPP_REAL e[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    fills e[0..n-1] with exponential deviates with unit mean
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+      int i;
+
+      KppRandUniformVec( rng, n, e );
+      for ( i = 0; i < n; i++ )
+        e[i] = -log( e[i] );
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int KppRandPoisson( KPP_RNG *rng, KPP_REAL mu )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Poisson deviate with mean mu
+    mu < 10 : multiplication of uniforms
+    mu >= 10: transformed rejection PTRS (W. Hormann, 1993)
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+      double emu, prod, smu, b, a, invalpha, vr, lmu, U, V, us;
+      int k;
+
+      if ( mu <= 0.0 ) return 0;
+
+      if ( mu < 10.0 ) {
+        emu  = exp( -(double)mu );
+        prod = KppRandUniform( rng );
+        for ( k = 0; prod > emu; k++ )
+          prod *= KppRandUniform( rng );
+        return k;
+      }
+
+      smu = sqrt( (double)mu );
+      lmu = log( (double)mu );
+      b = 0.931 + 2.53*smu;
+      a = -0.059 + 0.02483*b;
+      invalpha = 1.1239 + 1.1328/(b-3.4);
+      vr = 0.9277 - 3.6224/(b-2.0);
+      while ( 1 ) {
+        U  = KppRandUniform( rng ) - 0.5;
+        V  = KppRandUniform( rng );
+        us = 0.5 - fabs(U);
+        k  = (int)floor( (2.0*a/us + b)*U + mu + 0.43 );
+        if ( (us >= 0.07) && (V <= vr) ) return k;
+        if ( (k < 0) || ((us < 0.013) && (V > us)) ) continue;
+        if ( log(V) + log(invalpha) - log(a/(us*us) + b)
+             <= -mu + k*lmu - lgamma(k + 1.0) ) return k;
+      }
+}
@@ -0,0 +1,225 @@
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!  Reproducible random number streams for the stochastic solvers
+!
+!  Philox4x32-10 counter-based generator (Salmon et al., SC'11).
+!  A stream is fully described by (seed, stream id, block counter):
+!  every trajectory or thread owns a TYPE(KPP_RNG) and draws from
+!  its own stream.  The streams are identical to the C version.
+!  The 32-bit words are held in INTEGER(kind=8) so that no
+!  intermediate result overflows.
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+SUBROUTINE KppMulHiLo( A, B, Hi, Lo )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        64-bit product of two 32-bit words, Hi:Lo = A*B
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      INTEGER(kind=8), INTENT(IN)  :: A, B
+      INTEGER(kind=8), INTENT(OUT) :: Hi, Lo
+      INTEGER(kind=8), PARAMETER :: M16 = 65535_8, M32 = 4294967295_8
+      INTEGER(kind=8) :: PL, PH, S
+
+      PL = A*IAND(B,M16)
+      PH = A*ISHFT(B,-16)
+      S  = PL + ISHFT(IAND(PH,M16),16)
+      Lo = IAND(S,M32)
+      Hi = IAND(ISHFT(S,-32) + ISHFT(PH,-16),M32)
+
+END SUBROUTINE KppMulHiLo
+
+
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+SUBROUTINE KppPhilox( Ctr, Key, Out )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        Out <- Philox4x32_10( Ctr, Key )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      INTEGER(kind=8), INTENT(IN)  :: Ctr(4), Key(2)
+      INTEGER(kind=8), INTENT(OUT) :: Out(4)
+      INTEGER(kind=8), PARAMETER :: M0 = 3528531795_8, M1 = 3449720151_8
+      INTEGER(kind=8), PARAMETER :: W0 = 2654435769_8, W1 = 3144134277_8
+      INTEGER(kind=8), PARAMETER :: M32 = 4294967295_8
+      INTEGER(kind=8) :: C(4), K(2), Hi0, Lo0, Hi1, Lo1
+      INTEGER :: r
+
+      C = Ctr
+      K = Key
+      DO r = 1, 10
+        CALL KppMulHiLo( M0, C(1), Hi0, Lo0 )
+        CALL KppMulHiLo( M1, C(3), Hi1, Lo1 )
+        C(1) = IEOR(IEOR(Hi1,C(2)),K(1))
+        C(3) = IEOR(IEOR(Hi0,C(4)),K(2))
+        C(2) = Lo1
+        C(4) = Lo0
+        K(1) = IAND(K(1)+W0,M32)
+        K(2) = IAND(K(2)+W1,M32)
+      END DO
+      Out = C
+
+END SUBROUTINE KppPhilox
+
+
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+SUBROUTINE KppRandInit( Rng, Seed, Stream )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        Positions Rng at the beginning of stream number Stream
+!        of generator Seed. Use e.g. the trajectory number as Stream.
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      TYPE(KPP_RNG), INTENT(OUT) :: Rng
+      INTEGER, INTENT(IN) :: Seed, Stream
+      INTEGER(kind=8), PARAMETER :: M32 = 4294967295_8
+
+      Rng%Key(1) = IAND(INT(Seed,8),M32)
+      Rng%Key(2) = IAND(ISHFT(INT(Seed,8),-32),M32)
+      Rng%Ctr(1) = 0
+      Rng%Ctr(2) = 0
+      Rng%Ctr(3) = IAND(INT(Stream,8),M32)
+      Rng%Ctr(4) = IAND(ISHFT(INT(Stream,8),-32),M32)
+      Rng%Buf    = 0
+      Rng%Pos    = 5
+
+END SUBROUTINE KppRandInit
+
+
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+SUBROUTINE KppRandSkip( Rng, Nblocks )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        Jumps ahead by Nblocks blocks (2 uniforms per block)
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      TYPE(KPP_RNG), INTENT(INOUT) :: Rng
+      INTEGER, INTENT(IN) :: Nblocks
+      INTEGER(kind=8), PARAMETER :: M32 = 4294967295_8
+      INTEGER(kind=8) :: S
+
+      S = Rng%Ctr(1) + INT(Nblocks,8)
+      Rng%Ctr(1) = IAND(S,M32)
+      Rng%Ctr(2) = IAND(Rng%Ctr(2) + ISHFT(S,-32),M32)
+      Rng%Pos    = 5
+
+END SUBROUTINE KppRandSkip
+
+
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+SUBROUTINE KppRandNextBlock( Rng )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        Generates the next block of 4 words and advances the counter
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      TYPE(KPP_RNG), INTENT(INOUT) :: Rng
+      INTEGER(kind=8), PARAMETER :: M32 = 4294967295_8
+
+      CALL KppPhilox( Rng%Ctr, Rng%Key, Rng%Buf )
+      Rng%Ctr(1) = IAND(Rng%Ctr(1)+1,M32)
+      IF ( Rng%Ctr(1) == 0 ) Rng%Ctr(2) = IAND(Rng%Ctr(2)+1,M32)
+      Rng%Pos = 1
+
+END SUBROUTINE KppRandNextBlock
+
+
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+KPP_REAL FUNCTION KppRandUniform( Rng )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        Uniform deviate in the open interval (0,1), 53 random bits
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      TYPE(KPP_RNG), INTENT(INOUT) :: Rng
+      REAL(kind=dp), PARAMETER :: TWO26 = 67108864.0_dp, &
+                                  TWOM53 = 1.0_dp/9007199254740992.0_dp
+
+      IF ( Rng%Pos > 4 ) CALL KppRandNextBlock( Rng )
+      KppRandUniform = ( REAL(ISHFT(Rng%Buf(Rng%Pos),-5),dp)*TWO26   &
+                       + REAL(ISHFT(Rng%Buf(Rng%Pos+1),-6),dp)       &
+                       + 0.5_dp )*TWOM53
+      Rng%Pos = Rng%Pos + 2
+
+END FUNCTION KppRandUniform
+
+
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+KPP_REAL FUNCTION KppRandExponential( Rng )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        Exponential deviate with unit mean
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      TYPE(KPP_RNG), INTENT(INOUT) :: Rng
+
+      KppRandExponential = -LOG( KppRandUniform(Rng) )
+
+END FUNCTION KppRandExponential
+
+
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+SUBROUTINE KppRandUniformVec( Rng, N, U )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        Fills U(1:N) with uniform deviates in (0,1); the sequence
+!        is identical to N calls of KppRandUniform
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      TYPE(KPP_RNG), INTENT(INOUT) :: Rng
+      INTEGER, INTENT(IN) :: N
+      KPP_REAL, INTENT(OUT) :: U(N)
+      INTEGER :: i
+
+      DO i = 1, N
+        U(i) = KppRandUniform( Rng )
+      END DO
+
+END SUBROUTINE KppRandUniformVec
+
+
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+SUBROUTINE KppRandExponentialVec( Rng, N, E )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        Fills E(1:N) with exponential deviates with unit mean
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      TYPE(KPP_RNG), INTENT(INOUT) :: Rng
+      INTEGER, INTENT(IN) :: N
+      KPP_REAL, INTENT(OUT) :: E(N)
+
+      CALL KppRandUniformVec( Rng, N, E )
+      E(1:N) = -LOG( E(1:N) )
+
+END SUBROUTINE KppRandExponentialVec
+
+
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+INTEGER FUNCTION KppRandPoisson( Rng, Mu )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        Poisson deviate with mean Mu
+!        Mu < 10 : multiplication of uniforms
+!        Mu >= 10: transformed rejection PTRS (W. Hormann, 1993)
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+      TYPE(KPP_RNG), INTENT(INOUT) :: Rng
+      KPP_REAL, INTENT(IN) :: Mu
+      REAL(kind=dp) :: emu, prod, smu, lmu, a, b, invalpha, vr, U, V, us
+      INTEGER :: k
+
+      KppRandPoisson = 0
+      IF ( Mu <= 0 ) RETURN
+
+      IF ( Mu < 10 ) THEN
+        emu  = EXP(-REAL(Mu,dp))
+        prod = KppRandUniform( Rng )
+        k = 0
+        DO WHILE ( prod > emu )
+          prod = prod*KppRandUniform( Rng )
+          k = k + 1
+        END DO
+        KppRandPoisson = k
+        RETURN
+      END IF
+
+      smu = SQRT(REAL(Mu,dp))
+      lmu = LOG(REAL(Mu,dp))
+      b = 0.931_dp + 2.53_dp*smu
+      a = -0.059_dp + 0.02483_dp*b
+      invalpha = 1.1239_dp + 1.1328_dp/(b-3.4_dp)
+      vr = 0.9277_dp - 3.6224_dp/(b-2.0_dp)
+      DO
+        U  = KppRandUniform( Rng ) - 0.5_dp
+        V  = KppRandUniform( Rng )
+        us = 0.5_dp - ABS(U)
+        k  = FLOOR( (2.0_dp*a/us + b)*U + Mu + 0.43_dp )
+        IF ( us >= 0.07_dp .AND. V <= vr ) EXIT
+        IF ( k < 0 .OR. (us < 0.013_dp .AND. V > us) ) CYCLE
+        IF ( LOG(V) + LOG(invalpha) - LOG(a/(us*us) + b)  &
+             <= -Mu + k*lmu - LOG_GAMMA(k + 1.0_dp) ) EXIT
+      END DO
+      KppRandPoisson = k
+
+END FUNCTION KppRandPoisson
@@ -0,0 +1,132 @@
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Reader for the binary output of SaveData (KPP_ROOT.bin, see util.c)
+
+    Stand-alone utility, not part of the generated code:
+        cc -O -o readbin $KPP_HOME/util/readbin.c
+        readbin KPP_ROOT.bin                 header and all columns as text
+        readbin KPP_ROOT.bin O3 NO2          time and the named columns
+
+    KppReadBin can also be copied into user programs: it returns the
+    column names and the data (row major, NCOL values per row).
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  int     ncol, nrow, namelen;
+  double  cfactor, tscale;
+  char   *names;                 /* ncol names of namelen characters */
+  double *data;                  /* nrow x ncol, row major           */
+} KPP_BINDATA;
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+/* Reads file into B. Returns 0 on success, a negative code on error */
+int KppReadBin( const char *file, KPP_BINDATA *B )
+{
+FILE *fp;
+char magic[8];
+int hdr[4];
+double scale[2];
+long start, end;
+
+  memset( B, 0, sizeof(KPP_BINDATA) );
+  fp = fopen( file, "rb" );
+  if( fp == 0 ) return -1;
+
+  if( fread( magic, 1, 8, fp ) != 8 || strcmp( magic, "KPPDAT1" ) != 0 ||
+      fread( hdr, sizeof(int), 4, fp ) != 4 ||
+      fread( scale, sizeof(double), 2, fp ) != 2 ) {
+    fclose( fp );
+    return -2;
+  }
+  if( hdr[0] != 1 ) {            /* written with the other byte order */
+    fclose( fp );
+    return -3;
+  }
+  B->ncol    = hdr[1];
+  B->namelen = hdr[2];
+  B->cfactor = scale[0];
+  B->tscale  = scale[1];
+
+  B->names = (char*)malloc( B->ncol*B->namelen );
+  if( B->names == 0 ||
+      fread( B->names, 1, B->ncol*B->namelen, fp ) != (size_t)(B->ncol*B->namelen) ) {
+    fclose( fp );
+    return -2;
+  }
+
+  /* The number of rows follows from the file size */
+  start = ftell( fp );
+  fseek( fp, 0, SEEK_END );
+  end = ftell( fp );
+  fseek( fp, start, SEEK_SET );
+  B->nrow = (int)( (end-start)/(sizeof(double)*B->ncol) );
+
+  B->data = (double*)malloc( sizeof(double)*B->ncol*(B->nrow > 0 ? B->nrow : 1) );
+  if( B->data == 0 ||
+      fread( B->data, sizeof(double), B->ncol*B->nrow, fp ) != (size_t)(B->ncol*B->nrow) ) {
+    fclose( fp );
+    return -2;
+  }
+  fclose( fp );
+  return 0;
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void KppFreeBin( KPP_BINDATA *B )
+{
+  free( B->names );
+  free( B->data );
+  memset( B, 0, sizeof(KPP_BINDATA) );
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int main( int argc, char *argv[] )
+{
+KPP_BINDATA B;
+int i, j, k, ncol, *col;
+
+  if( argc < 2 ) {
+    printf("Usage: %s KPP_ROOT.bin [species ...]\n", argv[0]);
+    return 1;
+  }
+  switch( KppReadBin( argv[1], &B ) ) {
+    case -1: printf("Can't open file : %s\n", argv[1]); return 1;
+    case -2: printf("%s : not a KPP binary output file\n", argv[1]); return 1;
+    case -3: printf("%s : written with a different byte order\n", argv[1]); return 1;
+  }
+
+  /* Selected columns; the time always comes first */
+  col = (int*)malloc( sizeof(int)*(argc > 2 ? argc : B.ncol) );
+  col[0] = 0;
+  ncol = 1;
+  if( argc > 2 ) {
+    for( k = 2; k < argc; k++ ) {
+      for( j = 1; j < B.ncol; j++ )
+        if( strcmp( argv[k], B.names + j*B.namelen ) == 0 ) break;
+      if( j == B.ncol ) {
+        printf("%s : no column %s\n", argv[1], argv[k]);
+        return 1;
+      }
+      col[ncol++] = j;
+    }
+  } else {
+    for( j = 1; j < B.ncol; j++ ) col[ncol++] = j;
+  }
+
+  printf("# %d rows, CFACTOR = %g, time unit = %g s\n#",
+         B.nrow, B.cfactor, B.tscale );
+  for( k = 0; k < ncol; k++ )
+    printf( " %24s", B.names + col[k]*B.namelen );
+  printf("\n");
+  for( i = 0; i < B.nrow; i++ ) {
+    for( k = 0; k < ncol; k++ )
+      printf( " %24.16e", B.data[ i*B.ncol + col[k] ] );
+    printf("\n");
+  }
+
+  free( col );
+  KppFreeBin( &B );
+  return 0;
+}
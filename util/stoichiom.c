@@ -0,0 +1,72 @@
+/*--------------------------------------------------------------
+
+  Fun and Jacobian in the stoichiometric formulation
+
+  With mass action kinetics
+       Vdot = STOICM * ( RCT .* ARP )
+       Jac  = STOICM * diag( RCT ) * JVRP
+  where ARP are the reactant products and JVRP their Jacobian.
+  Both are evaluated row by row, through the row-compressed view
+  of the stoichiometric matrix (CROW_STOICM, IPOS_STOICM), so that
+  each component of Vdot and each row of Jac is written once.
+  The Jacobian is returned in the format of Jac_SP.  The results
+  equal those of Fun and Jac_SP up to rounding; the code size does
+  not grow with the mechanism, only the sparse data does.
+
+--------------------------------------------------------------*/
+
+void ReactantProd( KPP_REAL V[], KPP_REAL F[], KPP_REAL ARP[] );
+void JacReactantProd( KPP_REAL V[], KPP_REAL F[], KPP_REAL JVRP[] );
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void Fun_Stoic( KPP_REAL V[], KPP_REAL F[], KPP_REAL RCT[], KPP_REAL Vdot[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Time derivative of the variable species, as Fun
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL W[KPP_NREACT], sum;
+int i, k, kk;
+
+  ReactantProd( V, F, W );
+  for( k = 0; k < KPP_NREACT; k++ )
+    W[k] *= RCT[k];
+
+  for( i = 0; i < KPP_NVAR; i++ ) {
+    sum = 0.0;
+    for( kk = CROW_STOICM[i]; kk < CROW_STOICM[i+1]; kk++ ) {
+      k = IPOS_STOICM[kk];
+      sum += STOICM[k]*W[ ICOL_STOICM[k] ];
+    }
+    Vdot[i] = sum;
+  }
+}
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void Jac_SP_Stoic( KPP_REAL V[], KPP_REAL F[], KPP_REAL RCT[], KPP_REAL JVS[] )
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+    Sparse Jacobian of the variable species, as Jac_SP.  Row i sums
+    STOICM(i,r)*RCT(r) times row r of JVRP over the reactions r of
+    species i into a dense work row, gathered into JVS by LU_ICOL
+~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+{
+KPP_REAL JVRP[NJVRP], W[KPP_NVAR], a;
+int i, k, kk, r, m;
+
+  JacReactantProd( V, F, JVRP );
+
+  for( i = 0; i < KPP_NVAR; i++ )
+    W[i] = 0.0;
+  for( i = 0; i < KPP_NVAR; i++ ) {
+    for( kk = CROW_STOICM[i]; kk < CROW_STOICM[i+1]; kk++ ) {
+      k = IPOS_STOICM[kk];
+      r = ICOL_STOICM[k];
+      a = STOICM[k]*RCT[r];
+      for( m = CROW_JVRP[r]; m < CROW_JVRP[r+1]; m++ )
+        W[ ICOL_JVRP[m] ] += a*JVRP[m];
+    }
+    for( kk = LU_CROW[i]; kk < LU_CROW[i+1]; kk++ ) {
+      JVS[kk] = W[ LU_ICOL[kk] ];
+      W[ LU_ICOL[kk] ] = 0.0;
+    }
+  }
+}
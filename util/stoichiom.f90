@@ -0,0 +1,84 @@
+! ------------------------------------------------------------------------------
+! Fun and Jacobian in the stoichiometric formulation
+!
+! With mass action kinetics
+!      Vdot = STOICM * ( RCT .* ARP )
+!      Jac  = STOICM * diag( RCT ) * JVRP
+! where ARP are the reactant products and JVRP their Jacobian.
+! Both are evaluated row by row, through the row-compressed view of the
+! stoichiometric matrix (CROW_STOICM, IPOS_STOICM). The Jacobian is
+! returned in the format of Jac_SP.
+! -----------------------------------------------------------------------------
+
+      SUBROUTINE  Fun_Stoic( V, F, RCT, Vdot )
+       
+      USE KPP_ROOT_Parameters
+      USE KPP_ROOT_StoichiomSP
+      IMPLICIT NONE 
+
+! V - Concentrations of variable/fixed species            
+      KPP_REAL V(NVAR), F(NFIX)
+! RCT - Rate constants
+      KPP_REAL RCT(NREACT)
+! Vdot - Time derivative of the variable species, as Fun
+      KPP_REAL Vdot(NVAR)
+
+! Local vector with the reaction rates
+      KPP_REAL W(NREACT)
+      INTEGER i,k1,k2
+      
+      CALL ReactantProd ( V, F, W )
+      W(1:NREACT) = W(1:NREACT)*RCT(1:NREACT)
+
+      DO i=1,NVAR
+         k1 = CROW_STOICM(i)
+         k2 = CROW_STOICM(i+1)-1
+         Vdot(i) = DOT_PRODUCT( STOICM(IPOS_STOICM(k1:k2)), &
+                                W(ICOL_STOICM(IPOS_STOICM(k1:k2))) )
+      END DO
+      
+      END SUBROUTINE  Fun_Stoic
+
+
+! ------------------------------------------------------------------------------
+! Sparse Jacobian of the variable species, as Jac_SP: row i sums
+! STOICM(i,r)*RCT(r) times row r of JVRP over the reactions r of species i
+! -----------------------------------------------------------------------------
+
+      SUBROUTINE  Jac_SP_Stoic( V, F, RCT, JVS )
+       
+      USE KPP_ROOT_Parameters
+      USE KPP_ROOT_StoichiomSP
+      USE KPP_ROOT_JacobianSP
+      IMPLICIT NONE 
+
+! V - Concentrations of variable/fixed species            
+      KPP_REAL V(NVAR), F(NFIX)
+! RCT - Rate constants
+      KPP_REAL RCT(NREACT)
+! JVS - Sparse Jacobian, in the LU row-compressed format
+      KPP_REAL JVS(LU_NONZERO)
+
+! Local vector for Jacobian of reactant products and a dense work row
+      KPP_REAL JV_RPROD(NJVRP), W(NVAR), a
+      INTEGER i,k,kk,r,k1,k2
+      
+      CALL JacReactantProd( V, F, JV_RPROD )
+
+      W(1:NVAR) = 0.0_dp
+      DO i=1,NVAR
+         DO kk=CROW_STOICM(i),CROW_STOICM(i+1)-1
+           k = IPOS_STOICM(kk)
+           r = ICOL_STOICM(k)
+           a = STOICM(k)*RCT(r)
+           k1 = CROW_JVRP(r)
+           k2 = CROW_JVRP(r+1)-1
+           W(ICOL_JVRP(k1:k2)) = W(ICOL_JVRP(k1:k2)) + a*JV_RPROD(k1:k2)
+         END DO
+         k1 = LU_CROW(i)
+         k2 = LU_CROW(i+1)-1
+         JVS(k1:k2) = W(LU_ICOL(k1:k2))
+         W(LU_ICOL(k1:k2)) = 0.0_dp
+      END DO
+      
+      END SUBROUTINE  Jac_SP_Stoic
@@ -7,6 +7,7 @@ int k, kk, j, jj;
 
   for( k = 0; k < KPP_NVAR; k++ ) {
     if( JVS[ LU_DIAG[k] ] == 0.0 ) return k+1;
+    if( LU_CROW[k] == LU_DIAG[k] ) continue; /* no L part, e.g. a 1x1 block */
     for( kk = LU_CROW[k]; kk < LU_CROW[k+1]; kk++ )
       W[ LU_ICOL[kk] ] = JVS[kk];
     for( kk = LU_CROW[k]; kk < LU_DIAG[k]; kk++ ) {
@@ -88,3 +89,261 @@ void KppSolveCmplxR(KPP_REAL JVSR[], KPP_REAL JVSI[], KPP_REAL XR[], KPP_REAL XI
 /*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 	END FUNCTION KppSolveCmplxR
   ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Gershgorin bound of row k of the Jacobian JVS: the diagonal
+	shift JVS(k,k) + sum_j |JVS(k,j)| above which row k of
+	Shift*I - JVS is strictly diagonally dominant
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+KPP_REAL KppRowShift( KPP_REAL JVS[], int k )
+{
+   KPP_REAL Shift;
+   int kk;
+
+   Shift = JVS[ LU_DIAG[k] ];
+   for ( kk = LU_CROW[k]; kk < LU_CROW[k+1]; kk++ )
+	if ( kk != LU_DIAG[k] )
+	   Shift += ( JVS[kk] >= 0 ) ? JVS[kk] : -JVS[kk];
+   return Shift;
+}
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	END FUNCTION KppRowShift
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Sparse LU factorization in single precision: LUS receives the
+	factors of JVS, which is not changed.  Returns 0, or k+1 for a
+	zero or non-finite pivot in row k
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int KppDecompSP( KPP_REAL JVS[], float LUS[] )
+{
+   float W[KPP_NVAR];
+   float a;
+   int k, kk, j, jj;
+
+   for ( k = 0; k < KPP_NVAR; k++ ) {
+	for ( kk = LU_CROW[k]; kk < LU_CROW[k+1]; kk++ )
+	   W[ LU_ICOL[kk] ] = (float)JVS[kk];
+	for ( kk = LU_CROW[k]; kk < LU_DIAG[k]; kk++ ) {
+	   j = LU_ICOL[kk];
+	   a = -W[j] / LUS[ LU_DIAG[j] ];
+	   W[j] = -a;
+	   for ( jj = LU_DIAG[j]+1; jj < LU_CROW[j+1]; jj++ )
+		W[ LU_ICOL[jj] ] += a*LUS[jj];
+	}
+	for ( kk = LU_CROW[k]; kk < LU_CROW[k+1]; kk++ )
+	   LUS[kk] = W[ LU_ICOL[kk] ];
+	a = LUS[ LU_DIAG[k] ];
+	if ( (a == 0.0f) || !(a-a == 0.0f) ) return k+1;
+   }
+   return 0;
+}
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	END FUNCTION KppDecompSP
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Forward and back substitution in single precision with the
+	factors of KppDecompSP
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void KppSolveSP( float LUS[], KPP_REAL X[] )
+{
+   float XS[KPP_NVAR];
+   float sum;
+   int i, j;
+
+   for ( i = 0; i < KPP_NVAR; i++ ) {
+	sum = (float)X[i];
+	for ( j = LU_CROW[i]; j < LU_DIAG[i]; j++ )
+	   sum -= LUS[j]*XS[ LU_ICOL[j] ];
+	XS[i] = sum;
+   }
+   for ( i = KPP_NVAR-1; i >= 0; i-- ) {
+	sum = XS[i];
+	for ( j = LU_DIAG[i]+1; j < LU_CROW[i+1]; j++ )
+	   sum -= LUS[j]*XS[ LU_ICOL[j] ];
+	XS[i] = sum / LUS[ LU_DIAG[i] ];
+   }
+   for ( i = 0; i < KPP_NVAR; i++ )
+	X[i] = (KPP_REAL)XS[i];
+}
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	END FUNCTION KppSolveSP
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Mixed precision solve of JVS*X = B (B given in X) with the
+	single precision factors LUS of JVS.  The residual B - JVS*X
+	is computed in double precision; while its RMS norm scaled by
+	W is above Tol, X is refined with it, at most MaxRef times.
+	Returns 0 on convergence, else 1 with X = B
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+int KppSolveMixed( KPP_REAL JVS[], float LUS[], KPP_REAL W[],
+		   KPP_REAL Tol, int MaxRef, KPP_REAL X[] )
+{
+   KPP_REAL B[KPP_NVAR], R[KPP_NVAR];
+   KPP_REAL sum, rnorm;
+   int i, kk, it;
+
+   for ( i = 0; i < KPP_NVAR; i++ )
+	B[i] = X[i];
+   KppSolveSP( LUS, X );
+
+   for ( it = 0; ; it++ ) {
+	rnorm = 0.0;
+	for ( i = 0; i < KPP_NVAR; i++ ) {
+	   sum = B[i];
+	   for ( kk = LU_CROW[i]; kk < LU_CROW[i+1]; kk++ )
+		sum -= JVS[kk]*X[ LU_ICOL[kk] ];
+	   R[i] = sum;
+	   rnorm += (W[i]*sum)*(W[i]*sum);
+	}
+	if ( rnorm <= Tol*Tol*KPP_NVAR ) return 0;
+	/* No refinement of a NaN or infinite residual */
+	if ( ( it == MaxRef ) || !( rnorm-rnorm == 0.0 ) ) break;
+	KppSolveSP( LUS, R );
+	for ( i = 0; i < KPP_NVAR; i++ )
+	   X[i] += R[i];
+   }
+
+   for ( i = 0; i < KPP_NVAR; i++ )
+	X[i] = B[i];
+   return 1;
+}
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	END FUNCTION KppSolveMixed
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Forward and back substitution with the factors of KppDecomp
+	for NRHS right hand sides at once.  X holds them interleaved,
+	X[i*NRHS+d] being component i of right hand side d, so that
+	each row of the factors is read once for all of them.  Each
+	solution is identical to that of KppSolve
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void KppSolve_Multi( KPP_REAL JVS[], int NRHS, KPP_REAL X[] )
+{
+   KPP_REAL a;
+   KPP_REAL *Xi, *Xj;
+   int i, j, d;
+
+   for ( i = 0; i < KPP_NVAR; i++ ) {
+	Xi = &X[i*NRHS];
+	for ( j = LU_CROW[i]; j < LU_DIAG[i]; j++ ) {
+	   a  = JVS[j];
+	   Xj = &X[ LU_ICOL[j]*NRHS ];
+	   for ( d = 0; d < NRHS; d++ )
+		Xi[d] -= a*Xj[d];
+	}
+   }
+   for ( i = KPP_NVAR-1; i >= 0; i-- ) {
+	Xi = &X[i*NRHS];
+	for ( j = LU_DIAG[i]+1; j < LU_CROW[i+1]; j++ ) {
+	   a  = JVS[j];
+	   Xj = &X[ LU_ICOL[j]*NRHS ];
+	   for ( d = 0; d < NRHS; d++ )
+		Xi[d] -= a*Xj[d];
+	}
+	a = JVS[ LU_DIAG[i] ];
+	for ( d = 0; d < NRHS; d++ )
+	   Xi[d] = Xi[d] / a;
+   }
+}
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	END FUNCTION KppSolve_Multi
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Sparse Jacobian (in the LU pattern) times NRHS vectors:
+	JU = JVS * U, with U and JU interleaved as in KppSolve_Multi
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void Jac_SP_Mat( KPP_REAL JVS[], int NRHS, KPP_REAL U[], KPP_REAL JU[] )
+{
+   KPP_REAL a;
+   KPP_REAL *JUi, *Uj;
+   int i, kk, d;
+
+   for ( i = 0; i < KPP_NVAR; i++ ) {
+	JUi = &JU[i*NRHS];
+	for ( d = 0; d < NRHS; d++ )
+	   JUi[d] = 0.0;
+	for ( kk = LU_CROW[i]; kk < LU_CROW[i+1]; kk++ ) {
+	   a = JVS[kk];
+	   if ( a == 0.0 ) continue; /* fill-in */
+	   Uj = &U[ LU_ICOL[kk]*NRHS ];
+	   for ( d = 0; d < NRHS; d++ )
+		JUi[d] += a*Uj[d];
+	}
+   }
+}
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	END FUNCTION Jac_SP_Mat
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Transposed forward and back substitution with the factors of
+	KppDecomp, (LU)^T X = B, for NRHS right hand sides at once,
+	interleaved as in KppSolve_Multi.  The rows of the factors are
+	read once, in the order of KppSolve_Multi, each row scattering
+	into the rows of X it is a column of.  The solve with U^T is
+	identical to that of KppSolveTR, the solve with L^T equal to
+	it up to rounding
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void KppSolveTR_Multi( KPP_REAL JVS[], int NRHS, KPP_REAL X[] )
+{
+   KPP_REAL a;
+   KPP_REAL *Xi, *Xj;
+   int i, j, d;
+
+   for ( i = 0; i < KPP_NVAR; i++ ) {
+	Xi = &X[i*NRHS];
+	a  = JVS[ LU_DIAG[i] ];
+	for ( d = 0; d < NRHS; d++ )
+	   Xi[d] = Xi[d] / a;
+	for ( j = LU_DIAG[i]+1; j < LU_CROW[i+1]; j++ ) {
+	   a  = JVS[j];
+	   Xj = &X[ LU_ICOL[j]*NRHS ];
+	   for ( d = 0; d < NRHS; d++ )
+		Xj[d] -= a*Xi[d];
+	}
+   }
+   for ( i = KPP_NVAR-1; i >= 0; i-- ) {
+	Xi = &X[i*NRHS];
+	for ( j = LU_CROW[i]; j < LU_DIAG[i]; j++ ) {
+	   a  = JVS[j];
+	   Xj = &X[ LU_ICOL[j]*NRHS ];
+	   for ( d = 0; d < NRHS; d++ )
+		Xj[d] -= a*Xi[d];
+	}
+   }
+}
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	END FUNCTION KppSolveTR_Multi
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	Transposed sparse Jacobian (in the LU pattern) times NRHS
+	vectors: JTU = JVS^T * U, interleaved as in KppSolve_Multi
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
+void JacTR_SP_Mat( KPP_REAL JVS[], int NRHS, KPP_REAL U[], KPP_REAL JTU[] )
+{
+   KPP_REAL a;
+   KPP_REAL *Ui, *JTUj;
+   int i, kk, d;
+
+   for ( i = 0; i < KPP_NVAR*NRHS; i++ )
+	JTU[i] = 0.0;
+   for ( i = 0; i < KPP_NVAR; i++ ) {
+	Ui = &U[i*NRHS];
+	for ( kk = LU_CROW[i]; kk < LU_CROW[i+1]; kk++ ) {
+	   a = JVS[kk];
+	   if ( a == 0.0 ) continue; /* fill-in */
+	   JTUj = &JTU[ LU_ICOL[kk]*NRHS ];
+	   for ( d = 0; d < NRHS; d++ )
+		JTUj[d] += a*Ui[d];
+	}
+   }
+}
+/*~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+	END FUNCTION JacTR_SP_Mat
+  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
@@ -19,6 +19,8 @@ C ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
             IER = k
             RETURN
         END IF
+C       No L part, e.g. a 1x1 block
+        IF ( LU_CROW(k) .EQ. LU_DIAG(k) ) CYCLE
         DO kk = LU_CROW(k), LU_CROW(k+1)-1
               W( LU_ICOL(kk) ) = JVS(kk)
         END DO
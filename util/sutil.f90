@@ -21,6 +21,8 @@ SUBROUTINE KppDecomp( JVS, IER )
             IER = k
             RETURN
         END IF
+        ! No L part, e.g. a 1x1 block
+        IF ( LU_CROW(k) == LU_DIAG(k) ) CYCLE
         DO kk = LU_CROW(k), LU_CROW(k+1)-1
               W( LU_ICOL(kk) ) = JVS(kk)
         END DO
@@ -313,6 +315,128 @@ SUBROUTINE KppSolveTRCmplxR( JVSR, JVSI, XR, XI )
 END SUBROUTINE KppSolveTRCmplxR
 
 
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+SUBROUTINE KppDecompSP( JVS, LUS, IER )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        Sparse LU factorization in single precision: LUS receives
+!        the factors of JVS, which is not changed.  IER = k for a
+!        zero or non-finite pivot in row k
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+  USE KPP_ROOT_Parameters
+  USE KPP_ROOT_JacobianSP
+
+      INTEGER       :: IER
+      KPP_REAL      :: JVS(LU_NONZERO)
+      REAL(kind=sp) :: LUS(LU_NONZERO), W(NVAR), a
+      INTEGER       :: k, kk, j, jj
+
+      IER = 0
+      DO k=1,NVAR
+        DO kk = LU_CROW(k), LU_CROW(k+1)-1
+           W( LU_ICOL(kk) ) = REAL( JVS(kk), sp )
+        END DO
+        DO kk = LU_CROW(k), LU_DIAG(k)-1
+           j = LU_ICOL(kk)
+           a = -W(j) / LUS( LU_DIAG(j) )
+           W(j) = -a
+           DO jj = LU_DIAG(j)+1, LU_CROW(j+1)-1
+              W( LU_ICOL(jj) ) = W( LU_ICOL(jj) ) + a*LUS(jj)
+           END DO
+        END DO
+        DO kk = LU_CROW(k), LU_CROW(k+1)-1
+           LUS(kk) = W( LU_ICOL(kk) )
+        END DO
+        a = LUS( LU_DIAG(k) )
+        IF ( .NOT.( ABS(a) >= TINY(a) .AND. ABS(a) <= HUGE(a) ) ) THEN
+           IER = k
+           RETURN
+        END IF
+      END DO
+
+END SUBROUTINE KppDecompSP
+
+
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+SUBROUTINE KppSolveSP( LUS, X )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        Forward and back substitution in single precision with
+!        the factors of KppDecompSP
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+  USE KPP_ROOT_Parameters
+  USE KPP_ROOT_JacobianSP
+
+      REAL(kind=sp) :: LUS(LU_NONZERO), XS(NVAR), sum
+      KPP_REAL      :: X(NVAR)
+      INTEGER       :: i, j
+
+      DO i=1,NVAR
+         sum = REAL( X(i), sp )
+         DO j = LU_CROW(i), LU_DIAG(i)-1
+            sum = sum - LUS(j)*XS(LU_ICOL(j))
+         END DO
+         XS(i) = sum
+      END DO
+
+      DO i=NVAR,1,-1
+         sum = XS(i)
+         DO j = LU_DIAG(i)+1, LU_CROW(i+1)-1
+            sum = sum - LUS(j)*XS(LU_ICOL(j))
+         END DO
+         XS(i) = sum/LUS(LU_DIAG(i))
+      END DO
+
+      X(1:NVAR) = XS(1:NVAR)
+
+END SUBROUTINE KppSolveSP
+
+
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+SUBROUTINE KppSolveMixed( JVS, LUS, W, Tol, MaxRef, X, IER )
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+!        Mixed precision solve of JVS*X = B (B given in X) with the
+!        single precision factors LUS of JVS.  The residual B - JVS*X
+!        is computed in double precision; while its RMS norm scaled
+!        by W is above Tol, X is refined with it, at most MaxRef
+!        times.  IER = 0 on convergence, else IER = 1 and X = B
+! ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+  USE KPP_ROOT_Parameters
+  USE KPP_ROOT_JacobianSP
+
+      INTEGER       :: MaxRef, IER
+      KPP_REAL      :: JVS(LU_NONZERO), W(NVAR), Tol, X(NVAR)
+      REAL(kind=sp) :: LUS(LU_NONZERO)
+      KPP_REAL      :: B(NVAR), R(NVAR), rnorm
+      INTEGER       :: i, kk, it
+
+      B(1:NVAR) = X(1:NVAR)
+      CALL KppSolveSP( LUS, X )
+
+      IER = 0
+      DO it = 0, MaxRef
+         DO i=1,NVAR
+            R(i) = B(i)
+            DO kk = LU_CROW(i), LU_CROW(i+1)-1
+               R(i) = R(i) - JVS(kk)*X(LU_ICOL(kk))
+            END DO
+         END DO
+         rnorm = SUM( (W(1:NVAR)*R(1:NVAR))**2 )
+         IF ( rnorm <= Tol*Tol*NVAR ) RETURN
+         ! No refinement of a NaN or infinite residual
+         IF ( .NOT.( rnorm <= HUGE(rnorm) ) ) EXIT
+         IF ( it == MaxRef ) EXIT
+         CALL KppSolveSP( LUS, R )
+         X(1:NVAR) = X(1:NVAR) + R(1:NVAR)
+      END DO
+
+      IER = 1
+      X(1:NVAR) = B(1:NVAR)
+
+END SUBROUTINE KppSolveMixed
+
+
 !
 ! Next few commented subroutines perform sparse big linear algebra
 !
@@ -15,6 +15,84 @@ KPP_REAL max( KPP_REAL x, KPP_REAL y )
 
 static FILE *fpDat = 0;
 
+#ifdef KPP_BINARY_OUTPUT
+/* Binary output (compile with -DKPP_BINARY_OUTPUT), written to
+   KPP_ROOT.bin in native byte order:
+      char   magic[8]            "KPPDAT1"
+      int    order, NCOL, NAMELEN, 0     order = 1 (byte order check)
+      double CFACTOR, TSCALE             columns 1.. hold C/CFACTOR,
+                                         column 0 the time in units
+                                         of TSCALE seconds
+      char   names[NCOL][NAMELEN]        "TIME" and the LOOKAT species
+      double data[][NCOL]                one row per SaveData call
+   Rows are collected in a large buffer and written with one fwrite. */
+#define NAMELEN  32
+#define DATBUF   65536         /* Buffer length (doubles) */
+#define TSCALE   3600.0        /* Time is saved in hours */
+
+static double datBuf[DATBUF+NSPEC+1];
+static int nBuf = 0;
+
+static void FlushSaveData()
+{
+  if( nBuf > 0 ) fwrite( datBuf, sizeof(double), nBuf, fpDat );
+  nBuf = 0;
+}
+
+int InitSaveData()
+{
+int i, hdr[4];
+double scale[2];
+char name[NAMELEN];
+
+  fpDat = fopen("KPP_ROOT.bin", "wb");
+  if( fpDat == 0 ) {
+    printf("\n Can't create file : KPP_ROOT.bin");
+    exit(1);
+  }
+  setvbuf( fpDat, 0, _IONBF, 0 );   /* datBuf does the buffering */
+
+  hdr[0] = 1;
+  hdr[1] = NLOOKAT+1;
+  hdr[2] = NAMELEN;
+  hdr[3] = 0;
+  scale[0] = CFACTOR;
+  scale[1] = TSCALE;
+  fwrite( "KPPDAT1", 1, 8, fpDat );
+  fwrite( hdr, sizeof(int), 4, fpDat );
+  fwrite( scale, sizeof(double), 2, fpDat );
+  memset( name, 0, NAMELEN );
+  strcpy( name, "TIME" );
+  fwrite( name, 1, NAMELEN, fpDat );
+  for( i = 0; i < NLOOKAT; i++ ) {
+    memset( name, 0, NAMELEN );
+    strncpy( name, SPC_NAMES[ LOOKAT[i] ], NAMELEN-1 );
+    fwrite( name, 1, NAMELEN, fpDat );
+  }
+  nBuf = 0;
+  return 0;
+}
+
+int SaveData()
+{
+int i;
+
+  datBuf[nBuf++] = TIME/TSCALE;
+  for( i = 0; i < NLOOKAT; i++ )
+    datBuf[nBuf++] = C[ LOOKAT[i] ]/CFACTOR;
+  if( nBuf >= DATBUF ) FlushSaveData();
+  return 0;
+}
+
+int CloseSaveData()
+{
+  FlushSaveData();
+  fclose( fpDat );
+  return 0;
+}
+
+#else
+
 int InitSaveData()
 {
   fpDat = fopen("KPP_ROOT.dat", "w");
@@ -42,6 +120,8 @@ int CloseSaveData()
   return 0;
 }
 
+#endif
+
 int GenerateMatlab( char * prefix )
 {
 int i;
@@ -53,9 +133,20 @@ FILE *fpMatlab;
     exit(1);
   }
 
+#ifdef KPP_BINARY_OUTPUT
+  fprintf(fpMatlab, "fid = fopen('KPP_ROOT.bin','r');\n");
+  fprintf(fpMatlab, "fread(fid,8,'*char');\n");
+  fprintf(fpMatlab, "hdr = fread(fid,4,'int32');\n");
+  fprintf(fpMatlab, "if hdr(1) ~= 1, error('KPP_ROOT.bin: wrong byte order'); end\n");
+  fprintf(fpMatlab, "%sscale = fread(fid,2,'double');\n", prefix);
+  fprintf(fpMatlab, "fread(fid,[hdr(3),hdr(2)],'*char');\n");
+  fprintf(fpMatlab, "%sc = fread(fid,[hdr(2),Inf],'double')';\n", prefix);
+  fprintf(fpMatlab, "fclose(fid);\n");
+#else
   fprintf(fpMatlab, "load KPP_ROOT.dat;\n");
   fprintf(fpMatlab, "%sc = KPP_ROOT;\n", prefix);
   fprintf(fpMatlab, "clear KPP_ROOT;\n");
+#endif
   fprintf(fpMatlab, "%st=%sc(:,1);\n", prefix, prefix);
   fprintf(fpMatlab, "%sc(:,1)=[];\n", prefix);
   